@@ -56,6 +56,8 @@
 #endif
 
 #include "cJSON.h"
+/* the plain numbers are formatted and parsed by the link json, which shares the code with cJSON */
+#include <link_json.h>
 
 /* define our own boolean type */
 #define true ((cJSON_bool)1)
@@ -229,6 +231,10 @@ CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
         {
             global_hooks.deallocate(item->string);
         }
+        if (item->index != NULL)
+        {
+            global_hooks.deallocate(item->index);
+        }
         global_hooks.deallocate(item);
         item = next;
     }
@@ -276,6 +282,14 @@ static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_bu
         return false;
     }
 
+    /* most numbers are plain and short, which needs no strtod */
+    i = (size_t)json_number_parse((const char*)buffer_at_offset(input_buffer), (int)(input_buffer->length - input_buffer->offset), &number);
+    if (i != 0)
+    {
+        after_end = number_c_string + i;
+        goto number_end;
+    }
+
     /* copy the number into a temporary buffer and replace '.' with the decimal point
      * of the current locale (for strtod)
      * This also takes care of '\0' not necessarily being available for marking the end of the input */
@@ -317,6 +331,7 @@ loop_end:
         return false; /* parse_error */
     }
 
+number_end:
     item->valuedouble = number;
 
     /* use saturation in case of overflow */
@@ -470,28 +485,18 @@ static void update_offset(printbuffer * const buffer)
     buffer->offset += strlen((const char*)buffer_pointer);
 }
 
-/* Render the number nicely from the given item into a string. */
-static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+/* Render the number into the temporary buffer, returns the length or -1 on failure. */
+static int format_number(double d, unsigned char * const number_buffer, size_t size)
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
     int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26]; /* temporary buffer to print the number into */
-    unsigned char decimal_point = get_decimal_point();
     double test;
 
-    if (output_buffer == NULL)
-    {
-        return false;
-    }
-
     /* This checks for NaN and Infinity */
     if ((d * 0) != 0)
     {
         length = sprintf((char*)number_buffer, "null");
     }
-    else
+    else if ((length = json_number_format(d, (char*)number_buffer)) == 0)
     {
         /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
         length = sprintf((char*)number_buffer, "%1.15g", d);
@@ -505,7 +510,30 @@ static cJSON_bool print_number(const cJSON * const item, printbuffer * const out
     }
 
     /* sprintf failed or buffer overrun occured */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    if ((length < 0) || (length > (int)(size - 1)))
+    {
+        return -1;
+    }
+
+    return length;
+}
+
+/* Render the number nicely from the given item into a string. */
+static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    int length = 0;
+    size_t i = 0;
+    unsigned char number_buffer[26]; /* temporary buffer to print the number into */
+    unsigned char decimal_point = get_decimal_point();
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    length = format_number(item->valuedouble, number_buffer, sizeof(number_buffer));
+    if (length < 0)
     {
         return false;
     }
@@ -823,6 +851,40 @@ fail:
     return false;
 }
 
+/* numbers of additional characters needed for escaping the cstring */
+static size_t escape_length(const unsigned char * const input, size_t * const input_length)
+{
+    const unsigned char *input_pointer = NULL;
+    size_t escape_characters = 0;
+
+    for (input_pointer = input; *input_pointer; input_pointer++)
+    {
+        switch (*input_pointer)
+        {
+            case '\"':
+            case '\\':
+            case '\b':
+            case '\f':
+            case '\n':
+            case '\r':
+            case '\t':
+                /* one character escape sequence */
+                escape_characters++;
+                break;
+            default:
+                if (*input_pointer < 32)
+                {
+                    /* UTF-16 escape sequence uXXXX */
+                    escape_characters += 5;
+                }
+                break;
+        }
+    }
+    *input_length = (size_t)(input_pointer - input);
+
+    return escape_characters;
+}
+
 /* Render the cstring provided to an escaped version that can be printed. */
 static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
 {
@@ -852,30 +914,8 @@ static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffe
     }
 
     /* set "flag" to 1 if something needs to be escaped */
-    for (input_pointer = input; *input_pointer; input_pointer++)
-    {
-        switch (*input_pointer)
-        {
-            case '\"':
-            case '\\':
-            case '\b':
-            case '\f':
-            case '\n':
-            case '\r':
-            case '\t':
-                /* one character escape sequence */
-                escape_characters++;
-                break;
-            default:
-                if (*input_pointer < 32)
-                {
-                    /* UTF-16 escape sequence uXXXX */
-                    escape_characters += 5;
-                }
-                break;
-        }
-    }
-    output_length = (size_t)(input_pointer - input) + escape_characters;
+    escape_characters = escape_length(input, &output_length);
+    output_length += escape_characters;
 
     output = ensure(output_buffer, output_length + sizeof("\"\""));
     if (output == NULL)
@@ -958,6 +998,8 @@ static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buf
 static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer);
 static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer);
 static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer);
+static cJSON_bool print_length(const cJSON * const item, cJSON_bool format, size_t depth, size_t * const length);
+static void *build_object_index(const cJSON * const object);
 
 /* Utility to jump whitespace and cr/lf */
 static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
@@ -1089,14 +1131,42 @@ static unsigned char *print(const cJSON * const item, cJSON_bool format, const i
     static const size_t default_buffer_size = 256;
     printbuffer buffer[1];
     unsigned char *printed = NULL;
+    size_t length = 0;
 
     memset(buffer, 0, sizeof(buffer));
 
+    buffer->format = format;
+    buffer->hooks = *hooks;
+
+    /* measure the text first, then print it into one exact size buffer without any realloc and copy;
+     * ensure() always keeps one more byte behind the terminating '\0' it writes */
+    if (print_length(item, format, 0, &length) && (length < (INT_MAX / 2)))
+    {
+        buffer->buffer = (unsigned char*) hooks->allocate(length + sizeof("") + 1);
+        buffer->length = length + sizeof("") + 1;
+        buffer->noalloc = true;
+        if (buffer->buffer == NULL)
+        {
+            goto fail;
+        }
+
+        if (print_value(item, buffer))
+        {
+            update_offset(buffer);
+
+            return buffer->buffer;
+        }
+
+        /* should never happen, fall back to the growing buffer */
+        hooks->deallocate(buffer->buffer);
+        buffer->offset = 0;
+        buffer->depth = 0;
+        buffer->noalloc = false;
+    }
+
     /* create buffer */
     buffer->buffer = (unsigned char*) hooks->allocate(default_buffer_size);
     buffer->length = default_buffer_size;
-    buffer->format = format;
-    buffer->hooks = *hooks;
     if (buffer->buffer == NULL)
     {
         goto fail;
@@ -1498,6 +1568,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
 {
     cJSON *head = NULL; /* linked list head */
     cJSON *current_item = NULL;
+    size_t count = 0;
 
     if (input_buffer->depth >= CJSON_NESTING_LIMIT)
     {
@@ -1549,6 +1620,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
             new_item->prev = current_item;
             current_item = new_item;
         }
+        count++;
 
         /* parse the name of the child */
         input_buffer->offset++;
@@ -1590,6 +1662,12 @@ success:
     item->type = cJSON_Object;
     item->child = head;
 
+    /* the big object is likely to be looked up by many keys, index it here; without the index it still works */
+    if ((CJSON_INDEX_THRESHOLD > 0) && (count >= CJSON_INDEX_THRESHOLD))
+    {
+        item->index = build_object_index(item);
+    }
+
     input_buffer->offset++;
     return true;
 
@@ -1716,6 +1794,99 @@ static cJSON_bool print_object(const cJSON * const item, printbuffer * const out
     return true;
 }
 
+/* Calculate the exact length of the text rendered by print_value, without the terminating '\0'. */
+static cJSON_bool print_length(const cJSON * const item, cJSON_bool format, size_t depth, size_t * const length)
+{
+    unsigned char number_buffer[26];
+    size_t string_length = 0;
+    int number_length = 0;
+    cJSON *current_element = NULL;
+
+    if (item == NULL)
+    {
+        return false;
+    }
+
+    switch ((item->type) & 0xFF)
+    {
+        case cJSON_NULL:
+        case cJSON_True:
+            *length += 4;
+            return true;
+
+        case cJSON_False:
+            *length += 5;
+            return true;
+
+        case cJSON_Number:
+            number_length = format_number(item->valuedouble, number_buffer, sizeof(number_buffer));
+            if (number_length < 0)
+            {
+                return false;
+            }
+            *length += (size_t)number_length;
+            return true;
+
+        case cJSON_Raw:
+            if (item->valuestring == NULL)
+            {
+                return false;
+            }
+            *length += strlen(item->valuestring);
+            return true;
+
+        case cJSON_String:
+            if (item->valuestring != NULL)
+            {
+                *length += escape_length((unsigned char*)item->valuestring, &string_length) + string_length;
+            }
+            *length += sizeof("\"\"") - sizeof("");
+            return true;
+
+        case cJSON_Array:
+            /* [a, b] or [a,b] */
+            *length += 2;
+            for (current_element = item->child; current_element != NULL; current_element = current_element->next)
+            {
+                if (!print_length(current_element, format, depth + 1, length))
+                {
+                    return false;
+                }
+                if (current_element->next)
+                {
+                    *length += (size_t) (format ? 2 : 1);
+                }
+            }
+            return true;
+
+        case cJSON_Object:
+            /* {\n<depth tabs>"key":\tvalue,\n<depth - 1 tabs>} or {"key":value,} */
+            depth++;
+            *length += (size_t) (format ? (2 + depth) : 2);
+            for (current_element = item->child; current_element != NULL; current_element = current_element->next)
+            {
+                if (current_element->string != NULL)
+                {
+                    *length += escape_length((unsigned char*)current_element->string, &string_length) + string_length;
+                }
+                *length += sizeof("\"\"") - sizeof("");
+                *length += (size_t) (format ? (depth + 3) : 1);
+                if (!print_length(current_element, format, depth, length))
+                {
+                    return false;
+                }
+                if (current_element->next)
+                {
+                    *length += 1;
+                }
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 /* Get Array size/item / object item. */
 CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
 {
@@ -1769,6 +1940,96 @@ CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index)
     return get_array_item(array, (size_t)index);
 }
 
+/* the hash index of the object children, open addressing with linear probing */
+typedef struct
+{
+    size_t size; /* how many slots, power of 2 */
+    cJSON *slot[1];
+} object_index;
+
+static size_t hash_key(const unsigned char *key)
+{
+    size_t hash = 2166136261U;
+
+    /* case insensitive, so one index serves both lookups */
+    for (; *key != '\0'; key++)
+    {
+        hash = (hash ^ (size_t)tolower(*key)) * 16777619U;
+    }
+
+    return hash;
+}
+
+static void drop_object_index(cJSON * const object)
+{
+    if ((object != NULL) && (object->index != NULL))
+    {
+        global_hooks.deallocate(object->index);
+        object->index = NULL;
+    }
+}
+
+static void *build_object_index(const cJSON * const object)
+{
+    object_index *index = NULL;
+    cJSON *current_element = NULL;
+    size_t count = 0;
+    size_t size = 16;
+    size_t position = 0;
+
+    for (current_element = object->child; current_element != NULL; current_element = current_element->next)
+    {
+        count++;
+    }
+    /* keep the load factor under a half */
+    while (size < count * 2)
+    {
+        size *= 2;
+    }
+
+    index = (object_index*)global_hooks.allocate(sizeof(object_index) + (size - 1) * sizeof(cJSON*));
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    memset(index, '\0', sizeof(object_index) + (size - 1) * sizeof(cJSON*));
+    index->size = size;
+
+    /* inserted in the chain order, so the probing meets the duplicated keys in the chain order too */
+    for (current_element = object->child; current_element != NULL; current_element = current_element->next)
+    {
+        if (current_element->string == NULL)
+        {
+            continue;
+        }
+        position = hash_key((const unsigned char*)current_element->string) & (size - 1);
+        while (index->slot[position] != NULL)
+        {
+            position = (position + 1) & (size - 1);
+        }
+        index->slot[position] = current_element;
+    }
+
+    return index;
+}
+
+static cJSON *get_indexed_item(const object_index * const index, const char * const name, const cJSON_bool case_sensitive)
+{
+    size_t position = hash_key((const unsigned char*)name) & (index->size - 1);
+    cJSON *current_element = NULL;
+
+    while ((current_element = index->slot[position]) != NULL)
+    {
+        if (case_sensitive ? (strcmp(name, current_element->string) == 0) : (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) == 0))
+        {
+            return current_element;
+        }
+        position = (position + 1) & (index->size - 1);
+    }
+
+    return NULL;
+}
+
 static cJSON *get_object_item(const cJSON * const object, const char * const name, const cJSON_bool case_sensitive)
 {
     cJSON *current_element = NULL;
@@ -1778,6 +2039,11 @@ static cJSON *get_object_item(const cJSON * const object, const char * const nam
         return NULL;
     }
 
+    if (object->index != NULL)
+    {
+        return get_indexed_item((const object_index*)object->index, name, case_sensitive);
+    }
+
     current_element = object->child;
     if (case_sensitive)
     {
@@ -1812,6 +2078,23 @@ CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *st
     return cJSON_GetObjectItem(object, string) ? 1 : 0;
 }
 
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexObject(cJSON * const object)
+{
+    /* the reference shares the children with the original one, which drops only its own index when changed */
+    if (!cJSON_IsObject(object) || (object->type & cJSON_IsReference) || (CJSON_INDEX_THRESHOLD <= 0))
+    {
+        return false;
+    }
+    if (object->index != NULL)
+    {
+        return true;
+    }
+
+    object->index = build_object_index(object);
+
+    return (object->index != NULL);
+}
+
 /* Utility for array list handling. */
 static void suffix_object(cJSON *prev, cJSON *item)
 {
@@ -1836,6 +2119,7 @@ static cJSON *create_reference(const cJSON *item, const internal_hooks * const h
 
     (void) memcpy(reference, item, sizeof(cJSON));
     reference->string = NULL;
+    reference->index = NULL;
     reference->type |= cJSON_IsReference;
     reference->next = reference->prev = NULL;
     return reference;
@@ -1850,6 +2134,7 @@ static cJSON_bool add_item_to_array(cJSON *array, cJSON *item)
         return false;
     }
 
+    drop_object_index(array);
     child = array->child;
 
     if (child == NULL)
@@ -1892,6 +2177,7 @@ static void* cast_away_const(const void* string)
 #endif
 
 
+
 static cJSON_bool add_item_to_object(cJSON * const object, const char * const string, cJSON * const item, const internal_hooks * const hooks, const cJSON_bool constant_key)
 {
     char *new_key = NULL;
@@ -2075,6 +2361,8 @@ CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const it
         return NULL;
     }
 
+    drop_object_index(parent);
+
     if (item->prev != NULL)
     {
         /* not the first element */
@@ -2154,6 +2442,7 @@ CJSON_PUBLIC(void) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newit
         return;
     }
 
+    drop_object_index(array);
     newitem->next = after_inserted;
     newitem->prev = after_inserted->prev;
     after_inserted->prev = newitem;
@@ -2179,6 +2468,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON
         return true;
     }
 
+    drop_object_index(parent);
     replacement->next = item->next;
     replacement->prev = item->prev;
 
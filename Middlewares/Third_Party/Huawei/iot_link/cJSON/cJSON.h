@@ -120,6 +120,9 @@ typedef struct cJSON
 
     /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
     char *string;
+
+    /* The hash index of an object's children, built by the parser or cJSON_IndexObject and dropped when the object is changed. Internal, never touch it. */
+    void *index;
 } cJSON;
 
 typedef struct cJSON_Hooks
@@ -137,6 +140,13 @@ typedef int cJSON_bool;
 #define CJSON_NESTING_LIMIT 10
 #endif
 
+/* A parsed object with this many children or more gets a hash index of its children, so the lookups in the object
+ * take constant time. The index is dropped by any change made through the
+ * cJSON functions, so don't change the child chain of an object directly while looking it up. 0 disables the index. */
+#ifndef CJSON_INDEX_THRESHOLD
+#define CJSON_INDEX_THRESHOLD 8
+#endif
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
@@ -170,6 +180,9 @@ CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string);
+/* Build the hash index of the object's children, so the lookups in it take constant time. The parser does it for
+ * the objects with CJSON_INDEX_THRESHOLD children or more; call it for the big objects built by hand. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexObject(cJSON * const object);
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void);
 
@@ -46,6 +46,10 @@
 #define cn_driv_status_initialized     (1<<0)
 #define cn_driv_status_opend           (1<<1)
 
+#ifndef CONFIG_DRIVER_DEVPOOLSIZE
+#define CONFIG_DRIVER_DEVPOOLSIZE      4      //how many device open control block in each pool segment
+#endif
+
 
 //define the error type has happened in the driver
 typedef enum
@@ -72,11 +76,24 @@ struct driv_cb
     size_t            opencounter;            //reference counter
     unsigned int      errno;                  //the last errno has happend
 };
+//here we define the data structure which used by the driv application apis
+struct dev_cb
+{
+    void *nxt;            //used by the open lst
+    void *driv;           //which attached dri here
+    int openflag;       //here means the open state here
+    unsigned int offset;
+    //the following for the debug
+    unsigned int readbytes;
+    unsigned int writebytes;
+};
+
 typedef struct
 {
     osal_mutex_t                    lock;      //used to lock the devlst
     struct driv_cb                 *drivlst;   //all the dev will be added to the list
     unsigned int                    drivnum;
+    void                           *devpool;   //the device open control block pool
 }los_driv_module;
 static  los_driv_module   s_los_driv_module ;  //manage all the driver here
 
@@ -268,6 +285,14 @@ bool_t  los_driv_init()
         goto EXIT_MUTEX;
     }
 
+    s_los_driv_module.devpool = osal_pool_create("dev_cb",sizeof(struct dev_cb),CONFIG_DRIVER_DEVPOOLSIZE,1);
+    if(NULL == s_los_driv_module.devpool)
+    {
+        (void) osal_mutex_del(s_los_driv_module.lock);
+        ret = false;
+        goto EXIT_MUTEX;
+    }
+
     //load all the static device init
     osdriv_load_static();
 
@@ -275,18 +300,6 @@ EXIT_MUTEX:
     return ret;
 }
 
-//here we define the data structure which used by the driv application apis
-struct dev_cb
-{
-    void *nxt;            //used by the open lst
-    void *driv;           //which attached dri here
-    int openflag;       //here means the open state here
-    unsigned int offset;
-    //the following for the debug
-    unsigned int readbytes;
-    unsigned int writebytes;
-};
-
 /*******************************************************************************
 function     :open the device with the specified name
 parameters   :
@@ -302,7 +315,7 @@ los_dev_t  los_dev_open  (const char *name,unsigned int flag)
         goto EXIT_PARAERR;
     }
 
-    dev = osal_malloc(sizeof(struct dev_cb));
+    dev = osal_pool_alloc(s_los_driv_module.devpool);
     if (NULL == dev)
     {
         goto EXIT_MEMERR;
@@ -366,7 +379,7 @@ EXIT_EXCLERR:
 EXIT_DRIVERR:
     (void) osal_mutex_unlock(s_los_driv_module.lock);
 EXIT_MUTEXERR:
-    osal_free(dev);
+    osal_pool_free(s_los_driv_module.devpool,dev);
     dev = NULL;
 EXIT_MEMERR:
 EXIT_PARAERR:
@@ -435,7 +448,7 @@ bool_t  los_dev_close  (los_dev_t dev)
         driv->drivstatus &= (~cn_driv_status_initialized);
     }
 
-    osal_free(dev);
+    osal_pool_free(s_los_driv_module.devpool,dev);
     driv->opencounter--;
 
     (void) osal_mutex_unlock(s_los_driv_module.lock);
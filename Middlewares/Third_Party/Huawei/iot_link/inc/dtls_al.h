@@ -107,15 +107,25 @@ typedef struct
     dtls_al_security_t  security;
 }dtls_al_para_t;
 
+/** @brief the piece of the data written by dtls_al_writev */
+typedef struct
+{
+    const uint8_t  *base;
+    size_t          len;
+}dtls_al_iovec_t;
+
 en_dtls_al_err_t  dtls_al_new(dtls_al_para_t *para,void **handle);
 int   dtls_al_connect(void *handle,const char *ip, const char *port, int timeout );
 int   dtls_al_write(void *handle, uint8_t *msg, size_t len, int timeout );
+///< write the pieces as one stream without copying them together, the tls without the writev writes them one by one
+int   dtls_al_writev(void *handle, const dtls_al_iovec_t *iov, int iovcnt, int timeout );
 int   dtls_al_read(void *handle,uint8_t *buf, size_t len,int timeout );
 en_dtls_al_err_t   dtls_al_destroy(void *handle);
 
 typedef en_dtls_al_err_t (*fn_dtls_al_new)(dtls_al_para_t *para,void **handle);
 typedef int (*fn_dtls_al_connect)(void *handle,const char *server_ip, const char *server_port,int timeout);
 typedef int (*fn_dtls_al_write)(void *handle,uint8_t *msg, size_t len, int timeout);
+typedef int (*fn_dtls_al_writev)(void *handle,const dtls_al_iovec_t *iov, int iovcnt, int timeout);
 typedef int (*fn_dtls_al_read)(void *handle, uint8_t *buf, size_t len, int timeout);
 typedef en_dtls_al_err_t (*fn_dtls_al_destroy)(void *handle);
 
@@ -124,6 +134,7 @@ typedef struct
     fn_dtls_al_new            io_new;
     fn_dtls_al_connect        io_connect;
     fn_dtls_al_write          io_write;
+    fn_dtls_al_writev         io_writev;   ///< could be NULL
     fn_dtls_al_read           io_read;
     fn_dtls_al_destroy        io_destroy;
 }dtls_al_io_t;
@@ -117,10 +117,37 @@ typedef enum
 {
     en_mqtt_al_version_3_1_0 = 0,
     en_mqtt_al_version_3_1_1,
+    en_mqtt_al_version_5,       ///< only the topic alias, payload format and content type are used
 }en_mqtt_al_verison;
 
 
 
+/** @brief  defines for the message will be passed to the application dealer*/
+typedef struct
+{
+    mqtt_al_string_t       topic; ///< message topic
+    mqtt_al_string_t       msg;   ///< the topic message payload
+    en_mqtt_al_qos_t       qos;   ///< message qos
+    int                    dup;   ///< message dup times
+    int                    retain;///< retain or not
+    int                    offset;///< where the msg is in the whole payload, 0 except for the chunk dealer
+    int                    total; ///< the whole payload length, equals to msg.len except for the chunk dealer
+    char                   payloadformat;///< mqtt 5 only:1 utf-8 payload while 0 unspecified
+    mqtt_al_string_t       contenttype;  ///< mqtt 5 only:the content type, len 0 if none
+}mqtt_al_msgrcv_t;
+
+/** @brief  defines the mqtt received message dealer, called by mqtt engine*/
+typedef void (*fn_mqtt_al_msg_dealer)(void *arg,mqtt_al_msgrcv_t *msg);
+
+/** @brief  defines the payload reader of the streamed publish: copy at most len bytes of the
+ *          payload from offset to buf, return the copied length while <= 0 failed */
+typedef int (*fn_mqtt_al_pub_reader)(void *arg,uint8_t *buf,int len,int offset);
+
+/** @brief  defines the done of the publish without waiting: ret 0 acked(sent for qos0) while -1 aborted */
+typedef void (*fn_mqtt_al_pub_done)(void *arg,int ret);
+
+struct mqtt_al_pubpara;
+
 /** @brief defines the paramter for the mqtt connect */
 typedef struct
 {
@@ -136,32 +163,39 @@ typedef struct
     unsigned short                 keepalivetime;///< keep alive time
     char                           conret;       ///< mqtt connect code, return by server
     int                            timeout;      ///< how much time will be blocked
+    fn_mqtt_al_msg_dealer          chunk_dealer; ///< the message larger than the receive buffer comes by chunks, NULL
+                                                 ///< closes the connection without the ack, so it comes again
+    void                          *chunk_arg;    ///< used for the chunk dealer
+    char                           sessionpresent;///< 1 the server kept the session while 0 not, return by server
+    struct mqtt_al_pubpara        *resume;       ///< the unacked qos1/2 publishes of the last session, only used
+                                                 ///< without the clean session: they are taken by the window with
+                                                 ///< their ids and resent after the connack; on success the ids used
+                                                 ///< are written back, new ones when the session is not present and
+                                                 ///< 0 for the ones already done; the engine keeps none over the
+                                                 ///< disconnect, the unacked ones are aborted to be resumed here
+    int                            resume_num;   ///< how many publishes in the resume
 }mqtt_al_conpara_t;
 
 /** @brief defines for the mqtt publish */
-typedef struct
+typedef struct mqtt_al_pubpara
 {
     mqtt_al_string_t    topic;    ///< selected publish topic
     mqtt_al_string_t    msg;      ///< message to be published
     en_mqtt_al_qos_t    qos;      ///< message qos
     int                 retain;   ///< message retain :1 retain while 0 not
     int                 timeout;  ///< how much time will blocked
+    fn_mqtt_al_pub_reader reader; ///< if not NULL, msg.len is the payload length and the payload comes from it
+    void               *reader_arg;///< used for the reader
+    fn_mqtt_al_pub_done done;     ///< if not NULL and no reader, return without waiting for the ack, and the done is
+                                  ///< called by the mqtt engine only if 0 returned; the engine without the window
+                                  ///< calls it before return
+    void               *done_arg; ///< used for the done
+    unsigned short      id;       ///< the packet id of the qos1/2 publish taken by the window, return by the engine
+    char                payloadformat;///< mqtt 5 only:1 utf-8 payload while 0 unspecified
+    mqtt_al_string_t    contenttype;  ///< mqtt 5 only:the content type, len 0 sends none
 }mqtt_al_pubpara_t;
 
 
-/** @brief  defines for the message will be passed to the application dealer*/
-typedef struct
-{
-    mqtt_al_string_t       topic; ///< message topic
-    mqtt_al_string_t       msg;   ///< the topic message payload
-    en_mqtt_al_qos_t       qos;   ///< message qos
-    int                    dup;   ///< message dup times
-    int                    retain;///< retain or not
-}mqtt_al_msgrcv_t;
-
-/** @brief  defines the mqtt received message dealer, called by mqtt engine*/
-typedef void (*fn_mqtt_al_msg_dealer)(void *arg,mqtt_al_msgrcv_t *msg);
-
 /** @brief defines the mqtt subscribe parameter*/
 typedef struct
 {
@@ -171,6 +205,7 @@ typedef struct
     void                  *arg;       ///< used for the message dealer
     char                   subret;    ///< subscribe result code
     int                    timeout;   ///< how much time will be blocked
+    int                    local;     ///< 1 only install the dealer, for the server kept it in the session
 }mqtt_al_subpara_t;
 
 /** @brief defines the mqtt unsubscribe parameter*/
@@ -227,6 +262,8 @@ typedef struct
     int    (* unsubscribe) (void *handle, mqtt_al_unsubpara_t *unsubpara);
     ///< check the mqtt engine status
     en_mqtt_al_connect_state (* check_status) (void *handle);
+    ///< the idle seconds allowed before a ping now, could be NULL
+    int    (* keepalive)   (void *handle);
 
 }mqtt_al_op_t;
 
@@ -315,6 +352,16 @@ int mqtt_al_unsubscribe(void *handle, mqtt_al_unsubpara_t *unsubpara);
  */
 en_mqtt_al_connect_state mqtt_al_check_status(void *handle);
 
+/**
+ *  @brief the idle time allowed before a ping now, which may be searched by the mqtt engine
+ *         shorter than the keepalive to keep the path(nat) alive
+ *
+ *  @param[in]  handle the handle we get from mqtt_al_connect
+ *
+ *  @return the seconds while -1 not supported by the mqtt engine
+ */
+int mqtt_al_keepalive(void *handle);
+
 //////////////////////API USED FOR THE MQTT IMPLEMENT/////////////////////////
 
 /**
@@ -47,6 +47,21 @@ int sal_recvfrom(int sockfd, void *mem, size_t len, int flags,
 
 int sal_send(int sockfd,const void *buf,size_t len,int flags);
 
+/** @brief the piece of the data sent by sal_sendv, the same layout as the struct iovec */
+typedef struct
+{
+    const void *base;
+    size_t      len;
+}sal_iovec_t;
+
+/**
+ * @brief: send the pieces as one stream without copying them together, the tcpip stack without
+ *         the sendv sends them one by one
+ *
+ * @return: the sent length of all the pieces, which may be less than the whole, while -1 failed
+ * */
+int sal_sendv(int sockfd,const sal_iovec_t *iov,int iovcnt,int flags);
+
 int sal_sendto(int sockfd, const void *dataptr, size_t size, int flags,
     const struct sockaddr *to, socklen_t tolen);
 
@@ -58,8 +73,21 @@ int sal_closesocket(int sockfd);
 int sal_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout);
 #endif
 
+/**
+ * @brief: resolve the host name; the resolved address is kept for CONFIG_SAL_DNS_CACHE_TTL seconds,
+ *         so the reconnect does not query the dns server again
+ *
+ * @return: the host entry which is only valid until the next call, NULL if failed
+ * */
 struct hostent * sal_gethostbyname(const char *name);
 
+/**
+ * @brief: forget the address kept for the host, for example when it could not be connected
+ *
+ * @param[in] name: the host name, NULL forgets all the hosts
+ * */
+void sal_dns_flush(const char *name);
+
 
 /**
  * @brief: if you want to use the tcpip abstract layer,like install the tcpip stack,
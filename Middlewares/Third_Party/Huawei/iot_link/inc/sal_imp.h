@@ -45,6 +45,8 @@ typedef int (*fn_sal_send)(int sock,const void *buf,int len,int flags);
 typedef int (*fn_sal_sendto)(int sock, const void *dataptr, int size, int flags,
                              const void *to, int tolen);
 
+typedef int (*fn_sal_sendv)(int sock,const void *iov,int iovcnt,int flags);  ///< iov is the struct iovec array
+
 typedef int (*fn_sal_shutdown)(int sock, int how);
 
 typedef int (*fn_sal_closesocket)(int sock);
@@ -68,6 +70,7 @@ typedef struct
     fn_sal_getsockopt       getsockopt;
     fn_sal_send             send;
     fn_sal_sendto           sendto;
+    fn_sal_sendv            sendv;    ///< could be NULL
     fn_sal_recv             recv;
     fn_sal_recvfrom         recvfrom;
     fn_sal_shutdown         shutdown;
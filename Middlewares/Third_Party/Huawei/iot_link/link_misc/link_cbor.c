@@ -0,0 +1,683 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 10:20   The first version
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+
+#include <link_cbor.h>
+
+///< store the value in the network byte order
+static void cbor_put_be(uint8_t *buf, uint64_t value, int len)
+{
+    while(len > 0)
+    {
+        buf[--len] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static uint64_t cbor_get_be(const uint8_t *buf, int len)
+{
+    uint64_t value = 0;
+    int i;
+
+    for(i = 0; i < len; i++)
+    {
+        value = (value << 8) | buf[i];
+    }
+
+    return value;
+}
+
+int cbor_encode_head(uint8_t *buf, int major, uint64_t arg)
+{
+    int len;
+
+    major <<= 5;
+    if(arg < 24)
+    {
+        buf[0] = (uint8_t)(major | (int)arg);
+        return 1;
+    }
+
+    if(arg <= 0xff)
+    {
+        buf[0] = (uint8_t)(major | 24);
+        len = 1;
+    }
+    else if(arg <= 0xffff)
+    {
+        buf[0] = (uint8_t)(major | 25);
+        len = 2;
+    }
+    else if(arg <= 0xffffffffull)
+    {
+        buf[0] = (uint8_t)(major | 26);
+        len = 4;
+    }
+    else
+    {
+        buf[0] = (uint8_t)(major | 27);
+        len = 8;
+    }
+    cbor_put_be(buf + 1, arg, len);
+
+    return len + 1;
+}
+
+int cbor_encode_float(uint8_t *buf, double value)
+{
+    union
+    {
+        float    f;
+        uint32_t u;
+    }single;
+
+    single.f = (float)value;
+    if((double)single.f == value)
+    {
+        buf[0] = 0xfa;
+        cbor_put_be(buf + 1, single.u, 4);
+        return 5;
+    }
+
+    return cbor_encode_double(buf, value);
+}
+
+int cbor_encode_double(uint8_t *buf, double value)
+{
+    union
+    {
+        double   d;
+        uint64_t u;
+    }twice;
+
+    twice.d = value;
+    buf[0] = 0xfb;
+    cbor_put_be(buf + 1, twice.u, 8);
+
+    return 9;
+}
+
+///< the IEEE 754 half precision, which the encoder never uses but the others may
+static double cbor_half(unsigned int half)
+{
+    unsigned int exp = (half >> 10) & 0x1f;
+    unsigned int mant = half & 0x3ff;
+    double value;
+
+    if(exp == 0)
+    {
+        value = ldexp((double)mant, -24);
+    }
+    else if(exp != 31)
+    {
+        value = ldexp((double)(mant + 1024), (int)exp - 25);
+    }
+    else
+    {
+        value = (mant == 0) ? HUGE_VAL : NAN;
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+///< decode the head, the argument is the length or the value; indef set for the indefinite length
+static const uint8_t *cbor_head(const uint8_t *p, const uint8_t *end, int *major, uint64_t *arg, int *indef)
+{
+    int info;
+    int len;
+
+    if(p >= end)
+    {
+        return NULL;
+    }
+
+    *major = *p >> 5;
+    info = *p & 0x1f;
+    p++;
+    *indef = 0;
+    *arg = 0;
+
+    if(info < 24)
+    {
+        *arg = (uint64_t)info;
+        return p;
+    }
+    if(info == 31)
+    {
+        ///< the break is taken by the caller, the indefinite int and tag are bad
+        if((*major == CN_CBOR_MAJOR_UINT) || (*major == CN_CBOR_MAJOR_NINT) || \
+           (*major == CN_CBOR_MAJOR_TAG) || (*major == CN_CBOR_MAJOR_SIMPLE))
+        {
+            return NULL;
+        }
+        *indef = 1;
+        return p;
+    }
+    if(info > 27)
+    {
+        return NULL;
+    }
+
+    len = 1 << (info - 24);
+    if(end - p < len)
+    {
+        return NULL;
+    }
+    *arg = cbor_get_be(p, len);
+
+    return p + len;
+}
+
+///< skip one data item with all its nested items, and check the structure by the way
+static const uint8_t *cbor_skip(const uint8_t *p, const uint8_t *end)
+{
+    long     stack[CN_CBOR_DEPTH];
+    int      depth = 0;
+    long     left = 1;      ///< the items left at the current level, -1 for indefinite
+    int      major;
+    int      indef;
+    uint64_t arg;
+
+    for(;;)
+    {
+        if(left == 0)
+        {
+            if(depth == 0)
+            {
+                return p;
+            }
+            left = stack[--depth];
+            continue;
+        }
+
+        if(p >= end)
+        {
+            return NULL;
+        }
+        if(*p == CN_CBOR_BREAK)
+        {
+            if(left != -1)
+            {
+                return NULL;
+            }
+            p++;
+            left = 0;
+            continue;
+        }
+
+        p = cbor_head(p, end, &major, &arg, &indef);
+        if(NULL == p)
+        {
+            return NULL;
+        }
+        if(left > 0)
+        {
+            left--;
+        }
+
+        switch(major)
+        {
+            case CN_CBOR_MAJOR_BYTES:
+            case CN_CBOR_MAJOR_TEXT:
+                if(indef || (arg > (uint64_t)(end - p)))
+                {
+                    return NULL;
+                }
+                p += arg;
+                break;
+            case CN_CBOR_MAJOR_ARRAY:
+            case CN_CBOR_MAJOR_MAP:
+                ///< every item takes one byte at least, which also bounds the count
+                if((depth >= CN_CBOR_DEPTH) || (!indef && (arg > (uint64_t)(end - p))))
+                {
+                    return NULL;
+                }
+                stack[depth++] = left;
+                left = indef ? -1 : (long)arg * ((major == CN_CBOR_MAJOR_MAP) ? 2 : 1);
+                break;
+            case CN_CBOR_MAJOR_TAG:
+                if(left >= 0)
+                {
+                    left++;     ///< the tagged item follows
+                }
+                break;
+            default:
+                break;          ///< the int and the simple value are done with the head
+        }
+    }
+}
+
+///< scan one data item, the value fields filled; return where the next item starts
+static const uint8_t *cbor_scan(const uint8_t *p, const uint8_t *end, cbor_value_t *value)
+{
+    const uint8_t *next;
+    int            major;
+    int            indef;
+    uint64_t       arg;
+    union
+    {
+        uint32_t   u;
+        float      f;
+    }single;
+    union
+    {
+        uint64_t   u;
+        double     d;
+    }twice;
+
+    ///< the tags are skipped, the tagged item is taken as it is
+    while((p < end) && ((*p >> 5) == CN_CBOR_MAJOR_TAG))
+    {
+        p = cbor_head(p, end, &major, &arg, &indef);
+        if(NULL == p)
+        {
+            return NULL;
+        }
+    }
+
+    next = cbor_skip(p, end);
+    if(NULL == next)
+    {
+        return NULL;
+    }
+
+    (void) memset(value, 0, sizeof(cbor_value_t));
+    value->data = p;
+    value->len = (int)(next - p);
+    value->content = cbor_head(p, end, &major, &arg, &indef);
+
+    switch(major)
+    {
+        case CN_CBOR_MAJOR_UINT:
+            value->type = EN_CBOR_TYPE_INT;
+            value->integer = (arg > (uint64_t)INT64_MAX) ? INT64_MAX : (int64_t)arg;
+            break;
+        case CN_CBOR_MAJOR_NINT:
+            value->type = EN_CBOR_TYPE_INT;
+            value->integer = (arg > (uint64_t)INT64_MAX) ? INT64_MIN : (-1 - (int64_t)arg);
+            break;
+        case CN_CBOR_MAJOR_BYTES:
+        case CN_CBOR_MAJOR_TEXT:
+            value->type = (major == CN_CBOR_MAJOR_TEXT) ? EN_CBOR_TYPE_TEXT : EN_CBOR_TYPE_BYTES;
+            value->count = (int)arg;
+            break;
+        case CN_CBOR_MAJOR_ARRAY:
+        case CN_CBOR_MAJOR_MAP:
+            value->type = (major == CN_CBOR_MAJOR_MAP) ? EN_CBOR_TYPE_MAP : EN_CBOR_TYPE_ARRAY;
+            value->count = indef ? -1 : (int)arg;
+            break;
+        default:
+            value->content = NULL;
+            switch(*p & 0x1f)
+            {
+                case 20:
+                case 21:
+                    value->type = EN_CBOR_TYPE_BOOL;
+                    value->integer = (*p & 0x1f) - 20;
+                    break;
+                case 25:
+                    value->type = EN_CBOR_TYPE_FLOAT;
+                    value->number = cbor_half((unsigned int)arg);
+                    break;
+                case 26:
+                    value->type = EN_CBOR_TYPE_FLOAT;
+                    single.u = (uint32_t)arg;
+                    value->number = single.f;
+                    break;
+                case 27:
+                    value->type = EN_CBOR_TYPE_FLOAT;
+                    twice.u = arg;
+                    value->number = twice.d;
+                    break;
+                default:
+                    value->type = EN_CBOR_TYPE_NULL;
+                    break;
+            }
+            break;
+    }
+
+    return next;
+}
+
+int cbor_iter_init(cbor_iter_t *iter, const cbor_value_t *container)
+{
+    if((NULL == iter) || (NULL == container) || \
+       ((container->type != EN_CBOR_TYPE_ARRAY) && (container->type != EN_CBOR_TYPE_MAP)))
+    {
+        return -1;
+    }
+
+    iter->cur = container->content;
+    iter->end = container->data + container->len;
+    iter->left = container->count;
+    iter->map = (container->type == EN_CBOR_TYPE_MAP) ? 1 : 0;
+
+    return 0;
+}
+
+int cbor_iter_next(cbor_iter_t *iter, cbor_value_t *key, cbor_value_t *value)
+{
+    const uint8_t *p;
+    cbor_value_t   member;
+
+    if((NULL == iter) || (NULL == value) || (0 == iter->left) || (iter->cur >= iter->end) || \
+       (*iter->cur == CN_CBOR_BREAK))
+    {
+        return -1;
+    }
+
+    p = iter->cur;
+    if(iter->map)
+    {
+        p = cbor_scan(p, iter->end, &member);
+        if(NULL == p)
+        {
+            iter->left = 0;
+            return -1;
+        }
+        if(NULL != key)
+        {
+            *key = member;
+        }
+    }
+    else if(NULL != key)
+    {
+        (void) memset(key, 0, sizeof(cbor_value_t));
+    }
+
+    p = cbor_scan(p, iter->end, value);
+    if(NULL == p)
+    {
+        iter->left = 0;
+        return -1;
+    }
+    iter->cur = p;
+    if(iter->left > 0)
+    {
+        iter->left--;
+    }
+
+    return 0;
+}
+
+int cbor_get(const uint8_t *cbor, int len, const char *path, cbor_value_t *value)
+{
+    cbor_iter_t  iter;
+    cbor_value_t key;
+    cbor_value_t cur;
+    const char  *seg;
+    int          seglen;
+    long         index;
+    char        *num;
+
+    if((NULL == cbor) || (len <= 0) || (NULL == value))
+    {
+        return -1;
+    }
+
+    if(NULL == cbor_scan(cbor, cbor + len, &cur))
+    {
+        return -1;
+    }
+
+    while((NULL != path) && (*path != '\0'))
+    {
+        if(0 != cbor_iter_init(&iter, &cur))
+        {
+            return -1;
+        }
+
+        if(*path == '[')
+        {
+            index = strtol(path + 1, &num, 10);
+            if((cur.type != EN_CBOR_TYPE_ARRAY) || (num == path + 1) || (*num != ']') || (index < 0))
+            {
+                return -1;
+            }
+            path = num + 1;
+            do
+            {
+                if(0 != cbor_iter_next(&iter, NULL, &cur))
+                {
+                    return -1;
+                }
+            }while(index-- > 0);
+        }
+        else
+        {
+            seg = path;
+            while((*path != '\0') && (*path != '.') && (*path != '['))
+            {
+                path++;
+            }
+            seglen = (int)(path - seg);
+            if(cur.type != EN_CBOR_TYPE_MAP)
+            {
+                return -1;
+            }
+            do
+            {
+                if(0 != cbor_iter_next(&iter, &key, &cur))
+                {
+                    return -1;
+                }
+            }while(!cbor_value_equal(&key, seg, seglen));
+        }
+
+        if(*path == '.')
+        {
+            path++;
+        }
+    }
+
+    *value = cur;
+
+    return 0;
+}
+
+int cbor_value_string(const cbor_value_t *value, char *buf, int buflen)
+{
+    if((NULL == value) || (value->type != EN_CBOR_TYPE_TEXT))
+    {
+        return -1;
+    }
+
+    if(NULL != buf)
+    {
+        if(value->count >= buflen)
+        {
+            return -1;
+        }
+        (void) memcpy(buf, value->content, value->count);
+        buf[value->count] = '\0';
+    }
+
+    return value->count;
+}
+
+int cbor_value_equal(const cbor_value_t *value, const char *str, int len)
+{
+    if((NULL == value) || (NULL == str) || (value->type != EN_CBOR_TYPE_TEXT) || (value->count != len))
+    {
+        return 0;
+    }
+
+    return (0 == memcmp(value->content, str, len)) ? 1 : 0;
+}
+
+int cbor_value_int(const cbor_value_t *value, long *number)
+{
+    double d;
+
+    if((NULL == value) || (NULL == number))
+    {
+        return -1;
+    }
+
+    if(value->type == EN_CBOR_TYPE_INT)
+    {
+        *number = (value->integer > LONG_MAX) ? LONG_MAX : \
+                  ((value->integer < LONG_MIN) ? LONG_MIN : (long)value->integer);
+        return 0;
+    }
+    if((value->type != EN_CBOR_TYPE_FLOAT) || (value->number != value->number))
+    {
+        return -1;
+    }
+
+    d = value->number;
+    *number = (d >= (double)LONG_MAX) ? LONG_MAX : ((d <= (double)LONG_MIN) ? LONG_MIN : (long)d);
+
+    return 0;
+}
+
+int cbor_value_double(const cbor_value_t *value, double *number)
+{
+    if((NULL == value) || (NULL == number))
+    {
+        return -1;
+    }
+
+    if(value->type == EN_CBOR_TYPE_INT)
+    {
+        *number = (double)value->integer;
+    }
+    else if(value->type == EN_CBOR_TYPE_FLOAT)
+    {
+        *number = value->number;
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+///< write the scalar, or begin the container
+static int cbor_write_json(json_writer_t *writer, const cbor_value_t *value)
+{
+    switch(value->type)
+    {
+        case EN_CBOR_TYPE_INT:
+            if((value->integer >= LONG_MIN) && (value->integer <= LONG_MAX))
+            {
+                return json_writer_int(writer, (long)value->integer);
+            }
+            return json_writer_double(writer, (double)value->integer);
+        case EN_CBOR_TYPE_TEXT:
+            return json_writer_string_len(writer, (const char *)value->content, value->count);
+        case EN_CBOR_TYPE_ARRAY:
+            return json_writer_begin_array(writer);
+        case EN_CBOR_TYPE_MAP:
+            return json_writer_begin_object(writer);
+        case EN_CBOR_TYPE_BOOL:
+            return json_writer_bool(writer, (int)value->integer);
+        case EN_CBOR_TYPE_NULL:
+            return json_writer_null(writer);
+        case EN_CBOR_TYPE_FLOAT:
+            ///< the half and single precision are written in the fewest digits of the float, as the writer did
+            if((value->data[0] == 0xf9) || (value->data[0] == 0xfa))
+            {
+                return json_writer_float(writer, (float)value->number);
+            }
+            return json_writer_double(writer, value->number);
+        default:
+            writer->err = -1;   ///< the byte string has no json form
+            return -1;
+    }
+}
+
+int cbor_to_json(const uint8_t *cbor, int len, json_writer_t *writer)
+{
+    cbor_iter_t  stack[CN_CBOR_DEPTH];
+    int          depth = 0;
+    cbor_value_t key;
+    cbor_value_t value;
+
+    if((NULL == cbor) || (len <= 0) || (NULL == writer) || (NULL == cbor_scan(cbor, cbor + len, &value)))
+    {
+        return -1;
+    }
+
+    for(;;)
+    {
+        if(0 != cbor_write_json(writer, &value))
+        {
+            return -1;
+        }
+        if((value.type == EN_CBOR_TYPE_ARRAY) || (value.type == EN_CBOR_TYPE_MAP))
+        {
+            ///< the depth has been checked by the scan
+            (void) cbor_iter_init(&stack[depth++], &value);
+        }
+
+        ///< the next item, close the containers finished
+        while(depth > 0)
+        {
+            if(0 == cbor_iter_next(&stack[depth - 1], &key, &value))
+            {
+                break;
+            }
+            depth--;
+            if(0 != (stack[depth].map ? json_writer_end_object(writer) : json_writer_end_array(writer)))
+            {
+                return -1;
+            }
+        }
+        if(depth == 0)
+        {
+            return 0;
+        }
+
+        if(stack[depth - 1].map && \
+           ((key.type != EN_CBOR_TYPE_TEXT) || \
+            (0 != json_writer_key_len(writer, (const char *)key.content, key.count))))
+        {
+            writer->err = -1;
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 10:20   The first version
+ *
+ */
+#ifndef LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_CBOR_H_
+#define LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_CBOR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <link_json.h>
+
+/**
+ * CBOR(RFC 7049) is the binary form of the json data model; the json writer encodes it when
+ * json_writer_set_cbor is called, so the same writing code produces both; here are the head
+ * encoders used by the writer, and the reader which pulls the values from the CBOR data in
+ * place the same way as json_get does
+ *
+ * */
+
+#define CN_CBOR_MAJOR_UINT      0
+#define CN_CBOR_MAJOR_NINT      1
+#define CN_CBOR_MAJOR_BYTES     2
+#define CN_CBOR_MAJOR_TEXT      3
+#define CN_CBOR_MAJOR_ARRAY     4
+#define CN_CBOR_MAJOR_MAP       5
+#define CN_CBOR_MAJOR_TAG       6
+#define CN_CBOR_MAJOR_SIMPLE    7
+
+#define CN_CBOR_FALSE           0xf4
+#define CN_CBOR_TRUE            0xf5
+#define CN_CBOR_NULL            0xf6
+#define CN_CBOR_ARRAY_INDEF     0x9f
+#define CN_CBOR_MAP_INDEF       0xbf
+#define CN_CBOR_BREAK           0xff
+
+#define CN_CBOR_HEAD_MAX        9    ///< the longest head, also the longest float
+#define CN_CBOR_DEPTH           32   ///< the max nesting depth the reader supports
+
+/**
+ * @brief:use this function to encode the head of the data item
+ *
+ * @param[in]:buf, where to store the head, CN_CBOR_HEAD_MAX bytes at least
+ * @param[in]:major, the major type, CN_CBOR_MAJOR_XXX
+ * @param[in]:arg, the argument, such as the int value, the string length or the items count
+ *
+ * @return:the head length
+ *
+ * */
+int cbor_encode_head(uint8_t *buf, int major, uint64_t arg);
+
+///< encode the float in the single precision if it is lossless, otherwise the double precision; return the length
+int cbor_encode_float(uint8_t *buf, double value);
+int cbor_encode_double(uint8_t *buf, double value);   ///< always the double precision
+
+typedef enum
+{
+    EN_CBOR_TYPE_NONE = 0,
+    EN_CBOR_TYPE_INT,          ///< the unsigned and negative integer
+    EN_CBOR_TYPE_BYTES,
+    EN_CBOR_TYPE_TEXT,
+    EN_CBOR_TYPE_ARRAY,
+    EN_CBOR_TYPE_MAP,
+    EN_CBOR_TYPE_BOOL,
+    EN_CBOR_TYPE_NULL,         ///< the null, the undefined and the other simple values
+    EN_CBOR_TYPE_FLOAT,        ///< the half, single and double precision
+}en_cbor_type_t;
+
+typedef struct
+{
+    const uint8_t  *data;      ///< the data item, the tags skipped
+    int             len;       ///< the data item length
+    en_cbor_type_t  type;      ///< the data item type
+    const uint8_t  *content;   ///< the string bytes, or the first item of the container
+    int             count;     ///< the string length, the array items or the map pairs, -1 for indefinite
+    int64_t         integer;   ///< the int value, and 1 or 0 for the bool
+    double          number;    ///< the float value
+}cbor_value_t;
+
+typedef struct
+{
+    const uint8_t  *cur;       ///< where the next item starts
+    const uint8_t  *end;       ///< the end of the container
+    int             left;      ///< how many items left, -1 for indefinite
+    int             map;       ///< 1 for the map which gets the key and value pairs
+}cbor_iter_t;
+
+/**
+ * @brief:use this function to find the value by the path, the same path as json_get
+ *
+ * @param[in]:cbor, the CBOR data
+ * @param[in]:len, the CBOR data length
+ * @param[in]:path, such as "services[0].properties.temp", NULL or "" means the root value;
+ *            the map key must be the text string
+ * @param[out]:value, the value found
+ *
+ * @return:0 success while -1 not found or the data is bad
+ *
+ * @note: the indefinite length string is not supported
+ * */
+int cbor_get(const uint8_t *cbor, int len, const char *path, cbor_value_t *value);
+
+///< walk the items of the map or the array one by one, 0 success while -1 no more items
+int cbor_iter_init(cbor_iter_t *iter, const cbor_value_t *container);
+int cbor_iter_next(cbor_iter_t *iter, cbor_value_t *key, cbor_value_t *value);
+
+///< copy the text string to the buffer ending with '\0', return the length while -1 failed
+int cbor_value_string(const cbor_value_t *value, char *buf, int buflen);
+
+///< compare the text string with the str of len bytes, 1 equal while 0 not
+int cbor_value_equal(const cbor_value_t *value, const char *str, int len);
+
+///< get the number from the int or the float, the int is truncated and saturated; 0 success while -1 failed
+int cbor_value_int(const cbor_value_t *value, long *number);
+int cbor_value_double(const cbor_value_t *value, double *number);
+
+/**
+ * @brief:use this function to translate the CBOR data to the json text, such as for the log
+ *
+ * @param[in]:cbor, the CBOR data
+ * @param[in]:len, the CBOR data length
+ * @param[in]:writer, the json writer, which should be in the json text mode
+ *
+ * @return:0 success while -1 failed, such as the byte string or the none text key which json has not
+ *
+ * */
+int cbor_to_json(const uint8_t *cbor, int len, json_writer_t *writer);
+
+#endif /* LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_CBOR_H_ */
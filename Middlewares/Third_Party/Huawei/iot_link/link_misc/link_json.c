@@ -0,0 +1,1295 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 10:20   The first version
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+
+#include <link_json.h>
+#include <link_cbor.h>
+
+
+///< write the data to the buffer or the sink, only count it when measuring
+static void json_put(json_writer_t *writer, const char *data, int len)
+{
+    int cpy;
+    int room;
+
+    writer->total += len;
+    if((0 != writer->err) || (len <= 0))
+    {
+        return;
+    }
+
+    if(NULL == writer->buf)
+    {
+        if((NULL != writer->sink) && (0 != writer->sink(writer->arg, data, len)))
+        {
+            writer->err = -1;
+        }
+        return;
+    }
+
+    while(len > 0)
+    {
+        ///< keep one byte for the '\0' when there is no sink
+        room = writer->buflen - writer->len - ((NULL == writer->sink) ? 1 : 0);
+        if(room <= 0)
+        {
+            if((NULL == writer->sink) || (0 != writer->sink(writer->arg, writer->buf, writer->len)))
+            {
+                writer->err = -1;
+                return;
+            }
+            writer->len = 0;
+            continue;
+        }
+
+        cpy = len > room ? room : len;
+        (void) memcpy(writer->buf + writer->len, data, cpy);
+        writer->len += cpy;
+        data += cpy;
+        len -= cpy;
+    }
+
+    return;
+}
+
+///< write the comma before the item if needed, and mark the level
+static int json_item_begin(json_writer_t *writer)
+{
+    uint32_t bit;
+
+    if(0 != writer->err)
+    {
+        return -1;
+    }
+
+    if(writer->member)
+    {
+        writer->member = 0;     ///< the comma has been written with the key
+        return 0;
+    }
+
+    if(writer->cbor)
+    {
+        return 0;               ///< the CBOR items need no separator
+    }
+
+    if(writer->depth > 0)
+    {
+        bit = 1u << (writer->depth - 1);
+        if(writer->comma & bit)
+        {
+            json_put(writer, ",", 1);
+        }
+        writer->comma |= bit;
+    }
+
+    return writer->err;
+}
+
+///< write the CBOR head of the major type and the argument
+static void json_put_cbor(json_writer_t *writer, int major, uint64_t arg)
+{
+    uint8_t head[CN_CBOR_HEAD_MAX];
+
+    json_put(writer, (const char *)head, cbor_encode_head(head, major, arg));
+}
+
+static int json_begin(json_writer_t *writer, const char *ch, uint8_t cbor)
+{
+    if((NULL == writer) || (0 != json_item_begin(writer)))
+    {
+        return -1;
+    }
+
+    if(writer->depth >= CN_JSON_WRITER_DEPTH)
+    {
+        writer->err = -1;
+        return -1;
+    }
+
+    json_put(writer, writer->cbor ? (const char *)&cbor : ch, 1);
+    writer->depth++;
+    writer->comma &= ~(1u << (writer->depth - 1));
+
+    return writer->err;
+}
+
+static int json_end(json_writer_t *writer, const char *ch)
+{
+    uint8_t cbor = CN_CBOR_BREAK;
+
+    if((NULL == writer) || (0 != writer->err))
+    {
+        return -1;
+    }
+
+    if((0 == writer->depth) || writer->member)
+    {
+        writer->err = -1;
+        return -1;
+    }
+
+    writer->depth--;
+    json_put(writer, writer->cbor ? (const char *)&cbor : ch, 1);
+
+    return writer->err;
+}
+
+///< write the string with the quotation marks and the escape sequences, or the CBOR text string
+static void json_put_string(json_writer_t *writer, const char *value, int len)
+{
+    const unsigned char *run;
+    const unsigned char *ch;
+    const unsigned char *end;
+    char esc[8];
+
+    if(writer->cbor)
+    {
+        json_put_cbor(writer, CN_CBOR_MAJOR_TEXT, (uint64_t)len);
+        json_put(writer, value, len);
+        return;
+    }
+
+    json_put(writer, "\"", 1);
+
+    run = (const unsigned char *)value;
+    end = run + len;
+    for(ch = run; ch < end; ch++)
+    {
+        if((*ch >= 32) && (*ch != '\"') && (*ch != '\\'))
+        {
+            continue;
+        }
+
+        json_put(writer, (const char *)run, (int)(ch - run));
+        run = ch + 1;
+
+        esc[0] = '\\';
+        switch(*ch)
+        {
+            case '\"':
+                esc[1] = '\"';
+                break;
+            case '\\':
+                esc[1] = '\\';
+                break;
+            case '\b':
+                esc[1] = 'b';
+                break;
+            case '\f':
+                esc[1] = 'f';
+                break;
+            case '\n':
+                esc[1] = 'n';
+                break;
+            case '\r':
+                esc[1] = 'r';
+                break;
+            case '\t':
+                esc[1] = 't';
+                break;
+            default:
+                (void) snprintf(esc + 1, sizeof(esc) - 1, "u%04x", *ch);
+                json_put(writer, esc, 6);
+                continue;
+        }
+        json_put(writer, esc, 2);
+    }
+    json_put(writer, (const char *)run, (int)(ch - run));
+
+    json_put(writer, "\"", 1);
+}
+
+int json_writer_init(json_writer_t *writer, char *buf, int buflen, fn_json_sink sink, void *arg)
+{
+    if((NULL == writer) || ((NULL != buf) && (buflen <= 0)))
+    {
+        return -1;
+    }
+
+    (void) memset(writer, 0, sizeof(json_writer_t));
+    writer->buf = buf;
+    writer->buflen = (NULL == buf) ? 0 : buflen;
+    writer->sink = sink;
+    writer->arg = arg;
+
+    return 0;
+}
+
+int json_writer_begin_object(json_writer_t *writer)
+{
+    return json_begin(writer, "{", CN_CBOR_MAP_INDEF);
+}
+
+int json_writer_end_object(json_writer_t *writer)
+{
+    return json_end(writer, "}");
+}
+
+int json_writer_begin_array(json_writer_t *writer)
+{
+    return json_begin(writer, "[", CN_CBOR_ARRAY_INDEF);
+}
+
+int json_writer_end_array(json_writer_t *writer)
+{
+    return json_end(writer, "]");
+}
+
+int json_writer_set_cbor(json_writer_t *writer)
+{
+    if((NULL == writer) || (0 != writer->total))
+    {
+        return -1;
+    }
+    writer->cbor = 1;
+
+    return 0;
+}
+
+int json_writer_key(json_writer_t *writer, const char *key)
+{
+    return json_writer_key_len(writer, key, (NULL == key) ? 0 : (int)strlen(key));
+}
+
+int json_writer_key_len(json_writer_t *writer, const char *key, int len)
+{
+    if((NULL == writer) || (NULL == key) || (len < 0) || (writer->member) || (0 == writer->depth))
+    {
+        if(NULL != writer)
+        {
+            writer->err = -1;
+        }
+        return -1;
+    }
+
+    if(0 != json_item_begin(writer))
+    {
+        return -1;
+    }
+    json_put_string(writer, key, len);
+    if(!writer->cbor)
+    {
+        json_put(writer, ":", 1);
+    }
+    writer->member = 1;
+
+    return writer->err;
+}
+
+int json_writer_string(json_writer_t *writer, const char *value)
+{
+    return json_writer_string_len(writer, value, (NULL == value) ? 0 : (int)strlen(value));
+}
+
+int json_writer_string_len(json_writer_t *writer, const char *value, int len)
+{
+    if((NULL == writer) || (NULL == value) || (len < 0))
+    {
+        if(NULL != writer)
+        {
+            writer->err = -1;
+        }
+        return -1;
+    }
+
+    if(0 != json_item_begin(writer))
+    {
+        return -1;
+    }
+    json_put_string(writer, value, len);
+
+    return writer->err;
+}
+
+int json_writer_int(json_writer_t *writer, long value)
+{
+    char buf[24];
+    char *ch = buf + sizeof(buf);
+    unsigned long uvalue;
+
+    if((NULL == writer) || (0 != json_item_begin(writer)))
+    {
+        return -1;
+    }
+
+    if(writer->cbor)
+    {
+        ///< the negative int is encoded as -1 - n
+        json_put_cbor(writer, (value < 0) ? CN_CBOR_MAJOR_NINT : CN_CBOR_MAJOR_UINT, \
+                      (value < 0) ? (uint64_t)(-(value + 1)) : (uint64_t)value);
+        return writer->err;
+    }
+
+    uvalue = value < 0 ? (0ul - (unsigned long)value) : (unsigned long)value;
+    do
+    {
+        *--ch = (char)('0' + (uvalue % 10));
+        uvalue /= 10;
+    }while(uvalue != 0);
+
+    if(value < 0)
+    {
+        *--ch = '-';
+    }
+    json_put(writer, ch, (int)(buf + sizeof(buf) - ch));
+
+    return writer->err;
+}
+
+///< the powers of ten which are exact in double
+static const double s_json_exact_pow10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+///< the number in the fixed notation, the fewest decimals which recover the number are found by the exact division,
+///< the single one is checked against the float; two parts for the digits to avoid the 64 bits integer
+static int __number_format(double value, int single, char *buf)
+{
+    static const double zero = 0;
+    char          digits[16];
+    double        magnitude;
+    double        rounded = 0;
+    unsigned long high;
+    unsigned long low;
+    int           decimals;
+    int           count = 0;
+    int           len = 0;
+
+    if(value == 0)
+    {
+        if(0 != memcmp(&value, &zero, sizeof(value)))
+        {
+            return 0;  ///< "-0" is left to snprintf
+        }
+        buf[len++] = '0';
+        buf[len] = '\0';
+        return len;
+    }
+
+    magnitude = (value < 0) ? -value : value;
+    if((magnitude < 1e-4) || (magnitude >= 1e15))
+    {
+        return 0;  ///< "%1.15g" uses the exponent out of this range
+    }
+
+    for(decimals = 0; ; decimals++)
+    {
+        rounded = floor(magnitude * s_json_exact_pow10[decimals] + 0.5);
+        if(rounded >= 1e15)
+        {
+            return 0;
+        }
+        if(single ? ((float)(rounded / s_json_exact_pow10[decimals]) == (float)magnitude) : \
+                    ((rounded / s_json_exact_pow10[decimals]) == magnitude))
+        {
+            break;
+        }
+    }
+
+    high = (unsigned long)(rounded / 1e8);
+    low = (unsigned long)(rounded - (double)high * 1e8);
+    do
+    {
+        digits[count++] = (char)('0' + (low % 10));
+        low /= 10;
+    }while((low != 0) || ((high != 0) && (count < 8)));
+    for(; high != 0; high /= 10)
+    {
+        digits[count++] = (char)('0' + (high % 10));
+    }
+
+    if(value < 0)
+    {
+        buf[len++] = '-';
+    }
+    if(count > decimals)
+    {
+        for(; count > decimals; count--)
+        {
+            buf[len++] = digits[count - 1];
+        }
+    }
+    else if(decimals - count > 3)
+    {
+        return 0;
+    }
+    else
+    {
+        buf[len++] = '0';
+    }
+
+    if(decimals > 0)
+    {
+        buf[len++] = '.';
+        for(; decimals > count; decimals--)
+        {
+            buf[len++] = '0';
+        }
+        for(; count > 0; count--)
+        {
+            buf[len++] = digits[count - 1];
+        }
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+
+int json_number_format(double value, char *buf)
+{
+    return __number_format(value, 0, buf);
+}
+
+int json_number_format_float(float value, char *buf)
+{
+    return __number_format((double)value, 1, buf);
+}
+
+///< the fewest digits recovering the float, return the length
+static int json_float_text(float value, char *buf, int buflen)
+{
+    int len;
+    int prec;
+    double test;
+
+    if(0 == (len = json_number_format_float(value, buf)))
+    {
+        ///< 9 significant digits recover any float
+        for(prec = 1; prec <= 9; prec++)
+        {
+            len = snprintf(buf, buflen, "%1.*g", prec, (double)value);
+            if((sscanf(buf, "%lg", &test) == 1) && ((float)test == value))
+            {
+                break;
+            }
+        }
+    }
+
+    return len;
+}
+
+///< single means the value is a float, which is written in the fewest digits recovering the float
+static int json_writer_number(json_writer_t *writer, double value, int single)
+{
+    char buf[26];
+    int len;
+    double test;
+    uint8_t cbor[CN_CBOR_HEAD_MAX];
+
+    ///< the integer is the most case, which needs no printf; the range fits the 32 bits long, "-0" excluded
+    if((value > -2147483648.0) && (value < 2147483648.0) && (value == (double)(long)value) && \
+       ((value != 0) || !signbit(value)))
+    {
+        return json_writer_int(writer, (long)value);
+    }
+
+    if((NULL == writer) || (0 != json_item_begin(writer)))
+    {
+        return -1;
+    }
+
+    if(writer->cbor)
+    {
+        ///< the int has been taken above, so the same number is the float in both; null for NaN and Infinity
+        if((value * 0) != 0)
+        {
+            cbor[0] = CN_CBOR_NULL;
+            len = 1;
+        }
+        else
+        {
+            len = cbor_encode_float(cbor, value);
+            ///< the single precision is read back as the float text, so the double takes it only when that
+            ///< text recovers the double, then cbor_to_json gives the same text as the json mode does
+            if((len < CN_CBOR_HEAD_MAX) && (!single) && \
+               ((json_float_text((float)value, buf, sizeof(buf)) <= 0) || (strtod(buf, NULL) != value)))
+            {
+                len = cbor_encode_double(cbor, value);
+            }
+        }
+        json_put(writer, (const char *)cbor, len);
+        return writer->err;
+    }
+
+    ///< the same format as cJSON, NaN and Infinity are not allowed in json
+    if((value * 0) != 0)
+    {
+        len = snprintf(buf, sizeof(buf), "null");
+    }
+    else if(single)
+    {
+        len = json_float_text((float)value, buf, sizeof(buf));
+    }
+    else if(0 == (len = json_number_format(value, buf)))
+    {
+        len = snprintf(buf, sizeof(buf), "%1.15g", value);
+        if((sscanf(buf, "%lg", &test) != 1) || (test != value))
+        {
+            len = snprintf(buf, sizeof(buf), "%1.17g", value);
+        }
+    }
+
+    if((len < 0) || (len >= (int)sizeof(buf)))
+    {
+        writer->err = -1;
+        return -1;
+    }
+    json_put(writer, buf, len);
+
+    return writer->err;
+}
+
+int json_writer_double(json_writer_t *writer, double value)
+{
+    return json_writer_number(writer, value, 0);
+}
+
+int json_writer_float(json_writer_t *writer, float value)
+{
+    return json_writer_number(writer, (double)value, 1);
+}
+
+int json_writer_bool(json_writer_t *writer, int value)
+{
+    if((NULL == writer) || (0 != json_item_begin(writer)))
+    {
+        return -1;
+    }
+    if(writer->cbor)
+    {
+        json_put(writer, value ? "\xf5" : "\xf4", 1);
+        return writer->err;
+    }
+    json_put(writer, value ? "true" : "false", value ? 4 : 5);
+
+    return writer->err;
+}
+
+int json_writer_null(json_writer_t *writer)
+{
+    if((NULL == writer) || (0 != json_item_begin(writer)))
+    {
+        return -1;
+    }
+    json_put(writer, writer->cbor ? "\xf6" : "null", writer->cbor ? 1 : 4);
+
+    return writer->err;
+}
+
+int json_writer_raw(json_writer_t *writer, const char *raw, int len)
+{
+    if((NULL == writer) || (NULL == raw) || (0 != json_item_begin(writer)))
+    {
+        if(NULL != writer)
+        {
+            writer->err = -1;
+        }
+        return -1;
+    }
+    json_put(writer, raw, len);
+
+    return writer->err;
+}
+
+int json_writer_end(json_writer_t *writer)
+{
+    if((NULL == writer) || (0 != writer->err))
+    {
+        return -1;
+    }
+
+    if((0 != writer->depth) || writer->member)
+    {
+        writer->err = -1;
+        return -1;
+    }
+
+    if(NULL != writer->buf)
+    {
+        if(NULL == writer->sink)
+        {
+            writer->buf[writer->len] = '\0';
+        }
+        else if(writer->len > 0)
+        {
+            if(0 != writer->sink(writer->arg, writer->buf, writer->len))
+            {
+                writer->err = -1;
+                return -1;
+            }
+            writer->len = 0;
+        }
+    }
+
+    return writer->total;
+}
+
+
+static const char *json_skip_space(const char *p, const char *end)
+{
+    while((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n')))
+    {
+        p++;
+    }
+    return p;
+}
+
+///< p points to the opening quotation mark, return the position after the closing one
+static const char *json_skip_string(const char *p, const char *end)
+{
+    for(p++; p < end; p++)
+    {
+        if(*p == '\"')
+        {
+            return p + 1;
+        }
+        if(*p == '\\')
+        {
+            p++;
+        }
+    }
+    return NULL;
+}
+
+///< p points to the first char of the value, return the position after the value
+static const char *json_scan_value(const char *p, const char *end, json_value_t *value)
+{
+    const char *start = p;
+    int depth = 0;
+
+    if(p >= end)
+    {
+        return NULL;
+    }
+
+    switch(*p)
+    {
+        case '\"':
+            p = json_skip_string(p, end);
+            if(NULL == p)
+            {
+                return NULL;
+            }
+            value->type = EN_JSON_TYPE_STRING;
+            value->data = start + 1;
+            value->len = (int)(p - start) - 2;
+            return p;
+        case '{':
+        case '[':
+            value->type = (*p == '{') ? EN_JSON_TYPE_OBJECT : EN_JSON_TYPE_ARRAY;
+            while(p < end)
+            {
+                if(*p == '\"')
+                {
+                    p = json_skip_string(p, end);
+                    if(NULL == p)
+                    {
+                        return NULL;
+                    }
+                    continue;
+                }
+                if((*p == '{') || (*p == '['))
+                {
+                    depth++;
+                }
+                else if(((*p == '}') || (*p == ']')) && (--depth == 0))
+                {
+                    value->data = start;
+                    value->len = (int)(p - start) + 1;
+                    return p + 1;
+                }
+                p++;
+            }
+            return NULL;
+        case 't':
+        case 'f':
+            value->type = EN_JSON_TYPE_BOOL;
+            break;
+        case 'n':
+            value->type = EN_JSON_TYPE_NULL;
+            break;
+        default:
+            if((*p != '-') && ((*p < '0') || (*p > '9')))
+            {
+                return NULL;
+            }
+            value->type = EN_JSON_TYPE_NUMBER;
+            break;
+    }
+
+    while((p < end) && (*p != ',') && (*p != '}') && (*p != ']') && \
+          (*p != ' ') && (*p != '\t') && (*p != '\r') && (*p != '\n'))
+    {
+        p++;
+    }
+    value->data = start;
+    value->len = (int)(p - start);
+
+    if(((value->type == EN_JSON_TYPE_BOOL) && !(((value->len == 4) && (0 == memcmp(start, "true", 4))) || \
+        ((value->len == 5) && (0 == memcmp(start, "false", 5))))) || \
+       ((value->type == EN_JSON_TYPE_NULL) && !((value->len == 4) && (0 == memcmp(start, "null", 4)))))
+    {
+        return NULL;
+    }
+
+    return p;
+}
+
+int json_iter_init(json_iter_t *iter, const json_value_t *container)
+{
+    if((NULL == iter) || (NULL == container) || \
+       ((container->type != EN_JSON_TYPE_OBJECT) && (container->type != EN_JSON_TYPE_ARRAY)))
+    {
+        return -1;
+    }
+
+    iter->cur = container->data + 1;
+    iter->end = container->data + container->len;
+    iter->close = (container->type == EN_JSON_TYPE_OBJECT) ? '}' : ']';
+    iter->count = 0;
+
+    return 0;
+}
+
+int json_iter_next(json_iter_t *iter, json_value_t *key, json_value_t *value)
+{
+    const char *p;
+    json_value_t member;
+
+    if((NULL == iter) || (NULL == value))
+    {
+        return -1;
+    }
+
+    p = json_skip_space(iter->cur, iter->end);
+    if((p >= iter->end) || (*p == iter->close))
+    {
+        iter->cur = iter->end;
+        return -1;
+    }
+
+    if(iter->count > 0)
+    {
+        if(*p != ',')
+        {
+            iter->cur = iter->end;
+            return -1;
+        }
+        p = json_skip_space(p + 1, iter->end);
+    }
+
+    if(iter->close == '}')
+    {
+        if((p >= iter->end) || (*p != '\"'))
+        {
+            iter->cur = iter->end;
+            return -1;
+        }
+        p = json_scan_value(p, iter->end, &member);
+        p = (NULL == p) ? NULL : json_skip_space(p, iter->end);
+        if((NULL == p) || (p >= iter->end) || (*p != ':'))
+        {
+            iter->cur = iter->end;
+            return -1;
+        }
+        p = json_skip_space(p + 1, iter->end);
+        if(NULL != key)
+        {
+            *key = member;
+        }
+    }
+    else if(NULL != key)
+    {
+        key->type = EN_JSON_TYPE_NONE;
+        key->data = NULL;
+        key->len = 0;
+    }
+
+    p = json_scan_value(p, iter->end, value);
+    if(NULL == p)
+    {
+        iter->cur = iter->end;
+        return -1;
+    }
+    iter->cur = p;
+    iter->count++;
+
+    return 0;
+}
+
+int json_get(const char *json, int len, const char *path, json_value_t *value)
+{
+    json_iter_t  iter;
+    json_value_t key;
+    json_value_t cur;
+    const char  *seg;
+    int          seglen;
+    long         index;
+    char        *num;
+
+    if((NULL == json) || (len <= 0) || (NULL == value))
+    {
+        return -1;
+    }
+
+    if(NULL == json_scan_value(json_skip_space(json, json + len), json + len, &cur))
+    {
+        return -1;
+    }
+
+    while((NULL != path) && (*path != '\0'))
+    {
+        if(0 != json_iter_init(&iter, &cur))
+        {
+            return -1;
+        }
+
+        if(*path == '[')
+        {
+            index = strtol(path + 1, &num, 10);
+            if((cur.type != EN_JSON_TYPE_ARRAY) || (num == path + 1) || (*num != ']') || (index < 0))
+            {
+                return -1;
+            }
+            path = num + 1;
+            do
+            {
+                if(0 != json_iter_next(&iter, NULL, &cur))
+                {
+                    return -1;
+                }
+            }while(index-- > 0);
+        }
+        else
+        {
+            seg = path;
+            while((*path != '\0') && (*path != '.') && (*path != '['))
+            {
+                path++;
+            }
+            seglen = (int)(path - seg);
+            if(cur.type != EN_JSON_TYPE_OBJECT)
+            {
+                return -1;
+            }
+            do
+            {
+                if(0 != json_iter_next(&iter, &key, &cur))
+                {
+                    return -1;
+                }
+            }while(!json_value_equal(&key, seg, seglen));
+        }
+
+        if(*path == '.')
+        {
+            path++;
+        }
+    }
+
+    *value = cur;
+
+    return 0;
+}
+
+static int json_hex4(const char *p, const char *end, unsigned long *code)
+{
+    int i;
+
+    *code = 0;
+    if(end - p < 4)
+    {
+        return -1;
+    }
+    for(i = 0; i < 4; i++)
+    {
+        *code <<= 4;
+        if((p[i] >= '0') && (p[i] <= '9'))
+        {
+            *code |= (unsigned long)(p[i] - '0');
+        }
+        else if((p[i] >= 'a') && (p[i] <= 'f'))
+        {
+            *code |= (unsigned long)(p[i] - 'a' + 10);
+        }
+        else if((p[i] >= 'A') && (p[i] <= 'F'))
+        {
+            *code |= (unsigned long)(p[i] - 'A' + 10);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+///< decode one char of the string text to utf8, return how many text bytes used while -1 failed
+static int json_string_char(const char *p, const char *end, char *out, int *outlen)
+{
+    unsigned long code;
+    unsigned long low;
+    int used;
+
+    if(*p != '\\')
+    {
+        out[0] = *p;
+        *outlen = 1;
+        return 1;
+    }
+
+    if(end - p < 2)
+    {
+        return -1;
+    }
+
+    *outlen = 1;
+    switch(p[1])
+    {
+        case '\"':
+        case '\\':
+        case '/':
+            out[0] = p[1];
+            return 2;
+        case 'b':
+            out[0] = '\b';
+            return 2;
+        case 'f':
+            out[0] = '\f';
+            return 2;
+        case 'n':
+            out[0] = '\n';
+            return 2;
+        case 'r':
+            out[0] = '\r';
+            return 2;
+        case 't':
+            out[0] = '\t';
+            return 2;
+        case 'u':
+            break;
+        default:
+            return -1;
+    }
+
+    if(0 != json_hex4(p + 2, end, &code))
+    {
+        return -1;
+    }
+    used = 6;
+
+    if((code >= 0xDC00) && (code <= 0xDFFF))
+    {
+        return -1;
+    }
+    if((code >= 0xD800) && (code <= 0xDBFF))
+    {
+        if((end - p < 12) || (p[6] != '\\') || (p[7] != 'u') || (0 != json_hex4(p + 8, end, &low)) || \
+           (low < 0xDC00) || (low > 0xDFFF))
+        {
+            return -1;
+        }
+        code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+        used = 12;
+    }
+
+    if(code < 0x80)
+    {
+        out[0] = (char)code;
+    }
+    else if(code < 0x800)
+    {
+        out[0] = (char)(0xC0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3F));
+        *outlen = 2;
+    }
+    else if(code < 0x10000)
+    {
+        out[0] = (char)(0xE0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code & 0x3F));
+        *outlen = 3;
+    }
+    else
+    {
+        out[0] = (char)(0xF0 | (code >> 18));
+        out[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (code & 0x3F));
+        *outlen = 4;
+    }
+
+    return used;
+}
+
+int json_value_string(const json_value_t *value, char *buf, int buflen)
+{
+    const char *p;
+    const char *end;
+    char ch[4];
+    int  chlen;
+    int  used;
+    int  len = 0;
+
+    if((NULL == value) || (value->type != EN_JSON_TYPE_STRING) || ((NULL != buf) && (buflen <= 0)))
+    {
+        return -1;
+    }
+
+    end = value->data + value->len;
+    for(p = value->data; p < end; p += used)
+    {
+        used = json_string_char(p, end, ch, &chlen);
+        if(used < 0)
+        {
+            return -1;
+        }
+        if(NULL != buf)
+        {
+            if(len + chlen >= buflen)
+            {
+                return -1;
+            }
+            (void) memcpy(buf + len, ch, chlen);
+        }
+        len += chlen;
+    }
+
+    if(NULL != buf)
+    {
+        buf[len] = '\0';
+    }
+
+    return len;
+}
+
+int json_value_equal(const json_value_t *value, const char *str, int len)
+{
+    const char *p;
+    const char *end;
+    char ch[4];
+    int  chlen;
+    int  used;
+
+    if((NULL == value) || (value->type != EN_JSON_TYPE_STRING) || (NULL == str))
+    {
+        return 0;
+    }
+
+    if(NULL == memchr(value->data, '\\', value->len))
+    {
+        return (value->len == len) && (0 == memcmp(value->data, str, len));
+    }
+
+    end = value->data + value->len;
+    for(p = value->data; p < end; p += used)
+    {
+        used = json_string_char(p, end, ch, &chlen);
+        if((used < 0) || (chlen > len) || (0 != memcmp(ch, str, chlen)))
+        {
+            return 0;
+        }
+        str += chlen;
+        len -= chlen;
+    }
+
+    return (len == 0);
+}
+
+int json_number_parse(const char *text, int len, double *number)
+{
+    const char *start = text;
+    const char *end = text + len;
+    double mantissa = 0;
+    int    digits = 0;
+    int    scale = 0;
+    int    exp = 0;
+    int    expdigits = 0;
+    int    expneg = 0;
+    int    neg = 0;
+
+    if((text < end) && (*text == '-'))
+    {
+        neg = 1;
+        text++;
+    }
+    if((text >= end) || (*text < '0') || (*text > '9'))
+    {
+        return 0;
+    }
+    for(; (text < end) && (*text >= '0') && (*text <= '9'); text++)
+    {
+        mantissa = mantissa * 10 + (*text - '0');
+        digits += (mantissa != 0) ? 1 : 0;
+    }
+
+    if((text < end) && (*text == '.'))
+    {
+        text++;
+        if((text >= end) || (*text < '0') || (*text > '9'))
+        {
+            return 0;
+        }
+        for(; (text < end) && (*text >= '0') && (*text <= '9'); text++)
+        {
+            mantissa = mantissa * 10 + (*text - '0');
+            digits += (mantissa != 0) ? 1 : 0;
+            scale--;
+        }
+    }
+
+    if((text < end) && ((*text == 'e') || (*text == 'E')))
+    {
+        text++;
+        if((text < end) && ((*text == '+') || (*text == '-')))
+        {
+            expneg = (*text == '-');
+            text++;
+        }
+        for(; (text < end) && (*text >= '0') && (*text <= '9'); text++)
+        {
+            exp = exp * 10 + (*text - '0');
+            expdigits++;
+        }
+        if((expdigits == 0) || (expdigits > 3))
+        {
+            return 0;
+        }
+        scale += expneg ? -exp : exp;
+    }
+
+    ///< anything strtod might take further, or beyond the exact range
+    if(((text < end) && (NULL != strchr("0123456789+-eE.", *text))) || \
+       (digits > 15) || (scale < -22) || (scale > 22))
+    {
+        return 0;
+    }
+
+    mantissa = (scale < 0) ? (mantissa / s_json_exact_pow10[-scale]) : (mantissa * s_json_exact_pow10[scale]);
+    *number = neg ? -mantissa : mantissa;
+
+    return (int)(text - start);
+}
+
+int json_value_double(const json_value_t *value, double *number)
+{
+    char  text[32];
+    char *num;
+
+    if((NULL == value) || (value->type != EN_JSON_TYPE_NUMBER) || (NULL == number) || \
+       (value->len >= (int)sizeof(text)))
+    {
+        return -1;
+    }
+
+    if((value->len > 0) && (value->len == json_number_parse(value->data, value->len, number)))
+    {
+        return 0;
+    }
+
+    (void) memcpy(text, value->data, value->len);
+    text[value->len] = '\0';
+    *number = strtod(text, &num);
+
+    return (num == text + value->len) ? 0 : -1;
+}
+
+int json_value_int(const json_value_t *value, long *number)
+{
+    const char *p;
+    const char *end;
+    unsigned long n = 0;
+    double d;
+
+    if((NULL == value) || (value->type != EN_JSON_TYPE_NUMBER) || (NULL == number))
+    {
+        return -1;
+    }
+
+    ///< the plain integer is the most common, parse it directly
+    p = value->data;
+    end = value->data + value->len;
+    if((p < end) && (*p == '-'))
+    {
+        p++;
+    }
+    if((p < end) && (end - p < 10))
+    {
+        while((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            n = n * 10 + (unsigned long)(*p - '0');
+            p++;
+        }
+        if(p == end)
+        {
+            *number = (*value->data == '-') ? -(long)n : (long)n;
+            return 0;
+        }
+    }
+
+    if(0 != json_value_double(value, &d))
+    {
+        return -1;
+    }
+    if(d >= (double)LONG_MAX)
+    {
+        *number = LONG_MAX;
+    }
+    else if(d <= (double)LONG_MIN)
+    {
+        *number = LONG_MIN;
+    }
+    else
+    {
+        *number = (long)d;
+    }
+
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 10:20   The first version
+ *
+ */
+#ifndef LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_JSON_H_
+#define LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_JSON_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * the json writer emits the json text directly while the caller walks its own data, no
+ * tree is built and no memory is allocated:
+ *
+ *   1, buf and no sink: write to the buffer, failed when the buffer is too small
+ *   2, buf and sink: the buffer is used as the cache, flushed to the sink when full
+ *   3, no buf and sink: every piece is passed to the sink directly
+ *   4, no buf and no sink: nothing written, only count the length, used to measure
+ *
+ *  json_writer_begin_object(w);
+ *  json_writer_key(w,"temp");
+ *  json_writer_int(w,25);
+ *  json_writer_end_object(w);
+ *  len = json_writer_end(w);    ///< {"temp":25}
+ *
+ * */
+
+#define CN_JSON_WRITER_DEPTH    32   ///< the max nesting depth
+
+/**
+ * @brief:the sink for the json writer
+ *
+ * @param[in]:arg, the args passed to json_writer_init
+ * @param[in]:data, the json text
+ * @param[in]:len, the json text length
+ *
+ * @return:0 success while -1 failed
+ *
+ * */
+typedef int (*fn_json_sink)(void *arg, const char *data, int len);
+
+typedef struct
+{
+    char          *buf;       ///< the output buffer, or the cache for the sink
+    int            buflen;    ///< the buffer length
+    int            len;       ///< how many bytes in the buffer now
+    int            total;     ///< how many bytes of the json text
+    fn_json_sink   sink;      ///< where the json text flushed to, could be NULL
+    void          *arg;       ///< the args for the sink
+    uint32_t       comma;     ///< bit n set means the level n needs a comma before the next item
+    uint8_t        depth;     ///< the nesting depth now
+    uint8_t        member;    ///< the key has been written, waiting for the value
+    int8_t         err;       ///< -1 when the buffer is too small, the sink failed or bad usage
+    uint8_t        cbor;      ///< 1 when the CBOR is written instead of the json text
+}json_writer_t;
+
+/**
+ * @brief:use this function to initialize the json writer
+ *
+ * @param[in]:writer, the json writer
+ * @param[in]:buf, the output buffer or the cache for the sink, could be NULL
+ * @param[in]:buflen, the buffer length
+ * @param[in]:sink, the sink for the json text, could be NULL
+ * @param[in]:arg, the args for the sink
+ *
+ * @return:0 success while -1 failed
+ *
+ * */
+int json_writer_init(json_writer_t *writer, char *buf, int buflen, fn_json_sink sink, void *arg);
+
+/**
+ * @brief:use this function to make the writer encode the same items in CBOR(RFC 7049),
+ *        call it just after json_writer_init
+ *
+ * @param[in]:writer, the json writer
+ *
+ * @return:0 success while -1 failed
+ *
+ * @note: the map and the array are in the indefinite length, the number is the shortest
+ *        int or the float lossless; the raw is still written as it is, so it must be CBOR;
+ *        the data may contain '\0', use the length returned by json_writer_end
+ * */
+int json_writer_set_cbor(json_writer_t *writer);
+
+///< the structure, the object member must be started with json_writer_key
+int json_writer_begin_object(json_writer_t *writer);
+int json_writer_end_object(json_writer_t *writer);
+int json_writer_begin_array(json_writer_t *writer);
+int json_writer_end_array(json_writer_t *writer);
+int json_writer_key(json_writer_t *writer, const char *key);
+int json_writer_key_len(json_writer_t *writer, const char *key, int len);
+
+///< the values, the string will be escaped while the raw is written as it is
+int json_writer_string(json_writer_t *writer, const char *value);
+int json_writer_string_len(json_writer_t *writer, const char *value, int len);
+int json_writer_int(json_writer_t *writer, long value);
+int json_writer_double(json_writer_t *writer, double value);
+int json_writer_float(json_writer_t *writer, float value);   ///< the fewest digits recovering the float
+int json_writer_bool(json_writer_t *writer, int value);
+int json_writer_null(json_writer_t *writer);
+int json_writer_raw(json_writer_t *writer, const char *raw, int len);
+
+/**
+ * @brief:use this function to finish the json text, flush the cache to the sink and
+ *        terminate the buffer with '\0' when there is no sink
+ *
+ * @param[in]:writer, the json writer
+ *
+ * @return:the json text length while -1 failed
+ *
+ * */
+int json_writer_end(json_writer_t *writer);
+
+/**
+ * the json reader pulls the wanted values from the json text in place, no tree is built,
+ * no memory is allocated and the text needs no '\0' ending; the value found points into
+ * the text, so the text must be kept until the value is used:
+ *
+ *  json_get(msg,msglen,"services[0].paras.url",&url);
+ *  json_value_string(&url,buf,sizeof(buf));
+ *
+ *  the path is the keys separated by '.' with the array index in the brackets, the empty
+ *  path means the root value; the text is checked only as much as needed to skip the values
+ *
+ * */
+typedef enum
+{
+    EN_JSON_TYPE_NONE = 0,
+    EN_JSON_TYPE_NULL,
+    EN_JSON_TYPE_BOOL,
+    EN_JSON_TYPE_NUMBER,
+    EN_JSON_TYPE_STRING,
+    EN_JSON_TYPE_ARRAY,
+    EN_JSON_TYPE_OBJECT,
+}en_json_type_t;
+
+typedef struct
+{
+    const char     *data;   ///< the value text, the string without the quotation marks
+    int             len;    ///< the value text length
+    en_json_type_t  type;   ///< the value type
+}json_value_t;
+
+typedef struct
+{
+    const char     *cur;    ///< where the next item starts
+    const char     *end;    ///< the end of the container text
+    char            close;  ///< '}' for the object while ']' for the array
+    int             count;  ///< how many items have been read
+}json_iter_t;
+
+/**
+ * @brief:use this function to find the value by the path
+ *
+ * @param[in]:json, the json text
+ * @param[in]:len, the json text length
+ * @param[in]:path, such as "services[0].event_type", NULL or "" means the root value
+ * @param[out]:value, the value found
+ *
+ * @return:0 success while -1 not found or the text is bad
+ *
+ * */
+int json_get(const char *json, int len, const char *path, json_value_t *value);
+
+/**
+ * @brief:use this function to walk the items of the object or the array one by one
+ *
+ * @param[in]:iter, the iterator initialized by json_iter_init
+ * @param[out]:key, the member key for the object, could be NULL
+ * @param[out]:value, the member value or the array item
+ *
+ * @return:0 success while -1 no more items or the text is bad
+ *
+ * */
+int json_iter_init(json_iter_t *iter, const json_value_t *container);
+int json_iter_next(json_iter_t *iter, json_value_t *key, json_value_t *value);
+
+/**
+ * @brief:use this function to copy the string value to the buffer without the escapes
+ *
+ * @param[in]:value, the string value
+ * @param[in]:buf, the buffer to store the string ending with '\0', could be NULL to measure
+ * @param[in]:buflen, the buffer length
+ *
+ * @return:the string length while -1 not a string, bad escapes or the buffer too small
+ *
+ * */
+int json_value_string(const json_value_t *value, char *buf, int buflen);
+
+///< compare the string value with the str of len bytes without the escapes, 1 equal while 0 not
+int json_value_equal(const json_value_t *value, const char *str, int len);
+
+///< get the number value, the int is truncated and saturated as cJSON valueint; 0 success while -1 failed
+int json_value_double(const json_value_t *value, double *number);
+int json_value_int(const json_value_t *value, long *number);
+
+/**
+ * the number text without printf and strtod, shared with cJSON; only the plain numbers are taken here, and
+ * the others are left to the caller, which uses printf and strtod instead
+ *
+ * */
+
+/**
+ * @brief:use this function to format the number in the fixed notation as "%1.15g" does
+ *
+ * @param[in]:value, the number
+ * @param[out]:buf, the buffer for the text ending with '\0', 26 bytes at least
+ *
+ * @return:the text length, while 0 means the number is left to printf
+ *
+ * @note: json_number_format_float writes the fewest digits which recover the float instead
+ * */
+int json_number_format(double value, char *buf);
+int json_number_format_float(float value, char *buf);
+
+/**
+ * @brief:use this function to parse the number with no more than 15 significant digits and a power of
+ *        ten up to 22, which is exact in double, so the result is the same as strtod
+ *
+ * @param[in]:text, the number text, needs no '\0' ending
+ * @param[in]:len, the text length
+ * @param[out]:number, the number
+ *
+ * @return:the length parsed, while 0 means the number is left to strtod
+ * */
+int json_number_parse(const char *text, int len, double *number);
+
+#endif /* LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_JSON_H_ */
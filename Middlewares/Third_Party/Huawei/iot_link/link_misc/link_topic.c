@@ -0,0 +1,484 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 14:05   The first version
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <osal.h>
+#include <link_topic.h>
+
+#ifndef CONFIG_TOPIC_TRIE_BUCKETS
+#define CONFIG_TOPIC_TRIE_BUCKETS    16     ///< the initial buckets, must be the power of 2
+#endif
+
+#define CN_TOPIC_LEVEL_MAX           0xFFFF
+
+typedef struct topic_node
+{
+    struct topic_node *parent;
+    struct topic_node *next;       ///< the next node in the same bucket
+    struct topic_node *plus;       ///< the '+' child
+    struct topic_node *hash;       ///< the '#' child
+    void              *handler;
+    void              *arg;
+    uint32_t           key;        ///< the hash of the parent and the level
+    uint16_t           len;        ///< the level length
+    uint16_t           children;   ///< how many children, the wildcard ones included
+    uint8_t            used;       ///< 1 means a filter ends here
+    char               wild;       ///< '+' or '#' for the wildcard node, otherwise 0
+    char              *level;      ///< the level name, follows the node
+}topic_node_t;
+
+typedef struct
+{
+    topic_node_t     root;
+    topic_node_t   **buckets;      ///< all the nodes except the root
+    uint32_t         mask;         ///< the buckets number - 1
+    int              nodes;
+    int              filters;
+}topic_trie_t;
+
+///< the FNV-1a of the level, seeded by the parent
+static uint32_t topic_key(const topic_node_t *parent, const char *level, int len)
+{
+    uint32_t key;
+    int i;
+
+    key = 2166136261u ^ ((uint32_t)((uintptr_t)parent >> 2) * 2654435761u);
+    for(i = 0; i < len; i++)
+    {
+        key ^= (uint8_t)level[i];
+        key *= 16777619u;
+    }
+
+    return key;
+}
+
+static topic_node_t *topic_child_find(topic_trie_t *t, topic_node_t *parent, const char *level, int len)
+{
+    topic_node_t *node;
+    uint32_t key;
+
+    if(0 == parent->children)
+    {
+        return NULL;
+    }
+    key = topic_key(parent, level, len);
+    for(node = t->buckets[key & t->mask]; NULL != node; node = node->next)
+    {
+        if((node->key == key) && (node->parent == parent) && (node->len == len) && \
+           (0 == memcmp(node->level, level, len)))
+        {
+            break;
+        }
+    }
+
+    return node;
+}
+
+///< double the buckets when the chains get long, keep the old ones if no memory
+static void topic_buckets_grow(topic_trie_t *t)
+{
+    topic_node_t **buckets;
+    topic_node_t  *node;
+    uint32_t mask;
+    uint32_t i;
+
+    if(t->nodes <= (int)(2 * (t->mask + 1)))
+    {
+        return;
+    }
+    mask = (t->mask << 1) | 1;
+    buckets = osal_zalloc((mask + 1) * sizeof(topic_node_t *));
+    if(NULL == buckets)
+    {
+        return;
+    }
+    for(i = 0; i <= t->mask; i++)
+    {
+        while(NULL != (node = t->buckets[i]))
+        {
+            t->buckets[i] = node->next;
+            node->next = buckets[node->key & mask];
+            buckets[node->key & mask] = node;
+        }
+    }
+    osal_free(t->buckets);
+    t->buckets = buckets;
+    t->mask = mask;
+
+    return;
+}
+
+static topic_node_t *topic_child_add(topic_trie_t *t, topic_node_t *parent, const char *level, int len)
+{
+    topic_node_t *node;
+
+    node = osal_zalloc(sizeof(topic_node_t) + len + 1);
+    if(NULL == node)
+    {
+        return NULL;
+    }
+    node->parent = parent;
+    node->key = topic_key(parent, level, len);
+    node->len = (uint16_t)len;
+    node->level = (char *)(node + 1);
+    (void) memcpy(node->level, level, len);
+    if((1 == len) && (('+' == level[0]) || ('#' == level[0])))
+    {
+        node->wild = level[0];
+        if('+' == node->wild)
+        {
+            parent->plus = node;
+        }
+        else
+        {
+            parent->hash = node;
+        }
+    }
+    node->next = t->buckets[node->key & t->mask];
+    t->buckets[node->key & t->mask] = node;
+    parent->children++;
+    t->nodes++;
+    topic_buckets_grow(t);
+
+    return node;
+}
+
+///< release the nodes which hold no filter and no children, from the node up to the root
+static void topic_node_prune(topic_trie_t *t, topic_node_t *node)
+{
+    topic_node_t  *parent;
+    topic_node_t **link;
+
+    while((node != &t->root) && (0 == node->used) && (0 == node->children))
+    {
+        parent = node->parent;
+        if('+' == node->wild)
+        {
+            parent->plus = NULL;
+        }
+        else if('#' == node->wild)
+        {
+            parent->hash = NULL;
+        }
+        for(link = &t->buckets[node->key & t->mask]; *link != node; link = &(*link)->next)
+        {
+        }
+        *link = node->next;
+        parent->children--;
+        t->nodes--;
+        osal_free(node);
+        node = parent;
+    }
+
+    return;
+}
+
+///< the wildcard must be the whole level, and '#' must be the last level
+static int topic_filter_check(const char *filter, int len)
+{
+    int i;
+
+    if((NULL == filter) || (len <= 0) || (len > CN_TOPIC_LEVEL_MAX))
+    {
+        return -1;
+    }
+    for(i = 0; i < len; i++)
+    {
+        if(('+' != filter[i]) && ('#' != filter[i]))
+        {
+            continue;
+        }
+        if(((i > 0) && ('/' != filter[i - 1])) || ((i + 1 < len) && ('/' != filter[i + 1])))
+        {
+            return -1;
+        }
+        if(('#' == filter[i]) && (i + 1 != len))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+///< get the node of the filter, create the missed ones if create is set
+static topic_node_t *topic_filter_node(topic_trie_t *t, const char *filter, int len, int create)
+{
+    topic_node_t *node;
+    topic_node_t *child;
+    int off = 0;
+    int end;
+
+    node = &t->root;
+    while(off <= len)
+    {
+        for(end = off; (end < len) && ('/' != filter[end]); end++)
+        {
+        }
+        child = topic_child_find(t, node, filter + off, end - off);
+        if((NULL == child) && create)
+        {
+            child = topic_child_add(t, node, filter + off, end - off);
+            if(NULL == child)
+            {
+                topic_node_prune(t, node);
+            }
+        }
+        if(NULL == child)
+        {
+            return NULL;
+        }
+        node = child;
+        off = end + 1;
+    }
+
+    return node;
+}
+
+void *topic_trie_create(void)
+{
+    topic_trie_t *t;
+
+    t = osal_zalloc(sizeof(topic_trie_t));
+    if(NULL == t)
+    {
+        return NULL;
+    }
+    t->buckets = osal_zalloc(CONFIG_TOPIC_TRIE_BUCKETS * sizeof(topic_node_t *));
+    if(NULL == t->buckets)
+    {
+        osal_free(t);
+        return NULL;
+    }
+    t->mask = CONFIG_TOPIC_TRIE_BUCKETS - 1;
+
+    return t;
+}
+
+int topic_trie_add(void *trie, const char *filter, int len, void *handler, void *arg)
+{
+    topic_trie_t *t = trie;
+    topic_node_t *node;
+
+    if((NULL == t) || (0 != topic_filter_check(filter, len)))
+    {
+        return -1;
+    }
+    node = topic_filter_node(t, filter, len, 1);
+    if(NULL == node)
+    {
+        return -1;
+    }
+    if(0 == node->used)
+    {
+        node->used = 1;
+        t->filters++;
+    }
+    node->handler = handler;
+    node->arg = arg;
+
+    return 0;
+}
+
+int topic_trie_remove(void *trie, const char *filter, int len)
+{
+    topic_trie_t *t = trie;
+    topic_node_t *node;
+
+    if((NULL == t) || (0 != topic_filter_check(filter, len)))
+    {
+        return -1;
+    }
+    node = topic_filter_node(t, filter, len, 0);
+    if((NULL == node) || (0 == node->used))
+    {
+        return -1;
+    }
+    node->used = 0;
+    node->handler = NULL;
+    node->arg = NULL;
+    t->filters--;
+    topic_node_prune(t, node);
+
+    return 0;
+}
+
+int topic_trie_find(void *trie, const char *filter, int len, void **handler, void **arg)
+{
+    topic_trie_t *t = trie;
+    topic_node_t *node;
+
+    if((NULL == t) || (0 != topic_filter_check(filter, len)))
+    {
+        return -1;
+    }
+    node = topic_filter_node(t, filter, len, 0);
+    if((NULL == node) || (0 == node->used))
+    {
+        return -1;
+    }
+    if(NULL != handler)
+    {
+        *handler = node->handler;
+    }
+    if(NULL != arg)
+    {
+        *arg = node->arg;
+    }
+
+    return 0;
+}
+
+static int topic_visit(topic_node_t *node, fn_topic_trie_visit visit, void *ctx)
+{
+    if((NULL == node) || (0 == node->used))
+    {
+        return 0;
+    }
+    if(NULL != visit)
+    {
+        visit(ctx, node->handler, node->arg);
+    }
+
+    return 1;
+}
+
+///< off is where the next level begins, and beyond the len means all the levels matched
+static int topic_match_level(topic_trie_t *t, topic_node_t *node, const char *topic, int len, int off,\
+                             fn_topic_trie_visit visit, void *ctx)
+{
+    topic_node_t *child;
+    int ret = 0;
+    int wild;
+    int end;
+
+    if(off > len)
+    {
+        ret += topic_visit(node, visit, ctx);
+        ret += topic_visit(node->hash, visit, ctx);   ///< "a/#" matches "a" too
+        return ret;
+    }
+    wild = (node != &t->root) || ('$' != topic[0]);
+    if(wild)
+    {
+        ret += topic_visit(node->hash, visit, ctx);
+    }
+    for(end = off; (end < len) && ('/' != topic[end]); end++)
+    {
+    }
+    child = topic_child_find(t, node, topic + off, end - off);
+    if((NULL != child) && (0 == child->wild))
+    {
+        ret += topic_match_level(t, child, topic, len, end + 1, visit, ctx);
+    }
+    if(wild && (NULL != node->plus))
+    {
+        ret += topic_match_level(t, node->plus, topic, len, end + 1, visit, ctx);
+    }
+
+    return ret;
+}
+
+int topic_trie_match(void *trie, const char *topic, int len, fn_topic_trie_visit visit, void *ctx)
+{
+    topic_trie_t *t = trie;
+
+    if((NULL == t) || (NULL == topic) || (len <= 0) || (0 == t->filters))
+    {
+        return 0;
+    }
+
+    return topic_match_level(t, &t->root, topic, len, 0, visit, ctx);
+}
+
+int topic_trie_walk(void *trie, fn_topic_trie_visit visit, void *ctx)
+{
+    topic_trie_t *t = trie;
+    topic_node_t *node;
+    uint32_t i;
+    int ret = 0;
+
+    if(NULL == t)
+    {
+        return 0;
+    }
+    for(i = 0; i <= t->mask; i++)
+    {
+        for(node = t->buckets[i]; NULL != node; node = node->next)
+        {
+            ret += topic_visit(node, visit, ctx);
+        }
+    }
+
+    return ret;
+}
+
+int topic_trie_count(void *trie)
+{
+    topic_trie_t *t = trie;
+
+    return (NULL == t) ? 0 : t->filters;
+}
+
+int topic_trie_delete(void *trie)
+{
+    topic_trie_t *t = trie;
+    topic_node_t *node;
+    uint32_t i;
+
+    if(NULL == t)
+    {
+        return -1;
+    }
+    for(i = 0; i <= t->mask; i++)
+    {
+        while(NULL != (node = t->buckets[i]))
+        {
+            t->buckets[i] = node->next;
+            osal_free(node);
+        }
+    }
+    osal_free(t->buckets);
+    osal_free(t);
+
+    return 0;
+}
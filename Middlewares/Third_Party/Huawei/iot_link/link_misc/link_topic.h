@@ -0,0 +1,109 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 14:05   The first version
+ *
+ */
+#ifndef LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_TOPIC_H_
+#define LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_TOPIC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * the topic trie keeps the mqtt topic filters level by level, and each filter holds a
+ * handler and its arg; the children are found by the hash of the parent and the level,
+ * while the '+' and the '#' children are linked to the parent directly, so matching a
+ * topic costs the topic depth, no matter how many filters there are
+ *
+ * the match follows the mqtt rules: '+' matches exactly one level(could be empty), '#'
+ * matches the parent level and all the levels below, and the topic beginning with '$'
+ * is not matched by the filter beginning with a wildcard
+ *
+ * the trie is not thread safe, the caller should protect it
+ * */
+
+///< the visit called for each filter matched or walked
+typedef void (*fn_topic_trie_visit)(void *ctx, void *handler, void *arg);
+
+/**
+ * @brief:use this function to create the topic trie
+ *
+ * @return:the trie handle, while NULL failed
+ * */
+void *topic_trie_create(void);
+
+/**
+ * @brief:use this function to add the topic filter, the existed one will be replaced
+ *
+ * @param[in]:trie, the trie handle
+ * @param[in]:filter, the topic filter, need not be ended with '\0'
+ * @param[in]:len, the filter length
+ * @param[in]:handler, the handler for the filter
+ * @param[in]:arg, the arg passed to the handler
+ *
+ * @return:0 success while -1 failed(bad filter or no memory)
+ * */
+int topic_trie_add(void *trie, const char *filter, int len, void *handler, void *arg);
+
+///< remove the topic filter, 0 success while -1 not found
+int topic_trie_remove(void *trie, const char *filter, int len);
+
+///< find the topic filter exactly(no wildcard match), 0 success while -1 not found; handler and arg could be NULL
+int topic_trie_find(void *trie, const char *filter, int len, void **handler, void **arg);
+
+/**
+ * @brief:use this function to find all the filters matching the topic
+ *
+ * @param[in]:trie, the trie handle
+ * @param[in]:topic, the topic name, need not be ended with '\0'
+ * @param[in]:len, the topic length
+ * @param[in]:visit, called for each filter matched
+ * @param[in]:ctx, the ctx passed to the visit
+ *
+ * @return:how many filters matched
+ * */
+int topic_trie_match(void *trie, const char *topic, int len, fn_topic_trie_visit visit, void *ctx);
+
+///< visit all the filters in no specified order, return how many filters; don't change the trie in the visit
+int topic_trie_walk(void *trie, fn_topic_trie_visit visit, void *ctx);
+
+///< return how many filters in the trie
+int topic_trie_count(void *trie);
+
+///< delete the trie and all its filters, 0 success while -1 failed
+int topic_trie_delete(void *trie);
+
+#endif /* LITEOS_LAB_IOT_LINK_LINK_MISC_LINK_TOPIC_H_ */
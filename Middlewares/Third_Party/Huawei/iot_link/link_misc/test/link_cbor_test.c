@@ -0,0 +1,387 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 23:40   The first version
+ *
+ */
+
+///< the host check of the CBOR mode: the same writing code emits the json text and the CBOR, then
+///< cbor_to_json must give back the json text byte for byte, and cbor_get and the cbor iterators must
+///< find the same values as json_get and the json iterators do; the exit code is 0 when all passed
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <link_json.h>
+#include <link_cbor.h>
+
+#define CN_TEST_BUF_LEN     4096
+#define CN_TEST_DOCS        2000
+#define CN_TEST_DEPTH       5
+
+static int s_test_fail = 0;
+static uint32_t s_test_seed;
+
+#define TEST_CHECK(cond, ...) \
+    do \
+    { \
+        if(!(cond)) \
+        { \
+            if(s_test_fail++ < 10) \
+            { \
+                fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+                fprintf(stderr, __VA_ARGS__); \
+                fprintf(stderr, "\n"); \
+            } \
+        } \
+    }while(0)
+
+static uint32_t test_rand(void)
+{
+    s_test_seed ^= s_test_seed << 13;
+    s_test_seed ^= s_test_seed >> 17;
+    s_test_seed ^= s_test_seed << 5;
+    return s_test_seed;
+}
+
+///< the property report of the profile, with the values of every type
+static void write_report(json_writer_t *w)
+{
+    (void) json_writer_begin_object(w);
+    (void) json_writer_key(w, "services");
+    (void) json_writer_begin_array(w);
+    (void) json_writer_begin_object(w);
+    (void) json_writer_key(w, "service_id");
+    (void) json_writer_string(w, "Agriculture");
+    (void) json_writer_key(w, "properties");
+    (void) json_writer_begin_object(w);
+    (void) json_writer_key(w, "Temperature");
+    (void) json_writer_float(w, 25.3f);
+    (void) json_writer_key(w, "Humidity");
+    (void) json_writer_double(w, 61.75);
+    (void) json_writer_key(w, "Luminance");
+    (void) json_writer_int(w, 4000000L);
+    (void) json_writer_key(w, "Offset");
+    (void) json_writer_int(w, -24L);
+    (void) json_writer_key(w, "Ratio");
+    (void) json_writer_double(w, 0.1);
+    (void) json_writer_key(w, "LightStatus");
+    (void) json_writer_string(w, "ON \"quoted\"\n\\ \xc3\xa9");
+    (void) json_writer_key(w, "MotorStatus");
+    (void) json_writer_bool(w, 1);
+    (void) json_writer_key(w, "Alarm");
+    (void) json_writer_null(w);
+    (void) json_writer_key(w, "History");
+    (void) json_writer_begin_array(w);
+    (void) json_writer_int(w, 1L);
+    (void) json_writer_float(w, -0.5f);
+    (void) json_writer_string(w, "");
+    (void) json_writer_begin_array(w);
+    (void) json_writer_end_array(w);
+    (void) json_writer_begin_object(w);
+    (void) json_writer_end_object(w);
+    (void) json_writer_end_array(w);
+    (void) json_writer_end_object(w);
+    (void) json_writer_key(w, "event_time");
+    (void) json_writer_string(w, "20261018T234000Z");
+    (void) json_writer_end_object(w);
+    (void) json_writer_end_array(w);
+    (void) json_writer_end_object(w);
+}
+
+static const char *s_test_paths[] =
+{
+    "",
+    "services",
+    "services[0]",
+    "services[0].service_id",
+    "services[0].properties",
+    "services[0].properties.Temperature",
+    "services[0].properties.Humidity",
+    "services[0].properties.Luminance",
+    "services[0].properties.Offset",
+    "services[0].properties.Ratio",
+    "services[0].properties.LightStatus",
+    "services[0].properties.MotorStatus",
+    "services[0].properties.Alarm",
+    "services[0].properties.History",
+    "services[0].properties.History[1]",
+    "services[0].properties.History[2]",
+    "services[0].properties.History[3]",
+    "services[0].properties.History[4]",
+    "services[0].event_time",
+    ///< not there
+    "services[1]",
+    "services[0].properties.History[5]",
+    "services[0].properties.Pressure",
+    "services[0].service_id.name",
+    "services.service_id",
+};
+
+///< a random document, the same seed writes the same calls
+static void write_random(json_writer_t *w, int depth)
+{
+    static const char *keys[] = {"a", "temp", "Status", "\xe6\xb8\xa9\xe5\xba\xa6", "with \"quote\"", "x_1"};
+    static const char *strs[] = {"", "ON", "tab\tand\nnewline", "\x01\x1f control", "\xc3\xa9t\xc3\xa9", "/\\"};
+    int count;
+    int i;
+    uint32_t kind = test_rand() % 10;
+
+    if((depth >= CN_TEST_DEPTH) && (kind >= 8))
+    {
+        kind = test_rand() % 8;
+    }
+
+    switch(kind)
+    {
+        case 0:
+            (void) json_writer_int(w, (long)(test_rand() % 48) - 24);
+            break;
+        case 1:
+            (void) json_writer_int(w, (long)(int32_t)test_rand());
+            break;
+        case 2:
+            (void) json_writer_double(w, (double)(int32_t)test_rand() / 1000.0);
+            break;
+        case 3:
+            (void) json_writer_float(w, (float)((double)(int32_t)test_rand() / 100.0));
+            break;
+        case 4:
+            (void) json_writer_string(w, strs[test_rand() % (sizeof(strs) / sizeof(strs[0]))]);
+            break;
+        case 5:
+            (void) json_writer_bool(w, (int)(test_rand() & 1));
+            break;
+        case 6:
+            (void) json_writer_null(w);
+            break;
+        case 7:
+            (void) json_writer_double(w, (double)(test_rand() % 1000) * 1e-6);
+            break;
+        case 8:
+            count = (int)(test_rand() % 5);
+            (void) json_writer_begin_array(w);
+            for(i = 0; i < count; i++)
+            {
+                write_random(w, depth + 1);
+            }
+            (void) json_writer_end_array(w);
+            break;
+        default:
+            count = (int)(test_rand() % 5);
+            (void) json_writer_begin_object(w);
+            for(i = 0; i < count; i++)
+            {
+                (void) json_writer_key(w, keys[test_rand() % (sizeof(keys) / sizeof(keys[0]))]);
+                write_random(w, depth + 1);
+            }
+            (void) json_writer_end_object(w);
+            break;
+    }
+}
+
+///< encode the same calls in both forms, return 0 when both succeeded
+static int encode_both(void (*fn)(json_writer_t *w, int depth), int depth, uint32_t seed,
+                       char *json, int *jsonlen, uint8_t *cbor, int *cborlen)
+{
+    json_writer_t w;
+
+    s_test_seed = seed;
+    (void) json_writer_init(&w, json, CN_TEST_BUF_LEN, NULL, NULL);
+    fn(&w, depth);
+    *jsonlen = json_writer_end(&w);
+
+    s_test_seed = seed;
+    (void) json_writer_init(&w, (char *)cbor, CN_TEST_BUF_LEN, NULL, NULL);
+    (void) json_writer_set_cbor(&w);
+    fn(&w, depth);
+    *cborlen = json_writer_end(&w);
+
+    return ((*jsonlen > 0) && (*cborlen > 0)) ? 0 : -1;
+}
+
+static void write_report_fn(json_writer_t *w, int depth)
+{
+    (void) depth;
+    write_report(w);
+}
+
+///< cbor_to_json must give back the json text
+static void check_to_json(const char *json, int jsonlen, const uint8_t *cbor, int cborlen)
+{
+    char text[CN_TEST_BUF_LEN];
+    json_writer_t w;
+    int len;
+
+    (void) json_writer_init(&w, text, sizeof(text), NULL, NULL);
+    TEST_CHECK(0 == cbor_to_json(cbor, cborlen, &w), "cbor_to_json failed for %.*s", jsonlen, json);
+    len = json_writer_end(&w);
+    TEST_CHECK((len == jsonlen) && (0 == memcmp(text, json, len)), "cbor_to_json\n  %.*s\nexpected\n  %.*s",
+               len, text, jsonlen, json);
+}
+
+///< the json value and the CBOR value must be the same, and so must be their items
+static void check_value(const json_value_t *jv, const cbor_value_t *cv)
+{
+    char jstr[CN_TEST_BUF_LEN];
+    char cstr[CN_TEST_BUF_LEN];
+    double jnum;
+    double cnum;
+    json_iter_t jiter;
+    cbor_iter_t citer;
+    json_value_t jkey;
+    json_value_t jitem;
+    cbor_value_t ckey;
+    cbor_value_t citem;
+    int jret;
+    int cret;
+
+    switch(jv->type)
+    {
+        case EN_JSON_TYPE_NULL:
+            TEST_CHECK(cv->type == EN_CBOR_TYPE_NULL, "null expected, cbor type %d", cv->type);
+            break;
+        case EN_JSON_TYPE_BOOL:
+            TEST_CHECK((cv->type == EN_CBOR_TYPE_BOOL) && ((jv->data[0] == 't') == (cv->integer != 0)),
+                       "bool %.*s, cbor type %d", jv->len, jv->data, cv->type);
+            break;
+        case EN_JSON_TYPE_NUMBER:
+            TEST_CHECK((0 == json_value_double(jv, &jnum)) && (0 == cbor_value_double(cv, &cnum)) && \
+                       ((jnum == cnum) || ((cv->type == EN_CBOR_TYPE_FLOAT) && ((float)jnum == (float)cnum))),
+                       "number %.*s, cbor type %d %.17g", jv->len, jv->data, cv->type, cv->number);
+            break;
+        case EN_JSON_TYPE_STRING:
+            TEST_CHECK((cv->type == EN_CBOR_TYPE_TEXT) && \
+                       (json_value_string(jv, jstr, sizeof(jstr)) == cbor_value_string(cv, cstr, sizeof(cstr))) && \
+                       (0 == strcmp(jstr, cstr)), "string %.*s, cbor type %d", jv->len, jv->data, cv->type);
+            break;
+        case EN_JSON_TYPE_ARRAY:
+        case EN_JSON_TYPE_OBJECT:
+            if(((jv->type == EN_JSON_TYPE_ARRAY) && (cv->type != EN_CBOR_TYPE_ARRAY)) || \
+               ((jv->type == EN_JSON_TYPE_OBJECT) && (cv->type != EN_CBOR_TYPE_MAP)))
+            {
+                TEST_CHECK(0, "container %.*s, cbor type %d", jv->len, jv->data, cv->type);
+                break;
+            }
+            (void) json_iter_init(&jiter, jv);
+            (void) cbor_iter_init(&citer, cv);
+            for(;;)
+            {
+                jret = json_iter_next(&jiter, &jkey, &jitem);
+                cret = cbor_iter_next(&citer, &ckey, &citem);
+                TEST_CHECK(jret == cret, "items differ in %.*s", jv->len, jv->data);
+                if((jret != 0) || (cret != 0))
+                {
+                    break;
+                }
+                if(jv->type == EN_JSON_TYPE_OBJECT)
+                {
+                    check_value(&jkey, &ckey);
+                }
+                check_value(&jitem, &citem);
+            }
+            break;
+        default:
+            TEST_CHECK(0, "bad json type %d", jv->type);
+            break;
+    }
+}
+
+///< cbor_get must find what json_get finds, and miss what it misses
+static void check_paths(const char *json, int jsonlen, const uint8_t *cbor, int cborlen)
+{
+    json_value_t jv;
+    cbor_value_t cv;
+    int jret;
+    int cret;
+    size_t i;
+
+    for(i = 0; i < sizeof(s_test_paths) / sizeof(s_test_paths[0]); i++)
+    {
+        jret = json_get(json, jsonlen, s_test_paths[i], &jv);
+        cret = cbor_get(cbor, cborlen, s_test_paths[i], &cv);
+        TEST_CHECK(jret == cret, "path \"%s\" json %d cbor %d", s_test_paths[i], jret, cret);
+        if((jret == 0) && (cret == 0))
+        {
+            check_value(&jv, &cv);
+        }
+    }
+}
+
+int main(void)
+{
+    static char    json[CN_TEST_BUF_LEN];
+    static uint8_t cbor[CN_TEST_BUF_LEN];
+    json_value_t   jv;
+    cbor_value_t   cv;
+    int jsonlen;
+    int cborlen;
+    int docs;
+    long jsontotal = 0;
+    long cbortotal = 0;
+
+    TEST_CHECK(0 == encode_both(write_report_fn, 0, 1, json, &jsonlen, cbor, &cborlen), "report encode failed");
+    check_to_json(json, jsonlen, cbor, cborlen);
+    check_paths(json, jsonlen, cbor, cborlen);
+    printf("report: json %d bytes, cbor %d bytes\n", jsonlen, cborlen);
+
+    for(docs = 0; docs < CN_TEST_DOCS; docs++)
+    {
+        if(0 != encode_both(write_random, 0, 0x9e3779b9u + (uint32_t)docs, json, &jsonlen, cbor, &cborlen))
+        {
+            TEST_CHECK(0, "random document %d encode failed", docs);
+            continue;
+        }
+        check_to_json(json, jsonlen, cbor, cborlen);
+        if((0 == json_get(json, jsonlen, "", &jv)) && (0 == cbor_get(cbor, cborlen, "", &cv)))
+        {
+            check_value(&jv, &cv);
+        }
+        else
+        {
+            TEST_CHECK(0, "random document %d root not found", docs);
+        }
+        jsontotal += jsonlen;
+        cbortotal += cborlen;
+    }
+    printf("random: %d documents, json %ld bytes, cbor %ld bytes\n", docs, jsontotal, cbortotal);
+
+    printf("%s: %d failed\n", (s_test_fail == 0) ? "PASS" : "FAIL", s_test_fail);
+
+    return (s_test_fail == 0) ? 0 : 1;
+}
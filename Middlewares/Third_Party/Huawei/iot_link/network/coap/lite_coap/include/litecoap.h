@@ -39,6 +39,8 @@
 
 void *litecoap_malloc(int size);
 int litecoap_free(void *p);
+coap_msg_t *litecoap_malloc_msg(void);
+int litecoap_free_msg(coap_msg_t *msg);
 int litecoap_delay(unsigned int ms);
 unsigned long long litecoap_time();
 /**
@@ -45,6 +45,12 @@
 
 #define RANDOM_TOKEN_LEN 8
 
+#ifndef CONFIG_LITECOAP_MSG_POOLSIZE
+#define CONFIG_LITECOAP_MSG_POOLSIZE  4
+#endif
+
+static void *s_litecoap_msg_pool = NULL;
+
 int litecoap_sal_send(void *handle, char *buf, int size);
 int litecoap_sal_read(void *handle, char *buf, int size);
 
@@ -134,6 +140,36 @@ int litecoap_free(void *p)
     return LITECOAP_OK;
 }
 
+/*****************************************************************************
+ Function    : litecoap_malloc_msg
+ Description : malloc a coap message from the message pool
+ Input       : None
+ Output      : None
+ Return      : msg @ the message's pointer, NULL means failed.
+ *****************************************************************************/
+coap_msg_t *litecoap_malloc_msg(void)
+{
+    return (coap_msg_t *)osal_pool_alloc(s_litecoap_msg_pool);
+}
+
+/*****************************************************************************
+ Function    : litecoap_free_msg
+ Description : return the coap message to the message pool
+ Input       : msg @ the message that want to free.
+ Output      : None
+ Return      : LITECOAP_OK free ok, other value means failed.
+ *****************************************************************************/
+int litecoap_free_msg(coap_msg_t *msg)
+{
+    if (NULL == msg)
+    {
+        return LITECOAP_PARAM_NULL;
+    }
+
+    osal_pool_free(s_litecoap_msg_pool, msg);
+    return LITECOAP_OK;
+}
+
 /*****************************************************************************
  Function    : litecoap_check_validip
  Description : check if the ip address if valid ip address 
@@ -257,6 +293,15 @@ coap_context_t *litecoap_malloc_context(void *res)
 	{
 		return NULL;
 	}
+
+    if (NULL == s_litecoap_msg_pool)
+    {
+        s_litecoap_msg_pool = osal_pool_create("coap_msg", sizeof(coap_msg_t), CONFIG_LITECOAP_MSG_POOLSIZE, 1);
+        if (NULL == s_litecoap_msg_pool)
+        {
+            return NULL;
+        }
+    }
 	
 	tmp = osal_malloc(sizeof(coap_context_t));
 	if (NULL == tmp)
@@ -813,7 +813,7 @@ coap_msg_t *litecoap_new_msg(coap_context_t *ctx,
         return NULL;
     }
 
-    msg = (coap_msg_t *)litecoap_malloc(sizeof(coap_msg_t));
+    msg = litecoap_malloc_msg();
     if (msg == NULL) {
         return NULL;
     }
@@ -874,7 +874,7 @@ int litecoap_delete_msg(coap_msg_t *msg)
         litecoap_free(msg->payload);
     }
     msg->payload = NULL;
-    litecoap_free(msg);
+    litecoap_free_msg(msg);
 
     return LITECOAP_OK;
 }
@@ -898,7 +898,7 @@ int litecoap_send_back(coap_context_t *ctx, coap_msg_t *rcvmsg,
     if ((ctx == NULL) || (rcvmsg == NULL)) {
         return LITECOAP_PARAM_NULL;
     }
-    newmsg = (coap_msg_t *)litecoap_malloc(sizeof(coap_msg_t));
+    newmsg = litecoap_malloc_msg();
     if (newmsg == NULL) {
         return LITECOAP_MALLOC_FAILED;
     }
@@ -915,13 +915,13 @@ int litecoap_send_back(coap_context_t *ctx, coap_msg_t *rcvmsg,
     
     datalen = litecoap_build_byte_stream(ctx, newmsg);
     if (datalen < 0) {
-        litecoap_free(newmsg);
+        litecoap_free_msg(newmsg);
         newmsg = NULL;
         return LITECOAP_ENCODE_PKG_SIZE_ERR;
     }
     /* send msg to network */
     ctx->netops->network_send(ctx->udpio, (char *)ctx->sndbuf.buf, datalen);
-    litecoap_free(newmsg);
+    litecoap_free_msg(newmsg);
     return LITECOAP_OK;
 }
 
@@ -1428,7 +1428,7 @@ int litecoap_read(coap_context_t *ctx)
         fixed me: need parse data and then handle coap message 
         need malloc coap msg buffers, deal with it and then free, it
     */
-    msg = (coap_msg_t *)litecoap_malloc(sizeof(coap_msg_t));
+    msg = litecoap_malloc_msg();
     if (msg == NULL) {
         return LITECOAP_MALLOC_FAILED;
     }
@@ -79,6 +79,42 @@ int   dtls_al_write(void *handle, uint8_t *msg, size_t len, int timeout)
     return ret;
 }
 
+int   dtls_al_writev(void *handle, const dtls_al_iovec_t *iov, int iovcnt, int timeout)
+{
+    int ret = 0;
+    int sent = 0;
+    int i;
+
+    if((NULL == s_dtls_al) || (NULL == iov) || (iovcnt <= 0))
+    {
+        return ret;
+    }
+    if(NULL != s_dtls_al->io.io_writev)
+    {
+        return s_dtls_al->io.io_writev(handle, iov, iovcnt, timeout);
+    }
+    if(NULL == s_dtls_al->io.io_write)
+    {
+        return ret;
+    }
+    ///< stop at the first piece not written fully, the caller writes the rest again
+    for(i = 0; i < iovcnt; i++)
+    {
+        ret = s_dtls_al->io.io_write(handle, (uint8_t *)iov[i].base, iov[i].len, timeout);
+        if(ret <= 0)
+        {
+            return (sent > 0) ? sent : ret;
+        }
+        sent += ret;
+        if(ret < (int)iov[i].len)
+        {
+            break;
+        }
+    }
+
+    return sent;
+}
+
 int  dtls_al_read(void *handle, uint8_t *buf, size_t len, int timeout)
 {
     int ret = 0;
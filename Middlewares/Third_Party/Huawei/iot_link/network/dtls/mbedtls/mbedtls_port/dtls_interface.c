@@ -544,9 +544,29 @@ int dtls_accept( mbedtls_net_context *bind_ctx,
     return mbedtls_net_accept(bind_ctx, client_ctx, client_ip, buf_size, ip_len);
 }
 
+///< use the osal placement policy, so the large record buffers could go to the bulk memory region
+static void *dtls_calloc(size_t n, size_t size)
+{
+    void *ret = NULL;
+    size_t len = n * size;
+
+    if((0 != n) && ((len / n) != size))
+    {
+        return ret;
+    }
+
+    ret = osal_malloc_ex(len, 0);
+    if(NULL != ret)
+    {
+        (void) memset(ret, 0, len);
+    }
+
+    return ret;
+}
+
 void dtls_init(void)
 {
-    (void)mbedtls_platform_set_calloc_free(osal_calloc, osal_free);
+    (void)mbedtls_platform_set_calloc_free(dtls_calloc, osal_free);
     (void)mbedtls_platform_set_snprintf(snprintf);
     (void)mbedtls_platform_set_printf(printf);
 }
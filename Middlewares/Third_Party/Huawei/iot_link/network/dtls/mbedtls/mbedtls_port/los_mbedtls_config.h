@@ -133,6 +133,7 @@
 #define MBEDTLS_SSL_ALL_ALERT_MESSAGES
 #define MBEDTLS_SSL_RENEGOTIATION
 #define MBEDTLS_SSL_CACHE_C
+#define MBEDTLS_SSL_SESSION_TICKETS
 #define MBEDTLS_CIPHER_PADDING_ZEROS_AND_LEN
 #if 0 // We should support two encryption algorithm
 #define MBEDTLS_CCM_C
@@ -42,6 +42,111 @@
 #include <dtls_al.h>
 #include <dtls_interface.h>
 
+#ifndef CONFIG_MBEDTLS_SESSION_CACHE
+#define CONFIG_MBEDTLS_SESSION_CACHE  2     ///< how many servers' sessions kept to resume, 0 always does the full handshake
+#endif
+
+#define CN_MBED_SESSION_HOSTLEN       64    ///< the session of the longer host name is not kept
+#define CN_MBED_SESSION_PORTLEN       8
+
+#if defined(MBEDTLS_SSL_CLI_C) && (CONFIG_MBEDTLS_SESSION_CACHE > 0)
+typedef struct
+{
+    char                 host[CN_MBED_SESSION_HOSTLEN];
+    char                 port[CN_MBED_SESSION_PORTLEN];
+    mbedtls_ssl_session  session;     ///< the session id or the ticket, and the master secret
+    unsigned int         used;        ///< 0 means free, the least used is replaced first
+}mbed_session_t;
+
+static mbed_session_t  s_mbed_sessions[CONFIG_MBEDTLS_SESSION_CACHE];
+static unsigned int    s_mbed_session_seq;
+static osal_mutex_t    s_mbed_session_mutex = cn_mutex_invalid;
+
+static mbed_session_t *mbed_session_find(const char *host, const char *port)
+{
+    int i;
+
+    for(i = 0; i < CONFIG_MBEDTLS_SESSION_CACHE; i++)
+    {
+        if((0 != s_mbed_sessions[i].used) && (0 == strcmp(s_mbed_sessions[i].host, host)) && \
+           (0 == strcmp(s_mbed_sessions[i].port, port)))
+        {
+            return &s_mbed_sessions[i];
+        }
+    }
+
+    return NULL;
+}
+
+///< offer the session kept for the server, which does the full handshake if it does not know the session any more
+static void mbed_session_resume(mbedtls_ssl_context *ssl, const char *host, const char *port)
+{
+    mbed_session_t *session;
+
+    if((cn_mutex_invalid == s_mbed_session_mutex) || (false == osal_mutex_lock(s_mbed_session_mutex)))
+    {
+        return;
+    }
+    session = mbed_session_find(host, port);
+    if(NULL != session)
+    {
+        session->used = ++s_mbed_session_seq;
+        (void) mbedtls_ssl_set_session(ssl, &session->session);
+    }
+    (void) osal_mutex_unlock(s_mbed_session_mutex);
+}
+
+///< keep the session just established for the next connect, or forget the one of the failed handshake
+static void mbed_session_keep(mbedtls_ssl_context *ssl, const char *host, const char *port, int established)
+{
+    mbed_session_t *session;
+    int i;
+
+    if((cn_mutex_invalid == s_mbed_session_mutex) || (false == osal_mutex_lock(s_mbed_session_mutex)))
+    {
+        return;
+    }
+    session = mbed_session_find(host, port);
+    if((NULL == session) && established && (strlen(host) < CN_MBED_SESSION_HOSTLEN) && \
+       (strlen(port) < CN_MBED_SESSION_PORTLEN))
+    {
+        session = &s_mbed_sessions[0];
+        for(i = 1; i < CONFIG_MBEDTLS_SESSION_CACHE; i++)
+        {
+            if(s_mbed_sessions[i].used < session->used)
+            {
+                session = &s_mbed_sessions[i];
+            }
+        }
+        (void) strcpy(session->host, host);
+        (void) strcpy(session->port, port);
+    }
+    if(NULL != session)
+    {
+        mbedtls_ssl_session_free(&session->session);
+        session->used = 0;
+        if(established)
+        {
+            if(0 == mbedtls_ssl_get_session(ssl, &session->session))
+            {
+                session->used = ++s_mbed_session_seq;
+            }
+            else
+            {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+                if(session->session.ticket == ssl->session->ticket)
+                {
+                    session->session.ticket = NULL;     ///< not copied yet, never free the one of the ssl
+                }
+#endif
+                mbedtls_ssl_session_free(&session->session);
+            }
+        }
+    }
+    (void) osal_mutex_unlock(s_mbed_session_mutex);
+}
+#endif
+
 
 #if defined(MBEDTLS_DEBUG_C)
 static void mbed_port_debug( void *ctx, int level,
@@ -177,7 +282,14 @@ int mbed_connect(void *handle,const char *server_ip, const char *server_port,int
     sinfo.udp_or_tcp = MBEDTLS_NET_PROTO_TCP;
     sinfo.timeout = timeout;
 
+#if defined(MBEDTLS_SSL_CLI_C) && (CONFIG_MBEDTLS_SESSION_CACHE > 0)
+    ///< the resumed handshake takes one round trip and no public key operation
+    mbed_session_resume(handle, server_ip, server_port);
+    ret = dtls_shakehand( handle,&sinfo);
+    mbed_session_keep(handle, server_ip, server_port, (0 == ret));
+#else
     ret = dtls_shakehand( handle,&sinfo);
+#endif
 
     return ret;
 }
@@ -203,6 +315,12 @@ int dtls_imp_init(void)
     (void)mbedtls_platform_set_calloc_free(osal_calloc, osal_free);
     (void)mbedtls_platform_set_snprintf(snprintf);
     (void)mbedtls_platform_set_printf(printf);
+#if defined(MBEDTLS_SSL_CLI_C) && (CONFIG_MBEDTLS_SESSION_CACHE > 0)
+    if(false == osal_mutex_create(&s_mbed_session_mutex))
+    {
+        s_mbed_session_mutex = cn_mutex_invalid;
+    }
+#endif
     ret = dtls_al_install(&s_mbedtls_io);
 
     return ret;
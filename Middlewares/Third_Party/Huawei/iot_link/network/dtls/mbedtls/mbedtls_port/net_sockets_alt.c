@@ -91,6 +91,7 @@ int mbedtls_net_connect(mbedtls_net_context *ctx, const char *host, const char *
     {
         sal_closesocket(ctx->fd);
         ctx->fd = -1;
+        sal_dns_flush(host);    ///< the server may have moved, resolve it again next time
         return MBEDTLS_ERR_NET_CONNECT_FAILED;
     }
     return 0;
@@ -50,14 +50,18 @@ extern sinn_if_funcs_t sinn_sec_if;
 
 typedef struct
 {
-    sinn_manager_t *mgr;
-    void           *task;    //create a task for this client
+    sinn_connection_t *nc;
+    osal_queue_t       queue;   //the connack and suback codes of this connection
+    osal_semp_t        sem;     //lighted by the acks of this connection
+    osal_semp_t        sent;    //lighted when the manager has sent some of the send buffer
 } sinn_mqtt_cb_t;
 
 
 static sinn_device_info_t default_dev_info;
-static osal_queue_t link_queue;
-static osal_semp_t link_sem;
+static sinn_manager_t *s_sinn_mgr = NULL;   //all the connections share one manager and one loop task
+static void *s_sinn_task = NULL;
+static int s_sinn_users = 0;                //the connections using the manager, including the ones connecting
+static osal_mutex_t s_sinn_lock = cn_mutex_invalid;
 
 static int __loop_entry(void *arg)
 {
@@ -66,8 +70,55 @@ static int __loop_entry(void *arg)
     for(;;)
     {
         sinn_poll(mgr, SINN_EVENTS_HANDLE_PERIOD_MS);
+
+        //the last connection has gone, release the manager and the next connect creates a new one
+        (void) osal_mutex_lock(s_sinn_lock);
+        if (0 == s_sinn_users)
+        {
+            s_sinn_mgr = NULL;
+            s_sinn_task = NULL;
+            (void) osal_mutex_unlock(s_sinn_lock);
+            break;
+        }
+        (void) osal_mutex_unlock(s_sinn_lock);
     }
+    sinn_uninit(mgr);
+    osal_free(mgr);
+    osal_task_exit();
+
     return 0;
+}
+
+static sinn_manager_t *__mgr_get(void)
+{
+    sinn_manager_t *mgr = NULL;
+
+    (void) osal_mutex_lock(s_sinn_lock);
+    ///< the first connection creates the manager and the task, which serve all the later ones
+    if (NULL == s_sinn_mgr)
+    {
+        s_sinn_mgr = osal_malloc(sizeof(sinn_manager_t));
+        if (NULL != s_sinn_mgr)
+        {
+            sinn_init(s_sinn_mgr, &default_dev_info);
+            s_sinn_task = osal_task_create("sinn",__loop_entry,s_sinn_mgr,0x800,NULL,4);
+        }
+    }
+    if (NULL != s_sinn_mgr)
+    {
+        mgr = s_sinn_mgr;
+        s_sinn_users++;
+    }
+    (void) osal_mutex_unlock(s_sinn_lock);
+
+    return mgr;
+}
+
+static void __mgr_put(void)
+{
+    (void) osal_mutex_lock(s_sinn_lock);
+    s_sinn_users--;
+    (void) osal_mutex_unlock(s_sinn_lock);
 }
 
 
@@ -76,6 +127,7 @@ static int __loop_entry(void *arg)
 static void ev_handler(sinn_connection_t *nc, int event, void *event_data)
 {
     sinn_mqtt_msg_t *amm = (sinn_mqtt_msg_t *)event_data;
+    sinn_mqtt_cb_t *cb = (sinn_mqtt_cb_t *)((sinn_connect_param_t *)nc->user_data)->user_arg;
     switch(event)
     {
         case SINN_EV_CONNECTED:
@@ -87,22 +139,27 @@ static void ev_handler(sinn_connection_t *nc, int event, void *event_data)
 
                 sinn_register_proto(nc, sinn_mqtt_event_handler);
                 options = (mqtt_connect_opt_t *)sinn_conn_param->protocol_con_param;
-                nc->proto_data = (void *)osal_malloc((size_t)sizeof(sinn_mqtt_proto_data_t));
+                nc->proto_data = (void *)osal_zalloc((size_t)sizeof(sinn_mqtt_proto_data_t));   ///< no handler yet
                 sinn_mqtt_connect(nc, options);
                 osal_free(options);
             }
             break;
         case SINN_EV_RECONN:
             {
-                (void) osal_semp_post(link_sem);
+                (void) osal_semp_post(cb->sem);
+            }
+            break;
+        case SINN_EV_SEND:
+            {
+                (void) osal_semp_post(cb->sent);
             }
             break;
         case EV_MQTT_CONNACK:
             {
                 if (amm->ret[0] == MQTT_CONNACK_ACCEPTED)
                 {
-                    osal_queue_send(link_queue, &amm->ret[0], sizeof(amm->ret[0]), 0);
-                    (void) osal_semp_post(link_sem);
+                    osal_queue_send(cb->queue, &amm->ret[0], sizeof(amm->ret[0]), 0);
+                    (void) osal_semp_post(cb->sem);
                 }
                 else
                 {
@@ -113,8 +170,8 @@ static void ev_handler(sinn_connection_t *nc, int event, void *event_data)
             break;
         case EV_MQTT_SUBACK:
             {
-                osal_queue_send(link_queue, amm->ret, 8, 0);
-                (void) osal_semp_post(link_sem);
+                osal_queue_send(cb->queue, amm->ret, sizeof(amm->ret[0]), 0);   ///< one topic each subscribe
+                (void) osal_semp_post(cb->sem);
                 free(amm->ret);
             }
             break;
@@ -150,7 +207,7 @@ static void ev_handler(sinn_connection_t *nc, int event, void *event_data)
         case EV_MQTT_PUBACK:
         case EV_MQTT_PUBCOMP:
             {
-                (void) osal_semp_post(link_sem);
+                (void) osal_semp_post(cb->sem);
             }
             break;
         case EV_MQTT_PUBREL:
@@ -169,16 +226,15 @@ static void * __connect(mqtt_al_conpara_t *conparam)
 {
     void *ret = NULL;
     sinn_mqtt_cb_t *cb = NULL;
-    sinn_manager_t *mgr = NULL;
     sinn_connect_param_t *param = NULL;
     mqtt_connect_opt_t *mqtt_con_param;
+    sinn_manager_t *mgr;
 
     cb = osal_malloc(sizeof(sinn_mqtt_cb_t));
-    mgr = osal_malloc(sizeof(sinn_manager_t));
-    cb->mgr = mgr;
 
     param = (sinn_connect_param_t *)osal_malloc(sizeof(sinn_connect_param_t));
     param->proto_type = SOCK_STREAM;
+    param->user_arg = cb;
     param->server_ip = conparam->serveraddr.data;
     param->server_port = conparam->serverport;
     mqtt_con_param = (mqtt_connect_opt_t *)osal_malloc(sizeof(mqtt_connect_opt_t));
@@ -208,62 +264,78 @@ static void * __connect(mqtt_al_conpara_t *conparam)
         mqtt_con_param->connect_head.mqtt_connect_flag_u.bits.will_flag = 0;
     }
 
-    if (NULL == conparam->security || conparam->security->type == en_mqtt_al_security_none)
+#ifdef WITH_DTLS
+    if ((NULL == conparam->security) || (EN_DTLS_AL_SECURITY_TYPE_NONE == conparam->security->type))
     {
-        param->ssl_param.type = en_mqtt_al_security_none;
-        #ifndef WITH_DTLS
-        default_dev_info.ifuncs = &sinn_nosec_if;
-        #endif
+        param->ssl_param.type = e_sinn_ssl_type_none;
     }
     else
     {
-        param->ssl_param.type = conparam->security->type;
-        #ifdef WITH_DTLS
-            default_dev_info.ifuncs = &sinn_sec_if;
-        #endif
-        switch(param->ssl_param.type)
+        default_dev_info.ifuncs = &sinn_sec_if;
+        if (EN_DTLS_AL_SECURITY_TYPE_PSK == conparam->security->type)
         {
-            case en_mqtt_al_security_psk:
-                param->ssl_param.u.psk.psk_id = (const unsigned char *)conparam->security->u.psk.psk_id.data;
-                param->ssl_param.u.psk.psk_id_len = (size_t)conparam->security->u.psk.psk_id.len;
-                param->ssl_param.u.psk.psk_len = (size_t)conparam->security->u.psk.psk_key.len;
-                param->ssl_param.u.psk.psk = (const unsigned char *)conparam->security->u.psk.psk_key.data;
-                break;
-            case en_mqtt_al_security_cas:
-                param->ssl_param.u.uni_ca.ca_cert_len = (size_t)conparam->security->u.cas.ca_crt.len;
-                param->ssl_param.u.uni_ca.ca_cert = (const unsigned char *)conparam->security->u.cas.ca_crt.data;
-                break;
-            case en_mqtt_al_security_cacs:
-                param->ssl_param.u.bi_ca.server_name = (const char *)conparam->security->u.cacs.ca_host.data;
-                param->ssl_param.u.bi_ca.ca_cert_len = (size_t)conparam->security->u.cacs.ca_s_crt.len;
-                param->ssl_param.u.bi_ca.ca_cert = (const unsigned char *)conparam->security->u.cacs.ca_s_crt.data;
-                param->ssl_param.u.bi_ca.client_cert_len = (size_t)conparam->security->u.cacs.ca_c_crt.len;
-                param->ssl_param.u.bi_ca.client_cert = (const unsigned char *)conparam->security->u.cacs.ca_c_crt.data;
-                param->ssl_param.u.bi_ca.client_key_len = (size_t)conparam->security->u.cacs.ca_c_key.len;
-                param->ssl_param.u.bi_ca.client_key = (const unsigned char *)conparam->security->u.cacs.ca_c_key.data;
-                break;
-            default:
-                break;
+            param->ssl_param.type = e_sinn_ssl_type_psk;
+            param->ssl_param.u.psk.psk_id = (const unsigned char *)conparam->security->u.psk.psk_id;
+            param->ssl_param.u.psk.psk_id_len = (size_t)conparam->security->u.psk.psk_id_len;
+            param->ssl_param.u.psk.psk = (const unsigned char *)conparam->security->u.psk.psk_key;
+            param->ssl_param.u.psk.psk_len = (size_t)conparam->security->u.psk.psk_key_len;
         }
+        else if (NULL == conparam->security->u.cert.client_ca)
+        {
+            param->ssl_param.type = e_sinn_ssl_type_unica;
+            param->ssl_param.u.uni_ca.ca_cert = (const unsigned char *)conparam->security->u.cert.server_ca;
+            param->ssl_param.u.uni_ca.ca_cert_len = (size_t)conparam->security->u.cert.server_ca_len;
+        }
+        else
+        {
+            param->ssl_param.type = e_sinn_ssl_type_bica;
+            param->ssl_param.u.bi_ca.server_name = conparam->serveraddr.data;
+            param->ssl_param.u.bi_ca.ca_cert = (const unsigned char *)conparam->security->u.cert.server_ca;
+            param->ssl_param.u.bi_ca.ca_cert_len = (size_t)conparam->security->u.cert.server_ca_len;
+            param->ssl_param.u.bi_ca.client_cert = (const unsigned char *)conparam->security->u.cert.client_ca;
+            param->ssl_param.u.bi_ca.client_cert_len = (size_t)conparam->security->u.cert.client_ca_len;
+            param->ssl_param.u.bi_ca.client_key = (const unsigned char *)conparam->security->u.cert.client_pk;
+            param->ssl_param.u.bi_ca.client_key_len = (size_t)conparam->security->u.cert.client_pk_len;
+        }
+    }
+#else
+    ///< built without the dtls, the security asked could not be served
+    if ((NULL != conparam->security) && (EN_DTLS_AL_SECURITY_TYPE_NONE != conparam->security->type))
+    {
+        conparam->conret = cn_mqtt_al_con_code_err_network;
+        osal_free(mqtt_con_param);
+        osal_free(param);
+        osal_free(cb);
+        return NULL;
     }
+    default_dev_info.ifuncs = &sinn_nosec_if;
+#endif
 
-    sinn_init(mgr, &default_dev_info);
-    osal_queue_create(&link_queue, 10, 10);
-    osal_semp_create(&link_sem, 1, 0);
+    osal_queue_create(&cb->queue, 10, 10);
+    osal_semp_create(&cb->sem, 1, 0);
+    osal_semp_create(&cb->sent, 1, 0);
 
-    mgr->nc = sinn_connect(mgr, ev_handler, param);
-    if(mgr->nc)
+    mgr = __mgr_get();
+    cb->nc = (NULL != mgr) ? sinn_connect(mgr, ev_handler, param) : NULL;
+    if(cb->nc)
     {
-        cb->task =osal_task_create("sinn",__loop_entry,mgr,0x800,NULL,4);
-        osal_semp_pend(link_sem, 5*1000);
-        osal_queue_recv(link_queue, &conparam->conret, sizeof(conparam->conret), 0);
+        osal_semp_pend(cb->sem, 5*1000);
+        osal_queue_recv(cb->queue, &conparam->conret, sizeof(conparam->conret), 0);
 
         ret = cb;
         return ret;
     }
     else
     {
+        if (NULL != mgr)
+        {
+            __mgr_put();
+        }
         conparam->conret = cn_mqtt_al_con_code_err_network;
+        osal_queue_del(cb->queue);
+        (void) osal_semp_del(cb->sem);
+        (void) osal_semp_del(cb->sent);
+        osal_free(cb);
         return NULL;
     }
 }
@@ -282,16 +354,14 @@ static int __disconnect(void *handle)
     cb = handle;
 
     //mqtt disconnect
-    sinn_mqtt_disconnect(cb->mgr->nc);
-    //kill the thread
-    osal_task_kill(cb->task);
-    //net disconnect
-    cb->mgr->interface->ifuncs->if_discon(cb->mgr->nc);
-    //deinit the mqtt
-    //free the memory
-    sinn_destory(cb->mgr->nc);
-    osal_queue_del(link_queue);
-    (void) osal_semp_del(link_sem);
+    sinn_mqtt_disconnect(cb->nc);
+    //leave the loop task, which keeps serving the other connections
+    //net disconnect and free the memory
+    sinn_destory(cb->nc);
+    __mgr_put();
+    osal_queue_del(cb->queue);
+    (void) osal_semp_del(cb->sem);
+    (void) osal_semp_del(cb->sent);
     if(cb)
     {
         osal_free(cb);
@@ -310,8 +380,13 @@ static void general_dealer(sinn_mqtt_msg_t *data)
     msg.retain = data->retained;
     msg.msg.len = data->payloadlen;
     msg.msg.data = data->payload;
+    msg.offset = 0;
+    msg.total = msg.msg.len;
     msg.topic.data = data->topic;
     msg.topic.len = data->topiclen;
+    msg.payloadformat = 0;
+    msg.contenttype.data = NULL;
+    msg.contenttype.len = 0;
 
     if (NULL != data->arg)
     {
@@ -328,7 +403,7 @@ static int __subscribe(void *handle,mqtt_al_subpara_t *para)
     sinn_connection_t *nc;
     sinn_mqtt_cb_t *cb;
     cb = (sinn_mqtt_cb_t *)handle;
-    nc = cb->mgr->nc;
+    nc = cb->nc;
 
     opt.subscribe_payload.count = 1;
     opt.subscribe_payload.qoss = (unsigned char *)osal_malloc(sizeof(unsigned char) * opt.subscribe_payload.count);
@@ -339,7 +414,7 @@ static int __subscribe(void *handle,mqtt_al_subpara_t *para)
     ret = sinn_mqtt_subscribe(nc, &opt, general_dealer, para->dealer);
     if (ret > 0)
     {
-        ret = osal_semp_pend(link_sem, 5*1000);
+        ret = osal_semp_pend(cb->sem, 5*1000);
         if (ret == false)
         {
             ret = -1;
@@ -355,7 +430,7 @@ static int __subscribe(void *handle,mqtt_al_subpara_t *para)
         ret = -1;
         goto exit;
     }
-    osal_queue_recv(link_queue, &para->subret, sizeof(para->subret), 0);
+    osal_queue_recv(cb->queue, &para->subret, sizeof(para->subret), 0);
 
 exit:
     if (opt.subscribe_payload.qoss)
@@ -374,7 +449,7 @@ static int __unsubscribe(void *handle,mqtt_al_unsubpara_t *para)
     sinn_mqtt_cb_t *cb;
 
     cb = (sinn_mqtt_cb_t *)handle;
-    nc = cb->mgr->nc;
+    nc = cb->nc;
 
     opt.unsubscribe_payload.count = 1;
     opt.unsubscribe_payload.topic = (char **)osal_malloc(opt.unsubscribe_payload.count * sizeof(char *));
@@ -383,7 +458,7 @@ static int __unsubscribe(void *handle,mqtt_al_unsubpara_t *para)
     ret = sinn_mqtt_unsubscribe(nc, &opt);
     if (ret > 0)
     {
-        ret = osal_semp_pend(link_sem, 5*1000);
+        ret = osal_semp_pend(cb->sem, 5*1000);
         if (ret == false)
         {
             ret = -1;
@@ -409,9 +484,15 @@ static int __publish(void *handle, mqtt_al_pubpara_t *para)
     mqtt_publish_opt_t opt;
     sinn_connection_t *nc;
     sinn_mqtt_cb_t *cb;
+    unsigned long long deadline;
+
+    if (NULL != para->reader)   ///< the sinn engine copies the whole packet, no streamed publish
+    {
+        return -1;
+    }
 
     cb = (sinn_mqtt_cb_t *)handle;
-    nc = cb->mgr->nc;
+    nc = cb->nc;
 
     opt.publish_head.topic = para->topic.data;
     opt.publish_head.topic_len = para->topic.len;
@@ -423,18 +504,32 @@ static int __publish(void *handle, mqtt_al_pubpara_t *para)
     opt.publish_payload.msg = para->msg.data;
     opt.publish_payload.msg_len = para->msg.len;
     ret = sinn_mqtt_publish(nc, &opt);
-    if (ret > 0)
+    ///< the manager sends the buffer once a poll, so the full one is waited for rather than dropping the
+    ///< publish; the one never fits the empty buffer fails at once
+    deadline = osal_sys_time() + 5*1000;
+    while ((ret <= 0) && (nc->send_buf.len > 0) && (osal_sys_time() < deadline))
+    {
+        (void) osal_semp_pend(cb->sent, SINN_EVENTS_HANDLE_PERIOD_MS);
+        ret = sinn_mqtt_publish(nc, &opt);
+    }
+    if ((ret > 0) && (en_mqtt_al_qos_0 == para->qos))   ///< no ack comes for the qos 0
     {
-        ret = osal_semp_pend(link_sem, 5*1000);
-        if (ret == true)
-            return 0;
-        else
-            return -1;
+        ret = 0;
+    }
+    else if (ret > 0)
+    {
+        ret = (osal_semp_pend(cb->sem, 5*1000) == true) ? 0 : -1;
     }
     else
     {
-        return -1;
+        ret = -1;
     }
+    if ((0 == ret) && (NULL != para->done))   ///< no window in the sinn engine, it has been done here
+    {
+        para->done(para->done_arg, ret);
+    }
+
+    return ret;
 }
 
 static en_mqtt_al_connect_state __check_status(void *handle)
@@ -444,7 +539,7 @@ static en_mqtt_al_connect_state __check_status(void *handle)
     sinn_mqtt_cb_t *cb;
 
     cb = (sinn_mqtt_cb_t *)handle;
-    nc = cb->mgr->nc;
+    nc = cb->nc;
 
     if (!(nc->flags & SINN_FG_RECONNECT))
     {
@@ -472,6 +567,10 @@ int mqtt_install_sinnmqtt()
         .check_status = __check_status,
     };
 
+    if ((cn_mutex_invalid == s_sinn_lock) && (false == osal_mutex_create(&s_sinn_lock)))
+    {
+        return ret;
+    }
     ret = mqtt_al_install(&sinn_mqtt_op);
 
     return ret;
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <link_log.h>
 #include "mqtt_packet.h"
 
 static int mqtt_encode_len(unsigned char *buf, int len)
@@ -193,10 +194,14 @@ int mqtt_encode_publish(unsigned char *buf, int buf_len, mqtt_publish_opt_t *opt
     if (options->publish_head.topic)
         remaining_len += (int)strlen(options->publish_head.topic) + MQTT_STRING_LEN;
 
-    remaining_len += sizeof(options->publish_head.packet_id);
+    if (options->qos > 0)
+        remaining_len += sizeof(options->publish_head.packet_id);
 
+    ///< the payload is binary, never measure it by the strlen
     if (options->publish_payload.msg)
-        remaining_len += (int)strlen(options->publish_payload.msg);
+        remaining_len += (int)options->publish_payload.msg_len;
+    if (1 + MQTT_PACKET_MAX_LEN + remaining_len > buf_len)     ///< the type and the remaining length first
+        return -1;
     /* Encode fix header */
     len = mqtt_encode_fixhead(buf, MQTT_PACKET_TYPE_PUBLISH, options->dup, 
                               options->qos, options->retain, remaining_len);
@@ -210,7 +215,7 @@ int mqtt_encode_publish(unsigned char *buf, int buf_len, mqtt_publish_opt_t *opt
     /* Encode payload*/
     payload_buf = vhead_buf;
     if (options->publish_payload.msg)
-        memcpy(payload_buf, options->publish_payload.msg, strlen(options->publish_payload.msg));
+        memcpy(payload_buf, options->publish_payload.msg, options->publish_payload.msg_len);
 
     return (len + remaining_len);
 }
@@ -236,7 +241,7 @@ int mqtt_decode_publish(unsigned char *buf, int buf_len, mqtt_publish_opt_t *opt
 
     payload_buf = vhead_buf;
     options->publish_payload.msg = (char *)payload_buf;
-    options->publish_payload.msg_len = remaning_len - options->publish_head.topic_len - MQTT_STRING_LEN;
+    options->publish_payload.msg_len = remaning_len - (int)(vhead_buf - (buf + len));
 
     return 0;
 }
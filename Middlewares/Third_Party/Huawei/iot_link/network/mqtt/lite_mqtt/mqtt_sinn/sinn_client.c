@@ -33,6 +33,10 @@ void sinn_init(sinn_manager_t *m, sinn_device_info_t *param)
 {
     LINK_LOG_DEBUG("sinn init\r\n");
 
+    m->nc = NULL;
+    m->num = 0;
+    m->busy = NULL;
+    (void) osal_mutex_create(&m->lock);
     m->interface = (sinn_if_t *)osal_malloc(sizeof(sinn_if_t));   //TODO  check malloc and osal_malloc
     m->interface->mgr = m;
 
@@ -40,15 +44,27 @@ void sinn_init(sinn_manager_t *m, sinn_device_info_t *param)
     m->interface->ifuncs->if_init(m->interface);
 }
 
+void sinn_uninit(sinn_manager_t *m)
+{
+    LINK_LOG_DEBUG("sinn uninit\r\n");
+
+    if (m->interface)
+    {
+        m->interface->ifuncs->if_uninit(m->interface);
+        osal_free(m->interface);
+        m->interface = NULL;
+    }
+    (void) osal_mutex_del(m->lock);
+}
+
 sinn_connection_t* sinn_connect(sinn_manager_t *m, sinn_event_handler cb, sinn_connect_param_t *param)
 {
     int ret = 0;
     sinn_connection_t *nc = NULL;
     LINK_LOG_DEBUG("sinn connect\r\n");
-    if ((nc = (sinn_connection_t *)osal_malloc(sizeof(sinn_connection_t))) != NULL)
+    if ((nc = (sinn_connection_t *)osal_zalloc(sizeof(sinn_connection_t))) != NULL)
     {
         nc->mgr = m;
-        m->nc = nc;
         nc->flags |= (param->proto_type == SOCK_STREAM) ? 0 : SINN_FG_UDP;
         nc->flags |= SINN_FG_CONNECTING;
         nc->sock_fd = -1;
@@ -71,32 +87,66 @@ sinn_connection_t* sinn_connect(sinn_manager_t *m, sinn_event_handler cb, sinn_c
         return NULL;
     }
 
+    ///< join the poll only when connected, for the connect may block for a while
+    (void) osal_mutex_lock(m->lock);
+    nc->next = m->nc;
+    m->nc = nc;
+    m->num++;
+    (void) osal_mutex_unlock(m->lock);
+
     return nc;
 }
 
 void sinn_poll(sinn_manager_t *m, int timeout_ms)
 {
-    m->interface->ifuncs->if_poll(m->nc, timeout_ms);
+    m->interface->ifuncs->if_poll(m, timeout_ms);
 }
 
 void sinn_destory(sinn_connection_t* nc)
 {
-    if (nc && nc->mgr && nc->mgr->interface)
-        osal_free(nc->mgr->interface);
+    sinn_manager_t *m;
+    sinn_connection_t **link;
+
+    if (NULL == nc)
+        return;
 
-    if (nc && nc->mgr)
-        osal_free(nc->mgr);
+    m = nc->mgr;
+    if (m)
+    {
+        ///< leave the poll first, then nobody uses the socket
+        (void) osal_mutex_lock(m->lock);
+        for (link = &m->nc; NULL != *link; link = &(*link)->next)
+        {
+            if (*link == nc)
+            {
+                *link = nc->next;
+                m->num--;
+                break;
+            }
+        }
+        ///< wait for the loop out of the handlers of this connection
+        while (m->busy == nc)
+        {
+            (void) osal_mutex_unlock(m->lock);
+            osal_task_sleep(1);
+            (void) osal_mutex_lock(m->lock);
+        }
+        ///< the last packet(such as the disconnect) is sent if it could
+        if ((nc->sock_fd != -1) && (nc->send_buf.len > 0))
+            (void) m->interface->ifuncs->if_send(nc, nc->send_buf.data, nc->send_buf.len);
+        (void) osal_mutex_unlock(m->lock);
+
+        m->interface->ifuncs->if_discon(nc);
+    }
 
-    if (nc && nc->proto_data)
+    if (nc->proto_data)
         osal_free(nc->proto_data);
 
-    if (nc && nc->user_data)
+    if (nc->user_data)
         osal_free(nc->user_data);
 
     sinn_buf_free(&nc->send_buf);
     sinn_buf_free(&nc->recv_buf);
 
-    if (nc)
-        osal_free(nc);
-    nc = NULL;
+    osal_free(nc);
 }
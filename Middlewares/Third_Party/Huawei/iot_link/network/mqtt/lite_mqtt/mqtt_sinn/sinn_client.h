@@ -10,6 +10,7 @@
 #include <sal.h>
 #include <errno.h>
 #endif
+#include <osal.h>
 
 
 
@@ -21,6 +22,8 @@
 #define SINN_FG_ERR    (1 << 4)
 
 #define SINN_FG_RECONNECT  (1 << 5)
+#define SINN_FG_SELECTED   (1 << 6)   ///< the socket is in the select of this poll
+#define SINN_FG_PENDING    (1 << 7)   ///< not handled yet in this poll
 
 
 #define SINN_EV_POLL       (1)
@@ -49,12 +52,16 @@ typedef struct sinn_buf
 
 typedef struct sinn_manager
 {
-    sinn_connection_t *nc;
+    sinn_connection_t *nc;        ///< the connections list, all polled in one select
+    int num;                      ///< how many connections in the list
+    osal_mutex_t lock;            ///< the list and the send buffers are changed by the api tasks while polled by the loop
+    sinn_connection_t *busy;      ///< the one in its handlers now, which could not be freed
     sinn_if_t *interface;
 } sinn_manager_t;
 
 typedef struct sinn_connection
 {
+    sinn_connection_t *next;      ///< the next connection of the manager
     sinn_manager_t *mgr;
     int flags;
     int sock_fd;
@@ -85,7 +92,7 @@ typedef struct sinn_if_funcs
     void (*if_uninit)(sinn_if_t *interface);
     int (*if_connect)(sinn_connection_t *nc);
     void (*if_discon)(sinn_connection_t *nc);
-    sinn_time_t (*if_poll)(sinn_connection_t *nc, int timeout_ms);
+    sinn_time_t (*if_poll)(sinn_manager_t *m, int timeout_ms);   ///< poll all the connections of the manager
     int (*if_send)(sinn_connection_t *nc, const void *buf, size_t len);
     int (*if_recv)(sinn_connection_t *nc, void *buf, size_t len);
 } sinn_if_funcs_t;
@@ -148,6 +155,7 @@ typedef struct sinn_connect_param
     char *server_ip;
     unsigned int server_port;
     void *protocol_con_param;
+    void *user_arg;               ///< used by the user handler, get it from the user_data of the connection
 #ifdef WITH_DTLS
     // add some param used in dtls, like ca, key etc.
     sinn_ssl_param_t ssl_param;
@@ -157,10 +165,16 @@ typedef struct sinn_connect_param
 void sinn_register_proto(sinn_connection_t *nc, sinn_event_handler proto_handler);
 
 
+/**
+ * one manager owns a set of connections, each with its own buffers and handlers, and one
+ * task calls sinn_poll to serve them all; the connections could be added and destroyed by
+ * the other tasks, but never destroy the connection in its handler
+ */
 void sinn_init(sinn_manager_t *m,  sinn_device_info_t *param);
+void sinn_uninit(sinn_manager_t *m);  ///< all the connections should have been destroyed
 sinn_connection_t* sinn_connect(sinn_manager_t *m, sinn_event_handler cb, sinn_connect_param_t *param);
 void sinn_poll(sinn_manager_t *m, int timeout_ms);
-void sinn_destory(sinn_connection_t* nc);
+void sinn_destory(sinn_connection_t* nc);   ///< remove the connection from its manager, close and free it
 
 
 unsigned long int sinn_gettime_ms(void);
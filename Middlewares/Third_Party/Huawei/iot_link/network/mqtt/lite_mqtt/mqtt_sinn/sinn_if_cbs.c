@@ -65,11 +65,15 @@ void sinn_nc_can_write_cb(sinn_connection_t *nc)
 {
     int rc = 0;
     const unsigned char *buf = nc->send_buf.data;
-    size_t len = nc->send_buf.len;
+    size_t len;
 
     if(nc->sock_fd == -1)
         return;
 
+    (void) osal_mutex_lock(nc->mgr->lock);
+    len = nc->send_buf.len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
+
     nc->flags &= ~SINN_FG_CAN_WR;
     if (len > 0)
         rc = nc->mgr->interface->ifuncs->if_send(nc, buf, len);
@@ -83,9 +87,11 @@ void sinn_nc_can_write_cb(sinn_connection_t *nc)
     else if (rc > 0)
     {
         nc->last_time = sinn_gettime_ms();
+        (void) osal_mutex_lock(nc->mgr->lock);     ///< the api tasks append to the buffer meanwhile
         if(nc->send_buf.len > rc)
             memmove(nc->send_buf.data, nc->send_buf.data + rc, nc->send_buf.len - rc);
         nc->send_buf.len -= rc;
+        (void) osal_mutex_unlock(nc->mgr->lock);
         nc->flags |= SINN_FG_CAN_WR;
     }
     else if (rc == 0)
@@ -115,14 +121,14 @@ void sinn_nc_can_read_cb(sinn_connection_t *nc)
     }
     else if (rc == 0)
     {
-        nc->flags |= SINN_FG_CAN_RD;
+        nc->flags |= SINN_FG_RECONNECT;     ///< the peer closed
     }
     else if (rc > 0)
     {
+        ///< the next read waits for the select, the recv blocks on the idle socket
         nc->last_time = sinn_gettime_ms();
         nc->recv_buf.len += rc;
         sinn_dispatch_event(nc, NULL, NULL, SINN_EV_RECV, NULL);
-        nc->flags |= SINN_FG_CAN_RD;
     }
 }
 
@@ -161,3 +167,73 @@ void sinn_mgr_handle_conn(sinn_connection_t *nc)
         sinn_nc_can_write_cb(nc);
     }
 }
+
+int sinn_mgr_fd_set(sinn_manager_t *m, fd_set *rfds, fd_set *wfds, fd_set *efds)
+{
+    sinn_connection_t *nc;
+    int max_fd = -1;
+
+    FD_ZERO(rfds);
+    FD_ZERO(wfds);
+    FD_ZERO(efds);
+
+    (void) osal_mutex_lock(m->lock);
+    for (nc = m->nc; NULL != nc; nc = nc->next)
+    {
+        if (nc->sock_fd < 0)
+            continue;
+
+        if(!(nc->flags & SINN_FG_RECONNECT))
+            FD_SET(nc->sock_fd, rfds);
+        if(nc->send_buf.len > 0)
+        {
+            FD_SET(nc->sock_fd, wfds);
+            FD_SET(nc->sock_fd, efds);
+        }
+        nc->flags |= SINN_FG_SELECTED;
+
+        if (nc->sock_fd > max_fd)
+            max_fd = nc->sock_fd;
+    }
+    (void) osal_mutex_unlock(m->lock);
+
+    return max_fd;
+}
+
+void sinn_mgr_handle_conns(sinn_manager_t *m, fd_set *rfds, fd_set *wfds, fd_set *efds)
+{
+    sinn_connection_t *nc;
+
+    (void) osal_mutex_lock(m->lock);
+    for (nc = m->nc; NULL != nc; nc = nc->next)
+    {
+        ///< the connection joined during the select may reuse the fd of the destroyed one
+        if ((nc->flags & SINN_FG_SELECTED) && (nc->sock_fd >= 0))
+        {
+            if(FD_ISSET(nc->sock_fd, rfds)) {nc->flags |= SINN_FG_CAN_RD;}
+            if(FD_ISSET(nc->sock_fd, wfds)) {nc->flags |= SINN_FG_CAN_WR;}
+            if(FD_ISSET(nc->sock_fd, efds)) {nc->flags |= SINN_FG_ERR;}
+        }
+        nc->flags &= ~SINN_FG_SELECTED;
+        nc->flags |= SINN_FG_PENDING;
+    }
+
+    ///< the handlers run without the lock, so a slow one never stops the api tasks; the busy one
+    ///< is kept by sinn_destory, and the others may leave the list meanwhile, so look it up again
+    for (;;)
+    {
+        for (nc = m->nc; (NULL != nc) && !(nc->flags & SINN_FG_PENDING); nc = nc->next)
+        {
+        }
+        if (NULL == nc)
+            break;
+
+        nc->flags &= ~SINN_FG_PENDING;
+        m->busy = nc;
+        (void) osal_mutex_unlock(m->lock);
+        sinn_mgr_handle_conn(nc);
+        (void) osal_mutex_lock(m->lock);
+        m->busy = NULL;
+    }
+    (void) osal_mutex_unlock(m->lock);
+}
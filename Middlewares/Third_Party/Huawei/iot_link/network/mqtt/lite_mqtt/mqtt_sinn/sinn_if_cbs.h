@@ -50,4 +50,9 @@ void sinn_nc_can_read_cb(sinn_connection_t *nc);
 int sinn_nc_poll_cb(sinn_connection_t *nc);
 void sinn_mgr_handle_conn(sinn_connection_t *nc);
 
+///< add the sockets of the manager to the sets, return the max fd while -1 means none; the lock is held inside
+int sinn_mgr_fd_set(sinn_manager_t *m, fd_set *rfds, fd_set *wfds, fd_set *efds);
+///< mark the connections by the select result and handle all of them out of the lock, the sets of the failed select should be zero
+void sinn_mgr_handle_conns(sinn_manager_t *m, fd_set *rfds, fd_set *wfds, fd_set *efds);
+
 #endif /* __SINN_IF_CBS_H__ */
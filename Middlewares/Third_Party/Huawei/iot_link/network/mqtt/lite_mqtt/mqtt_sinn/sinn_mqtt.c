@@ -15,9 +15,11 @@ int sinn_mqtt_parser(sinn_buf_t *io, sinn_mqtt_msg_t *amm)
     int len = 0;
     int rem_len = 0;
 
-    len = mqtt_decode_fixhead(io->data, &amm->type, &amm->dup, (unsigned char *)&amm->qos, &amm->retained, &rem_len);
     if (io->len < 2)
         return MQTTPACKET_BUFFER_TOO_SHORT;
+    len = mqtt_decode_fixhead(io->data, &amm->type, &amm->dup, (unsigned char *)&amm->qos, &amm->retained, &rem_len);
+    if (io->len < len + rem_len)    ///< wait for the rest of the packet
+        return MQTTPACKET_BUFFER_TOO_SHORT;
 
     switch(amm->type)
     {
@@ -65,7 +67,9 @@ int sinn_mqtt_parser(sinn_buf_t *io, sinn_mqtt_msg_t *amm)
                 LINK_LOG_DEBUG("pub payload:%d %s\r\n", (int)amm->payloadlen, (char *)amm->payload);
                 for (i = 0; i < SINN_MQTT_BUILTIN_NUM; i++)
                 {
-                    if(amm->mqtt_data->messageHandlers[i].topicFilter && (memcmp(options.publish_head.topic, amm->mqtt_data->messageHandlers[i].topicFilter, options.publish_head.topic_len) == 0))
+                    if(amm->mqtt_data->messageHandlers[i].topicFilter && \
+                       (strlen(amm->mqtt_data->messageHandlers[i].topicFilter) == (size_t)options.publish_head.topic_len) && \
+                       (memcmp(options.publish_head.topic, amm->mqtt_data->messageHandlers[i].topicFilter, options.publish_head.topic_len) == 0))
                     {
                         amm->arg = amm->mqtt_data->messageHandlers[i].arg;
                         if(amm->mqtt_data->messageHandlers[i].efficient)
@@ -111,7 +115,7 @@ void sinn_mqtt_event_handler(sinn_connection_t *nc, int event, void *event_data)
                     break;
                 }
                 nc->user_handler(nc, EV_MQTT_BASE + amm.type, &amm);
-                memmove(nc->recv_buf.data, nc->recv_buf.data + len, nc->recv_buf.len);
+                memmove(nc->recv_buf.data, nc->recv_buf.data + len, nc->recv_buf.len - len);
                 nc->recv_buf.len -= len;
             }
             break;
@@ -139,12 +143,16 @@ int sinn_mqtt_connect(sinn_connection_t *nc, mqtt_connect_opt_t *options)
     data->keep_alive = options->connect_head.keep_alive;
     data->next_packetid = 1;
 
+    ///< the loop task takes the sent bytes out of the buffer meanwhile
+    (void) osal_mutex_lock(nc->mgr->lock);
     if ((len = mqtt_encode_connect((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len), options)) <= 0)
     {
+        (void) osal_mutex_unlock(nc->mgr->lock);
         LINK_LOG_DEBUG("mqtt connect error\r\n");
         return rc;
     }
     nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return 0;
@@ -155,9 +163,11 @@ int sinn_mqtt_ping(sinn_connection_t *nc)
     int len = 0;
     sinn_mqtt_proto_data_t *data;
     data = (sinn_mqtt_proto_data_t *)nc->proto_data;
+    (void) osal_mutex_lock(nc->mgr->lock);
     len = mqtt_encode_ping((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len));
     if (len > 0)
         nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return len;
@@ -168,9 +178,11 @@ int sinn_mqtt_disconnect(sinn_connection_t *nc)
     int len = 0;
     sinn_mqtt_proto_data_t *data;
     data = (sinn_mqtt_proto_data_t *)nc->proto_data;
+    (void) osal_mutex_lock(nc->mgr->lock);
     len = mqtt_encode_disconnect((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len));
     if (len > 0)
         nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return len;
@@ -185,9 +197,11 @@ int sinn_mqtt_publish(sinn_connection_t *nc, mqtt_publish_opt_t *options)
 
     if(options->qos)
         options->publish_head.packet_id = sinn_mqtt_packetid(nc);
+    (void) osal_mutex_lock(nc->mgr->lock);
     len = mqtt_encode_publish((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len), options);
     if (len > 0)
         nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return len;
@@ -208,9 +222,11 @@ int sinn_mqtt_subscribe(sinn_connection_t *nc, mqtt_subscribe_opt_t *options, si
         data->messageHandlers[i].arg = arg;
     }
 
+    (void) osal_mutex_lock(nc->mgr->lock);
     len = mqtt_encode_subscribe((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len), options);
     if (len > 0)
         nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return len;
@@ -222,9 +238,11 @@ int sinn_mqtt_puback(sinn_connection_t *nc, mqtt_puback_opt_t *options)
     sinn_mqtt_proto_data_t *data;
     data = (sinn_mqtt_proto_data_t *)nc->proto_data;
 
+    (void) osal_mutex_lock(nc->mgr->lock);
     len = mqtt_encode_puback((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len), options);
     if (len > 0)
         nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return len;
@@ -237,9 +255,11 @@ int sinn_mqtt_unsubscribe(sinn_connection_t *nc, mqtt_unsubscribe_opt_t *options
     data = (sinn_mqtt_proto_data_t *)nc->proto_data;
     options->unsubscribe_head.packet_id = sinn_mqtt_packetid(nc);
 
+    (void) osal_mutex_lock(nc->mgr->lock);
     len = mqtt_encode_unsubscribe((nc->send_buf.data + nc->send_buf.len), (nc->send_buf.size - nc->send_buf.len), options);
     if (len > 0)
         nc->send_buf.len += len;
+    (void) osal_mutex_unlock(nc->mgr->lock);
     data->last_time = sinn_gettime_ms();
 
     return len;
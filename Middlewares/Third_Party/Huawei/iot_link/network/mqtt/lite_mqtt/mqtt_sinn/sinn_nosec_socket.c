@@ -32,6 +32,7 @@
  * applicable export control laws and regulations.
  *---------------------------------------------------------------------------*/
 
+#include <string.h>
 #include "sal.h"
 #include "sinn_nosec_socket.h"
 #include "sinn_if_cbs.h"
@@ -49,6 +50,20 @@ static void __sinn_sock_uninit(sinn_if_t *interface)
 static int __sinn_sock_connect(sinn_connection_t *nc)
 {
     int rc = -1;
+    struct hostent *entry;
+
+    ///< the server maybe a domain name
+    entry = sal_gethostbyname(nc->server_ip);
+    if (!(entry && entry->h_addr_list[0] && (entry->h_addrtype == AF_INET)))
+    {
+        LINK_LOG_DEBUG("could not resolve %s\r\n", nc->server_ip);
+        nc->flags |= SINN_FG_RECONNECT;
+        return rc;
+    }
+    (void) memset(&nc->address, 0, sizeof(nc->address));
+    nc->address.sin_family = AF_INET;
+    (void) memcpy(&nc->address.sin_addr.s_addr, entry->h_addr_list[0], sizeof(nc->address.sin_addr.s_addr));
+    nc->address.sin_port = htons((uint16_t)nc->server_port);
 
     nc->sock_fd = sal_socket(AF_INET, SOCK_STREAM, 0);
     if (nc->sock_fd == -1)
@@ -62,6 +77,7 @@ static int __sinn_sock_connect(sinn_connection_t *nc)
     if(rc < 0)
     {
         LINK_LOG_DEBUG("sock %d rc %d \r\n",  nc->sock_fd, rc);
+        sal_dns_flush(nc->server_ip);    ///< the server may have moved, resolve it again next time
         nc->flags |= SINN_FG_RECONNECT;
         return rc;
     }
@@ -86,7 +102,7 @@ static void __sinn_sock_discon(sinn_connection_t *nc)
 }
 
 
-static sinn_time_t __sinn_sock_poll(sinn_connection_t *nc, int timeout_ms)
+static sinn_time_t __sinn_sock_poll(sinn_manager_t *m, int timeout_ms)
 {
     sinn_time_t now;
     fd_set rfds, wfds, efds;
@@ -94,36 +110,28 @@ static sinn_time_t __sinn_sock_poll(sinn_connection_t *nc, int timeout_ms)
     int max_fd = -1;
     int rc = 0;
 
-    FD_ZERO(&rfds);
-    FD_ZERO(&wfds);
-    FD_ZERO(&efds);
-
-    if(!(nc->flags & SINN_FG_RECONNECT))
-        FD_SET(nc->sock_fd, &rfds);
-    if(nc->send_buf.len > 0)
-    {
-        FD_SET(nc->sock_fd, &wfds);
-        FD_SET(nc->sock_fd, &efds);
-    }
-
-    max_fd = nc->sock_fd;
+    ///< all the connections go to one select
+    max_fd = sinn_mgr_fd_set(m, &rfds, &wfds, &efds);
 
     tv.tv_sec = timeout_ms / 1000;
     tv.tv_usec = (timeout_ms % 1000) * 1000;
 
-    rc = sal_select(max_fd + 1, &rfds, &wfds, &efds, &tv);
+    if(max_fd < 0)
+        osal_task_sleep(timeout_ms);
+    else
+        rc = sal_select(max_fd + 1, &rfds, &wfds, &efds, &tv);
     now = sinn_gettime_ms();
 
     if(rc == -1)
         LINK_LOG_DEBUG("select() error\r\n");
-    else if(rc > 0)
+    if(rc <= 0)
     {
-        if(FD_ISSET(nc->sock_fd, &rfds)) {nc->flags |= SINN_FG_CAN_RD;}
-        if(FD_ISSET(nc->sock_fd, &wfds)) {nc->flags |= SINN_FG_CAN_WR;}
-        if(FD_ISSET(nc->sock_fd, &efds)) {nc->flags |= SINN_FG_ERR;}
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        FD_ZERO(&efds);
     }
 
-    sinn_mgr_handle_conn(nc);
+    sinn_mgr_handle_conns(m, &rfds, &wfds, &efds);
 
     return now;
 }
@@ -36,6 +36,8 @@
 #include "sinn_sec_socket.h"
 #include "sinn_if_cbs.h"
 
+#ifdef WITH_DTLS   ///< the secure interface is built on the mbedtls, none without it
+
 static void __sinn_sock_init(sinn_if_t *interface)
 {
     (void)interface;
@@ -121,7 +123,7 @@ static void __sinn_sock_discon(sinn_connection_t *nc)
 }
 
 
-static sinn_time_t __sinn_sock_poll(sinn_connection_t *nc, int timeout_ms)
+static sinn_time_t __sinn_sock_poll(sinn_manager_t *m, int timeout_ms)
 {
     sinn_time_t now;
     fd_set rfds, wfds, efds;
@@ -129,39 +131,28 @@ static sinn_time_t __sinn_sock_poll(sinn_connection_t *nc, int timeout_ms)
     int max_fd = -1;
     int rc = 0;
 
-    FD_ZERO(&rfds);
-    FD_ZERO(&wfds);
-    FD_ZERO(&efds);
-
-    if(!(nc->flags & SINN_FG_RECONNECT))
-        FD_SET(nc->sock_fd, &rfds);
-    if(nc->send_buf.len > 0)
-    {
-        FD_SET(nc->sock_fd, &wfds);
-        FD_SET(nc->sock_fd, &efds);
-    }
-
-    max_fd = nc->sock_fd;
+    ///< all the connections go to one select
+    max_fd = sinn_mgr_fd_set(m, &rfds, &wfds, &efds);
 
     tv.tv_sec = timeout_ms / 1000;
     tv.tv_usec = (timeout_ms % 1000) * 1000;
 
-    rc = sal_select(max_fd + 1, &rfds, &wfds, &efds, &tv);
+    if(max_fd < 0)
+        osal_task_sleep(timeout_ms);
+    else
+        rc = sal_select(max_fd + 1, &rfds, &wfds, &efds, &tv);
     now = sinn_gettime_ms();
 
     if(rc == -1)
-    {
         LINK_LOG_DEBUG("select() error\r\n");
-        return 0;
-    }
-    else if(rc > 0)
+    if(rc <= 0)
     {
-        if(FD_ISSET(nc->sock_fd, &rfds)) {nc->flags |= SINN_FG_CAN_RD;}
-        if(FD_ISSET(nc->sock_fd, &wfds)) {nc->flags |= SINN_FG_CAN_WR;}
-        if(FD_ISSET(nc->sock_fd, &efds)) {nc->flags |= SINN_FG_ERR;}
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        FD_ZERO(&efds);
     }
 
-    sinn_mgr_handle_conn(nc);
+    sinn_mgr_handle_conns(m, &rfds, &wfds, &efds);
 
     return now;
 }
@@ -232,3 +223,5 @@ sinn_if_funcs_t sinn_sec_if =
     __sinn_sock_send,
     __sinn_sock_recv,
 };
+
+#endif
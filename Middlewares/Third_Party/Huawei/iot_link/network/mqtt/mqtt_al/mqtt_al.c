@@ -201,6 +201,19 @@ en_mqtt_al_connect_state mqtt_al_check_status(void *handle)
     return ret;
 }
 
+int mqtt_al_keepalive(void *handle)
+{
+
+    int ret = -1;
+
+    if((NULL != handle) && (NULL != s_mqtt_al_op_cb.ops) && (NULL != s_mqtt_al_op_cb.ops->keepalive))
+    {
+        ret = s_mqtt_al_op_cb.ops->keepalive(handle);
+    }
+
+    return ret;
+}
+
 
 
 
@@ -0,0 +1,23 @@
+#define CONFIG_LINUXOS_ENABLE 1
+#define CONFIG_LINKLOG_ENABLE 1
+#define CONFIG_TCPIP_AL_ENABLE 1
+#define CONFIG_LINUXSOCKET_ENABLE 1
+#define CONFIG_SAL_DNS_CACHE_SIZE 4
+#define CONFIG_SAL_DNS_CACHE_TTL 3600
+#define CONFIG_DTLS_AL_ENABLE 1
+#define CONFIG_MQTT_AL_ENABLE 1
+#define CONFIG_PAHO_MQTT 1
+#define CONFIG_PAHO_CONNECT_TIMEOUT 10000
+#define CONFIG_PAHO_CMD_TIMEOUT 10000
+#define CONFIG_PAHO_LOOPTIMEOUT 10
+#define CONFIG_PAHO_SNDBUF_SIZE 2048
+#define CONFIG_PAHO_RCVBUF_SIZE 2048
+#define CONFIG_LITE_MQTT 1
+#define CONFIG_IOT_LINK_CONFIGFILE "iot_config.h"
+
+///< the results go to the stdout one json line each, so the logs of the link go to the stderr
+#define link_printf(fmt, ...) \
+    do \
+    { \
+        fprintf(stderr, fmt, ##__VA_ARGS__); \
+    }while(0)
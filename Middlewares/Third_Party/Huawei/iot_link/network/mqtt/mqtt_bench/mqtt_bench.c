@@ -0,0 +1,478 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 22:05   The first version
+ *
+ */
+
+///< the benchmark of the mqtt implements behind the mqtt_al, on the linux host against the broker stub in
+///< the process; for each implement, payload size and qos it measures the connect time, the publish
+///< throughput, the round trip latency through the broker and the heap taken by the implement, and prints
+///< one json line for each case to the stdout, the logs and the progress go to the stderr; the throughput is
+///< of the publishes the broker received, and ok false means some publish failed or was lost, or some echo
+///< did not come back, which the error tells
+///<
+///< usage: mqtt_bench [-b paho,sinn] [-s 16,128,512] [-q 0,1] [-n publishes] [-r round trips]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <osal.h>
+#include <link_log.h>
+#include <mqtt_al.h>
+#include <linux_imp.h>
+#include <paho_mqtt_port.h>
+#include <mqtt_sinn_port.h>
+#include <mqtt_bench_broker.h>
+
+extern int link_main(void *args);
+
+#define CN_BENCH_LISTMAX        8
+#define CN_BENCH_TIMEOUT        5000       ///< ms, the longest wait for the connect, the ack or the echo
+#define CN_BENCH_SETTLE         200        ///< ms, for the implement to send the disconnect and to quit its tasks
+#define CN_BENCH_ECHO_TOPIC     "bench/echo"
+#define CN_BENCH_SINK_TOPIC     "bench/sink"   ///< nobody subscribes it, only the throughput
+
+typedef struct
+{
+    const char           *name;
+    int                 (*install)(void);
+}bench_backend_t;
+
+typedef struct
+{
+    const char           *backend;
+    int                   payload;
+    int                   qos;
+    int                   ok;
+    long long             connect_us;
+    int                   pub_ok;        ///< the publishes the implement took
+    int                   pub_rcvd;      ///< the publishes the broker received
+    double                pub_msgs_per_s;
+    int                   rtt_ok;
+    long long             rtt_p50_us;
+    long long             rtt_p90_us;
+    long long             rtt_p99_us;
+    long long             rtt_max_us;
+    size_t                heap_peak;
+    long long             heap_left;
+    const char           *error;
+}bench_result_t;
+
+typedef struct
+{
+    int                   port;
+    int                   pubs;
+    int                   rtts;
+    osal_semp_t           echo;        ///< lighted by each echo comes back
+    volatile unsigned int echoed;      ///< the sequence of the last echo
+    unsigned int          chunked;     ///< the sequence of the echo coming by chunks
+    unsigned char        *payload;
+    long long            *samples;
+}bench_cb_t;
+
+static bench_cb_t s_bench;
+
+static int __install_sinn(void)
+{
+    return mqtt_install_sinnmqtt();
+}
+
+static const bench_backend_t s_bench_backends[] =
+{
+    {"paho", mqtt_imp_init},
+    {"sinn", __install_sinn},
+};
+
+static long long __now_us(void)
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int __parse_list(const char *arg, int *list)
+{
+    char *end;
+    int num = 0;
+
+    while((num < CN_BENCH_LISTMAX) && ('\0' != *arg))
+    {
+        list[num++] = (int)strtol(arg, &end, 10);
+        if((end == arg) || (('\0' != *end) && (',' != *end)))
+        {
+            return -1;
+        }
+        arg = ('\0' == *end) ? end : end + 1;
+    }
+
+    return num;
+}
+
+static int __cmp_sample(const void *a, const void *b)
+{
+    long long diff = *(const long long *)a - *(const long long *)b;
+
+    return (diff > 0) - (diff < 0);
+}
+
+///< the sinn engine gives no arg to the dealer, so the state is global
+static void __echo_dealer(void *arg, mqtt_al_msgrcv_t *msg)
+{
+    unsigned int seq;
+
+    (void) arg;
+    if(msg->msg.len >= (int)sizeof(seq))
+    {
+        (void) memcpy(&seq, msg->msg.data, sizeof(seq));
+        s_bench.echoed = seq;
+        (void) osal_semp_post(s_bench.echo);
+    }
+}
+
+///< the echo larger than the receive buffer of the implement comes piece by piece, counted by the last
+static void __echo_chunk_dealer(void *arg, mqtt_al_msgrcv_t *msg)
+{
+    (void) arg;
+    if((0 == msg->offset) && (msg->msg.len >= (int)sizeof(s_bench.chunked)))
+    {
+        (void) memcpy(&s_bench.chunked, msg->msg.data, sizeof(s_bench.chunked));
+    }
+    if((msg->offset + msg->msg.len) >= msg->total)
+    {
+        s_bench.echoed = s_bench.chunked;
+        (void) osal_semp_post(s_bench.echo);
+    }
+}
+
+static int __publish(void *handle, const char *topic, int payload, int qos)
+{
+    mqtt_al_pubpara_t pubpara;
+
+    (void) memset(&pubpara, 0, sizeof(pubpara));
+    pubpara.topic.data = (char *)topic;
+    pubpara.topic.len = strlen(topic);
+    pubpara.msg.data = (char *)s_bench.payload;
+    pubpara.msg.len = payload;
+    pubpara.qos = (en_mqtt_al_qos_t)qos;
+    pubpara.timeout = CN_BENCH_TIMEOUT;
+
+    return mqtt_al_publish(handle, &pubpara);
+}
+
+///< wait for the broker having received num publishes more than base, return how many and when the last came
+static int __wait_received(unsigned int base, int num, long long *last_us)
+{
+    long long deadline = __now_us() + CN_BENCH_TIMEOUT * 1000LL;
+    unsigned int received;
+
+    while(((int)((received = bench_broker_received(last_us)) - base) < num) && (__now_us() < deadline))
+    {
+        osal_task_sleep(1);
+    }
+
+    return (int)(received - base);
+}
+
+static int __wait_echo(unsigned int seq)
+{
+    long long deadline = __now_us() + CN_BENCH_TIMEOUT * 1000LL;
+    long long left;
+
+    while(s_bench.echoed != seq)   ///< the late echo of the one lost before is passed over
+    {
+        left = deadline - __now_us();
+        if((left <= 0) || (false == osal_semp_pend(s_bench.echo, (unsigned int)(left / 1000) + 1)))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void __bench_case(bench_result_t *result)
+{
+    mqtt_al_conpara_t conpara;
+    mqtt_al_subpara_t subpara;
+    mqtt_al_unsubpara_t unsubpara;
+    void *handle;
+    size_t used_base;
+    size_t used;
+    long long start;
+    long long last;
+    unsigned int base;
+    unsigned int seq;
+    int i;
+
+    (void) memset(&conpara, 0, sizeof(conpara));
+    conpara.serveraddr.data = "127.0.0.1";
+    conpara.serveraddr.len = strlen(conpara.serveraddr.data);
+    conpara.serverport = s_bench.port;
+    conpara.version = en_mqtt_al_version_3_1_1;
+    conpara.clientid.data = "mqtt_bench";
+    conpara.clientid.len = strlen(conpara.clientid.data);
+    conpara.user.data = "bench";
+    conpara.user.len = strlen(conpara.user.data);
+    conpara.passwd.data = "bench";
+    conpara.passwd.len = strlen(conpara.passwd.data);
+    conpara.cleansession = 1;
+    conpara.keepalivetime = 60;
+    conpara.timeout = CN_BENCH_TIMEOUT;
+    conpara.chunk_dealer = __echo_chunk_dealer;
+
+    ///< the heap the implement keeps after the first connect(such as the task and the manager of the sinn)
+    ///< shows as the heap_left of the first case of it
+    linux_mem_stat(&used_base, NULL);
+    linux_mem_peak_reset();
+
+    start = __now_us();
+    handle = mqtt_al_connect(&conpara);
+    result->connect_us = __now_us() - start;
+    if((NULL == handle) || (cn_mqtt_al_con_code_ok != conpara.conret))
+    {
+        result->error = "connect";
+        goto EXIT_STAT;
+    }
+
+    (void) memset(&subpara, 0, sizeof(subpara));
+    subpara.topic.data = CN_BENCH_ECHO_TOPIC;
+    subpara.topic.len = strlen(subpara.topic.data);
+    subpara.qos = (en_mqtt_al_qos_t)result->qos;
+    subpara.dealer = __echo_dealer;
+    subpara.timeout = CN_BENCH_TIMEOUT;
+    if(0 != mqtt_al_subscribe(handle, &subpara))
+    {
+        result->error = "subscribe";
+        goto EXIT_DISCONNECT;
+    }
+
+    ///< the throughput: the qos1 publish waits for its ack before the next one, while the qos0 ones queued
+    ///< by the implement count when the broker gets them, so the failed ones never make the rate higher
+    fprintf(stderr, "mqtt_bench: %s payload %d qos %d: %d publishes\n", result->backend, result->payload,
+            result->qos, s_bench.pubs);
+    base = bench_broker_received(NULL);
+    start = __now_us();
+    for(i = 0; i < s_bench.pubs; i++)
+    {
+        if(0 == __publish(handle, CN_BENCH_SINK_TOPIC, result->payload, result->qos))
+        {
+            result->pub_ok++;
+        }
+    }
+    result->pub_rcvd = __wait_received(base, result->pub_ok, &last);
+    if(result->pub_rcvd > 0)
+    {
+        result->pub_msgs_per_s = (double)result->pub_rcvd * 1000000.0 / (double)(last - start + 1);
+    }
+    if(result->pub_ok < s_bench.pubs)
+    {
+        result->error = "publish";
+    }
+    else if(result->pub_rcvd < result->pub_ok)
+    {
+        result->error = "lost";
+    }
+
+    ///< the round trip: publish to the topic subscribed and wait for it coming back through the broker
+    fprintf(stderr, "mqtt_bench: %s payload %d qos %d: %d round trips\n", result->backend, result->payload,
+            result->qos, s_bench.rtts);
+    for(i = 0; i < s_bench.rtts; i++)
+    {
+        seq = s_bench.echoed + 1;
+        (void) memcpy(s_bench.payload, &seq, sizeof(seq));
+        start = __now_us();
+        if((0 == __publish(handle, CN_BENCH_ECHO_TOPIC, result->payload, result->qos)) && (0 == __wait_echo(seq)))
+        {
+            s_bench.samples[result->rtt_ok++] = __now_us() - start;
+        }
+    }
+    if(result->rtt_ok > 0)
+    {
+        qsort(s_bench.samples, result->rtt_ok, sizeof(s_bench.samples[0]), __cmp_sample);
+        result->rtt_p50_us = s_bench.samples[(result->rtt_ok - 1) * 50 / 100];
+        result->rtt_p90_us = s_bench.samples[(result->rtt_ok - 1) * 90 / 100];
+        result->rtt_p99_us = s_bench.samples[(result->rtt_ok - 1) * 99 / 100];
+        result->rtt_max_us = s_bench.samples[result->rtt_ok - 1];
+    }
+    if((NULL == result->error) && (result->rtt_ok < s_bench.rtts))
+    {
+        result->error = "echo";
+    }
+
+    (void) memset(&unsubpara, 0, sizeof(unsubpara));
+    unsubpara.topic = subpara.topic;
+    unsubpara.timeout = CN_BENCH_TIMEOUT;
+    (void) mqtt_al_unsubscribe(handle, &unsubpara);
+
+EXIT_DISCONNECT:
+    (void) mqtt_al_disconnect(handle);
+    osal_task_sleep(CN_BENCH_SETTLE);
+EXIT_STAT:
+    linux_mem_stat(&used, &result->heap_peak);
+    result->heap_peak -= used_base;
+    result->heap_left = (long long)used - (long long)used_base;
+    result->ok = (NULL == result->error);
+}
+
+static void __print_result(const bench_result_t *result)
+{
+    printf("{\"backend\":\"%s\",\"payload\":%d,\"qos\":%d,\"connect_us\":%lld,\"pub_msgs\":%d,\"pub_ok\":%d,"
+           "\"pub_rcvd\":%d,\"pub_msgs_per_s\":%.1f,\"rtt_msgs\":%d,\"rtt_ok\":%d,\"rtt_p50_us\":%lld,\"rtt_p90_us\":%lld,"
+           "\"rtt_p99_us\":%lld,\"rtt_max_us\":%lld,\"heap_peak\":%zu,\"heap_left\":%lld,\"ok\":%s",
+           result->backend, result->payload, result->qos, result->connect_us, s_bench.pubs, result->pub_ok,
+           result->pub_rcvd, result->pub_msgs_per_s, s_bench.rtts, result->rtt_ok, result->rtt_p50_us, result->rtt_p90_us,
+           result->rtt_p99_us, result->rtt_max_us, result->heap_peak, result->heap_left,
+           result->ok ? "true" : "false");
+    if(NULL != result->error)
+    {
+        printf(",\"error\":\"%s\"", result->error);
+    }
+    printf("}\n");
+    (void) fflush(stdout);
+}
+
+static void __usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-b paho,sinn] [-s 16,128,512] [-q 0,1] [-n publishes] [-r round trips]\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *backends = "paho,sinn";
+    int payloads[CN_BENCH_LISTMAX] = {16, 128, 512};
+    int qoss[CN_BENCH_LISTMAX] = {0, 1};
+    int payload_num = 3;
+    int qos_num = 2;
+    int payload_max = 0;
+    bench_result_t result;
+    int failed = 0;
+    int opt;
+    int b;
+    int p;
+    int q;
+
+    s_bench.pubs = 100;     ///< the sinn polls each 100 ms, and its qos1 case takes 15 s with these
+    s_bench.rtts = 50;
+    while(-1 != (opt = getopt(argc, argv, "b:s:q:n:r:h")))
+    {
+        switch(opt)
+        {
+            case 'b':
+                backends = optarg;
+                break;
+            case 's':
+                payload_num = __parse_list(optarg, payloads);
+                break;
+            case 'q':
+                qos_num = __parse_list(optarg, qoss);
+                break;
+            case 'n':
+                s_bench.pubs = atoi(optarg);
+                break;
+            case 'r':
+                s_bench.rtts = atoi(optarg);
+                break;
+            default:
+                __usage(argv[0]);
+                return 2;
+        }
+    }
+    for(p = 0; p < payload_num; p++)
+    {
+        if((payloads[p] < (int)sizeof(unsigned int)) || (payloads[p] > 1024 * 1024))
+        {
+            payload_num = -1;
+            break;
+        }
+        payload_max = (payloads[p] > payload_max) ? payloads[p] : payload_max;
+    }
+    for(q = 0; q < qos_num; q++)
+    {
+        qos_num = ((qoss[q] < en_mqtt_al_qos_0) || (qoss[q] > en_mqtt_al_qos_2)) ? -1 : qos_num;
+    }
+    if((payload_num <= 0) || (qos_num <= 0) || (s_bench.pubs < 0) || (s_bench.rtts < 0))
+    {
+        __usage(argv[0]);
+        return 2;
+    }
+
+    (void) signal(SIGPIPE, SIG_IGN);    ///< the peer closed comes as the error of the send
+    (void) link_main(NULL);
+    (void) link_log_level_set(EN_LINK_LOG_LEVEL_WARN);
+
+    s_bench.payload = malloc(payload_max);
+    s_bench.samples = malloc(sizeof(long long) * (s_bench.rtts + 1));
+    if((NULL == s_bench.payload) || (NULL == s_bench.samples) || \
+       (false == osal_semp_create(&s_bench.echo, 0x7fff, 0)) || (0 != bench_broker_start(&s_bench.port)))
+    {
+        fprintf(stderr, "mqtt_bench: could not start\n");
+        return 1;
+    }
+    (void) memset(s_bench.payload, 'b', payload_max);
+
+    for(b = 0; b < (int)(sizeof(s_bench_backends) / sizeof(s_bench_backends[0])); b++)
+    {
+        if(NULL == strstr(backends, s_bench_backends[b].name))
+        {
+            continue;
+        }
+        (void) mqtt_al_uninstall();
+        (void) s_bench_backends[b].install();
+        for(p = 0; p < payload_num; p++)
+        {
+            for(q = 0; q < qos_num; q++)
+            {
+                (void) memset(&result, 0, sizeof(result));
+                result.backend = s_bench_backends[b].name;
+                result.payload = payloads[p];
+                result.qos = qoss[q];
+                __bench_case(&result);
+                __print_result(&result);
+                failed |= !result.ok;
+            }
+        }
+    }
+
+    bench_broker_stop();
+
+    return failed ? 1 : 0;
+}
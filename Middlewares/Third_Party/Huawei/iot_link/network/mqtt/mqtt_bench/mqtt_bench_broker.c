@@ -0,0 +1,601 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 22:05   The first version
+ *
+ */
+
+///< the broker stub runs on the posix sockets and the libc heap directly, so nothing of it is counted
+///< in the heap or the time of the mqtt engine measured
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include <mqtt_bench_broker.h>
+
+#define CN_BROKER_CLIENTS       8
+#define CN_BROKER_SUBS          8
+#define CN_BROKER_TOPICLEN      64
+#define CN_BROKER_PACKETMAX     (1024*1024)    ///< the larger packet closes the client
+
+#define CN_MQTT_CONNECT         1
+#define CN_MQTT_PUBLISH         3
+#define CN_MQTT_PUBACK          4
+#define CN_MQTT_PUBREC          5
+#define CN_MQTT_PUBREL          6
+#define CN_MQTT_PUBCOMP         7
+#define CN_MQTT_SUBSCRIBE       8
+#define CN_MQTT_UNSUBSCRIBE     10
+#define CN_MQTT_PINGREQ         12
+#define CN_MQTT_DISCONNECT      14
+
+typedef struct
+{
+    char             topic[CN_BROKER_TOPICLEN];
+    int              qos;                ///< -1 means free
+}broker_sub_t;
+
+typedef struct
+{
+    int              fd;                 ///< -1 means free
+    pthread_mutex_t  wlock;              ///< the acks of its own and the forwarded publishes
+    unsigned short   nextid;             ///< for the forwarded qos1/2 publishes
+    broker_sub_t     subs[CN_BROKER_SUBS];
+}broker_client_t;
+
+typedef struct
+{
+    int              fd;
+    pthread_t        acceptor;
+    pthread_mutex_t  lock;               ///< the clients and their subscriptions
+    int              running;
+    int              active;             ///< the client tasks not quit yet
+    unsigned int     received;           ///< the publishes received from all the clients
+    long long        received_us;        ///< when the last one was received
+    broker_client_t  clients[CN_BROKER_CLIENTS];
+}broker_cb_t;
+
+static broker_cb_t s_broker =
+{
+    .fd = -1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static int __read_full(int fd, uint8_t *buf, int len)
+{
+    int ret;
+    int done = 0;
+
+    while(done < len)
+    {
+        ret = recv(fd, buf + done, len - done, 0);
+        if(ret <= 0)
+        {
+            return -1;
+        }
+        done += ret;
+    }
+
+    return 0;
+}
+
+static int __write_full(broker_client_t *client, const uint8_t *buf, int len)
+{
+    int ret;
+    int done = 0;
+
+    (void) pthread_mutex_lock(&client->wlock);
+    while(done < len)
+    {
+        ret = send(client->fd, buf + done, len - done, MSG_NOSIGNAL);
+        if(ret <= 0)
+        {
+            break;
+        }
+        done += ret;
+    }
+    (void) pthread_mutex_unlock(&client->wlock);
+
+    return (done == len) ? 0 : -1;
+}
+
+static int __encode_len(uint8_t *buf, int len)
+{
+    int n = 0;
+
+    do
+    {
+        buf[n] = len % 128;
+        len /= 128;
+        if(len > 0)
+        {
+            buf[n] |= 0x80;
+        }
+        n++;
+    }while(len > 0);
+
+    return n;
+}
+
+///< the acks are all the same: the type, the length 2 and the packet id
+static int __send_ack(broker_client_t *client, uint8_t head, const uint8_t *id)
+{
+    uint8_t ack[4];
+
+    ack[0] = head;
+    ack[1] = 2;
+    ack[2] = id[0];
+    ack[3] = id[1];
+
+    return __write_full(client, ack, sizeof(ack));
+}
+
+static int __read_packet(int fd, uint8_t *head, uint8_t **body, int *len)
+{
+    uint8_t byte;
+    int mul = 1;
+    int i;
+
+    *len = 0;
+    if(0 != __read_full(fd, head, 1))
+    {
+        return -1;
+    }
+    for(i = 0; i < 4; i++)
+    {
+        if(0 != __read_full(fd, &byte, 1))
+        {
+            return -1;
+        }
+        *len += (byte & 0x7f) * mul;
+        mul *= 128;
+        if(0 == (byte & 0x80))
+        {
+            break;
+        }
+    }
+    if((i == 4) || (*len > CN_BROKER_PACKETMAX))
+    {
+        return -1;
+    }
+    *body = malloc(*len + 1);
+    if(NULL == *body)
+    {
+        return -1;
+    }
+    if((*len > 0) && (0 != __read_full(fd, *body, *len)))
+    {
+        free(*body);
+        return -1;
+    }
+
+    return 0;
+}
+
+///< forward to the exact topic subscribers, with the lower qos of the publish and the subscription
+static void __forward(const uint8_t *topic, int topiclen, const uint8_t *payload, int payloadlen, int qos)
+{
+    broker_client_t *client;
+    uint8_t *packet;
+    int fwdqos;
+    int len;
+    int i;
+    int j;
+
+    packet = malloc(5 + 2 + topiclen + 2 + payloadlen);
+    if(NULL == packet)
+    {
+        return;
+    }
+    (void) pthread_mutex_lock(&s_broker.lock);
+    for(i = 0; i < CN_BROKER_CLIENTS; i++)
+    {
+        client = &s_broker.clients[i];
+        for(j = 0; (client->fd != -1) && (j < CN_BROKER_SUBS); j++)
+        {
+            if((client->subs[j].qos < 0) || (strlen(client->subs[j].topic) != (size_t)topiclen) || \
+               (0 != memcmp(client->subs[j].topic, topic, topiclen)))
+            {
+                continue;
+            }
+            fwdqos = (qos < client->subs[j].qos) ? qos : client->subs[j].qos;
+            packet[0] = (CN_MQTT_PUBLISH << 4) | (fwdqos << 1);
+            len = __encode_len(&packet[1], 2 + topiclen + ((fwdqos > 0) ? 2 : 0) + payloadlen) + 1;
+            packet[len++] = topiclen >> 8;
+            packet[len++] = topiclen & 0xff;
+            (void) memcpy(&packet[len], topic, topiclen);
+            len += topiclen;
+            if(fwdqos > 0)
+            {
+                if(0 == ++client->nextid)
+                {
+                    client->nextid = 1;
+                }
+                packet[len++] = client->nextid >> 8;
+                packet[len++] = client->nextid & 0xff;
+            }
+            (void) memcpy(&packet[len], payload, payloadlen);
+            len += payloadlen;
+            (void) __write_full(client, packet, len);
+            break;   ///< one copy for each client
+        }
+    }
+    (void) pthread_mutex_unlock(&s_broker.lock);
+    free(packet);
+}
+
+static int __deal_connect(broker_client_t *client, const uint8_t *body, int len)
+{
+    uint8_t connack[4] = {0x20, 2, 0, 0};     ///< the connack(2) accepted
+    int namelen;
+    int level = -1;
+
+    if(len >= 2)
+    {
+        namelen = (body[0] << 8) | body[1];
+        if(len > 2 + namelen)
+        {
+            level = body[2 + namelen];
+        }
+    }
+    connack[3] = (4 == level) ? 0 : 1;   ///< 1 refuses the protocol level not supported
+
+    if((0 != __write_full(client, connack, sizeof(connack))) || (0 != connack[3]))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int __deal_publish(broker_client_t *client, uint8_t head, const uint8_t *body, int len)
+{
+    int qos = (head >> 1) & 0x03;
+    int topiclen;
+    int offset;
+    struct timespec ts;
+
+    if(len < 2)
+    {
+        return -1;
+    }
+    topiclen = (body[0] << 8) | body[1];
+    offset = 2 + topiclen + ((qos > 0) ? 2 : 0);
+    if((offset > len) || (qos > 2))
+    {
+        return -1;
+    }
+    __forward(&body[2], topiclen, &body[offset], len - offset, qos);
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    (void) pthread_mutex_lock(&s_broker.lock);
+    s_broker.received++;
+    s_broker.received_us = (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    (void) pthread_mutex_unlock(&s_broker.lock);
+
+    if(1 == qos)
+    {
+        return __send_ack(client, CN_MQTT_PUBACK << 4, &body[2 + topiclen]);
+    }
+    else if(2 == qos)
+    {
+        return __send_ack(client, CN_MQTT_PUBREC << 4, &body[2 + topiclen]);
+    }
+
+    return 0;
+}
+
+static int __deal_subscribe(broker_client_t *client, const uint8_t *body, int len, int subscribe)
+{
+    uint8_t *ack;
+    int acklen = 0;
+    int offset = 2;
+    int topiclen;
+    int ret;
+    int i;
+
+    if(len < 2)
+    {
+        return -1;
+    }
+    ack = malloc(5 + len);
+    if(NULL == ack)
+    {
+        return -1;
+    }
+    (void) pthread_mutex_lock(&s_broker.lock);
+    while(offset + 2 <= len)
+    {
+        topiclen = (body[offset] << 8) | body[offset + 1];
+        offset += 2;
+        if(offset + topiclen + (subscribe ? 1 : 0) > len)
+        {
+            break;
+        }
+        for(i = 0; i < CN_BROKER_SUBS; i++)   ///< drop the old one of the topic
+        {
+            if((client->subs[i].qos >= 0) && (strlen(client->subs[i].topic) == (size_t)topiclen) && \
+               (0 == memcmp(client->subs[i].topic, &body[offset], topiclen)))
+            {
+                client->subs[i].qos = -1;
+            }
+        }
+        if(subscribe)
+        {
+            for(i = 0; (i < CN_BROKER_SUBS) && (client->subs[i].qos >= 0); i++);
+            if((i < CN_BROKER_SUBS) && (topiclen < CN_BROKER_TOPICLEN) && (body[offset + topiclen] <= 2))
+            {
+                (void) memcpy(client->subs[i].topic, &body[offset], topiclen);
+                client->subs[i].topic[topiclen] = '\0';
+                client->subs[i].qos = body[offset + topiclen];
+                ack[4 + acklen++] = client->subs[i].qos;   ///< grant what it asks
+            }
+            else
+            {
+                ack[4 + acklen++] = 0x80;
+            }
+            offset++;
+        }
+        offset += topiclen;
+    }
+    (void) pthread_mutex_unlock(&s_broker.lock);
+
+    ///< the suback(9) or the unsuback(11), with the packet id of the request
+    ack[0] = subscribe ? 0x90 : 0xb0;
+    ack[1] = 2 + acklen;
+    ack[2] = body[0];
+    ack[3] = body[1];
+    ret = __write_full(client, ack, 4 + acklen);
+    free(ack);
+
+    return ret;
+}
+
+static int __deal_packet(broker_client_t *client, uint8_t head, const uint8_t *body, int len)
+{
+    int ret = 0;
+
+    switch(head >> 4)
+    {
+        case CN_MQTT_CONNECT:
+            ret = __deal_connect(client, body, len);
+            break;
+        case CN_MQTT_PUBLISH:
+            ret = __deal_publish(client, head, body, len);
+            break;
+        case CN_MQTT_PUBREC:       ///< the forwarded qos2 publish goes on
+            ret = (len >= 2) ? __send_ack(client, (CN_MQTT_PUBREL << 4) | 0x02, body) : -1;
+            break;
+        case CN_MQTT_PUBREL:
+            ret = (len >= 2) ? __send_ack(client, CN_MQTT_PUBCOMP << 4, body) : -1;
+            break;
+        case CN_MQTT_PUBACK:
+        case CN_MQTT_PUBCOMP:
+            break;
+        case CN_MQTT_SUBSCRIBE:
+            ret = __deal_subscribe(client, body, len, 1);
+            break;
+        case CN_MQTT_UNSUBSCRIBE:
+            ret = __deal_subscribe(client, body, len, 0);
+            break;
+        case CN_MQTT_PINGREQ:
+            {
+                uint8_t pingresp[2] = {0xd0, 0};
+                ret = __write_full(client, pingresp, sizeof(pingresp));
+            }
+            break;
+        case CN_MQTT_DISCONNECT:
+        default:
+            ret = -1;
+            break;
+    }
+
+    return ret;
+}
+
+static void *__client_entry(void *arg)
+{
+    broker_client_t *client = arg;
+    uint8_t head;
+    uint8_t *body;
+    int len;
+    int i;
+
+    while(0 == __read_packet(client->fd, &head, &body, &len))
+    {
+        i = __deal_packet(client, head, body, len);
+        free(body);
+        if(0 != i)
+        {
+            break;
+        }
+    }
+
+    (void) pthread_mutex_lock(&s_broker.lock);
+    (void) close(client->fd);
+    client->fd = -1;
+    s_broker.active--;
+    (void) pthread_mutex_unlock(&s_broker.lock);
+
+    return NULL;
+}
+
+static void *__accept_entry(void *arg)
+{
+    broker_client_t *client;
+    pthread_t task;
+    int fd;
+    int on = 1;
+    int i;
+
+    (void) arg;
+    while(s_broker.running)
+    {
+        fd = accept(s_broker.fd, NULL, NULL);
+        if(fd < 0)
+        {
+            continue;
+        }
+        (void) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        (void) pthread_mutex_lock(&s_broker.lock);
+        for(i = 0; (i < CN_BROKER_CLIENTS) && (s_broker.clients[i].fd != -1); i++);
+        if((i == CN_BROKER_CLIENTS) || (0 == s_broker.running))
+        {
+            (void) pthread_mutex_unlock(&s_broker.lock);
+            (void) close(fd);
+            continue;
+        }
+        client = &s_broker.clients[i];
+        client->fd = fd;
+        client->nextid = 0;
+        for(i = 0; i < CN_BROKER_SUBS; i++)
+        {
+            client->subs[i].qos = -1;
+        }
+        if(0 == pthread_create(&task, NULL, __client_entry, client))
+        {
+            (void) pthread_detach(task);
+            s_broker.active++;
+        }
+        else
+        {
+            (void) close(fd);
+            client->fd = -1;
+        }
+        (void) pthread_mutex_unlock(&s_broker.lock);
+    }
+
+    return NULL;
+}
+
+int bench_broker_start(int *port)
+{
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    int i;
+
+    if(-1 != s_broker.fd)
+    {
+        return -1;
+    }
+    for(i = 0; i < CN_BROKER_CLIENTS; i++)
+    {
+        s_broker.clients[i].fd = -1;
+        (void) pthread_mutex_init(&s_broker.clients[i].wlock, NULL);
+    }
+
+    s_broker.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(s_broker.fd < 0)
+    {
+        return -1;
+    }
+    (void) memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if((0 != bind(s_broker.fd, (struct sockaddr *)&addr, sizeof(addr))) || (0 != listen(s_broker.fd, 8)) || \
+       (0 != getsockname(s_broker.fd, (struct sockaddr *)&addr, &addrlen)))
+    {
+        goto EXIT_SOCKET;
+    }
+    s_broker.running = 1;
+    if(0 != pthread_create(&s_broker.acceptor, NULL, __accept_entry, NULL))
+    {
+        s_broker.running = 0;
+        goto EXIT_SOCKET;
+    }
+    *port = ntohs(addr.sin_port);
+
+    return 0;
+
+EXIT_SOCKET:
+    (void) close(s_broker.fd);
+    s_broker.fd = -1;
+    return -1;
+}
+
+unsigned int bench_broker_received(long long *last_us)
+{
+    unsigned int ret;
+
+    (void) pthread_mutex_lock(&s_broker.lock);
+    ret = s_broker.received;
+    if(NULL != last_us)
+    {
+        *last_us = s_broker.received_us;
+    }
+    (void) pthread_mutex_unlock(&s_broker.lock);
+
+    return ret;
+}
+
+void bench_broker_stop(void)
+{
+    int i;
+
+    if(-1 == s_broker.fd)
+    {
+        return;
+    }
+    s_broker.running = 0;
+    (void) shutdown(s_broker.fd, SHUT_RDWR);    ///< wake up the accept
+    (void) pthread_join(s_broker.acceptor, NULL);
+    (void) close(s_broker.fd);
+    s_broker.fd = -1;
+
+    (void) pthread_mutex_lock(&s_broker.lock);
+    for(i = 0; i < CN_BROKER_CLIENTS; i++)
+    {
+        if(-1 != s_broker.clients[i].fd)
+        {
+            (void) shutdown(s_broker.clients[i].fd, SHUT_RDWR);
+        }
+    }
+    (void) pthread_mutex_unlock(&s_broker.lock);
+
+    for(i = 0; (i < 1000) && (s_broker.active > 0); i++)   ///< the client tasks close their own socket
+    {
+        (void) usleep(1000);
+    }
+}
@@ -0,0 +1,67 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 22:05   The first version
+ *
+ */
+#ifndef LITEOS_LAB_IOT_LINK_NETWORK_MQTT_MQTT_BENCH_MQTT_BENCH_BROKER_H_
+#define LITEOS_LAB_IOT_LINK_NETWORK_MQTT_MQTT_BENCH_MQTT_BENCH_BROKER_H_
+
+/**
+ * @brief:start the broker stub in the process, which listens on the loop back only; it speaks the
+ *        mqtt 3.1.1: the connect, the publish of qos 0/1/2 forwarded to the exact topic subscribers,
+ *        the subscribe, the unsubscribe, the ping and the disconnect, no wildcard, no retain, no session
+ *
+ * @param[out]:port, the port it listens on, chosen by the system
+ *
+ * @return:0 success while -1 failed
+ * */
+int bench_broker_start(int *port);
+
+/**
+ * @brief:how many publishes the stub has received from all the clients since started
+ *
+ * @param[out]:last_us, when the last one was received, in us of the CLOCK_MONOTONIC, could be NULL
+ *
+ * @return:the publishes received
+ * */
+unsigned int bench_broker_received(long long *last_us);
+
+/**
+ * @brief:stop the broker stub, and close all the clients still connected
+ * */
+void bench_broker_stop(void);
+
+#endif /* LITEOS_LAB_IOT_LINK_NETWORK_MQTT_MQTT_BENCH_MQTT_BENCH_BROKER_H_ */
@@ -0,0 +1,7 @@
+#ifndef __TIMEVAL_H__
+#define __TIMEVAL_H__
+
+///< the host has the struct timeval in its own headers, this only stands for the one of the mcu project
+#include <sys/time.h>
+
+#endif
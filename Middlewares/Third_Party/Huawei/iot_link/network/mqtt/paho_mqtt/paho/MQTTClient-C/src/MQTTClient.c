@@ -23,8 +23,192 @@ static void NewMessageData(MessageData* md, MQTTString* aTopicName, MQTTMessage*
 }
 
 
+static int findInflight(MQTTClient *c, unsigned short id) {
+    int i;
+
+    for (i = 0; i < MAX_INFLIGHT_PUBLISH; ++i)
+    {
+        if (c->inflight[i].wait != 0 && c->inflight[i].id == id)
+            return i;
+    }
+    return -1;
+}
+
+
 static int getNextPacketId(MQTTClient *c) {
-    return c->next_packetid = (c->next_packetid == MAX_PACKET_ID) ? 1 : c->next_packetid + 1;
+    do   ///< --modified,never reuse the id still in flight
+        c->next_packetid = (c->next_packetid == MAX_PACKET_ID) ? 1 : c->next_packetid + 1;
+    while (c->inflight_count > 0 && findInflight(c, c->next_packetid) >= 0);
+    return c->next_packetid;
+}
+
+
+static void completeInflight(MQTTClient *c, int i, int rc) {
+    publishDone done = c->inflight[i].done;
+    void* arg = c->inflight[i].arg;
+
+    MQTTFree(c->inflight[i].packet);
+    memset(&c->inflight[i], 0, sizeof(c->inflight[i]));
+    c->inflight_count--;
+    if (done != NULL)
+        done(arg, rc);
+}
+
+
+/* --modified,record the serialized publish in the buf to the slot, for the retransmission */
+static int keepInflight(MQTTClient *c, MQTTInflight* slot, MQTTMessage* message, int len, publishDone done, void* arg) {
+    if ((slot->packet = MQTTMalloc(len)) == NULL)
+        return BUFFER_OVERFLOW;
+    memcpy(slot->packet, c->buf, len);
+    slot->len = len;
+    slot->id = message->id;
+    slot->wait = (message->qos == QOS1) ? PUBACK : PUBREC;
+    slot->seq = ++c->inflight_seq;
+    slot->done = done;
+    slot->arg = arg;
+    c->inflight_count++;
+    return MQTT_SUCCESS;
+}
+
+
+/* --modified,the properties to serialize with, NULL before MQTT 5 */
+static MQTTProperties* versionProps(MQTTClient *c, MQTTProperties* props) {
+    MQTTProperties empty = MQTTProperties_initializer;
+
+    *props = empty;
+    return (c->MQTTVersion >= 5) ? props : NULL;
+}
+
+
+/* --modified,the aliases are set up again in each connection */
+static void clearAliases(MQTTClient *c) {
+    int i;
+
+    for (i = 0; i < MAX_TOPIC_ALIAS; ++i)
+    {
+        MQTTFree(c->aliases[i].topic);
+        c->aliases[i].topic = NULL;
+        c->aliases[i].used = 0;
+    }
+}
+
+
+/* --modified,the alias of the topic, taking the free or the least recently used one when not set
+ * up yet(*known 0); 0 when the server takes none or no memory */
+static int takeAlias(MQTTClient *c, const char* topicName, int* known) {
+    int n = (c->topicAliasMax < MAX_TOPIC_ALIAS) ? c->topicAliasMax : MAX_TOPIC_ALIAS;
+    int i, slot = -1;
+    size_t len = strlen(topicName);
+
+    *known = 0;
+    for (i = 0; i < n; ++i)
+    {
+        if (c->aliases[i].topic != NULL && strcmp(c->aliases[i].topic, topicName) == 0)
+        {
+            c->aliases[i].used = ++c->alias_seq;
+            *known = 1;
+            return i + 1;
+        }
+        if (slot < 0 || (c->aliases[slot].topic != NULL && (c->aliases[i].topic == NULL ||
+            c->alias_seq - c->aliases[i].used > c->alias_seq - c->aliases[slot].used)))
+            slot = i;
+    }
+    if (slot < 0 || len == 0)
+        return 0;
+    MQTTFree(c->aliases[slot].topic);
+    if ((c->aliases[slot].topic = MQTTMalloc(len + 1)) == NULL)
+        return 0;
+    memcpy(c->aliases[slot].topic, topicName, len + 1);
+    c->aliases[slot].used = ++c->alias_seq;
+    return slot + 1;
+}
+
+
+/* --modified,the alias taken but the publish never goes, so the server never knows it */
+static void dropAlias(MQTTClient *c, int alias) {
+    if (alias == 0)
+        return;
+    MQTTFree(c->aliases[alias - 1].topic);
+    c->aliases[alias - 1].topic = NULL;
+}
+
+
+/* --modified,serialize the publish to the buf, the MQTT 5 one carries the message properties and,
+ * if asked, the topic alias: only the alias goes once the server knows it */
+static int serializePublish(MQTTClient *c, unsigned char dup, const char* topicName, MQTTMessage* message, int alias) {
+    MQTTString topic = MQTTString_initializer;
+    MQTTProperties props;
+    MQTTProperties* p = versionProps(c, &props);
+    int known = 0;
+    int len;
+
+    topic.cstring = (char *)topicName;
+    if (p != NULL)
+    {
+        props.payloadFormat = message->payloadFormat;
+        props.contentType = message->contentType;
+        if (alias && (props.topicAlias = takeAlias(c, topicName, &known)) != 0 && known)
+            topic.cstring = "";
+    }
+    len = MQTTV5Serialize_publish(c->buf, c->buf_size, dup, message->qos, message->retained, message->id,
+              topic, p, (unsigned char*)message->payload, message->payloadlen);
+    if (len <= 0 && p != NULL && !known)
+        dropAlias(c, props.topicAlias);
+    return len;
+}
+
+
+/* --modified,serialize only the fixed and the variable header of the publish to the buf, the payload is
+ * sent from elsewhere; return the header length or BUFFER_OVERFLOW */
+static int serializePublishHeader(MQTTClient *c, const char* topicName, MQTTMessage* message) {
+    MQTTString topic = MQTTString_initializer;
+    MQTTHeader header = {0};
+    MQTTProperties props;
+    MQTTProperties* p = versionProps(c, &props);
+    unsigned char* ptr;
+    int rem_len;
+    int known = 0;
+
+    topic.cstring = (char *)topicName;
+    if (p != NULL)
+    {
+        props.payloadFormat = message->payloadFormat;
+        props.contentType = message->contentType;
+        if ((props.topicAlias = takeAlias(c, topicName, &known)) != 0 && known)
+            topic.cstring = "";
+    }
+
+    rem_len = 2 + MQTTstrlen(topic) + ((message->qos > 0) ? 2 : 0) + message->payloadlen;
+    if (p != NULL)
+        rem_len += MQTTProperties_len(p);
+    if (MQTTPacket_len(rem_len) - message->payloadlen >= c->buf_size)
+    {
+        if (p != NULL && !known)
+            dropAlias(c, props.topicAlias);
+        return BUFFER_OVERFLOW;
+    }
+    header.bits.type = PUBLISH;
+    header.bits.dup = 0;
+    header.bits.qos = message->qos;
+    header.bits.retain = message->retained;
+    ptr = c->buf;
+    writeChar(&ptr, header.byte);
+    ptr += MQTTPacket_encode(ptr, rem_len);
+    writeMQTTString(&ptr, topic);
+    if (message->qos > 0)
+        writeInt(&ptr, message->id);
+    if (p != NULL)
+        MQTTProperties_write(&ptr, p);
+    return ptr - c->buf;
+}
+
+
+/* --modified,the idle seconds allowed before a ping, never longer than the keepalive */
+static unsigned int pingInterval(MQTTClient* c)
+{
+    if (c->pingInterval == 0 || c->pingInterval > c->keepAliveInterval)
+        return c->keepAliveInterval;
+    return c->pingInterval;
 }
 
 
@@ -35,7 +219,7 @@ static int sendPacket(MQTTClient* c, int length, Timer* timer)
 
     while (sent < length && !TimerIsExpired(timer))
     {
-        rc = c->ipstack->mqttwrite(c->ipstack, &c->buf[sent], length, TimerLeftMS(timer));
+        rc = c->ipstack->mqttwrite(c->ipstack, &c->buf[sent], length - sent, TimerLeftMS(timer));   ///< --modified,only the unsent part
         if (rc < 0)  // there was an error writing the data
             break;
         sent += rc;
@@ -43,12 +227,57 @@ static int sendPacket(MQTTClient* c, int length, Timer* timer)
     if (sent == length)
     {
         TimerCountdown(&c->last_sent, c->keepAliveInterval); // record the fact that we have successfully sent the packet
+        TimerCountdown(&c->last_io, pingInterval(c));      ///< --modified
+        rc = MQTT_SUCCESS;
+    }
+    else
+        rc = FAILURE;
+    return rc;
+}
+
+
+#if defined(MQTT_WRITEV)
+/* --modified,send the header in the buf and then the payload from the caller's buffer with one write,
+ * without copying the payload to the buf */
+static int sendPacketv(MQTTClient* c, int length, unsigned char* payload, int payloadlen, Timer* timer)
+{
+    IoVec iov[2];
+    int rc = FAILURE,
+        sent = 0,
+        total = length + payloadlen,
+        n;
+
+    while (sent < total && !TimerIsExpired(timer))
+    {
+        n = 0;
+        if (sent < length)
+        {
+            iov[n].base = &c->buf[sent];
+            iov[n].len = length - sent;
+            n++;
+        }
+        if (payloadlen > 0)
+        {
+            iov[n].base = payload + ((sent > length) ? sent - length : 0);
+            iov[n].len = total - ((sent > length) ? sent : length);
+            n++;
+        }
+        rc = c->ipstack->mqttwritev(c->ipstack, iov, n, TimerLeftMS(timer));
+        if (rc < 0)
+            break;
+        sent += rc;
+    }
+    if (sent == total)
+    {
+        TimerCountdown(&c->last_sent, c->keepAliveInterval);
+        TimerCountdown(&c->last_io, pingInterval(c));
         rc = MQTT_SUCCESS;
     }
     else
         rc = FAILURE;
     return rc;
 }
+#endif
 
 
 int MQTTClientInit(MQTTClient* c, Network* network, unsigned int command_timeout_ms,
@@ -67,10 +296,28 @@ int MQTTClientInit(MQTTClient* c, Network* network, unsigned int command_timeout
     c->isconnected = 0;
     c->cleansession = 0;
     c->ping_outstanding = 0;
+    c->ping_idle = 0;
+    c->MQTTVersion = 4;
+    c->topicAliasMax = 0;
+    memset(c->aliases, 0, sizeof(c->aliases));
+    c->alias_seq = 0;
+    c->pingInterval = 0;
+    c->pingHandler = NULL;
+    c->pingArg = NULL;
     c->defaultMessageHandler = NULL;
+    c->defaultMessageArg = NULL;
+    c->chunkHandler = NULL;
+    c->chunkArg = NULL;
+    c->streamed = 0;
+    memset(c->inflight, 0, sizeof(c->inflight));
+    c->inflight_window = MAX_INFLIGHT_PUBLISH;
+    c->inflight_count = 0;
+    c->inflight_seq = 0;
 	c->next_packetid = 1;
     TimerInit(&c->last_sent);
     TimerInit(&c->last_received);
+    TimerInit(&c->last_io);
+    TimerInit(&c->ping_timer);
 #if defined(MQTT_TASK)
     if (MutexInit(&c->mutex) != 0)
     {
@@ -84,6 +331,8 @@ void MQTTClientDeInit(MQTTClient *c)
 {
     if(!c)
         return;
+    MQTTAbortInflight(c, FAILURE);    ///< --modified
+    clearAliases(c);
 #if defined(MQTT_TASK)
     MutexDestory(&c->mutex);
 #endif
@@ -118,30 +367,123 @@ exit:
 }
 
 
+/* --modified,the publish larger than the readbuf: keep the variable header in the readbuf and pass
+ * the payload to the chunk handler through the rest of the readbuf, then leave a publish without
+ * payload in the readbuf, so the cycle could still ack it */
+static int readPublishChunks(MQTTClient* c, int len, int rem_len)
+{
+    MQTTHeader header = {0};
+    MQTTString topicName = MQTTString_initializer;
+    MQTTMessage msg;
+    MessageChunk chunk;
+    Timer timer;
+    unsigned char* ptr;
+    int varlen, props, multiplier, n;
+    size_t offset = 0;
+
+    TimerInit(&timer);
+    TimerCountdownMS(&timer, c->command_timeout_ms);
+    header.byte = c->readbuf[0];
+    ptr = c->readbuf + len;
+    if (len + 2 > c->readbuf_size || c->ipstack->mqttread(c->ipstack, ptr, 2, TimerLeftMS(&timer)) != 2)
+        return FAILURE;
+    varlen = 2 + ((ptr[0] << 8) | ptr[1]) + ((header.bits.qos > 0) ? 2 : 0);
+    if (varlen > rem_len || len + varlen >= c->readbuf_size)
+        return BUFFER_OVERFLOW;
+    if (c->ipstack->mqttread(c->ipstack, ptr + 2, varlen - 2, TimerLeftMS(&timer)) != varlen - 2)
+        return FAILURE;
+    memset(&msg, 0, sizeof(msg));
+    if (c->MQTTVersion >= 5)     /* the properties are part of the variable header, skipped here */
+    {
+        props = 0;
+        multiplier = 1;
+        do
+        {
+            if (varlen >= rem_len || len + varlen + 1 >= c->readbuf_size || multiplier > 128 * 128 * 128 ||
+                c->ipstack->mqttread(c->ipstack, ptr + varlen, 1, TimerLeftMS(&timer)) != 1)
+                return FAILURE;
+            props += (ptr[varlen] & 127) * multiplier;
+            multiplier *= 128;
+        } while ((ptr[varlen++] & 128) != 0);
+        if (varlen + props > rem_len)
+            return FAILURE;
+        if (len + varlen + props >= c->readbuf_size)
+            return BUFFER_OVERFLOW;
+        if (c->ipstack->mqttread(c->ipstack, ptr + varlen, props, TimerLeftMS(&timer)) != props)
+            return FAILURE;
+        varlen += props;
+    }
+
+    topicName.lenstring.len = (ptr[0] << 8) | ptr[1];
+    topicName.lenstring.data = (char *)ptr + 2;
+    msg.qos = (enum QoS)header.bits.qos;
+    msg.retained = header.bits.retain;
+    msg.dup = header.bits.dup;
+    msg.id = 0;
+    msg.payloadlen = rem_len - varlen;
+    chunk.message = &msg;
+    chunk.topicName = &topicName;
+    chunk.arg = c->chunkArg;
+    ptr += varlen;
+    while (offset < msg.payloadlen)
+    {
+        n = c->readbuf_size - (ptr - c->readbuf);
+        if (n > msg.payloadlen - offset)
+            n = msg.payloadlen - offset;
+        if (c->ipstack->mqttread(c->ipstack, ptr, n, TimerLeftMS(&timer)) != n)
+            return FAILURE;
+        msg.payload = ptr;
+        chunk.offset = offset;
+        chunk.len = n;
+        c->chunkHandler(&chunk);
+        offset += n;
+    }
+
+    /* the remaining length is shorter now, so the variable header moves forward */
+    n = 1 + MQTTPacket_encode(c->readbuf + 1, varlen);
+    memmove(c->readbuf + n, c->readbuf + len, varlen);
+    c->streamed = 1;
+    return MQTT_SUCCESS;
+}
+
+
 static int readPacket(MQTTClient* c, Timer* timer)
 {
     MQTTHeader header = {0};
     int len = 0;
     int rem_len = 0;
+    Timer rest;   ///< --modified
 
     /* 1. read the header byte.  This has the packet type in it */
     int rc = c->ipstack->mqttread(c->ipstack, c->readbuf, 1, TimerLeftMS(timer));
     if (rc != 1)
         goto exit;
 
+    ///< --modified,the rest follows the header at once, and the packet read in part is lost, so never
+    ///< read it with what is left of the yield, which may be nothing after waiting for the mutex
+    TimerInit(&rest);
+    TimerCountdownMS(&rest, c->command_timeout_ms);
+
     len = 1;
     /* 2. read the remaining length.  This is variable in itself */
-    decodePacket(c, &rem_len, TimerLeftMS(timer));
+    decodePacket(c, &rem_len, TimerLeftMS(&rest));   ///< --modified
     len += MQTTPacket_encode(c->readbuf + 1, rem_len); /* put the original remaining length back into the buffer */
 
     if (rem_len > (c->readbuf_size - len))
     {
-        rc = BUFFER_OVERFLOW;
-        goto exit;
+        header.byte = c->readbuf[0];
+        if (header.bits.type != PUBLISH || c->chunkHandler == NULL)   ///< --modified,not acked, so it comes again
+        {
+            rc = BUFFER_OVERFLOW;
+            goto exit;
+        }
+        if ((rc = readPublishChunks(c, len, rem_len)) != MQTT_SUCCESS)   ///< --modified
+            goto exit;
+        rem_len = 0;
     }
 
     /* 3. read the rest of the buffer using a callback to supply the rest of the data */
-    if (rem_len > 0 && (rc = c->ipstack->mqttread(c->ipstack, c->readbuf + len, rem_len, TimerLeftMS(timer)) != rem_len)) {
+    if (rem_len > 0 && (rc = c->ipstack->mqttread(c->ipstack, c->readbuf + len, rem_len, TimerLeftMS(&rest)) != rem_len)) {   ///< --modified
         rc = 0;
         goto exit;
     }
@@ -149,7 +491,10 @@ static int readPacket(MQTTClient* c, Timer* timer)
     header.byte = c->readbuf[0];
     rc = header.bits.type;
     if (c->keepAliveInterval > 0)
+    {
         TimerCountdown(&c->last_received, c->keepAliveInterval); // record the fact that we have successfully received a packet
+        TimerCountdown(&c->last_io, pingInterval(c));      ///< --modified,what we receive keeps the path too
+    }
 exit:
     return rc;
 }
@@ -330,6 +675,7 @@ int deliverMessage(MQTTClient* c, MQTTString* topicName, MQTTMessage* message)
     {
         MessageData md;
         NewMessageData(&md, topicName, message);
+        md.arg = c->defaultMessageArg;   ///< --modified,we need a args for the handler
         c->defaultMessageHandler(&md);
         rc = MQTT_SUCCESS;
     }
@@ -345,21 +691,31 @@ int keepalive(MQTTClient* c)
     if (c->keepAliveInterval == 0)
         goto exit;
 
-    ///<ACOCORDING TO THE protocol,we only care about the  send time
-    if (TimerIsExpired(&c->last_sent))
+    if (c->ping_outstanding)
     {
-        if (c->ping_outstanding)
-            rc = FAILURE; /* PINGRESP not received in keepalive interval */
-        else
+        ///< --modified,the pingresp is waited for the command timeout, then the connection is taken as lost
+        if (TimerIsExpired(&c->ping_timer))
         {
-            Timer timer;
-            TimerInit(&timer);
-            TimerCountdownMS(&timer, 1000);
-            int len = MQTTSerialize_pingreq(c->buf, c->buf_size);
-            if (len > 0 && (rc = sendPacket(c, len, &timer)) == MQTT_SUCCESS) // send the ping packet
-                c->ping_outstanding = 1;
+            rc = FAILURE; /* PINGRESP not received in time */
+            if (c->ping_idle && c->pingHandler != NULL)
+                c->pingHandler(c->pingArg, FAILURE);    ///< --modified,only the pingresp timeout tells the idle ping is lost
+            c->ping_idle = 0;
         }
     }
+    ///<ACOCORDING TO THE protocol,the server only cares about our send time, while the path(nat) drops the
+    ///<connection idle in both directions for the ping interval: any packet suppresses the ping --modified
+    else if (TimerIsExpired(&c->last_sent) || TimerIsExpired(&c->last_io))
+    {
+        Timer timer;
+        TimerInit(&timer);
+        TimerCountdownMS(&timer, 1000);
+        c->ping_idle = TimerIsExpired(&c->last_io);
+        c->ping_outstanding = 1;    ///< a ping failed to go is lost as well
+        TimerCountdownMS(&c->ping_timer, c->command_timeout_ms);
+        int len = MQTTSerialize_pingreq(c->buf, c->buf_size);
+        if (len <= 0 || (rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS) // send the ping packet
+            rc = FAILURE;
+    }
 
 exit:
     return rc;
@@ -377,7 +733,8 @@ void MQTTCleanSession(MQTTClient* c)
 
 void MQTTCloseSession(MQTTClient* c)
 {
-    c->ping_outstanding = 0;
+    c->ping_outstanding = 0;    ///< --modified,the other errors tell nothing of the idle ping
+    c->ping_idle = 0;
     c->isconnected = 0;
     if (c->cleansession)
         MQTTCleanSession(c);
@@ -401,21 +758,38 @@ int cycle(MQTTClient* c, Timer* timer)
     case 0: /* timed out reading packet */
         break;
     case CONNACK:
-    case PUBACK:
     case SUBACK:
     case UNSUBACK:
         break;
+    case PUBACK:
+    case PUBCOMP:    ///< --modified,the async publish is done
+    {
+        unsigned short mypacketid;
+        unsigned char dup, type, reason;
+        int i;
+        if (c->inflight_count > 0 &&
+            MQTTV5Deserialize_ack(&type, &dup, &mypacketid, &reason, c->readbuf, c->readbuf_size) == 1 &&
+            (i = findInflight(c, mypacketid)) >= 0 && c->inflight[i].wait == packet_type)
+            completeInflight(c, i, (reason < 0x80) ? MQTT_SUCCESS : FAILURE);   ///< the MQTT 5 failures are all from 0x80
+        break;
+    }
     case PUBLISH:
     {
         MQTTString topicName;
         MQTTMessage msg;
+        MQTTProperties props;
         int intQoS;
-        msg.payloadlen = 0; /* this is a size_t, but deserialize publish sets this as int */
-        if (MQTTDeserialize_publish(&msg.dup, &intQoS, &msg.retained, &msg.id, &topicName,
+        memset(&msg, 0, sizeof(msg)); /* --modified,the payloadlen is a size_t, but deserialize publish sets this as int */
+        if (MQTTV5Deserialize_publish(&msg.dup, &intQoS, &msg.retained, &msg.id, &topicName, versionProps(c, &props),
                                     (unsigned char **)&msg.payload, (int *)&msg.payloadlen, c->readbuf, c->readbuf_size) != 1)
             goto exit;
         msg.qos = (enum QoS)intQoS;
-        deliverMessage(c, &topicName, &msg);
+        msg.payloadFormat = props.payloadFormat;   ///< --modified
+        msg.contentType = props.contentType;
+        if (c->streamed)     ///< --modified,the payload has gone to the chunk handler, only ack it
+            c->streamed = 0;
+        else
+            deliverMessage(c, &topicName, &msg);
         if (msg.qos != QOS0)
         {
             if (msg.qos == QOS1)
@@ -439,14 +813,28 @@ int cycle(MQTTClient* c, Timer* timer)
     case PUBREL:
     {
         unsigned short mypacketid;
-        unsigned char dup, type;
-        if (MQTTDeserialize_ack(&type, &dup, &mypacketid, c->readbuf, c->readbuf_size) != 1)
+        unsigned char dup, type, reason;
+        int i;
+        if (MQTTV5Deserialize_ack(&type, &dup, &mypacketid, &reason, c->readbuf, c->readbuf_size) != 1)
             rc = FAILURE;
+        else if (packet_type == PUBREC && reason >= 0x80)
+        {
+            ///< --modified,the MQTT 5 server refused the publish, which ends here without the pubrel
+            if ((i = findInflight(c, mypacketid)) >= 0 && c->inflight[i].wait == PUBREC)
+                completeInflight(c, i, FAILURE);
+        }
         else if ((len = MQTTSerialize_ack(c->buf, c->buf_size,
                                           (packet_type == PUBREC) ? PUBREL : PUBCOMP, 0, mypacketid)) <= 0)
             rc = FAILURE;
         else
         {
+            ///< --modified,from now on the async publish waits for the pubcomp, and the pubrel is retransmitted
+            if (packet_type == PUBREC && (i = findInflight(c, mypacketid)) >= 0 && c->inflight[i].wait == PUBREC)
+            {
+                memcpy(c->inflight[i].packet, c->buf, len);
+                c->inflight[i].len = len;
+                c->inflight[i].wait = PUBCOMP;
+            }
             TimerInit(&send_timer);
             TimerCountdownMS(&send_timer, 1000);
             rc = sendPacket(c, len, &send_timer);
@@ -458,10 +846,11 @@ int cycle(MQTTClient* c, Timer* timer)
         break;
     }
 
-    case PUBCOMP:
-        break;
     case PINGRESP:
         c->ping_outstanding = 0;
+        if (c->ping_idle && c->pingHandler != NULL)
+            c->pingHandler(c->pingArg, MQTT_SUCCESS);    ///< --modified,the path survived the idle ping interval
+        c->ping_idle = 0;
         break;
     }
 
@@ -556,6 +945,73 @@ int waitfor(MQTTClient* c, int packet_type, Timer* timer)
 }
 
 
+/* --modified,the broker without the session knows none of the inflight ones: the publish goes again as a
+   new one with a fresh id, while the pubrel is done since the pubrec has told that the broker got the publish;
+   the owner keeping the ids finds the new one in the window by the done and its arg after the connack */
+static void renewInflight(MQTTClient* c)
+{
+    unsigned char* packet;
+    MQTTHeader header = {0};
+    int i, pos;
+
+    for (i = 0; i < MAX_INFLIGHT_PUBLISH && c->inflight_count > 0; ++i)
+    {
+        if (c->inflight[i].wait == PUBCOMP)
+            completeInflight(c, i, MQTT_SUCCESS);
+        else if (c->inflight[i].wait != 0)
+        {
+            packet = c->inflight[i].packet;
+            header.byte = packet[0];
+            header.bits.dup = 0;
+            packet[0] = header.byte;
+            for (pos = 1; (packet[pos] & 128) != 0; ++pos)
+                ;   /* the remaining length */
+            pos += 3 + ((packet[pos + 1] << 8) | packet[pos + 2]);   /* the topic, the packet id follows */
+            c->inflight[i].id = getNextPacketId(c);
+            packet[pos] = (unsigned char)(c->inflight[i].id >> 8);
+            packet[pos + 1] = (unsigned char)(c->inflight[i].id & 0xff);
+        }
+    }
+}
+
+
+/* --modified,retransmit the unacked publishes and pubrels in the original order after the connack,
+   the duplicated flag is set only when the broker has kept the session */
+static int resendInflight(MQTTClient* c, Timer* timer, unsigned char sessionPresent)
+{
+    int rc = MQTT_SUCCESS;
+    char sent[MAX_INFLIGHT_PUBLISH] = {0};
+    int i, next;
+    MQTTHeader header = {0};
+
+    if (!sessionPresent)
+        renewInflight(c);
+    while (rc == MQTT_SUCCESS)
+    {
+        next = -1;   /* the oldest one not sent yet */
+        for (i = 0; i < MAX_INFLIGHT_PUBLISH; ++i)
+        {
+            if (c->inflight[i].wait != 0 && !sent[i] && (next < 0 ||
+                c->inflight_seq - c->inflight[i].seq > c->inflight_seq - c->inflight[next].seq))
+                next = i;
+        }
+        if (next < 0)
+            break;
+        sent[next] = 1;
+        header.byte = c->inflight[next].packet[0];
+        if (header.bits.type == PUBLISH && sessionPresent)
+        {
+            header.bits.dup = 1;
+            c->inflight[next].packet[0] = header.byte;
+        }
+        memcpy(c->buf, c->inflight[next].packet, c->inflight[next].len);
+        rc = sendPacket(c, c->inflight[next].len, timer);
+    }
+
+    return rc;
+}
+
+
 int MQTTConnectWithResults(MQTTClient* c, MQTTPacket_connectData* options, MQTTConnackData* data)
 {
     Timer connect_timer;
@@ -577,6 +1033,9 @@ int MQTTConnectWithResults(MQTTClient* c, MQTTPacket_connectData* options, MQTTC
 
     c->keepAliveInterval = options->keepAliveInterval;
     c->cleansession = options->cleansession;
+    c->MQTTVersion = options->MQTTVersion;   ///< --modified,the aliases of the last connection are gone
+    c->topicAliasMax = 0;
+    clearAliases(c);
     TimerCountdown(&c->last_received, c->keepAliveInterval);
     if ((len = MQTTSerialize_connect(c->buf, c->buf_size, options)) <= 0)
         goto exit;
@@ -586,21 +1045,30 @@ int MQTTConnectWithResults(MQTTClient* c, MQTTPacket_connectData* options, MQTTC
     // this will be a blocking call, wait for the connack
     if (waitfor(c, CONNACK, &connect_timer) == CONNACK)
     {
+        MQTTProperties props;
         data->rc = 0;
         data->sessionPresent = 0;
-        if (MQTTDeserialize_connack(&data->sessionPresent, &data->rc, c->readbuf, c->readbuf_size) == 1)
+        if (MQTTV5Deserialize_connack(&data->sessionPresent, &data->rc, versionProps(c, &props),
+                                      c->readbuf, c->readbuf_size) == 1)
+        {
             rc = data->rc;
+            c->topicAliasMax = props.topicAliasMax;   ///< --modified
+        }
         else
             rc = FAILURE;
     }
     else
         rc = FAILURE;
 
+    if (rc == MQTT_SUCCESS)
+        rc = resendInflight(c, &connect_timer, data->sessionPresent);   ///< --modified
+
 exit:
     if (rc == MQTT_SUCCESS)
     {
         c->isconnected = 1;
         c->ping_outstanding = 0;
+        c->ping_idle = 0;
     }
 
 #if defined(MQTT_TASK)
@@ -618,6 +1086,20 @@ int MQTTConnect(MQTTClient* c, MQTTPacket_connectData* options)
 }
 
 
+/* --modified,takes effect from the next packet */
+int MQTTSetPingInterval(MQTTClient* c, unsigned int interval)
+{
+#if defined(MQTT_TASK)
+    MutexLock(&c->mutex);
+#endif
+    c->pingInterval = interval;
+#if defined(MQTT_TASK)
+    MutexUnlock(&c->mutex);
+#endif
+    return MQTT_SUCCESS;
+}
+
+
 int MQTTSetMessageHandler(MQTTClient* c, const char* topicFilter, messageHandler messageHandler)
 {
     int rc = FAILURE;
@@ -668,6 +1150,7 @@ int MQTTSubscribeWithResults(MQTTClient *c, const char *topicFilter, enum QoS qo
     Timer timer;
     int len = 0;
     MQTTString topic = MQTTString_initializer;
+    MQTTProperties props;
     topic.cstring = (char *)topicFilter;
 
 #if defined(MQTT_TASK)
@@ -679,7 +1162,8 @@ int MQTTSubscribeWithResults(MQTTClient *c, const char *topicFilter, enum QoS qo
     TimerInit(&timer);
     TimerCountdownMS(&timer, c->command_timeout_ms);
 
-    len = MQTTSerialize_subscribe(c->buf, c->buf_size, 0, getNextPacketId(c), 1, &topic, (int *)&qos);
+    len = MQTTV5Serialize_subscribe(c->buf, c->buf_size, 0, getNextPacketId(c), versionProps(c, &props),
+              1, &topic, (int *)&qos);   ///< --modified
     if (len <= 0)
         goto exit;
     if ((rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS) // send the subscribe packet
@@ -690,9 +1174,10 @@ int MQTTSubscribeWithResults(MQTTClient *c, const char *topicFilter, enum QoS qo
         int count = 0;
         unsigned short mypacketid;
         data->grantedQoS = QOS0;
-        if (MQTTDeserialize_suback(&mypacketid, 1, &count, (int *)&data->grantedQoS, c->readbuf, c->readbuf_size) == 1)
+        if (MQTTV5Deserialize_suback(&mypacketid, versionProps(c, &props), 1, &count, (int *)&data->grantedQoS,
+                                     c->readbuf, c->readbuf_size) == 1)
         {
-            if (data->grantedQoS != 0x80)
+            if (data->grantedQoS < 0x80)   ///< --modified,the MQTT 5 failures are all from 0x80
                 rc = MQTTSetMessageHandler(c, topicFilter, messageHandler);
         }
     }
@@ -761,6 +1246,7 @@ int MQTTSubscribeWithResultsArgs(MQTTClient *c, const char *topicFilter, enum Qo
     Timer timer;
     int len = 0;
     MQTTString topic = MQTTString_initializer;
+    MQTTProperties props;
     topic.cstring = (char *)topicFilter;
 
 #if defined(MQTT_TASK)
@@ -772,7 +1258,8 @@ int MQTTSubscribeWithResultsArgs(MQTTClient *c, const char *topicFilter, enum Qo
     TimerInit(&timer);
     TimerCountdownMS(&timer, c->command_timeout_ms);
 
-    len = MQTTSerialize_subscribe(c->buf, c->buf_size, 0, getNextPacketId(c), 1, &topic, (int *)&qos);
+    len = MQTTV5Serialize_subscribe(c->buf, c->buf_size, 0, getNextPacketId(c), versionProps(c, &props),
+              1, &topic, (int *)&qos);   ///< --modified
     if (len <= 0)
         goto exit;
     if ((rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS) // send the subscribe packet
@@ -783,9 +1270,10 @@ int MQTTSubscribeWithResultsArgs(MQTTClient *c, const char *topicFilter, enum Qo
         int count = 0;
         unsigned short mypacketid;
         data->grantedQoS = QOS0;
-        if (MQTTDeserialize_suback(&mypacketid, 1, &count, (int *)&data->grantedQoS, c->readbuf, c->readbuf_size) == 1)
+        if (MQTTV5Deserialize_suback(&mypacketid, versionProps(c, &props), 1, &count, (int *)&data->grantedQoS,
+                                     c->readbuf, c->readbuf_size) == 1)
         {
-            if (data->grantedQoS != 0x80)
+            if ((data->grantedQoS < 0x80) && (NULL != messageHandler))   ///< --modified,NULL for the default handler
                 rc = MQTTSetMessageHandlerArgs(c, topicFilter, messageHandler,arg);
         }
     }
@@ -814,6 +1302,7 @@ int MQTTUnsubscribe(MQTTClient* c, const char* topicFilter)
     int rc = FAILURE;
     Timer timer;
     MQTTString topic = MQTTString_initializer;
+    MQTTProperties props;
     topic.cstring = (char *)topicFilter;
     int len = 0;
 
@@ -826,7 +1315,8 @@ int MQTTUnsubscribe(MQTTClient* c, const char* topicFilter)
     TimerInit(&timer);
     TimerCountdownMS(&timer, c->command_timeout_ms);
 
-    if ((len = MQTTSerialize_unsubscribe(c->buf, c->buf_size, 0, getNextPacketId(c), 1, &topic)) <= 0)
+    if ((len = MQTTV5Serialize_unsubscribe(c->buf, c->buf_size, 0, getNextPacketId(c), versionProps(c, &props),
+                                           1, &topic)) <= 0)   ///< --modified
         goto exit;
     if ((rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS) // send the subscribe packet
         goto exit; // there was a problem
@@ -853,12 +1343,34 @@ exit:
 }
 
 
+#define PUBLISH_REFUSED (-3)   ///< --modified,the MQTT 5 server acked the publish with a failure reason
+
+/* --modified,shared by MQTTPublish and MQTTPublishStream, the acks of the async publishes are skipped */
+static int waitPublishAck(MQTTClient* c, enum QoS qos, unsigned short id, Timer* timer)
+{
+    int wanted;
+    unsigned short mypacketid;
+    unsigned char dup, type, reason;
+
+    if (qos == QOS0)
+        return MQTT_SUCCESS;
+    wanted = (qos == QOS1) ? PUBACK : PUBCOMP;
+    while (waitfor(c, wanted, timer) == wanted)
+    {
+        if (MQTTV5Deserialize_ack(&type, &dup, &mypacketid, &reason, c->readbuf, c->readbuf_size) != 1)
+            break;
+        if (mypacketid == id)
+            return (reason < 0x80) ? MQTT_SUCCESS : PUBLISH_REFUSED;
+    }
+
+    return FAILURE;
+}
+
+
 int MQTTPublish(MQTTClient* c, const char* topicName, MQTTMessage* message)
 {
     int rc = FAILURE;
     Timer timer;
-    MQTTString topic = MQTTString_initializer;
-    topic.cstring = (char *)topicName;
     int len = 0;
 
 #if defined(MQTT_TASK)
@@ -876,41 +1388,201 @@ int MQTTPublish(MQTTClient* c, const char* topicName, MQTTMessage* message)
     if (message->qos == QOS1 || message->qos == QOS2)
         message->id = getNextPacketId(c);
 
-    len = MQTTSerialize_publish(c->buf, c->buf_size, 0, message->qos, message->retained, message->id,
-              topic, (unsigned char*)message->payload, message->payloadlen);
-    if (len <= 0)
+#if defined(MQTT_WRITEV)
+    /* --modified,the large payload goes to the network from the caller's buffer, only the header is copied */
+    if (c->ipstack->mqttwritev != NULL && (message->payloadlen >= MQTT_WRITEV_MIN || message->payloadlen >= c->buf_size))
+    {
+        if ((len = serializePublishHeader(c, topicName, message)) <= 0)
+        {
+            rc = BUFFER_OVERFLOW;
+            goto exit;
+        }
+        if ((rc = sendPacketv(c, len, (unsigned char*)message->payload, message->payloadlen, &timer)) != MQTT_SUCCESS)
+            goto exit;
+    }
+    else
+#endif
+    {
+        len = serializePublish(c, 0, topicName, message, 1);   ///< --modified
+        if (len <= 0)
+            goto exit;
+        if ((rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS) // send the subscribe packet
+            goto exit; // there was a problem
+    }
+
+    rc = waitPublishAck(c, message->qos, message->id, &timer);
+
+exit:
+    if (rc == PUBLISH_REFUSED)   ///< --modified,the connection is fine, only this publish failed
+        rc = FAILURE;
+    else if (rc == FAILURE)
+        MQTTCloseSession(c);
+#if defined(MQTT_TASK)
+	  MutexUnlock(&c->mutex);
+#endif
+    return rc;
+}
+
+
+int MQTTPublishStream(MQTTClient* c, const char* topicName, MQTTMessage* message, MQTTPayloadReader reader, void* arg)
+{
+    int rc = FAILURE;
+    Timer timer;
+    int len, n;
+    size_t offset = 0;
+    char sent = 0;
+
+#if defined(MQTT_TASK)
+	  MutexLock(&c->mutex);
+#endif
+	  if (!c->isconnected || reader == NULL)
+		    goto exit;
+
+    TimerInit(&timer);
+    if(message->qos == QOS2)
+        TimerCountdownMS(&timer, c->command_timeout_ms * 2);
+    else
+        TimerCountdownMS(&timer, c->command_timeout_ms);
+
+    if (message->qos == QOS1 || message->qos == QOS2)
+        message->id = getNextPacketId(c);
+
+    /* the fixed and the variable header must be in the sendbuf at one time, the payload not */
+    if ((len = serializePublishHeader(c, topicName, message)) <= 0)
+    {
+        rc = BUFFER_OVERFLOW;
         goto exit;
-    if ((rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS) // send the subscribe packet
-        goto exit; // there was a problem
+    }
 
-    if (message->qos == QOS1)
+    do
     {
-        if (waitfor(c, PUBACK, &timer) == PUBACK)
+        n = c->buf_size - len;
+        if (n > message->payloadlen - offset)
+            n = message->payloadlen - offset;
+        if (n > 0 && (n = reader(arg, c->buf + len, n, offset)) <= 0)
         {
-            unsigned short mypacketid;
-            unsigned char dup, type;
-            if (MQTTDeserialize_ack(&type, &dup, &mypacketid, c->readbuf, c->readbuf_size) != 1)
-                rc = FAILURE;
+            rc = sent ? FAILURE : BUFFER_OVERFLOW;    ///< the broker has got part of the packet, drop the session
+            goto exit;
         }
-        else
-            rc = FAILURE;
-    }
-    else if (message->qos == QOS2)
+        len += n;
+        offset += n;
+        if ((rc = sendPacket(c, len, &timer)) != MQTT_SUCCESS)
+            goto exit;
+        sent = 1;
+        len = 0;
+    } while (offset < message->payloadlen);
+
+    rc = waitPublishAck(c, message->qos, message->id, &timer);
+
+exit:
+    if (rc == PUBLISH_REFUSED)   ///< --modified,the connection is fine, only this publish failed
+        rc = FAILURE;
+    else if (rc == FAILURE)
+        MQTTCloseSession(c);
+#if defined(MQTT_TASK)
+	  MutexUnlock(&c->mutex);
+#endif
+    return rc;
+}
+
+
+int MQTTPublishAsync(MQTTClient* c, const char* topicName, MQTTMessage* message, publishDone done, void* arg)
+{
+    int rc = FAILURE;
+    Timer timer;
+    MQTTInflight* slot = NULL;
+    int len = 0;
+    int i;
+
+#if defined(MQTT_TASK)
+	  MutexLock(&c->mutex);
+#endif
+	  if (!c->isconnected)
+		    goto exit;
+
+    TimerInit(&timer);
+    TimerCountdownMS(&timer, c->command_timeout_ms);
+
+    if (message->qos == QOS1 || message->qos == QOS2)
     {
-        if (waitfor(c, PUBCOMP, &timer) == PUBCOMP)
+        /* the window is full, read the acks here until a slot is free */
+        while (c->inflight_count >= c->inflight_window)
         {
-            unsigned short mypacketid;
-            unsigned char dup, type;
-            if (MQTTDeserialize_ack(&type, &dup, &mypacketid, c->readbuf, c->readbuf_size) != 1)
+            if (TimerIsExpired(&timer))
+            {
+                rc = BUFFER_OVERFLOW;
+                goto exit;
+            }
+            if (cycle(c, &timer) < 0 || !c->isconnected)
+            {
                 rc = FAILURE;
+                goto exit;
+            }
         }
-        else
-            rc = FAILURE;
+        for (i = 0; c->inflight[i].wait != 0; ++i)
+            ;
+        slot = &c->inflight[i];
+        message->id = getNextPacketId(c);
+    }
+
+    len = serializePublish(c, 0, topicName, message, slot == NULL);
+    if (len <= 0)
+    {
+        rc = BUFFER_OVERFLOW;
+        goto exit;
     }
 
+    /* keep a copy for the retransmission, from now on the publish belongs to the session */
+    if (slot != NULL && (rc = keepInflight(c, slot, message, len, done, arg)) != MQTT_SUCCESS)
+        goto exit;
+    /* the copy keeps the topic for the next connection, while this one could go by the alias */
+    if (slot != NULL && c->topicAliasMax > 0 && (i = serializePublish(c, 0, topicName, message, 1)) > 0)
+        len = i;
+
+    if (sendPacket(c, len, &timer) != MQTT_SUCCESS)
+        MQTTCloseSession(c);     /* the inflight one is retransmitted after the next connect */
+    else if (slot == NULL && done != NULL)
+        done(arg, MQTT_SUCCESS);
+    rc = (slot != NULL || c->isconnected) ? MQTT_SUCCESS : FAILURE;
+
+exit:
+#if defined(MQTT_TASK)
+	  MutexUnlock(&c->mutex);
+#endif
+    return rc;
+}
+
+
+int MQTTResumeInflight(MQTTClient* c, const char* topicName, MQTTMessage* message, publishDone done, void* arg)
+{
+    int rc = FAILURE;
+    int len = 0;
+    int i;
+
+#if defined(MQTT_TASK)
+	  MutexLock(&c->mutex);
+#endif
+    if ((message->qos != QOS1 && message->qos != QOS2) || (message->id != 0 && findInflight(c, message->id) >= 0))
+        goto exit;
+    if (c->inflight_count >= MAX_INFLIGHT_PUBLISH)
+    {
+        rc = BUFFER_OVERFLOW;
+        goto exit;
+    }
+    for (i = 0; c->inflight[i].wait != 0; ++i)
+        ;
+    if (message->id == 0)
+        message->id = getNextPacketId(c);
+
+    len = serializePublish(c, 1, topicName, message, 0);   ///< --modified,no alias in the next connection
+    if (len <= 0)
+    {
+        rc = BUFFER_OVERFLOW;
+        goto exit;
+    }
+    rc = keepInflight(c, &c->inflight[i], message, len, done, arg);
+
 exit:
-    if (rc == FAILURE)
-        MQTTCloseSession(c);
 #if defined(MQTT_TASK)
 	  MutexUnlock(&c->mutex);
 #endif
@@ -918,6 +1590,33 @@ exit:
 }
 
 
+int MQTTSetInflightWindow(MQTTClient* c, unsigned int window)
+{
+    if (window == 0 || window > MAX_INFLIGHT_PUBLISH)
+        return FAILURE;
+#if defined(MQTT_TASK)
+	  MutexLock(&c->mutex);
+#endif
+    c->inflight_window = window;
+#if defined(MQTT_TASK)
+	  MutexUnlock(&c->mutex);
+#endif
+    return MQTT_SUCCESS;
+}
+
+
+void MQTTAbortInflight(MQTTClient* c, int rc)
+{
+    int i;
+
+    for (i = 0; i < MAX_INFLIGHT_PUBLISH && c->inflight_count > 0; ++i)
+    {
+        if (c->inflight[i].wait != 0)
+            completeInflight(c, i, rc);
+    }
+}
+
+
 int MQTTDisconnect(MQTTClient* c)
 {
     int rc = FAILURE;
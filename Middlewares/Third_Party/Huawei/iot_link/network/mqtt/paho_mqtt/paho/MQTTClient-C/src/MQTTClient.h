@@ -52,6 +52,20 @@
 #define MAX_MESSAGE_HANDLERS 10/* redefinable - how many subscriptions do you want? */
 #endif
 
+#if !defined(MAX_INFLIGHT_PUBLISH)
+#define MAX_INFLIGHT_PUBLISH 8 /* --modified,redefinable - how many qos1/2 publishes could wait for the ack */
+#endif
+
+#if !defined(MAX_TOPIC_ALIAS)
+#define MAX_TOPIC_ALIAS 8 /* --modified,redefinable - how many MQTT 5 topic aliases we keep for our publishes */
+#endif
+
+#if !defined(MQTTMalloc)  /* --modified,the inflight publishes are copied for the retransmission */
+#include <stdlib.h>
+#define MQTTMalloc(size)  malloc(size)
+#define MQTTFree(ptr)     free(ptr)
+#endif
+
 enum QoS { QOS0, QOS1, QOS2, SUBFAIL=0x80 };
 
 /* all failure return codes must be negative */
@@ -82,6 +96,8 @@ typedef struct MQTTMessage
     unsigned short id;
     void *payload;
     size_t payloadlen;
+    unsigned char payloadFormat;   ///< --modified,MQTT 5 only: 1 means the payload is utf-8
+    MQTTString contentType;        ///< --modified,MQTT 5 only: the mime type of the payload, empty means none
 } MQTTMessage;
 
 typedef struct MessageData
@@ -104,6 +120,47 @@ typedef struct MQTTSubackData
 
 typedef void (*messageHandler)(MessageData*);
 
+///< --modified,called when the async publish is done, rc is MQTT_SUCCESS when acked while FAILURE aborted
+typedef void (*publishDone)(void* arg, int rc);
+
+///< --modified,the qos1/2 publish waiting for the ack, kept until the ack comes even over the reconnect
+typedef struct MQTTInflight
+{
+    unsigned short id;
+    unsigned char wait;        ///< the ack waited:PUBACK PUBREC or PUBCOMP, 0 means the slot is free
+    unsigned int seq;          ///< the retransmission keeps the original order
+    unsigned char* packet;     ///< the publish, or the pubrel after the pubrec received
+    int len;
+    publishDone done;
+    void* arg;
+} MQTTInflight;
+
+///< --modified,the topic our MQTT 5 publishes refer to by the alias, which is the index + 1
+typedef struct MQTTTopicAlias
+{
+    char* topic;               ///< NULL means the alias is not set up in this connection
+    unsigned int used;         ///< the least recently used one is replaced
+} MQTTTopicAlias;
+
+///< --modified,the publish larger than the readbuf is passed to the chunk handler piece by piece
+typedef struct MessageChunk
+{
+    MQTTMessage* message;     ///< payload is the chunk while payloadlen is the whole payload length
+    MQTTString* topicName;
+    size_t offset;            ///< where the chunk is in the whole payload
+    size_t len;               ///< the chunk length
+    void  *arg;
+} MessageChunk;
+
+typedef void (*chunkHandler)(MessageChunk*);
+
+///< --modified,copy at most len bytes of the payload from offset to buf, return the copied length while <= 0 failed
+typedef int (*MQTTPayloadReader)(void* arg, unsigned char* buf, int len, int offset);
+
+///< --modified,told whether the ping after the idle ping interval is answered(MQTT_SUCCESS) or lost(FAILURE),
+///< lost only when the pingresp is not received in the command timeout
+typedef void (*pingHandler)(void* arg, int rc);
+
 typedef struct MQTTClient
 {
     unsigned int next_packetid,
@@ -113,7 +170,13 @@ typedef struct MQTTClient
     unsigned char *buf,
       *readbuf;
     unsigned int keepAliveInterval;
+    unsigned char MQTTVersion;        ///< --modified,4 for 3.1.1 while 5 adds the properties, set before the connect
+    unsigned short topicAliasMax;     ///< --modified,how many topic aliases the server takes, from the connack
+    MQTTTopicAlias aliases[MAX_TOPIC_ALIAS];
+    unsigned int alias_seq;
+    unsigned int pingInterval;        ///< --modified,seconds without any packet before a ping, 0 or >= the keepalive means the keepalive
     char ping_outstanding;
+    char ping_idle;                   ///< --modified,the outstanding ping is sent for the idle ping interval
     int isconnected;
     int cleansession;
 
@@ -125,9 +188,23 @@ typedef struct MQTTClient
     } messageHandlers[MAX_MESSAGE_HANDLERS];      /* Message handlers are indexed by subscription topic */
 
     void (*defaultMessageHandler) (MessageData*);
+    void  *defaultMessageArg;         ///< --modified,the args for the default handler
+
+    void (*chunkHandler) (MessageChunk*);  ///< --modified,NULL refuses the publish larger than the readbuf by BUFFER_OVERFLOW without the ack
+    void  *chunkArg;
+    char   streamed;                  ///< --modified,the publish in the readbuf has gone to the chunk handler
+
+    MQTTInflight inflight[MAX_INFLIGHT_PUBLISH];   ///< --modified,the async publishes not acked yet
+    unsigned int inflight_window;     ///< --modified,how many of the slots could be used
+    unsigned int inflight_count;
+    unsigned int inflight_seq;
+
+    void (*pingHandler) (void*, int);  ///< --modified,NULL when nobody cares about the idle pings
+    void  *pingArg;
 
     Network* ipstack;
     Timer last_sent, last_received;
+    Timer last_io, ping_timer;        ///< --modified,the last packet in any direction and the pingresp deadline
 #if defined(MQTT_TASK)
     Mutex mutex;
     Thread thread;
@@ -168,9 +245,73 @@ DLLExport int MQTTConnect(MQTTClient* client, MQTTPacket_connectData* options);
  *  @param topic - the topic to publish to
  *  @param message - the message to send
  *  @return success code
+ *  @note: --modified,with the MQTT_WRITEV the large payload is sent from the message without copying it to
+ *         the sendbuf, so it could be larger than the sendbuf
  */
 DLLExport int MQTTPublish(MQTTClient* client, const char*, MQTTMessage*);
 
+/** MQTT PublishStream - send an MQTT publish packet whose payload is supplied by the reader
+ *  piece by piece through the sendbuf, and wait for all acks to complete for all QoSs  --modified
+ *  @param client - the client object to use
+ *  @param topic - the topic to publish to
+ *  @param message - the message to send, payloadlen is the whole length and payload is ignored
+ *  @param reader - supplies the payload
+ *  @param arg - passed to the reader
+ *  @return success code
+ */
+DLLExport int MQTTPublishStream(MQTTClient* client, const char*, MQTTMessage*, MQTTPayloadReader reader, void* arg);
+
+/** MQTT PublishAsync - send an MQTT publish packet and return without waiting for the acks, at most
+ *  inflight_window qos1/2 publishes could be outstanding; when the window is full, the acks are read
+ *  here until a slot is free. The unacked publishes are retransmitted after the next connect; when the
+ *  broker has no session, they go as new publishes with fresh ids and the pending pubrels are done  --modified
+ *  @param client - the client object to use
+ *  @param topic - the topic to publish to
+ *  @param message - the message to send
+ *  @param done - called with the client locked when the publish is acked or aborted, could be NULL;
+ *                for qos0 it is called once sent
+ *  @param arg - passed to the done
+ *  @return MQTT_SUCCESS when the done will be called, BUFFER_OVERFLOW when the window stays full or
+ *          no memory for the copy, FAILURE when not connected
+ */
+DLLExport int MQTTPublishAsync(MQTTClient* client, const char*, MQTTMessage*, publishDone done, void* arg);
+
+/** MQTT ResumeInflight - take a publish of the last session into the window without sending it, it
+ *  is sent with the dup flag after the next connack, or as a new one with a fresh id when the broker
+ *  has no session, used before the connect  --modified
+ *  @param client - the client object to use
+ *  @param topic - the topic to publish to
+ *  @param message - the qos1/2 message, id 0 means a new id which is written back
+ *  @param done - the same as the MQTTPublishAsync
+ *  @param arg - passed to the done
+ *  @return MQTT_SUCCESS when the done will be called, BUFFER_OVERFLOW when all the slots are used or
+ *          no memory for the copy, FAILURE when not qos1/2 or the id is already in flight
+ */
+DLLExport int MQTTResumeInflight(MQTTClient* client, const char*, MQTTMessage*, publishDone done, void* arg);
+
+/** MQTT SetInflightWindow - set how many qos1/2 async publishes could be outstanding  --modified
+ *  @param client - the client object to use
+ *  @param window - 1 to MAX_INFLIGHT_PUBLISH
+ *  @return success code
+ */
+DLLExport int MQTTSetInflightWindow(MQTTClient* client, unsigned int window);
+
+/** MQTT AbortInflight - call the done of all the outstanding async publishes with the rc and
+ *  forget them, used when the session is never resumed  --modified
+ *  @param client - the client object to use
+ *  @param rc - passed to the done
+ */
+DLLExport void MQTTAbortInflight(MQTTClient* client, int rc);
+
+/** MQTT SetPingInterval - set how many seconds without any packet in either direction is allowed
+ *  before a ping, so that a path(nat) dropping the idle connection earlier than the keepalive is
+ *  kept. The ping for the keepalive is sent anyway when we have sent nothing for the keepalive  --modified
+ *  @param client - the client object to use
+ *  @param interval - seconds, 0 means the keepalive
+ *  @return success code
+ */
+DLLExport int MQTTSetPingInterval(MQTTClient* client, unsigned int interval);
+
 /** MQTT SetMessageHandler - set or remove a per topic message handler
  *  @param client - the client object to use
  *  @param topicFilter - the topic filter set the message handler for
@@ -203,6 +344,7 @@ DLLExport int MQTTSubscribeWithResults(MQTTClient* client, const char* topicFilt
  *  @param data - suback granted QoS returned
  *  @param arg  - which used for the messageHandler
  *  @return success code
+ *  @note: --modified,NULL messageHandler means the message is delivered to the defaultMessageHandler
  */
 DLLExport int MQTTSubscribeWithResultsArgs(MQTTClient* client, const char* topicFilter, enum QoS, messageHandler, MQTTSubackData* data,void *args);
 
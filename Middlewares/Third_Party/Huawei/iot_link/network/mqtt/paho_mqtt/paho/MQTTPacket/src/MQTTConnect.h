@@ -92,7 +92,7 @@ typedef struct
 	char struct_id[4];
 	/** The version number of this structure.  Must be 0 */
 	int struct_version;
-	/** Version of MQTT to be used.  3 = 3.1 4 = 3.1.1
+	/** Version of MQTT to be used.  3 = 3.1 4 = 3.1.1 5 = 5 without the connect properties --modified
 	  */
 	unsigned char MQTTVersion;
 	MQTTString clientID;
@@ -102,6 +102,8 @@ typedef struct
 	MQTTPacket_willOptions will;
 	MQTTString username;
 	MQTTString password;
+	/** --modified,MQTT 5: seconds the server keeps the session after the close, sent only when the cleansession is 0 */
+	unsigned int sessionExpiry;
 } MQTTPacket_connectData;
 
 typedef union
@@ -123,13 +125,15 @@ typedef union
 } MQTTConnackFlags;	/**< connack flags byte */
 
 #define MQTTPacket_connectData_initializer { {'M', 'Q', 'T', 'C'}, 0, 4, {NULL, {0, NULL}}, 60, 1, 0, \
-		MQTTPacket_willOptions_initializer, {NULL, {0, NULL}}, {NULL, {0, NULL}} }
+		MQTTPacket_willOptions_initializer, {NULL, {0, NULL}}, {NULL, {0, NULL}}, 0 }
 
 DLLExport int MQTTSerialize_connect(unsigned char* buf, int buflen, MQTTPacket_connectData* options);
 DLLExport int MQTTDeserialize_connect(MQTTPacket_connectData* data, unsigned char* buf, int len);
 
 DLLExport int MQTTSerialize_connack(unsigned char* buf, int buflen, unsigned char connack_rc, unsigned char sessionPresent);
 DLLExport int MQTTDeserialize_connack(unsigned char* sessionPresent, unsigned char* connack_rc, unsigned char* buf, int buflen);
+DLLExport int MQTTV5Deserialize_connack(unsigned char* sessionPresent, unsigned char* connack_rc, MQTTProperties* props,
+		unsigned char* buf, int buflen);   /* --modified,the connack_rc is the MQTT 5 reason code */
 
 DLLExport int MQTTSerialize_disconnect(unsigned char* buf, int buflen);
 DLLExport int MQTTSerialize_pingreq(unsigned char* buf, int buflen);
@@ -19,6 +19,17 @@
 
 #include <string.h>
 
+/* --modified,the connect properties of MQTT 5, the session outlives the connection only without the clean session */
+static MQTTProperties* connectProps(MQTTPacket_connectData* options, MQTTProperties* props)
+{
+	MQTTProperties empty = MQTTProperties_initializer;
+
+	*props = empty;
+	if (!options->cleansession)
+		props->sessionExpiry = options->sessionExpiry;
+	return props;
+}
+
 /**
   * Determines the length of the MQTT connect packet that would be produced using the supplied connect options.
   * @param options the options to be used to build the connect packet
@@ -27,6 +38,7 @@
 int MQTTSerialize_connectLength(MQTTPacket_connectData* options)
 {
 	int len = 0;
+	MQTTProperties props;
 
 	FUNC_ENTRY;
 
@@ -34,6 +46,8 @@ int MQTTSerialize_connectLength(MQTTPacket_connectData* options)
 		len = 12; /* variable depending on MQTT or MQIsdp */
 	else if (options->MQTTVersion == 4)
 		len = 10;
+	else if (options->MQTTVersion == 5)
+		len = 10 + MQTTProperties_len(connectProps(options, &props)) + (options->willFlag ? 1 : 0); /* --modified,no will properties */
 
 	len += MQTTstrlen(options->clientID)+2;
 	if (options->willFlag)
@@ -60,6 +74,7 @@ int MQTTSerialize_connect(unsigned char* buf, int buflen, MQTTPacket_connectData
 	unsigned char *ptr = buf;
 	MQTTHeader header = {0};
 	MQTTConnectFlags flags = {0};
+	MQTTProperties props;
 	int len = 0;
 	int rc = -1;
 
@@ -76,10 +91,10 @@ int MQTTSerialize_connect(unsigned char* buf, int buflen, MQTTPacket_connectData
 
 	ptr += MQTTPacket_encode(ptr, len); /* write remaining length */
 
-	if (options->MQTTVersion == 4)
+	if (options->MQTTVersion == 4 || options->MQTTVersion == 5)   /* --modified */
 	{
 		writeCString(&ptr, "MQTT");
-		writeChar(&ptr, (char) 4);
+		writeChar(&ptr, (char) options->MQTTVersion);
 	}
 	else
 	{
@@ -103,9 +118,13 @@ int MQTTSerialize_connect(unsigned char* buf, int buflen, MQTTPacket_connectData
 
 	writeChar(&ptr, flags.all);
 	writeInt(&ptr, options->keepAliveInterval);
+	if (options->MQTTVersion == 5)
+		MQTTProperties_write(&ptr, connectProps(options, &props)); /* --modified,the connect properties */
 	writeMQTTString(&ptr, options->clientID);
 	if (options->willFlag)
 	{
+		if (options->MQTTVersion == 5)
+			writeChar(&ptr, 0); /* --modified,the will properties */
 		writeMQTTString(&ptr, options->will.topicName);
 		writeMQTTString(&ptr, options->will.message);
 	}
@@ -130,6 +149,18 @@ int MQTTSerialize_connect(unsigned char* buf, int buflen, MQTTPacket_connectData
   * @return error code.  1 is success, 0 is failure
   */
 int MQTTDeserialize_connack(unsigned char* sessionPresent, unsigned char* connack_rc, unsigned char* buf, int buflen)
+{
+	return MQTTV5Deserialize_connack(sessionPresent, connack_rc, NULL, buf, buflen);
+}
+
+
+/**
+  * Deserializes the supplied (wire) buffer into connack data with the MQTT 5 properties --modified
+  * @param props returned the MQTT 5 properties, NULL for the MQTT 3.1.1 connack without any
+  * @return error code.  1 is success, 0 is failure
+  */
+int MQTTV5Deserialize_connack(unsigned char* sessionPresent, unsigned char* connack_rc, MQTTProperties* props,
+		unsigned char* buf, int buflen)
 {
 	MQTTHeader header = {0};
 	unsigned char* curdata = buf;
@@ -152,6 +183,10 @@ int MQTTDeserialize_connack(unsigned char* sessionPresent, unsigned char* connac
 	*sessionPresent = flags.bits.sessionpresent;
 	*connack_rc = readChar(&curdata);
 
+	/* the properties may be left out by the failed one */
+	if (props != NULL && curdata < enddata && !MQTTProperties_read(props, &curdata, enddata))
+		goto exit;
+
 	rc = 1;
 exit:
 	FUNC_EXIT_RC(rc);
@@ -35,6 +35,18 @@
   */
 int MQTTDeserialize_publish(unsigned char* dup, int* qos, unsigned char* retained, unsigned short* packetid, MQTTString* topicName,
 		unsigned char** payload, int* payloadlen, unsigned char* buf, int buflen)
+{
+	return MQTTV5Deserialize_publish(dup, qos, retained, packetid, topicName, NULL, payload, payloadlen, buf, buflen);
+}
+
+
+/**
+  * Deserializes the supplied (wire) buffer into publish data with the MQTT 5 properties --modified
+  * @param props returned the MQTT 5 properties, NULL for the MQTT 3.1.1 publish without any
+  * @return error code.  1 is success
+  */
+int MQTTV5Deserialize_publish(unsigned char* dup, int* qos, unsigned char* retained, unsigned short* packetid, MQTTString* topicName,
+		MQTTProperties* props, unsigned char** payload, int* payloadlen, unsigned char* buf, int buflen)
 {
 	MQTTHeader header = {0};
 	unsigned char* curdata = buf;
@@ -60,6 +72,9 @@ int MQTTDeserialize_publish(unsigned char* dup, int* qos, unsigned char* retaine
 	if (*qos > 0)
 		*packetid = readInt(&curdata);
 
+	if (props != NULL && !MQTTProperties_read(props, &curdata, enddata))
+		goto exit;
+
 	*payloadlen = enddata - curdata;
 	*payload = curdata;
 	rc = 1;
@@ -80,6 +95,20 @@ exit:
   * @return error code.  1 is success, 0 is failure
   */
 int MQTTDeserialize_ack(unsigned char* packettype, unsigned char* dup, unsigned short* packetid, unsigned char* buf, int buflen)
+{
+	unsigned char reasonCode;
+
+	return MQTTV5Deserialize_ack(packettype, dup, packetid, &reasonCode, buf, buflen);
+}
+
+
+/**
+  * Deserializes the supplied (wire) buffer into an ack with the MQTT 5 reason code --modified
+  * @param reasonCode returned the reason code, 0 when the ack carries only the packet identifier as MQTT 3.1.1 does
+  * @return error code.  1 is success, 0 is failure
+  */
+int MQTTV5Deserialize_ack(unsigned char* packettype, unsigned char* dup, unsigned short* packetid, unsigned char* reasonCode,
+		unsigned char* buf, int buflen)
 {
 	MQTTHeader header = {0};
 	unsigned char* curdata = buf;
@@ -98,6 +127,7 @@ int MQTTDeserialize_ack(unsigned char* packettype, unsigned char* dup, unsigned
 	if (enddata - curdata < 2)
 		goto exit;
 	*packetid = readInt(&curdata);
+	*reasonCode = (enddata > curdata) ? readChar(&curdata) : 0;
 
 	rc = 1;
 exit:
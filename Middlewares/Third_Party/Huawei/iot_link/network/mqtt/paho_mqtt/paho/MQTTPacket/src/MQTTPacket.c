@@ -251,6 +251,156 @@ int MQTTstrlen(MQTTString mqttstring)
 }
 
 
+/* --modified,the length of the properties without the length in front */
+static int MQTTProperties_bodyLen(MQTTProperties* props)
+{
+	int len = 0;
+
+	if (props->payloadFormat)
+		len += 1 + 1;
+	if (MQTTstrlen(props->contentType) > 0)
+		len += 1 + 2 + MQTTstrlen(props->contentType);
+	if (props->topicAliasMax)
+		len += 1 + 2;
+	if (props->topicAlias)
+		len += 1 + 2;
+	if (props->sessionExpiry)
+		len += 1 + 4;
+	return len;
+}
+
+
+/**
+ * Determines the length of the MQTT 5 properties, including the length in front --modified
+ * @param props the properties, the zero or empty ones are skipped
+ * @return the length of buffer needed to contain the serialized properties
+ */
+int MQTTProperties_len(MQTTProperties* props)
+{
+	int len = MQTTProperties_bodyLen(props);
+
+	return MQTTPacket_len(len) - 1; /* no header byte */
+}
+
+
+/**
+ * Writes the MQTT 5 properties with their length in front --modified
+ * @param pptr pointer to the output buffer - incremented by the number of bytes used & returned
+ * @param props the properties, the zero or empty ones are skipped
+ */
+void MQTTProperties_write(unsigned char** pptr, MQTTProperties* props)
+{
+	*pptr += MQTTPacket_encode(*pptr, MQTTProperties_bodyLen(props));
+	if (props->payloadFormat)
+	{
+		writeChar(pptr, 0x01);
+		writeChar(pptr, props->payloadFormat);
+	}
+	if (MQTTstrlen(props->contentType) > 0)
+	{
+		writeChar(pptr, 0x03);
+		writeMQTTString(pptr, props->contentType);
+	}
+	if (props->topicAliasMax)
+	{
+		writeChar(pptr, 0x22);
+		writeInt(pptr, props->topicAliasMax);
+	}
+	if (props->topicAlias)
+	{
+		writeChar(pptr, 0x23);
+		writeInt(pptr, props->topicAlias);
+	}
+	if (props->sessionExpiry)
+	{
+		writeChar(pptr, 0x11);
+		writeInt(pptr, (int)(props->sessionExpiry >> 16));
+		writeInt(pptr, (int)(props->sessionExpiry & 0xFFFF));
+	}
+}
+
+
+/**
+ * Reads the MQTT 5 properties with their length in front, the ones not used by this client are skipped --modified
+ * @param props the properties read, could be NULL to skip them all
+ * @param pptr pointer to the input buffer - incremented by the number of bytes used & returned
+ * @param enddata pointer to the end of the data: do not read beyond
+ * @return 1 if successful, 0 if not
+ */
+int MQTTProperties_read(MQTTProperties* props, unsigned char** pptr, unsigned char* enddata)
+{
+	MQTTString str = MQTTString_initializer;
+	unsigned char* end;
+	int len = 0;
+	int multiplier = 1;
+	int count = 0;
+	int id;
+
+	do
+	{
+		if (*pptr >= enddata || ++count > 4)
+			return 0;
+		len += (**pptr & 127) * multiplier;
+		multiplier *= 128;
+	} while ((*(*pptr)++ & 128) != 0);
+	if (len > enddata - *pptr)
+		return 0;
+
+	end = *pptr + len;
+	while (*pptr < end)
+	{
+		id = readChar(pptr);
+		switch (id)
+		{
+		case 0x01: case 0x17: case 0x19: case 0x24: case 0x25: case 0x28: case 0x29: case 0x2A: /* byte */
+			if (end - *pptr < 1)
+				return 0;
+			if (id == 0x01 && props != NULL)
+				props->payloadFormat = **pptr;
+			*pptr += 1;
+			break;
+		case 0x13: case 0x21: case 0x22: case 0x23: /* two byte integer */
+			if (end - *pptr < 2)
+				return 0;
+			if (id == 0x22 && props != NULL)
+				props->topicAliasMax = (*pptr)[0] << 8 | (*pptr)[1];
+			else if (id == 0x23 && props != NULL)
+				props->topicAlias = (*pptr)[0] << 8 | (*pptr)[1];
+			*pptr += 2;
+			break;
+		case 0x02: case 0x11: case 0x18: case 0x27: /* four byte integer */
+			if (end - *pptr < 4)
+				return 0;
+			if (id == 0x11 && props != NULL)
+				props->sessionExpiry = (unsigned int)(*pptr)[0] << 24 | (unsigned int)(*pptr)[1] << 16 | (*pptr)[2] << 8 | (*pptr)[3];
+			*pptr += 4;
+			break;
+		case 0x0B: /* variable byte integer */
+			count = 0;
+			do
+			{
+				if (*pptr >= end || ++count > 4)
+					return 0;
+			} while ((*(*pptr)++ & 128) != 0);
+			break;
+		case 0x26: /* string pair */
+			if (!readMQTTLenString(&str, pptr, end))
+				return 0;
+			/* no break */
+		case 0x03: case 0x08: case 0x09: case 0x12: case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F: /* string or binary */
+			if (!readMQTTLenString(&str, pptr, end))
+				return 0;
+			if (id == 0x03 && props != NULL)
+				props->contentType = str;
+			break;
+		default:
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
 /**
  * Compares an MQTTString to a C string
  * @param a the MQTTString to compare
@@ -88,6 +88,25 @@ typedef struct
 
 int MQTTstrlen(MQTTString mqttstring);
 
+/**
+ * --modified,the MQTT 5 properties this client uses, the zero or empty ones are not serialized.
+ * NULL properties passed to the MQTTV5 functions mean the MQTT 3.1.1 packet without any.
+ */
+typedef struct
+{
+	unsigned char payloadFormat;  /**< 0x01 publish: 1 means the payload is utf-8 */
+	MQTTString contentType;       /**< 0x03 publish: the mime type of the payload */
+	unsigned short topicAliasMax; /**< 0x22 connack: how many topic aliases the server takes from us */
+	unsigned short topicAlias;    /**< 0x23 publish: stands for the topic, set up by sending both */
+	unsigned int sessionExpiry;   /**< 0x11 connect: seconds the server keeps the session after the close */
+} MQTTProperties;
+
+#define MQTTProperties_initializer {0, MQTTString_initializer, 0, 0, 0}
+
+int MQTTProperties_len(MQTTProperties* props);
+void MQTTProperties_write(unsigned char** pptr, MQTTProperties* props);
+int MQTTProperties_read(MQTTProperties* props, unsigned char** pptr, unsigned char* enddata);
+
 #include "MQTTConnect.h"
 #include "MQTTPublish.h"
 #include "MQTTSubscribe.h"
@@ -96,6 +115,8 @@ int MQTTstrlen(MQTTString mqttstring);
 
 DLLExport int MQTTSerialize_ack(unsigned char* buf, int buflen, unsigned char type, unsigned char dup, unsigned short packetid);
 DLLExport int MQTTDeserialize_ack(unsigned char* packettype, unsigned char* dup, unsigned short* packetid, unsigned char* buf, int buflen);
+DLLExport int MQTTV5Deserialize_ack(unsigned char* packettype, unsigned char* dup, unsigned short* packetid, unsigned char* reasonCode,
+		unsigned char* buf, int buflen);
 
 int MQTTPacket_len(int rem_len);
 DLLExport int MQTTPacket_equals(MQTTString* a, char* b);
@@ -28,6 +28,10 @@
 DLLExport int MQTTSerialize_subscribe(unsigned char* buf, int buflen, unsigned char dup, unsigned short packetid,
 		int count, MQTTString topicFilters[], int requestedQoSs[]);
 
+/* --modified,the MQTT 5 subscribe, NULL props for the MQTT 3.1.1 one */
+DLLExport int MQTTV5Serialize_subscribe(unsigned char* buf, int buflen, unsigned char dup, unsigned short packetid,
+		MQTTProperties* props, int count, MQTTString topicFilters[], int requestedQoSs[]);
+
 DLLExport int MQTTDeserialize_subscribe(unsigned char* dup, unsigned short* packetid,
 		int maxcount, int* count, MQTTString topicFilters[], int requestedQoSs[], unsigned char* buf, int len);
 
@@ -35,5 +39,9 @@ DLLExport int MQTTSerialize_suback(unsigned char* buf, int buflen, unsigned shor
 
 DLLExport int MQTTDeserialize_suback(unsigned short* packetid, int maxcount, int* count, int grantedQoSs[], unsigned char* buf, int len);
 
+/* --modified,the grantedQoSs are the MQTT 5 reason codes, failed from 0x80 */
+DLLExport int MQTTV5Deserialize_suback(unsigned short* packetid, MQTTProperties* props, int maxcount, int* count, int grantedQoSs[],
+		unsigned char* buf, int len);
+
 
 #endif /* MQTTSUBSCRIBE_H_ */
@@ -28,6 +28,10 @@
 DLLExport int MQTTSerialize_unsubscribe(unsigned char* buf, int buflen, unsigned char dup, unsigned short packetid,
 		int count, MQTTString topicFilters[]);
 
+/* --modified,the MQTT 5 unsubscribe, NULL props for the MQTT 3.1.1 one */
+DLLExport int MQTTV5Serialize_unsubscribe(unsigned char* buf, int buflen, unsigned char dup, unsigned short packetid,
+		MQTTProperties* props, int count, MQTTString topicFilters[]);
+
 DLLExport int MQTTDeserialize_unsubscribe(unsigned char* dup, unsigned short* packetid, int max_count, int* count, MQTTString topicFilters[],
 		unsigned char* buf, int len);
 
@@ -39,6 +39,7 @@
 #include <paho_mqtt_port.h>
 #include <iot_config.h>
 #include <timeval.h>
+#include <link_topic.h>
 
 
 #ifndef CONFIG_PAHO_CONNECT_TIMEOUT
@@ -63,6 +64,40 @@
 #define CONFIG_PAHO_RCVBUF_SIZE      (1024 * 2)
 #endif
 
+#ifndef CONFIG_PAHO_RDBUF_SIZE
+#define CONFIG_PAHO_RDBUF_SIZE       (128)   ///< the small reads are served from one receive, 0 means no buffer
+#endif
+
+#ifndef CONFIG_PAHO_TIMEO_SLACK
+#define CONFIG_PAHO_TIMEO_SLACK      (50)    ///< the socket timeout longer by this(ms) is kept, not set again
+#endif
+
+#ifndef CONFIG_PAHO_INFLIGHT_WINDOW
+#define CONFIG_PAHO_INFLIGHT_WINDOW  (4)     ///< how many qos1/2 publishes without waiting could be unacked
+#endif
+
+#ifndef CONFIG_PAHO_PING_PROBE
+#define CONFIG_PAHO_PING_PROBE       (1)     ///< 1 search the longest idle time the path survives, 0 ping at the keepalive
+#endif
+
+#ifndef CONFIG_PAHO_PING_FLOOR
+#define CONFIG_PAHO_PING_FLOOR       (30)    ///< seconds, the searched idle time never goes below
+#endif
+
+#ifndef CONFIG_PAHO_PING_STEP
+#define CONFIG_PAHO_PING_STEP        (10)    ///< seconds, the search stops when the bounds are this close
+#endif
+
+#ifndef CONFIG_PAHO_PING_REPROBE
+#define CONFIG_PAHO_PING_REPROBE     (20)    ///< the idle pings answered in a row before searching upward again
+#endif
+
+#ifndef CONFIG_PAHO_SESSION_EXPIRY
+#define CONFIG_PAHO_SESSION_EXPIRY   (3600)  ///< seconds, MQTT 5 server keeps the session not cleaned after the close
+#endif
+
+#define CN_PAHO_IOV_MAX              (2)     ///< the client writes the publish header and payload at most
+
 typedef struct
 {
     Network        network;
@@ -72,8 +107,31 @@ typedef struct
     void          *sndbuf;
     int            stop;
     int            stoped;
+    void          *topics;  //the subscribed topic filters, dispatched by the topic trie
+    fn_mqtt_al_msg_dealer chunk_dealer; //for the message larger than the rcvbuf
+    void          *chunk_arg;
+    int            cleansession;
 }paho_mqtt_cb_t;
 
+///< the idle time allowed before a ping, binary searched over the connections between the floor and the
+///< keepalive: an answered idle ping raises the good bound and a lost one lowers the bad bound; the path
+///< may get better, so after CONFIG_PAHO_PING_REPROBE answered in a row the bad bound is forgotten
+typedef struct
+{
+    unsigned int   keepalive;   ///< the keepalive searched for, another one restarts the search
+    unsigned int   good;        ///< the longest idle seconds survived
+    unsigned int   bad;         ///< the shortest idle seconds lost, keepalive + 1 when none
+    unsigned int   interval;    ///< the idle seconds tried or chosen now
+    unsigned int   answered;    ///< how many idle pings answered
+    unsigned int   lost;        ///< how many idle pings lost
+    unsigned int   streak;      ///< how many idle pings answered since the last lost one
+}paho_ping_probe_t;
+static paho_ping_probe_t s_paho_probe;
+static osal_mutex_t      s_paho_probe_lock = cn_mutex_invalid;   ///< the connections share the search
+
+static void general_dealer(MessageData *data);
+static void chunk_dealer(MessageChunk *chunk);
+
 ///< waring: the paho mqtt has the opposite return code with normal socket read and write
 
 static int __tls_read(void *ssl, unsigned char *buffer, int len, int timeout)
@@ -131,6 +189,38 @@ static int __tls_write(void *ssl, unsigned char *buffer, int len, int timeout)
     return ret;
 }
 
+///< each piece written by the tls is a record of its own, so the short header would be sent alone;
+///< when the header lies in the wrbuf, the payload head is copied behind it and they go as one record
+static int __tls_writev(Network *n, IoVec *iov, int iovcnt, int timeout)
+{
+    dtls_al_iovec_t vec[CN_PAHO_IOV_MAX];
+    unsigned char *tail;
+    int room;
+    int sndlen;
+    int i;
+
+    if((NULL == n->ctx) || (iovcnt > CN_PAHO_IOV_MAX))
+    {
+        return -1;
+    }
+    tail = iov[0].base + iov[0].len;
+    if((iovcnt > 1) && (NULL != n->wrbuf) && (iov[0].base >= n->wrbuf) && (tail <= (n->wrbuf + n->wrbuf_size)))
+    {
+        room = (int)((n->wrbuf + n->wrbuf_size) - tail);
+        room = (room < iov[1].len) ? room : iov[1].len;
+        (void) memcpy(tail, iov[1].base, room);
+        return __tls_write(n->ctx, iov[0].base, iov[0].len + room, timeout);
+    }
+    for(i = 0; i < iovcnt; i++)
+    {
+        vec[i].base = iov[i].base;
+        vec[i].len = (size_t)iov[i].len;
+    }
+    sndlen = dtls_al_writev(n->ctx, vec, iovcnt, timeout);
+
+    return (sndlen == 0) ? -1 : ((sndlen < 0) ? 0 : sndlen);
+}
+
 #define PORT_BUF_LEN 16
 static int __tls_connect(Network *n,const char *addr, int port)
 {    int ret = -1;
@@ -184,27 +274,46 @@ static void __tls_disconnect(void *ctx)
 }
 
 
+///< set the socket timeout only when the one set before is shorter or much longer, for each set is
+///< a call to the stack(an AT command round trip for the modem); return 0 success while -1 failed
+static int __socket_timeo(int fd, int opt, int *cached, int timeout)
+{
+    struct timeval timedelay;
+
+    timeout = (timeout > 0) ? timeout : 1;    ///< 0 means blocking forever for the socket
+    if((*cached >= timeout) && (*cached <= (timeout + CONFIG_PAHO_TIMEO_SLACK)))
+    {
+        return 0;
+    }
+
+    timedelay.tv_sec = timeout/1000;
+    timedelay.tv_usec = (timeout%1000)*1000;
+    if(0 != sal_setsockopt(fd,SOL_SOCKET,opt,&timedelay,sizeof(timedelay)))
+    {
+        *cached = 0;
+        return -1;
+    }
+    *cached = timeout;
+
+    return 0;
+}
+
 ///< receve function: return code:0 means timeout -1:failed  > receive length
-static int __socket_read(void *ctx, unsigned char *buf, int len, int timeout)
+static int __socket_read(Network *n, unsigned char *buf, int len, int timeout)
 {
     int fd;
     int ret = 0;
     int rcvlen = -1;
 
-    struct timeval timedelay;
-
     if(NULL== buf)
     {
         return ret;
     }
 
-    fd = (int)(intptr_t)ctx;  ///< socket could be zero
-
-    timedelay.tv_sec = timeout/1000;
-    timedelay.tv_usec = (timeout%1000)*1000;
+    fd = (int)(intptr_t)n->ctx;  ///< socket could be zero
 
     ///< set the recv timeout
-    if(0 != sal_setsockopt(fd,SOL_SOCKET,SO_RCVTIMEO,&timedelay,sizeof(timedelay)))
+    if(0 != __socket_timeo(fd,SO_RCVTIMEO,&n->rcvtimeo,timeout))
     {
         return ret;  //could not support the rcv timeout
     }
@@ -227,28 +336,23 @@ static int __socket_read(void *ctx, unsigned char *buf, int len, int timeout)
 
 
 ///< receve function: return code:0 means timeout -1:failed  > receive length
-static int __socket_write(void *ctx, unsigned char *buf, int len, int timeout)
+static int __socket_write(Network *n, unsigned char *buf, int len, int timeout)
 {
     int fd;
     int ret = 0;
     int sndlen = -1;
 
-    struct timeval timedelay;
-
     if(NULL== buf)
     {
         return ret;
     }
 
-    fd = (int)(intptr_t)ctx;  ///< THE SOCKET COULD BE ZERO
-
-    timedelay.tv_sec = timeout/1000;
-    timedelay.tv_usec = (timeout%1000)*1000;
+    fd = (int)(intptr_t)n->ctx;  ///< THE SOCKET COULD BE ZERO
 
-    ///< set the recv timeout
-    if(0 != sal_setsockopt(fd,SOL_SOCKET,SO_SNDTIMEO,&timedelay,sizeof(timedelay)))
+    ///< set the send timeout
+    if(0 != __socket_timeo(fd,SO_SNDTIMEO,&n->sndtimeo,timeout))
     {
-        return ret;  //could not support the rcv timeout
+        return ret;  //could not support the snd timeout
     }
 
     sndlen = sal_send(fd,buf,len,0);
@@ -266,6 +370,31 @@ static int __socket_write(void *ctx, unsigned char *buf, int len, int timeout)
     }
     return ret;
 }
+static int __socket_writev(Network *n, IoVec *iov, int iovcnt, int timeout)
+{
+    sal_iovec_t vec[CN_PAHO_IOV_MAX];
+    int fd;
+    int sndlen;
+    int i;
+
+    if(iovcnt > CN_PAHO_IOV_MAX)
+    {
+        return 0;
+    }
+    fd = (int)(intptr_t)n->ctx;
+    if(0 != __socket_timeo(fd,SO_SNDTIMEO,&n->sndtimeo,timeout))
+    {
+        return 0;
+    }
+    for(i = 0; i < iovcnt; i++)
+    {
+        vec[i].base = iov[i].base;
+        vec[i].len = (size_t)iov[i].len;
+    }
+    sndlen = sal_sendv(fd, vec, iovcnt, 0);
+
+    return (sndlen == 0) ? -1 : ((sndlen < 0) ? 0 : sndlen);
+}
 static void __socket_disconnect(void *ctx)
 {
     (void) sal_closesocket((int)(intptr_t)ctx);
@@ -300,6 +429,7 @@ static int __socket_connect(Network *n, const char *host, int port)
     if(-1 == sal_connect(fd,(struct sockaddr *)&addr,sizeof(addr)))
     {
         (void) sal_closesocket(fd);
+        sal_dns_flush(host);    ///< the server may have moved, resolve it again next time
     }
     else
     {
@@ -319,7 +449,7 @@ static int __io_read(Network *n, unsigned char *buffer, int len, int timeout_ms)
 
     if(n->arg.type == EN_DTLS_AL_SECURITY_TYPE_NONE)
     {
-        ret = __socket_read(n->ctx, buffer, len, timeout_ms);
+        ret = __socket_read(n, buffer, len, timeout_ms);
     }
     else
     {
@@ -335,7 +465,7 @@ static int __io_write(Network *n, unsigned char *buffer, int len, int timeout_ms
 
     if(n->arg.type == EN_DTLS_AL_SECURITY_TYPE_NONE)
     {
-        ret = __socket_write(n->ctx, buffer, len, timeout_ms);
+        ret = __socket_write(n, buffer, len, timeout_ms);
     }
     else
     {
@@ -344,6 +474,21 @@ static int __io_write(Network *n, unsigned char *buffer, int len, int timeout_ms
     return ret;
 }
 
+static int __io_writev(Network *n, IoVec *iov, int iovcnt, int timeout_ms)
+{
+    int ret = -1;
+
+    if(n->arg.type == EN_DTLS_AL_SECURITY_TYPE_NONE)
+    {
+        ret = __socket_writev(n, iov, iovcnt, timeout_ms);
+    }
+    else
+    {
+        ret = __tls_writev(n, iov, iovcnt, timeout_ms);
+    }
+    return ret;
+}
+
 static int __io_connect(Network *n, const char *addr, int port)
 {
     int ret = -1;
@@ -379,10 +524,42 @@ static void __io_disconnect(Network *n)
     }
 
     n->ctx = NULL;
+    n->rcvtimeo = 0;
+    n->sndtimeo = 0;
+    n->rdlen = 0;
+    n->rdpos = 0;
 
     return;
 }
 
+///< the client reads the header byte by byte, so the small reads are served from one receive to the
+///< rdbuf, and the large ones(the payload) go to the client buffer directly
+static int __io_read_buffered(Network *n, unsigned char *buffer, int len, int timeout_ms)
+{
+    int ret;
+
+    if((n->rdpos >= n->rdlen) && (NULL != n->rdbuf) && (len < CONFIG_PAHO_RDBUF_SIZE))
+    {
+        ret = __io_read(n, n->rdbuf, CONFIG_PAHO_RDBUF_SIZE, timeout_ms);
+        n->rdpos = 0;
+        n->rdlen = (ret > 0) ? ret : 0;
+        if(ret <= 0)
+        {
+            return ret;
+        }
+    }
+    if(n->rdpos < n->rdlen)
+    {
+        ret = n->rdlen - n->rdpos;
+        ret = (ret > len) ? len : ret;
+        (void) memcpy(buffer, n->rdbuf + n->rdpos, ret);
+        n->rdpos += ret;
+        return ret;
+    }
+
+    return __io_read(n, buffer, len, timeout_ms);
+}
+
 
 ///< make the mqtt io loop read or write
 static int mqtt_io_read(Network *n, unsigned char *buffer, int len, int timeout_ms)
@@ -390,6 +567,7 @@ static int mqtt_io_read(Network *n, unsigned char *buffer, int len, int timeout_
     int ret = -1;
     int cur_sum = 0;
     int cur_ret;
+    int cur_timeout = timeout_ms;
     unsigned long long time_deadtime;
 
     if((NULL == n) || (NULL == buffer ))
@@ -397,12 +575,13 @@ static int mqtt_io_read(Network *n, unsigned char *buffer, int len, int timeout_
         return ret;
     }
 
-    time_deadtime = osal_sys_time();
+    ///< the packet may come in pieces, so read until all come or the time is over
+    time_deadtime = osal_sys_time() + timeout_ms;
     do{
-        cur_ret = __io_read(n, buffer+cur_sum,len-cur_sum,timeout_ms);
+        cur_ret = __io_read_buffered(n, buffer+cur_sum,len-cur_sum,cur_timeout);
         if(cur_ret == 0)
         {
-            ret = 0;
+            ret = (cur_sum > 0) ? cur_sum : 0;
             break;
         }
         else if(cur_ret > 0)
@@ -410,6 +589,12 @@ static int mqtt_io_read(Network *n, unsigned char *buffer, int len, int timeout_
             cur_sum += cur_ret;
             ret = cur_sum;
         }
+        else
+        {
+            ret = -1;
+            break;
+        }
+        cur_timeout = (int)(time_deadtime - osal_sys_time());
 
     }while((osal_sys_time() < time_deadtime) && (cur_sum < len));
 
@@ -446,7 +631,166 @@ static int mqtt_io_write(Network *n, unsigned char *buffer, int len, int timeout
 
     return ret;
 }
+///< the client writes the rest again when only part written, as the mqtt_io_write
+static int mqtt_io_writev(Network *n, IoVec *iov, int iovcnt, int timeout_ms)
+{
+    if((NULL == n) || (NULL == iov) || (iovcnt <= 0))
+    {
+        return -1;
+    }
+
+    return __io_writev(n, iov, iovcnt, timeout_ms);
+}
 ///////////////////////CREATE THE API FOR THE MQTT_AL///////////////////////////
+///< the unacked publishes kept by the caller join the window, they are the only ones resumed: the
+///< ones still in flight when the connection closes are aborted, and the caller resumes them again
+static void inflight_take(paho_mqtt_cb_t *cb, mqtt_al_conpara_t *conparam)
+{
+    MQTTMessage  msg;
+    mqtt_al_pubpara_t *para;
+    int i;
+
+    if((0 != cb->cleansession) || (NULL == conparam->resume))
+    {
+        return;
+    }
+    for(i = 0; i < conparam->resume_num; i++)
+    {
+        para = &conparam->resume[i];
+        (void) memset(&msg,0,sizeof(msg));
+        msg.retained = (unsigned char )para->retain;
+        msg.qos = QOS0 + (enum QoS)para->qos;
+        msg.id = para->id;
+        msg.payload = para->msg.data;
+        msg.payloadlen = para->msg.len;
+        msg.payloadFormat = (unsigned char)para->payloadformat;
+        msg.contentType.lenstring.len = para->contenttype.len;
+        msg.contentType.lenstring.data = para->contenttype.data;
+        if(BUFFER_OVERFLOW == MQTTResumeInflight(&cb->client, para->topic.data, &msg, para->done, para->done_arg))
+        {
+            break;
+        }
+        para->id = msg.id;
+    }
+
+    return;
+}
+
+///< the broker without the session got the resumed publishes as new ones under the new ids, so write
+///< the ids used back to the caller after the connack, found by the done and its arg; 0 means done
+static void inflight_give(paho_mqtt_cb_t *cb, mqtt_al_conpara_t *conparam)
+{
+    MQTTClient *c = &cb->client;
+    mqtt_al_pubpara_t *para;
+    int i;
+    int j;
+
+    if((0 != cb->cleansession) || (NULL == conparam->resume))
+    {
+        return;
+    }
+    for(i = 0; i < conparam->resume_num; i++)
+    {
+        para = &conparam->resume[i];
+        para->id = 0;
+        for(j = 0; j < MAX_INFLIGHT_PUBLISH; j++)
+        {
+            if((0 != c->inflight[j].wait) && (c->inflight[j].done == para->done) && \
+               (c->inflight[j].arg == para->done_arg))
+            {
+                para->id = c->inflight[j].id;
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+///< try the keepalive first, then the middle of the bounds until they are close, then stay at the good one
+static void ping_probe_next(void)
+{
+    if((s_paho_probe.bad - s_paho_probe.good) <= CONFIG_PAHO_PING_STEP)
+    {
+        s_paho_probe.interval = s_paho_probe.good;
+    }
+    else
+    {
+        s_paho_probe.interval = s_paho_probe.good + (s_paho_probe.bad - s_paho_probe.good) / 2;
+    }
+
+    return;
+}
+
+static unsigned int ping_probe_start(unsigned int keepalive)
+{
+    unsigned int interval;
+
+    if((0 == CONFIG_PAHO_PING_PROBE) || (0 == keepalive))
+    {
+        return 0;
+    }
+    (void) osal_mutex_lock(s_paho_probe_lock);
+    if(keepalive != s_paho_probe.keepalive)
+    {
+        (void) memset(&s_paho_probe,0,sizeof(s_paho_probe));
+        s_paho_probe.keepalive = keepalive;
+        s_paho_probe.good = (keepalive < CONFIG_PAHO_PING_FLOOR) ? keepalive : CONFIG_PAHO_PING_FLOOR;
+        s_paho_probe.bad = keepalive + 1;
+        s_paho_probe.interval = keepalive;
+    }
+    interval = s_paho_probe.interval;
+    (void) osal_mutex_unlock(s_paho_probe_lock);
+
+    return interval;
+}
+
+///< called by the client with its mutex held when the idle ping is answered or lost
+static void ping_probe_dealer(void *arg, int rc)
+{
+    paho_mqtt_cb_t *cb = arg;
+    unsigned int    floor;
+
+    (void) osal_mutex_lock(s_paho_probe_lock);
+    if(s_paho_probe.interval != cb->client.pingInterval)
+    {
+        (void) osal_mutex_unlock(s_paho_probe_lock);
+        return;   ///< not the one we are trying
+    }
+    if(MQTT_SUCCESS == rc)
+    {
+        s_paho_probe.answered++;
+        s_paho_probe.streak++;
+        if(s_paho_probe.interval > s_paho_probe.good)
+        {
+            s_paho_probe.good = s_paho_probe.interval;
+        }
+        if((s_paho_probe.streak >= CONFIG_PAHO_PING_REPROBE) && (s_paho_probe.bad <= s_paho_probe.keepalive))
+        {
+            s_paho_probe.streak = 0;
+            s_paho_probe.bad = s_paho_probe.keepalive + 1;
+        }
+    }
+    else
+    {
+        s_paho_probe.lost++;
+        s_paho_probe.streak = 0;
+        s_paho_probe.bad = s_paho_probe.interval;
+        if(s_paho_probe.bad <= s_paho_probe.good)  ///< the path changed, what survived may not any more
+        {
+            floor = (s_paho_probe.keepalive < CONFIG_PAHO_PING_FLOOR) ? s_paho_probe.keepalive : CONFIG_PAHO_PING_FLOOR;
+            s_paho_probe.good = (s_paho_probe.bad > floor) ? floor : s_paho_probe.bad;
+        }
+    }
+    ping_probe_next();
+    cb->client.pingInterval = s_paho_probe.interval;
+    LINK_LOG_DEBUG("PAHO PING INTERVAL:%u(%u-%u) ANSWERED:%u LOST:%u",s_paho_probe.interval,\
+            s_paho_probe.good,s_paho_probe.bad,s_paho_probe.answered,s_paho_probe.lost);
+    (void) osal_mutex_unlock(s_paho_probe_lock);
+
+    return;
+}
+
 void __mqtt_cb_stop(paho_mqtt_cb_t   *cb)
 {
     if(NULL != cb)
@@ -477,6 +821,40 @@ static  int __loop_entry(void *arg)
     return 0;
 }
 
+///< the mqtt 5 connack reason codes to the mqtt_al ones, which are the 3.1.1 return codes
+static int connack_code_v5(unsigned char rc)
+{
+    int ret;
+
+    switch(rc)
+    {
+        case 0x00:
+            ret = cn_mqtt_al_con_code_ok;
+            break;
+        case 0x84:
+            ret = cn_mqtt_al_con_code_err_version;
+            break;
+        case 0x85:
+            ret = cn_mqtt_al_con_code_err_clientID;
+            break;
+        case 0x86:
+            ret = cn_mqtt_al_con_code_err_u_p;
+            break;
+        case 0x87:
+            ret = cn_mqtt_al_con_code_err_auth;
+            break;
+        case 0x88:
+        case 0x89:
+            ret = cn_mqtt_al_con_code_err_netrefuse;
+            break;
+        default:
+            ret = cn_mqtt_al_con_code_err_unkown;
+            break;
+    }
+
+    return ret;
+}
+
 
 static void * __connect(mqtt_al_conpara_t *conparam)
 {
@@ -504,6 +882,7 @@ static void * __connect(mqtt_al_conpara_t *conparam)
     n = &cb->network;
     n->mqttread = mqtt_io_read;
     n->mqttwrite = mqtt_io_write;
+    n->mqttwritev = mqtt_io_writev;
 
     if(NULL == conparam->security)
     {
@@ -522,26 +901,53 @@ static void * __connect(mqtt_al_conpara_t *conparam)
     //then do the mqtt config
     cb->rcvbuf = osal_malloc(CONFIG_PAHO_RCVBUF_SIZE) ;
     cb->sndbuf = osal_malloc(CONFIG_PAHO_SNDBUF_SIZE) ;
+    n->rdbuf = (CONFIG_PAHO_RDBUF_SIZE > 0) ? osal_malloc(CONFIG_PAHO_RDBUF_SIZE) : NULL;   ///< NULL reads directly
+    n->wrbuf = cb->sndbuf;   ///< the client serializes the header here and leaves the rest free while sending
+    n->wrbuf_size = CONFIG_PAHO_SNDBUF_SIZE;
     if((NULL == cb->rcvbuf) || (NULL == cb->sndbuf))
     {
         conparam->conret = cn_mqtt_al_con_code_err_unkown;
         goto EIXT_BUF_MEM_ERR;
     }
+    cb->topics = topic_trie_create();
+    if(NULL == cb->topics)
+    {
+        conparam->conret = cn_mqtt_al_con_code_err_unkown;
+        goto EIXT_BUF_MEM_ERR;
+    }
     c = &cb->client;
     if(MQTT_SUCCESS != MQTTClientInit(c, n, CONFIG_PAHO_CMD_TIMEOUT,\
             cb->sndbuf, CONFIG_PAHO_SNDBUF_SIZE, cb->rcvbuf, CONFIG_PAHO_RCVBUF_SIZE))
     {
         goto EXIT_MQTT_INIT;
     }
+    ///< all the messages go to the general dealer, which finds the subscriptions in the trie
+    c->defaultMessageHandler = general_dealer;
+    c->defaultMessageArg = cb;
+    cb->chunk_dealer = conparam->chunk_dealer;
+    cb->chunk_arg = conparam->chunk_arg;
+    c->chunkHandler = (NULL != cb->chunk_dealer) ? chunk_dealer : NULL;   ///< none refuses the large one
+    c->chunkArg = cb;
+    (void) MQTTSetInflightWindow(c, CONFIG_PAHO_INFLIGHT_WINDOW);
+    c->pingHandler = ping_probe_dealer;
+    c->pingArg = cb;
+    (void) MQTTSetPingInterval(c, ping_probe_start(conparam->keepalivetime));
+    cb->cleansession = conparam->cleansession;
     //then do make the mqtt connect param
     if(conparam->version == en_mqtt_al_version_3_1_0)
     {
         option.MQTTVersion = 3 ;
     }
+    else if(conparam->version == en_mqtt_al_version_5)
+    {
+        option.MQTTVersion = 5 ;
+    }
     else
     {
         option.MQTTVersion = 4 ;
     }
+    c->MQTTVersion = option.MQTTVersion;  ///< the resumed publishes are packed with the version
+    inflight_take(cb,conparam);
 
     option.clientID.lenstring.len = conparam->clientid.len;
     option.clientID.lenstring.data = conparam->clientid.data;
@@ -549,6 +955,7 @@ static void * __connect(mqtt_al_conpara_t *conparam)
     option.keepAliveInterval = conparam->keepalivetime;
 
     option.cleansession = (unsigned char)conparam->cleansession;
+    option.sessionExpiry = CONFIG_PAHO_SESSION_EXPIRY;   ///< only sent by MQTT 5 without the clean session
 
     if(NULL != conparam->willmsg)
     {
@@ -578,12 +985,14 @@ static void * __connect(mqtt_al_conpara_t *conparam)
     if((MQTT_SUCCESS != MQTTConnectWithResults(c, &option,&conack)) || \
          (conack.rc != cn_mqtt_al_con_code_ok))
     {
-        conparam->conret = conack.rc;
+        conparam->conret = (option.MQTTVersion == 5) ? connack_code_v5(conack.rc) : conack.rc;
         goto EXIT_MQTT_CONNECT;
     }
     else
     {
         conparam->conret = conack.rc;
+        conparam->sessionpresent = (char)conack.sessionPresent;
+        inflight_give(cb,conparam);   ///< before the loop task runs the window
     }
     //create the loop task here
     cb->task = osal_task_create("paho",__loop_entry,cb,0x800,NULL,4);
@@ -604,8 +1013,10 @@ EXIT_MQTT_CONNECT:
 EXIT_MQTT_INIT:
 EIXT_BUF_MEM_ERR:
     __io_disconnect(n);
+    (void) topic_trie_delete(cb->topics);
     osal_free(cb->rcvbuf);
     osal_free(cb->sndbuf);
+    osal_free(cb->network.rdbuf);
 
 EXIT_NET_CONNECT_ERR:
     osal_free(cb);
@@ -651,8 +1062,10 @@ static int __disconnect(void *handle)
     MQTTClientDeInit(c);
     //free the memory
     LINK_LOG_DEBUG("PAHO  TO FREE THE MEMORY");
+    (void) topic_trie_delete(cb->topics);
     osal_free(cb->rcvbuf);
     osal_free(cb->sndbuf);
+    osal_free(cb->network.rdbuf);
     osal_free(cb);
     LINK_LOG_DEBUG("PAHO TASK EXIT");
     return 0;
@@ -662,16 +1075,33 @@ static int __disconnect(void *handle)
  * Copyright (c) 2009-2018 Roger Light <roger@atchoo.org>
  * licensed under the Eclipse Public License 1.0 and the Eclipse Distribution License 1.0
  */
-///< we changge the lib to support the args
+///< called for each subscription matched, the ctx is the received message
+static void topic_dealer(void *ctx, void *handler, void *arg)
+{
+    fn_mqtt_al_msg_dealer  dealer;
+
+    dealer = (fn_mqtt_al_msg_dealer) handler;
+    if(NULL != dealer)
+    {
+        dealer(arg,(mqtt_al_msgrcv_t *)ctx);
+    }
+}
+
+///< we changge the lib to support the args, and the arg of the default handler is the cb
 static void general_dealer(MessageData *data)
 {
     mqtt_al_msgrcv_t   msg;
-    fn_mqtt_al_msg_dealer  dealer;
+    paho_mqtt_cb_t    *cb;
     msg.dup = data->message->dup;
     msg.qos = data->message->qos;
     msg.retain = data->message->retained;
     msg.msg.len = data->message->payloadlen;
     msg.msg.data = data->message->payload;
+    msg.offset = 0;
+    msg.total = msg.msg.len;
+    msg.payloadformat = (char)data->message->payloadFormat;
+    msg.contenttype.data = data->message->contentType.lenstring.data;
+    msg.contenttype.len = data->message->contentType.lenstring.len;
 
     if(data->topicName->lenstring.len)
     {
@@ -684,13 +1114,42 @@ static void general_dealer(MessageData *data)
         msg.topic.len = strlen(data->topicName->cstring);
     }
 
-    if(NULL != data->arg)
+    cb = data->arg;
+    if(NULL != cb)
     {
-        dealer = (fn_mqtt_al_msg_dealer) data->arg;
-        dealer((void *)data->arg,&msg);  ///<   the args not implement yet
+        ///< the deliver is done in the client mutex, so the trie is safe here
+        (void) topic_trie_match(cb->topics,msg.topic.data,msg.topic.len,topic_dealer,&msg);
     }
 }
 
+///< the message larger than the rcvbuf comes here piece by piece, and the arg is the cb
+static void chunk_dealer(MessageChunk *chunk)
+{
+    mqtt_al_msgrcv_t   msg;
+    paho_mqtt_cb_t    *cb;
+
+    cb = chunk->arg;
+    if(NULL == cb)
+    {
+        return;
+    }
+
+    msg.dup = chunk->message->dup;
+    msg.qos = chunk->message->qos;
+    msg.retain = chunk->message->retained;
+    msg.msg.len = chunk->len;
+    msg.msg.data = chunk->message->payload;
+    msg.offset = chunk->offset;
+    msg.total = chunk->message->payloadlen;
+    msg.topic.data = chunk->topicName->lenstring.data;
+    msg.topic.len = chunk->topicName->lenstring.len;
+    msg.payloadformat = (char)chunk->message->payloadFormat;
+    msg.contenttype.data = chunk->message->contentType.lenstring.data;
+    msg.contenttype.len = chunk->message->contentType.lenstring.len;
+
+    cb->chunk_dealer(cb->chunk_arg,&msg);
+}
+
 
 //////////////////////END --PATCH FOR PAHO MQTT/////////////////////////////////
 static int __subscribe(void *handle,mqtt_al_subpara_t *para)
@@ -700,6 +1159,9 @@ static int __subscribe(void *handle,mqtt_al_subpara_t *para)
     paho_mqtt_cb_t   *cb = NULL;
 
     MQTTSubackData   ack;
+    int              existed;
+    void            *handler = NULL;
+    void            *arg = NULL;
 
     if((NULL == handle) ||(NULL == para))
     {
@@ -709,8 +1171,20 @@ static int __subscribe(void *handle,mqtt_al_subpara_t *para)
     cb = handle;
     c = &cb->client;
 
+    ///< add the filter before the subscribe, for the retained messages may come before the suback
+    (void) MutexLock(&c->mutex);
+    existed = topic_trie_find(cb->topics,para->topic.data,para->topic.len,&handler,&arg);
+    ret = topic_trie_add(cb->topics,para->topic.data,para->topic.len,(void *)para->dealer,para->arg);
+    MutexUnlock(&c->mutex);
+    if((0 != ret) || (0 != para->local))
+    {
+        return ret;       ///< the server kept the local one, only the dealer is needed
+    }
+    ret = -1;
+
+    ///< no handler for the paho, all the messages go to the default one
     if(MQTT_SUCCESS == MQTTSubscribeWithResultsArgs(c,para->topic.data,para->qos,\
-            general_dealer,&ack, (void *) (para->dealer)))
+            NULL,&ack,NULL))
     {
         para->subret = ack.grantedQoS;
         if((ack.grantedQoS == QOS0)|| (ack.grantedQoS == QOS1 ) || (ack.grantedQoS == QOS2 ) )
@@ -719,6 +1193,20 @@ static int __subscribe(void *handle,mqtt_al_subpara_t *para)
         }
     }
 
+    if(0 != ret)
+    {
+        (void) MutexLock(&c->mutex);
+        if(0 == existed)
+        {
+            (void) topic_trie_add(cb->topics,para->topic.data,para->topic.len,handler,arg);
+        }
+        else
+        {
+            (void) topic_trie_remove(cb->topics,para->topic.data,para->topic.len);
+        }
+        MutexUnlock(&c->mutex);
+    }
+
     return ret;
 }
 
@@ -738,6 +1226,9 @@ static int __unsubscribe(void *handle,mqtt_al_unsubpara_t *para)
 
     if(MQTT_SUCCESS == MQTTUnsubscribe(c,para->topic.data))
     {
+        (void) MutexLock(&c->mutex);
+        (void) topic_trie_remove(cb->topics,para->topic.data,para->topic.len);
+        MutexUnlock(&c->mutex);
         ret = 0;
     }
 
@@ -765,10 +1256,25 @@ static int __publish(void *handle, mqtt_al_pubpara_t *para)
     msg.qos = QOS0 + (enum QoS)para->qos;
     msg.payload = para->msg.data;
     msg.payloadlen = para->msg.len;
-    if(MQTT_SUCCESS ==  MQTTPublish(c, para->topic.data, &msg))
+    msg.payloadFormat = (unsigned char)para->payloadformat;
+    msg.contentType.lenstring.len = para->contenttype.len;
+    msg.contentType.lenstring.data = para->contenttype.data;
+    if(NULL != para->reader)
     {
-        ret = 0;
+        ///< the payload is larger than the sndbuf maybe, so send it piece by piece
+        ret = MQTTPublishStream(c, para->topic.data, &msg, para->reader, para->reader_arg);
     }
+    else if(NULL != para->done)
+    {
+        ///< the qos1/2 ones wait for the ack in the window, so several could be on the way
+        ret = MQTTPublishAsync(c, para->topic.data, &msg, para->done, para->done_arg);
+        para->id = msg.id;
+    }
+    else
+    {
+        ret = MQTTPublish(c, para->topic.data, &msg);
+    }
+    ret = (MQTT_SUCCESS == ret) ? 0 : -1;
 
     return ret;
 }
@@ -796,6 +1302,26 @@ static en_mqtt_al_connect_state __check_status(void *handle)
 }
 
 
+///< the idle seconds allowed before a ping now, the keepalive when not searched
+static int __keepalive(void *handle)
+{
+    paho_mqtt_cb_t   *cb = handle;
+    MQTTClient       *c;
+
+    if(NULL == cb)
+    {
+        return -1;
+    }
+    c = &cb->client;
+    if((0 == c->pingInterval) || (c->pingInterval > c->keepAliveInterval))
+    {
+        return (int)c->keepAliveInterval;
+    }
+
+    return (int)c->pingInterval;
+}
+
+
 int mqtt_imp_init()
 {
     int ret = -1;
@@ -808,8 +1334,13 @@ int mqtt_imp_init()
         .unsubscribe = __unsubscribe,
         .publish = __publish,
         .check_status = __check_status,
+        .keepalive = __keepalive,
     };
 
+    if((cn_mutex_invalid == s_paho_probe_lock) && (false == osal_mutex_create(&s_paho_probe_lock)))
+    {
+        return ret;
+    }
     ret = mqtt_al_install(&paho_mqtt_op);
 
     return ret;
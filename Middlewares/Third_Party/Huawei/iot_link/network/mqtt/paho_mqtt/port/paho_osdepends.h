@@ -46,6 +46,15 @@
 
 #define MQTT_TASK 1
 
+#ifndef CONFIG_PAHO_WRITEV_MIN
+#define CONFIG_PAHO_WRITEV_MIN   512    ///< the publish payload at least so large goes to the socket from the caller, 0 never
+#endif
+
+#if CONFIG_PAHO_WRITEV_MIN > 0
+#define MQTT_WRITEV 1                   ///< the client sends the publish header and payload by the mqttwritev
+#define MQTT_WRITEV_MIN  CONFIG_PAHO_WRITEV_MIN
+#endif
+
 
 typedef osal_loop_timer_t  Timer;
 
@@ -55,6 +64,9 @@ typedef osal_loop_timer_t  Timer;
 #define TimerLeftMS(timer)             osal_loop_timer_left(timer)
 #define TimerCountdown(timer,value)    osal_loop_timer_count_down(timer,value)
 
+#define MQTTMalloc(size)               osal_malloc(size)
+#define MQTTFree(ptr)                  osal_free(ptr)
+
 typedef osal_mutex_t  Mutex;
 #define MutexInit(mutex)     ((true==osal_mutex_create(mutex))?0:-1)
 #define MutexLock(mutex)     ((true==osal_mutex_lock(*mutex))?0:-1)
@@ -69,12 +81,27 @@ typedef struct
 int ThreadStart(Thread *thread, void (*fn)(void *), void *arg);
 
 
+///< the piece of the packet written by the mqttwritev
+typedef struct
+{
+    unsigned char *base;
+    int            len;
+} IoVec;
+
 typedef struct Network
 {
     void *ctx;                      ///< if it is tls, then it is tls context, else it is socket fd
     dtls_al_security_t arg;
     int (*mqttread) (struct Network*, unsigned char*, int, int);
     int (*mqttwrite) (struct Network*, unsigned char*, int, int);
+    int (*mqttwritev) (struct Network*, IoVec*, int, int);   ///< return as the mqttwrite, NULL means not supported
+    int rcvtimeo;                   ///< the receive timeout set to the socket, 0 means not set yet
+    int sndtimeo;                   ///< the send timeout set to the socket, 0 means not set yet
+    unsigned char *rdbuf;           ///< the bytes received but not read by the client yet, NULL means no buffer
+    int rdlen;                      ///< how many bytes in the rdbuf
+    int rdpos;                      ///< where the client reads the rdbuf from
+    unsigned char *wrbuf;           ///< the tls record staging, the header in it gets the payload head behind it
+    int wrbuf_size;                 ///< how many bytes in the wrbuf
 } Network;
 
 #endif
@@ -83,6 +83,17 @@ static int __linux_setsockopt(int fd, int level, int option, const void *option_
     return setsockopt(fd, level, option, option_value, option_len);
 }
 
+static int __linux_sendv(int fd, const void *iov, int iovcnt, int flags)
+{
+    struct msghdr msg;
+
+    (void) memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec *)iov;
+    msg.msg_iovlen = iovcnt;
+
+    return sendmsg(fd, &msg, flags);
+}
+
 
 static const tag_tcpip_ops s_tcpip_socket_ops =
 {
@@ -93,6 +104,7 @@ static const tag_tcpip_ops s_tcpip_socket_ops =
     .accept = (fn_sal_accept)accept,
     .send = (fn_sal_send)send,
     .sendto = (fn_sal_sendto)sendto,
+    .sendv = (fn_sal_sendv)__linux_sendv,
     .recv = (fn_sal_recv)recv,
     .recvfrom = (fn_sal_recvfrom)recvfrom,
     .setsockopt = (fn_sal_setsockopt)__linux_setsockopt,
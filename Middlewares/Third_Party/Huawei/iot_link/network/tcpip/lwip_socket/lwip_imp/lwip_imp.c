@@ -155,6 +155,17 @@ static int __lwip_setsockopt(int fd, int level, int option, const void *option_v
     return setsockopt(fd, level, option, option_value, option_len);
 }
 
+static int __lwip_sendv(int fd, const void *iov, int iovcnt, int flags)
+{
+    struct msghdr msg;
+
+    (void) memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec *)iov;
+    msg.msg_iovlen = iovcnt;
+
+    return lwip_sendmsg(fd, &msg, flags);
+}
+
 
 static const tag_tcpip_ops s_tcpip_lwip_ops =
 {
@@ -165,6 +176,7 @@ static const tag_tcpip_ops s_tcpip_lwip_ops =
     .accept = (fn_sal_accept)__lwip_accept,
     .send = (fn_sal_send)lwip_send,
     .sendto = (fn_sal_sendto)__lwip_sendto,
+    .sendv = (fn_sal_sendv)__lwip_sendv,
     .recv = (fn_sal_recv)lwip_recv,
     .recvfrom = (fn_sal_recvfrom)__lwip_recvfrom,
     .setsockopt = (fn_sal_setsockopt)__lwip_setsockopt,
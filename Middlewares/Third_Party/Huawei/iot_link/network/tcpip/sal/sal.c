@@ -13,6 +13,24 @@
 
 #define CN_LINK_SOCKET_NUM 10
 
+#ifndef CONFIG_SAL_DNS_CACHE_SIZE
+#define CONFIG_SAL_DNS_CACHE_SIZE   4       ///< how many resolved hosts kept, 0 resolves on every connect
+#endif
+
+#ifndef CONFIG_SAL_DNS_CACHE_TTL
+#define CONFIG_SAL_DNS_CACHE_TTL    3600    ///< seconds, gethostbyname gives not the ttl of the record
+#endif
+
+#define CN_SAL_DNS_NAMELEN          64
+
+#if CONFIG_SAL_DNS_CACHE_SIZE > 0
+typedef struct
+{
+    char                name[CN_SAL_DNS_NAMELEN];
+    in_addr_t           addr;
+    unsigned long long  expire;         ///< system time in ms, 0 means the entry is free
+}tag_dns_cache;
+#endif
 
 typedef struct
 {
@@ -27,6 +45,13 @@ typedef struct
     int                     sock_cb_num;    ///< how many socket control block could be used
     osal_mutex_t            sock_cb_mutex;  ///< used to protect the sock control block
     void                  **sock_cb_tab;    ///< which used to
+    void                   *sock_cb_pool;   ///< the sock control block object pool
+#if CONFIG_SAL_DNS_CACHE_SIZE > 0
+    tag_dns_cache           dns_cache[CONFIG_SAL_DNS_CACHE_SIZE];
+    struct hostent          dns_host;       ///< returned for the cached host, like the gethostbyname does
+    char                   *dns_addr_list[2];
+    in_addr_t               dns_addr;
+#endif
 }tag_sal_cb;
 
 static tag_sal_cb   s_sal_cb;
@@ -58,6 +83,12 @@ int link_tcpip_init(void)
         goto EXIT_MEM_ERR;
     }
 
+    s_sal_cb.sock_cb_pool = osal_pool_create("sal_sockcb",sizeof(tag_sock_cb),CN_LINK_SOCKET_NUM,0);
+    if(NULL == s_sal_cb.sock_cb_pool)
+    {
+        goto EXIT_POOL_ERR;
+    }
+
     (void) memset(s_sal_cb.sock_cb_tab,0,CN_LINK_SOCKET_NUM*sizeof(void *));
     s_sal_cb.sock_cb_num = CN_LINK_SOCKET_NUM;
     s_sal_cb.domain = NULL;
@@ -69,6 +100,10 @@ int link_tcpip_init(void)
     return ret;
 
 
+EXIT_POOL_ERR:
+    osal_free(s_sal_cb.sock_cb_tab);
+    s_sal_cb.sock_cb_tab = NULL;
+
 EXIT_MEM_ERR:
     (void) osal_mutex_del(s_sal_cb.sock_cb_mutex);
     s_sal_cb.sock_cb_mutex = cn_mutex_invalid;
@@ -101,7 +136,7 @@ static void * __sal_sockcb_malloc()
 
     tag_sock_cb *sockcb;
 
-    sockcb = osal_malloc(sizeof(tag_sock_cb));
+    sockcb = osal_pool_alloc(s_sal_cb.sock_cb_pool);
 
     if(NULL == sockcb)
     {
@@ -128,7 +163,7 @@ static void * __sal_sockcb_malloc()
 
         if(i == s_sal_cb.sock_cb_num)
         {
-            osal_free(sockcb);
+            osal_pool_free(s_sal_cb.sock_cb_pool,sockcb);
 
             sockcb = NULL;
         }
@@ -156,7 +191,7 @@ static void __sal_sockcb_free(int sockfd)
 
         (void) osal_mutex_unlock(s_sal_cb.sock_cb_mutex);
 
-        osal_free(sockcb);
+        osal_pool_free(s_sal_cb.sock_cb_pool,sockcb);
     }
 
     return;
@@ -440,6 +475,44 @@ int sal_send(int sockfd,const void *buf,size_t len,int flags)
     return ret;
 }
 
+int sal_sendv(int sockfd,const sal_iovec_t *iov,int iovcnt,int flags)
+{
+    int ret = -1;
+    int sent = 0;
+    int i;
+    tag_sock_cb *sockcb;
+
+    sockcb = __sal_sockcb_getcb(sockfd);
+    if((NULL == sockcb) || (NULL == sockcb->ops) || (NULL == iov) || (iovcnt <= 0))
+    {
+        return ret;
+    }
+    if(NULL != sockcb->ops->sendv)
+    {
+        return sockcb->ops->sendv(sockcb->sock,iov,iovcnt,flags);
+    }
+    if(NULL == sockcb->ops->send)
+    {
+        return ret;
+    }
+    ///< stop at the first piece not sent fully, the caller sends the rest again
+    for(i = 0; i < iovcnt; i++)
+    {
+        ret = sockcb->ops->send(sockcb->sock,iov[i].base,iov[i].len,flags);
+        if(ret < 0)
+        {
+            return (sent > 0) ? sent : ret;
+        }
+        sent += ret;
+        if(ret < (int)iov[i].len)
+        {
+            break;
+        }
+    }
+
+    return sent;
+}
+
 int sal_sendto(int sockfd, const void *buf, size_t len, int flags,
     const struct sockaddr *to, socklen_t tolen)
 {
@@ -498,29 +571,200 @@ int sal_closesocket(int sockfd)
     return ret;
 }
 
+#if CONFIG_SAL_DNS_CACHE_SIZE > 0
+
+///< the dotted address resolves without any query, so never take a cache entry for it
+static int __sal_dns_isdotted(const char *name)
+{
+    while(('.' == *name) || (('0' <= *name) && ('9' >= *name)))
+    {
+        name++;
+    }
+
+    return ('\0' == *name);
+}
+
+static struct hostent *__sal_dns_lookup(const char *name)
+{
+    struct hostent *ret = NULL;
+    unsigned long long now;
+    int i;
+
+    if((NULL == s_sal_cb.sock_cb_tab) || (false == osal_mutex_lock(s_sal_cb.sock_cb_mutex)))
+    {
+        return ret;
+    }
+    now = osal_sys_time();
+    for(i = 0; i < CONFIG_SAL_DNS_CACHE_SIZE; i++)
+    {
+        if((0 != s_sal_cb.dns_cache[i].expire) && (0 == strcmp(s_sal_cb.dns_cache[i].name, name)))
+        {
+            if(now < s_sal_cb.dns_cache[i].expire)
+            {
+                s_sal_cb.dns_addr = s_sal_cb.dns_cache[i].addr;
+                s_sal_cb.dns_addr_list[0] = (char *)&s_sal_cb.dns_addr;
+                s_sal_cb.dns_addr_list[1] = NULL;
+                s_sal_cb.dns_host.h_name = s_sal_cb.dns_cache[i].name;
+                s_sal_cb.dns_host.h_aliases = &s_sal_cb.dns_addr_list[1];
+                s_sal_cb.dns_host.h_addrtype = AF_INET;
+                s_sal_cb.dns_host.h_length = sizeof(in_addr_t);
+                s_sal_cb.dns_host.h_addr_list = s_sal_cb.dns_addr_list;
+                ret = &s_sal_cb.dns_host;
+            }
+            else
+            {
+                s_sal_cb.dns_cache[i].expire = 0;
+            }
+            break;
+        }
+    }
+    (void) osal_mutex_unlock(s_sal_cb.sock_cb_mutex);
+
+    return ret;
+}
+
+///< keep the first ipv4 address, replacing the entry of the same name, a free one or the one expires first
+static void __sal_dns_keep(const char *name, const struct hostent *host)
+{
+    tag_dns_cache *entry;
+    int i;
+
+    if((NULL == host) || (AF_INET != host->h_addrtype) || (NULL == host->h_addr_list) || \
+       (NULL == host->h_addr_list[0]) || (strlen(name) >= CN_SAL_DNS_NAMELEN) || __sal_dns_isdotted(name))
+    {
+        return;
+    }
+    if((NULL == s_sal_cb.sock_cb_tab) || (false == osal_mutex_lock(s_sal_cb.sock_cb_mutex)))
+    {
+        return;
+    }
+    entry = &s_sal_cb.dns_cache[0];
+    for(i = 0; i < CONFIG_SAL_DNS_CACHE_SIZE; i++)
+    {
+        if((0 != s_sal_cb.dns_cache[i].expire) && (0 == strcmp(s_sal_cb.dns_cache[i].name, name)))
+        {
+            entry = &s_sal_cb.dns_cache[i];
+            break;
+        }
+        if(s_sal_cb.dns_cache[i].expire < entry->expire)
+        {
+            entry = &s_sal_cb.dns_cache[i];
+        }
+    }
+    (void) strcpy(entry->name, name);
+    (void) memcpy(&entry->addr, host->h_addr_list[0], sizeof(entry->addr));
+    entry->expire = osal_sys_time() + (unsigned long long)CONFIG_SAL_DNS_CACHE_TTL * 1000;
+    (void) osal_mutex_unlock(s_sal_cb.sock_cb_mutex);
+
+    return;
+}
+
+void sal_dns_flush(const char *name)
+{
+    int i;
+
+    if((NULL == s_sal_cb.sock_cb_tab) || (false == osal_mutex_lock(s_sal_cb.sock_cb_mutex)))
+    {
+        return;
+    }
+    for(i = 0; i < CONFIG_SAL_DNS_CACHE_SIZE; i++)
+    {
+        if((NULL == name) || (0 == strcmp(s_sal_cb.dns_cache[i].name, name)))
+        {
+            s_sal_cb.dns_cache[i].expire = 0;
+        }
+    }
+    (void) osal_mutex_unlock(s_sal_cb.sock_cb_mutex);
+
+    return;
+}
+
+#else
+
+void sal_dns_flush(const char *name)
+{
+    (void) name;
+    return;
+}
+
+#endif
+
 struct hostent * sal_gethostbyname(const char *name)
 {
     struct hostent *ret =NULL;
+
+#if CONFIG_SAL_DNS_CACHE_SIZE > 0
+    if(NULL == name)
+    {
+        return ret;
+    }
+    ret = __sal_dns_lookup(name);
+    if(NULL != ret)
+    {
+        return ret;
+    }
+#endif
+
     if((NULL != s_sal_cb.domain)&&(NULL != s_sal_cb.domain->ops) &&\
        (NULL != s_sal_cb.domain->ops->gethostbyname))
     {
         ret = (struct hostent *)s_sal_cb.domain->ops->gethostbyname(name);
+#if CONFIG_SAL_DNS_CACHE_SIZE > 0
+        __sal_dns_keep(name, ret);
+#endif
     }
     return ret;
 }
 
 #ifndef __KEIL__
+///< the sets come with the sal fds while the implement selects its own sockets, so they are mapped to the
+///< sockets and back; all the fds in the sets should be of the same implement
 int sal_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout)
 {
     int ret = -1;
+    int fd;
+    int i;
+    int maxsock = -1;
+    fd_set *sets[3];
+    fd_set socks[3];
     tag_sock_cb *sockcb;
+    const tag_tcpip_ops *ops = NULL;
 
-    sockcb = __sal_sockcb_getcb(nfds-1);
-    if(NULL != sockcb)
+    sets[0] = readfds;
+    sets[1] = writefds;
+    sets[2] = exceptfds;
+    for(i = 0; i < 3; i++)
+    {
+        FD_ZERO(&socks[i]);
+    }
+    for(fd = 0; fd < nfds; fd++)
+    {
+        sockcb = __sal_sockcb_getcb(fd);
+        for(i = 0; (NULL != sockcb) && (i < 3); i++)
+        {
+            if((NULL != sets[i]) && FD_ISSET(fd, sets[i]))
+            {
+                FD_SET(sockcb->sock, &socks[i]);
+                maxsock = (sockcb->sock > maxsock) ? sockcb->sock : maxsock;
+                ops = sockcb->ops;
+            }
+        }
+    }
+
+    if((NULL != ops) && (NULL != ops->select))
     {
-        if((NULL != sockcb->ops)&&(NULL != sockcb->ops->select))
+        ret = ops->select(maxsock + 1, (NULL != readfds) ? &socks[0] : NULL, (NULL != writefds) ? &socks[1] : NULL,
+                          (NULL != exceptfds) ? &socks[2] : NULL, timeout);
+    }
+    for(fd = 0; (ret >= 0) && (fd < nfds); fd++)
+    {
+        sockcb = __sal_sockcb_getcb(fd);
+        for(i = 0; i < 3; i++)
         {
-            ret = sockcb->ops->select(sockcb->sock+1, readfds, writefds, exceptfds, timeout);
+            if((NULL != sets[i]) && FD_ISSET(fd, sets[i]) && ((NULL == sockcb) || !FD_ISSET(sockcb->sock, &socks[i])))
+            {
+                FD_CLR(fd, sets[i]);
+            }
         }
     }
 
@@ -354,6 +354,7 @@ static int ec2x_oc_msg_deal(void *args,void *msg,size_t len)
         oc_msg.qos = qos;
         oc_msg.msg.data = payload;
         oc_msg.msg.len = payload_len;
+        oc_msg.total = payload_len;
 
         if(NULL != s_ec2x_cb.msg_dealer)
         {
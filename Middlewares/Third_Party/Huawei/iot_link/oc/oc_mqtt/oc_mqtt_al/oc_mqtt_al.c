@@ -87,6 +87,26 @@ int oc_mqtt_publish(char  *topic,uint8_t *msg,int msg_len,int qos)
     return ret;
 }
 
+int oc_mqtt_publish_async(char *topic,uint8_t *msg,int msg_len,int qos,fn_oc_mqtt_pubdone done,void *arg)
+{
+    int ret =(int)en_oc_mqtt_err_system;
+
+    if((NULL != s_oc_mqtt) &&(NULL != s_oc_mqtt->op.publish_async))
+    {
+       ret = s_oc_mqtt->op.publish_async(topic,msg,msg_len,qos,done,arg);
+    }
+    else if((NULL != s_oc_mqtt) &&(NULL != s_oc_mqtt->op.publish))
+    {
+       ret = s_oc_mqtt->op.publish(topic,msg,msg_len,qos);
+       if(((int)en_oc_mqtt_err_ok == ret) && (NULL != done))
+       {
+           done(arg,ret);
+       }
+    }
+
+    return ret;
+}
+
 int oc_mqtt_report(uint8_t *msg, int len, int qos)
 {
     int ret =(int)en_oc_mqtt_err_system;
@@ -109,6 +129,23 @@ int oc_mqtt_subscribe(char *topic,int qos)
 }
 
 
+int oc_mqtt_subscribe_ex(char *topic,int qos,fn_oc_mqtt_msg_deal dealer,void *arg)
+{
+    int ret =(int)en_oc_mqtt_err_system;
+
+    if(NULL == dealer)
+    {
+        ret = oc_mqtt_subscribe(topic,qos);
+    }
+    else if((NULL != s_oc_mqtt) &&(NULL != s_oc_mqtt->op.subscribe_ex))
+    {
+       ret = s_oc_mqtt->op.subscribe_ex(topic,qos,dealer,arg);
+    }
+
+    return ret;
+}
+
+
 int oc_mqtt_unsubscribe(char *topic)
 {
     int ret =(int)en_oc_mqtt_err_system;
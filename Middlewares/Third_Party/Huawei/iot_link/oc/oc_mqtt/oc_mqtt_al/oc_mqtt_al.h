@@ -113,6 +113,11 @@ typedef  int (*fn_oc_mqtt_deconfig)(void);
 typedef  int (*fn_oc_mqtt_publish)(char *topic,uint8_t *msg,int msg_len,int qos);
 typedef  int (*fn_oc_mqtt_subscribe)(char *topic, int qos);
 typedef  int (*fn_oc_mqtt_unsubscribe)(char *topic);
+typedef  int (*fn_oc_mqtt_subscribe_ex)(char *topic, int qos, fn_oc_mqtt_msg_deal dealer, void *arg);
+///< the code of the done callback defines by en_oc_mqtt_err_code
+typedef  void (*fn_oc_mqtt_pubdone)(void *arg, int code);
+typedef  int (*fn_oc_mqtt_publish_async)(char *topic,uint8_t *msg,int msg_len,int qos,\
+                                         fn_oc_mqtt_pubdone done,void *arg);
 
 
 /**
@@ -126,6 +131,8 @@ typedef struct
     fn_oc_mqtt_publish     publish;      ///< this function added by the new device profile
     fn_oc_mqtt_subscribe   subscribe;    ///< this function make the tiny extended
     fn_oc_mqtt_unsubscribe unsubscribe;  ///< this function make the tiny extended
+    fn_oc_mqtt_publish_async publish_async; ///< could be NULL, then the publish is called instead
+    fn_oc_mqtt_subscribe_ex  subscribe_ex;  ///< could be NULL, then only the config msg_deal is supported
 }oc_mqtt_op_t;
 
 typedef struct
@@ -188,10 +195,38 @@ int oc_mqtt_deconfig(void);
  *
  * @param[in] msg_len:the message length
  *
+ * @param[in] qos: defines as the mqtt does, could be or-ed with cn_oc_mqtt_qos_alarm
+ *
  * @return code: define by en_oc_mqtt_err_code while 0 means success
+ *
+ * @note: when the implement has the offline outbox, the message is queued while the
+ *        connection is not ready and sent later, and en_oc_mqtt_err_ok is returned
  */
+#define cn_oc_mqtt_qos_mask      0x03       ///< the mqtt qos bits of the qos parameter
+#define cn_oc_mqtt_qos_alarm    (1<<4)      ///< the alarm message overtakes the queued normal ones
 int oc_mqtt_publish(char *topic,uint8_t *msg,int msg_len,int qos);
 
+/**
+ * @brief the application use this function to publish message without waiting the network
+ *
+ * @param[in] topic: the destination topic, NULL means the default topic
+ *
+ * @param[in] msg:the message to send, copied before return
+ *
+ * @param[in] msg_len:the message length
+ *
+ * @param[in] qos: the same as oc_mqtt_publish
+ *
+ * @param[in] done: called with the publish result in the agent task, could be NULL
+ *
+ * @param[in] arg: the parameter passed to the done
+ *
+ * @return code: define by en_oc_mqtt_err_code while 0 means the message has been accepted,
+ *               and only then the done will be called; parafmt when the message is bigger than
+ *               the async ring, while sysmem when the ring is full for now
+ */
+int oc_mqtt_publish_async(char *topic,uint8_t *msg,int msg_len,int qos,fn_oc_mqtt_pubdone done,void *arg);
+
 /**
  * @brief the application use this function to subscribe the specified topic
  *
@@ -203,6 +238,23 @@ int oc_mqtt_publish(char *topic,uint8_t *msg,int msg_len,int qos);
  */
  int oc_mqtt_subscribe(char *topic,int qos);
 
+/**
+ * @brief the application use this function to subscribe the topic with its own dealer
+ *
+ * @param[in] topic: the topic filter, '+' and '#' wildcards supported
+ *
+ * @param[in] qos:the topic qos
+ *
+ * @param[in] dealer: called for the messages matching the topic, NULL means the config msg_deal
+ *
+ * @param[in] arg: the parameter passed to the dealer
+ *
+ * @return code: define by en_oc_mqtt_err_code while 0 means success
+ *
+ * @note: the message matching several subscribed topics is passed to each of their dealers
+ */
+ int oc_mqtt_subscribe_ex(char *topic,int qos,fn_oc_mqtt_msg_deal dealer,void *arg);
+
 /**
  * @brief the application use this function to unsubscribe the specified topic
  *
@@ -45,11 +45,21 @@
 #include <oc_mqtt_al.h>
 #include <oc_mqtt_profile.h>
 #include <oc_mqtt_profile_package.h>
+#include <link_json.h>
+
+#ifndef CONFIG_OC_MQTT_PROFILE_MSGBUFLEN
+#define CONFIG_OC_MQTT_PROFILE_MSGBUFLEN      256   ///< the message is written on the stack, the bigger one uses the heap
+#endif
+
+#ifndef CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN
+#define CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN    128
+#endif
 
 typedef struct
 {
     char                        *device_id;
     fn_oc_mqtt_profile_rcvdeal   rcvfunc;
+    int                          format;    ///< en_oc_mqtt_profile_format_t
 }oc_mqtt_profile_cb_t;
 
 static oc_mqtt_profile_cb_t s_oc_mqtt_profile_cb;
@@ -181,6 +191,7 @@ int oc_mqtt_profile_connect(oc_mqtt_profile_connect_t *payload)
     }
     s_oc_mqtt_profile_cb.device_id = osal_strdup(payload->device_id);
     s_oc_mqtt_profile_cb.rcvfunc = payload->rcvfunc;
+    s_oc_mqtt_profile_cb.format = (int)payload->format;
     ret = oc_mqtt_config(&config);
 
     return ret;
@@ -204,8 +215,8 @@ int oc_mqtt_profile_disconnect(void)
 
 
 ///< use this function to make a topic to publish
-///< if request_id  is needed depends on the fmt
-static char *topic_make(char *fmt, char *device_id, char *request_id)
+///< if request_id  is needed depends on the fmt; the buf is used if it is big enough
+static char *topic_make(char *buf, int buflen, char *fmt, char *device_id, char *request_id)
 {
     int len;
     char *ret = NULL;
@@ -220,7 +231,7 @@ static char *topic_make(char *fmt, char *device_id, char *request_id)
         len += strlen(request_id);
     }
 
-    ret = osal_malloc(len);
+    ret = (len <= buflen) ? buf : osal_malloc(len);
     if(NULL != ret)
     {
         (void) snprintf(ret,len,fmt,device_id,request_id);
@@ -228,14 +239,55 @@ static char *topic_make(char *fmt, char *device_id, char *request_id)
     return ret;
 }
 
+///< use this function to end the message written to the stack buffer, NULL if it is too big
+static char *msg_make(json_writer_t *writer, int ret, char *buf, int *len)
+{
+    if((0 == ret) && ((*len = json_writer_end(writer)) >= 0))
+    {
+        return buf;
+    }
+
+    return NULL;
+}
+
+///< use this function to publish the message and release the topic and message not on the stack
+static int msg_publish(char *topic, char *topicbuf, char *msg, int msglen, char *msgbuf)
+{
+    int ret;
+
+    if((NULL != topic) && (NULL != msg))
+    {
+        ret = oc_mqtt_publish(topic,(uint8_t *)msg,msglen,(int)en_mqtt_al_qos_1);
+    }
+    else
+    {
+        ret = (int)en_oc_mqtt_err_sysmem;
+    }
+
+    if(topic != topicbuf)
+    {
+        osal_free(topic);
+    }
+    if(msg != msgbuf)
+    {
+        osal_free(msg);
+    }
+
+    return ret;
+}
+
 
 ///< use this function to report the messsage
 #define CN_OC_MQTT_PROFILE_MSGUP_TOPICFMT   "$oc/devices/%s/sys/messages/up"
 int oc_mqtt_profile_msgup(char *deviceid,oc_mqtt_profile_msgup_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -254,20 +306,15 @@ int oc_mqtt_profile_msgup(char *deviceid,oc_mqtt_profile_msgup_t *payload)
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_MSGUP_TOPICFMT, deviceid,NULL);
-    msg = oc_mqtt_profile_package_msgup(payload);
-
-    if((NULL != topic) && (NULL != msg))
-    {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_MSGUP_TOPICFMT, deviceid,NULL);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_msgup(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
     {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        msg = oc_mqtt_profile_encode_msgup(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
@@ -276,8 +323,12 @@ int oc_mqtt_profile_msgup(char *deviceid,oc_mqtt_profile_msgup_t *payload)
 int oc_mqtt_profile_propertyreport(char *deviceid,oc_mqtt_profile_service_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -296,30 +347,193 @@ int oc_mqtt_profile_propertyreport(char *deviceid,oc_mqtt_profile_service_t *pay
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_PROPERTYREPORT_TOPICFMT, deviceid,NULL);
-    msg = oc_mqtt_profile_package_propertyreport(payload);
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_PROPERTYREPORT_TOPICFMT, deviceid,NULL);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_propertyreport(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
+    {
+        msg = oc_mqtt_profile_encode_propertyreport(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
+    }
+
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
-    if((NULL != topic) && (NULL != msg))
+    return ret;
+}
+
+void *oc_mqtt_profile_template_create(char *deviceid,oc_mqtt_profile_service_t *payload)
+{
+    oc_mqtt_profile_template_t *tpl;
+
+    if(NULL == deviceid)
     {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
+        deviceid = s_oc_mqtt_profile_cb.device_id;
     }
-    else
+
+    if((NULL == deviceid) || (NULL== payload) || (NULL== payload->service_id) || (NULL == payload->service_property))
     {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        return NULL;
+    }
+
+    tpl = oc_mqtt_profile_template_compile(payload,s_oc_mqtt_profile_cb.format);
+    if(NULL != tpl)
+    {
+        tpl->topic = topic_make(NULL,0,CN_OC_MQTT_PROFILE_PROPERTYREPORT_TOPICFMT, deviceid,NULL);
+        if(NULL == tpl->topic)
+        {
+            osal_free(tpl);
+            tpl = NULL;
+        }
+    }
+
+    return tpl;
+}
+
+int oc_mqtt_profile_template_report(void *handle)
+{
+    int ret = (int)en_oc_mqtt_err_parafmt;
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
+    oc_mqtt_profile_template_t *tpl;
+    char *msg;
+    int msglen = 0;
+
+    tpl = handle;
+    if(NULL == tpl)
+    {
+        return ret;
+    }
+
+    ///< only the values are formatted, the others are copied from the compiled text in its format
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),tpl->format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_template(&writer,tpl),msgbuf,&msglen);
+    if(NULL == msg)
+    {
+        msg = oc_mqtt_profile_encode_template(tpl,tpl->format,&msglen);  ///< too big for the stack buffer
+    }
+
+    ret = msg_publish(tpl->topic,tpl->topic,msg,msglen,msgbuf);
+
+    return ret;
+}
+
+int oc_mqtt_profile_template_delete(void *handle)
+{
+    oc_mqtt_profile_template_t *tpl;
+
+    tpl = handle;
+    if(NULL == tpl)
+    {
+        return (int)en_oc_mqtt_err_parafmt;
+    }
+
+    osal_free(tpl->topic);
+    osal_free(tpl);
+
+    return (int)en_oc_mqtt_err_ok;
+}
+
+void *oc_mqtt_profile_batch_create(char *deviceid,oc_mqtt_profile_service_t *payload,int size)
+{
+    oc_mqtt_profile_batch_t *batch;
+
+    if(NULL == deviceid)
+    {
+        deviceid = s_oc_mqtt_profile_cb.device_id;
+    }
+
+    if((NULL == deviceid) || (NULL== payload) || (NULL== payload->service_id) || (NULL == payload->service_property))
+    {
+        return NULL;
+    }
+
+    batch = oc_mqtt_profile_batch_alloc(payload,size);
+    if(NULL != batch)
+    {
+        batch->topic = topic_make(NULL,0,CN_OC_MQTT_PROFILE_PROPERTYREPORT_TOPICFMT, deviceid,NULL);
+        if(NULL == batch->topic)
+        {
+            oc_mqtt_profile_batch_free(batch);
+            batch = NULL;
+        }
+    }
+
+    return batch;
+}
+
+int oc_mqtt_profile_batch_add(void *handle,unsigned long utc)
+{
+    if(NULL == handle)
+    {
+        return -1;
+    }
+
+    return oc_mqtt_profile_batch_push(handle,utc);
+}
+
+int oc_mqtt_profile_batch_count(void *handle)
+{
+    oc_mqtt_profile_batch_t *batch = handle;
+
+    return (NULL == batch) ? -1 : batch->count;
+}
+
+int oc_mqtt_profile_batch_report(void *handle)
+{
+    int ret = (int)en_oc_mqtt_err_parafmt;
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
+    oc_mqtt_profile_batch_t *batch;
+    char *msg;
+    int msglen = 0;
+
+    batch = handle;
+    if((NULL == batch) || (0 == batch->count))
+    {
+        return ret;
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_batch(&writer,batch),msgbuf,&msglen);
+    if(NULL == msg)
+    {
+        msg = oc_mqtt_profile_encode_batch(batch,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
+    }
+
+    ret = msg_publish(batch->topic,batch->topic,msg,msglen,msgbuf);
+    if(ret == (int)en_oc_mqtt_err_ok)
+    {
+        oc_mqtt_profile_batch_clear(batch);
+    }
 
     return ret;
 }
 
+int oc_mqtt_profile_batch_delete(void *handle)
+{
+    oc_mqtt_profile_batch_t *batch;
+
+    batch = handle;
+    if(NULL == batch)
+    {
+        return (int)en_oc_mqtt_err_parafmt;
+    }
+
+    osal_free(batch->topic);
+    oc_mqtt_profile_batch_free(batch);
+
+    return (int)en_oc_mqtt_err_ok;
+}
+
 #define CN_OC_MQTT_PROFILE_GWPROPERTYREPORT_TOPICFMT   "$oc/devices/%s/sys/gateway/sub_devices/properties/report"
 int oc_mqtt_profile_gwpropertyreport(char *deviceid,oc_mqtt_profile_device_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -339,20 +553,15 @@ int oc_mqtt_profile_gwpropertyreport(char *deviceid,oc_mqtt_profile_device_t *pa
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_GWPROPERTYREPORT_TOPICFMT, deviceid,NULL);
-    msg = oc_mqtt_profile_package_gwpropertyreport(payload);
-
-    if((NULL != topic) && (NULL != msg))
-    {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_GWPROPERTYREPORT_TOPICFMT, deviceid,NULL);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_gwpropertyreport(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
     {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        msg = oc_mqtt_profile_encode_gwpropertyreport(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
@@ -362,8 +571,12 @@ int oc_mqtt_profile_gwpropertyreport(char *deviceid,oc_mqtt_profile_device_t *pa
 int oc_mqtt_profile_propertysetresp(char *deviceid,oc_mqtt_profile_propertysetresp_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -381,20 +594,15 @@ int oc_mqtt_profile_propertysetresp(char *deviceid,oc_mqtt_profile_propertysetre
     {
         return ret;
     }
-    topic = topic_make(CN_OC_MQTT_PROFILE_ROPERTYSETRESP_TOPICFMT, deviceid,payload->request_id);
-    msg = oc_mqtt_profile_package_propertysetresp(payload);
-
-    if((NULL != topic) && (NULL != msg))
-    {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_ROPERTYSETRESP_TOPICFMT, deviceid,payload->request_id);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_propertysetresp(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
     {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        msg = oc_mqtt_profile_encode_propertysetresp(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
@@ -404,8 +612,12 @@ int oc_mqtt_profile_propertysetresp(char *deviceid,oc_mqtt_profile_propertysetre
 int oc_mqtt_profile_propertygetresp(char *deviceid,oc_mqtt_profile_propertygetresp_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -425,20 +637,15 @@ int oc_mqtt_profile_propertygetresp(char *deviceid,oc_mqtt_profile_propertygetre
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_ROPERTYGETRESP_TOPICFMT, deviceid,payload->request_id);
-    msg = oc_mqtt_profile_package_propertygetresp(payload);
-
-    if((NULL != topic) && (NULL != msg))
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_ROPERTYGETRESP_TOPICFMT, deviceid,payload->request_id);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_propertygetresp(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
     {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else
-    {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        msg = oc_mqtt_profile_encode_propertygetresp(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
@@ -447,8 +654,12 @@ int oc_mqtt_profile_propertygetresp(char *deviceid,oc_mqtt_profile_propertygetre
 int oc_mqtt_profile_cmdresp(char *deviceid,oc_mqtt_profile_cmdresp_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -467,20 +678,15 @@ int oc_mqtt_profile_cmdresp(char *deviceid,oc_mqtt_profile_cmdresp_t *payload)
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_CMDRESP_TOPICFMT, deviceid,payload->request_id);
-    msg = oc_mqtt_profile_package_cmdresp(payload);
-
-    if((NULL != topic) && (NULL != msg))
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_CMDRESP_TOPICFMT, deviceid,payload->request_id);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_cmdresp(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
     {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else
-    {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        msg = oc_mqtt_profile_encode_cmdresp(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
@@ -489,8 +695,12 @@ int oc_mqtt_profile_cmdresp(char *deviceid,oc_mqtt_profile_cmdresp_t *payload)
 int oc_mqtt_profile_getshadow(char *deviceid,oc_mqtt_profile_shadowget_t *payload)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid)
     {
@@ -509,20 +719,15 @@ int oc_mqtt_profile_getshadow(char *deviceid,oc_mqtt_profile_shadowget_t *payloa
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_GETSHADOW_TOPICFMT, deviceid,payload->request_id);
-    msg = oc_mqtt_profile_package_shadowget(payload);
-
-    if((NULL != topic) && (NULL != msg))
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_GETSHADOW_TOPICFMT, deviceid,payload->request_id);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_shadowget(&writer,payload),msgbuf,&msglen);
+    if(NULL == msg)
     {
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else
-    {
-        ret = (int)en_oc_mqtt_err_sysmem;
+        msg = oc_mqtt_profile_encode_shadowget(payload,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
@@ -532,8 +737,12 @@ int oc_mqtt_profile_getshadow(char *deviceid,oc_mqtt_profile_shadowget_t *payloa
 int oc_mqtt_profile_reportevent(char *deviceid,oc_mqtt_profile_event_t *event)
 {
     int ret = (int)en_oc_mqtt_err_parafmt;
+    char topicbuf[CONFIG_OC_MQTT_PROFILE_TOPICBUFLEN];
+    char msgbuf[CONFIG_OC_MQTT_PROFILE_MSGBUFLEN];
+    json_writer_t writer;
     char *topic;
     char *msg;
+    int msglen = 0;
 
     if(NULL == deviceid){
         if(NULL == s_oc_mqtt_profile_cb.device_id){
@@ -548,18 +757,15 @@ int oc_mqtt_profile_reportevent(char *deviceid,oc_mqtt_profile_event_t *event)
         return ret;
     }
 
-    topic = topic_make(CN_OC_MQTT_PROFILE_EVENT_TOPICFMT, deviceid,NULL);
-    msg = oc_mqtt_profile_package_event(event);
-
-    if((topic != NULL) && (msg != NULL)){
-        ret = oc_mqtt_publish(topic,(uint8_t *)msg,strlen(msg),(int)en_mqtt_al_qos_1);
-    }
-    else{
-        ret = (int)en_oc_mqtt_err_sysmem;
+    topic = topic_make(topicbuf,sizeof(topicbuf),CN_OC_MQTT_PROFILE_EVENT_TOPICFMT, deviceid,NULL);
+    (void) oc_mqtt_profile_writer_init(&writer,msgbuf,sizeof(msgbuf),s_oc_mqtt_profile_cb.format);
+    msg = msg_make(&writer,oc_mqtt_profile_write_event(&writer,event),msgbuf,&msglen);
+    if(NULL == msg)
+    {
+        msg = oc_mqtt_profile_encode_event(event,s_oc_mqtt_profile_cb.format,&msglen);  ///< too big for the stack buffer
     }
 
-    osal_free(topic);
-    osal_free(msg);
+    ret = msg_publish(topic,topicbuf,msg,msglen,msgbuf);
 
     return ret;
 }
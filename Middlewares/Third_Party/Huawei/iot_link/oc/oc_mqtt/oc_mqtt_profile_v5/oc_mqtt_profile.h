@@ -130,6 +130,13 @@ typedef struct
  * */
 typedef int (*fn_oc_mqtt_profile_rcvdeal)(oc_mqtt_profile_msgrcv_t *payload);
 
+///< the encoding of the reported messages, the platform must be configured to decode the CBOR
+typedef enum
+{
+    EN_OC_MQTT_PROFILE_FORMAT_JSON = 0,
+    EN_OC_MQTT_PROFILE_FORMAT_CBOR,        ///< RFC 7049, the same data model as the json in about half the size
+}en_oc_mqtt_profile_format_t;
+
 typedef struct
 {
     int boostrap;              ///< we use the bootstrap mode or not
@@ -144,6 +151,7 @@ typedef struct
 
     fn_oc_mqtt_profile_rcvdeal   rcvfunc;
     fn_oc_mqtt_log               logfunc;
+    en_oc_mqtt_profile_format_t  format;   ///< the report encoding, zero is the json
 
 }oc_mqtt_profile_connect_t;
 
@@ -208,6 +216,87 @@ typedef struct
  * */
 int oc_mqtt_profile_propertyreport(char *deviceid,oc_mqtt_profile_service_t *payload);
 
+/**
+ * @brief: use this function to compile the property report to a template, the keys, the service ids and
+ *         the structure are rendered once, and each report only formats the values into it
+ *
+ * @param[in] deviceid: the cloud message receiver, if NULL then send to the connected one
+ *
+ * @param[in] payload: properties list to send to the platform; the list is referenced by the template, so
+ *                     keep it until the template deleted, the values and the event time are read at each report
+ *
+ * @note: the template is encoded in the format of the connection when it is created
+ *
+ * @return :the template handle, NULL failed
+ *
+ * */
+void *oc_mqtt_profile_template_create(char *deviceid,oc_mqtt_profile_service_t *payload);
+
+/**
+ * @brief: use this function to report the properties with the template
+ *
+ * @param[in] handle: the template got from oc_mqtt_profile_template_create
+ *
+ * @return :defined as en_oc_mqtt_err_code_t
+ *
+ * */
+int oc_mqtt_profile_template_report(void *handle);
+
+/**
+ * @brief: use this function to delete the template
+ *
+ * @param[in] handle: the template got from oc_mqtt_profile_template_create
+ *
+ * @return :defined as en_oc_mqtt_err_code_t
+ *
+ * */
+int oc_mqtt_profile_template_delete(void *handle);
+
+/**
+ * @brief: use this function to create a batch, which keeps the property samples and reports them in one message,
+ *         so the modem could be waked once for many samples
+ *
+ * @param[in] deviceid: the cloud message receiver, if NULL then send to the connected one
+ *
+ * @param[in] payload: properties list to sample; the list is referenced by the batch, so keep it until the batch
+ *                     deleted, the values are read at each oc_mqtt_profile_batch_add and the event time is not used
+ *
+ * @param[in] size: the ring size to keep the samples, each sample takes the time delta and the values packed
+ *
+ * @return :the batch handle, NULL failed
+ *
+ * */
+void *oc_mqtt_profile_batch_create(char *deviceid,oc_mqtt_profile_service_t *payload,int size);
+
+/**
+ * @brief: use this function to add a sample of the current property values to the batch
+ *
+ * @param[in] handle: the batch got from oc_mqtt_profile_batch_create
+ *
+ * @param[in] utc: the sample time, seconds since 1970-01-01 UTC, reported as the event time
+ *
+ * @return :how many oldest samples dropped to make room, while -1 failed
+ *
+ * */
+int oc_mqtt_profile_batch_add(void *handle,unsigned long utc);
+
+///< use this function to get how many samples in the batch, -1 failed
+int oc_mqtt_profile_batch_count(void *handle);
+
+/**
+ * @brief: use this function to report all the samples in one property report, each service of each sample
+ *         with its event time; the batch is emptied when the report success
+ *
+ * @param[in] handle: the batch got from oc_mqtt_profile_batch_create
+ *
+ * @return :defined as en_oc_mqtt_err_code_t
+ *
+ * */
+int oc_mqtt_profile_batch_report(void *handle);
+
+///< use this function to delete the batch, the samples not reported are dropped
+int oc_mqtt_profile_batch_delete(void *handle);
+
 typedef struct
 {
     void *nxt;                                                  ///< maybe much more
@@ -37,639 +37,748 @@
  *
  */
 ////< this file used to package the data for the profile and you must make sure the data format is right
+#include <string.h>
+#include <stdio.h>
+#include <osal.h>
 #include <oc_mqtt_profile.h>
 #include <oc_mqtt_profile_package.h>
-#include <cJSON.h>
-
-
+#include <link_json.h>
 
 
 ///< format the report data to json string mode
-static cJSON  *JsonCreateKv(oc_mqtt_profile_kv_t  *kv)
+static int JsonWriteKv(json_writer_t *writer, oc_mqtt_profile_kv_t  *kv)
 {
-    cJSON  *ret = NULL;
+    int ret = -1;
     switch (kv->type)
     {
         case EN_OC_MQTT_PROFILE_VALUE_INT:
-            ret = cJSON_CreateNumber((double)(*(int *)kv->value));
+            ret = json_writer_int(writer,(long)(*(int *)kv->value));
             break;
         case EN_OC_MQTT_PROFILE_VALUE_LONG:
-            ret = cJSON_CreateNumber((double)(*(long *)kv->value));
+            ret = json_writer_int(writer,(*(long *)kv->value));
             break;
         case EN_OC_MQTT_PROFILE_VALUE_FLOAT:
-            ret = cJSON_CreateNumber((double)(*(float *)kv->value));
+            ret = json_writer_float(writer,(*(float *)kv->value));
             break;
         case EN_OC_MQTT_PROFILE_VALUE_DOUBLE:
-            ret = cJSON_CreateNumber((*(double *)kv->value));
+            ret = json_writer_double(writer,(*(double *)kv->value));
             break;
         case EN_OC_MQTT_PROFILE_VALUE_STRING:
-            ret = cJSON_CreateString((const char *)kv->value);
+            ret = json_writer_string(writer,(const char *)kv->value);
             break;
         default:
+            writer->err = -1;   ///< unknown type, fail the whole package
             break;
     }
 
     return ret;
 }
 
-char *oc_mqtt_profile_package_msgup(oc_mqtt_profile_msgup_t *payload)
+///< write the key and the string value if the value is not NULL
+static int JsonWriteKeyString(json_writer_t *writer, const char *key, const char *value)
 {
+    int ret = 0;
 
-    char *ret = NULL;
-    cJSON *root = NULL;
-    cJSON *device_id = NULL;
-    cJSON *msg_name;
-    cJSON *msg_id;
-    cJSON *msg_conntent;
-
-    root = cJSON_CreateObject();
-    if(NULL == root)
+    if(NULL != value)
     {
-        goto EXIT_MEM;
+        (void) json_writer_key(writer, key);
+        ret = json_writer_string(writer, value);
     }
 
-    if(NULL != payload->device_id)
-    {
-        device_id = cJSON_CreateString(payload->device_id);
-        if(NULL == device_id)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_OBJECTDEVICEID,device_id);
-    }
+    return ret;
+}
+
+int oc_mqtt_profile_write_msgup(json_writer_t *writer, oc_mqtt_profile_msgup_t *payload)
+{
+    (void) json_writer_begin_object(writer);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_OBJECTDEVICEID,payload->device_id);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_NAME,payload->name);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_ID,payload->id);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_CONTENT);
+    (void) json_writer_string(writer,payload->msg);
+
+    return json_writer_end_object(writer);
+}
 
-    if(NULL != payload->name)
-    {
-        msg_name = cJSON_CreateString(payload->name);
-        if(NULL == msg_name)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_NAME,msg_name);
-    }
 
-    if(NULL != payload->id)
+///< write the value, or leave the slot for the value when compiling the template; the kv is the property
+///< value while the str is the string such as the event time
+static int JsonWriteSlot(json_writer_t *writer, oc_mqtt_profile_template_t *tpl, oc_mqtt_profile_kv_t *kv, char **str)
+{
+    oc_mqtt_profile_slot_t *slot;
+
+    if(NULL == tpl)
     {
-        msg_id = cJSON_CreateString(payload->id);
-        if(NULL == msg_id)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_ID,msg_id);
+        return (NULL != kv) ? JsonWriteKv(writer,kv) : json_writer_string(writer,*str);
     }
 
-    msg_conntent = cJSON_CreateString(payload->msg);
-    if(NULL == msg_conntent)
+    if((NULL != kv) && (kv->type >= EN_OC_MQTT_PROFILE_VALUE_LAST))
     {
-        goto EXIT_MEM;
+        writer->err = -1;
+        return -1;
     }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_CONTENT,msg_conntent);
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
-
-EXIT_MEM:
-    if(NULL != root)
+    ///< the first pass only counts the slots
+    if(NULL != tpl->slots)
     {
-       cJSON_Delete(root);
+        slot = &tpl->slots[tpl->slotnum];
+        slot->kv = kv;
+        slot->str = str;
+        slot->offset = writer->total;
     }
-    return ret;
-}
+    tpl->slotnum++;
 
+    return json_writer_raw(writer,"",0);
+}
 
-static cJSON *JsonCreateKvLst(oc_mqtt_profile_kv_t *kvlst)
+static int JsonWriteKvLst(json_writer_t *writer, oc_mqtt_profile_template_t *tpl, oc_mqtt_profile_kv_t *kvlst)
 {
-
-    cJSON *root;
-    cJSON *kv;
     oc_mqtt_profile_kv_t  *kv_info;
 
-    ///< build a root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
-    {
-       goto EXIT_MEM;
-    }
+    (void) json_writer_begin_object(writer);
 
     ///< add all the property to the properties
     kv_info = kvlst;
     while(NULL != kv_info)
     {
-        kv = JsonCreateKv( kv_info);
-        if(NULL == kv)
-        {
-            goto EXIT_MEM;
-        }
-
-        cJSON_AddItemToObject(root,kv_info->key,kv);
+        (void) json_writer_key(writer,kv_info->key);
+        (void) JsonWriteSlot(writer,tpl,kv_info,NULL);
         kv_info = kv_info->nxt;
     }
 
-    ///< OK, now we return it
-    return root;
-
-EXIT_MEM:
-    if(NULL != root)
-    {
-       cJSON_Delete(root);
-       root = NULL;
-    }
-    return root;
-
-
+    return json_writer_end_object(writer);
 }
 
-
-
-static cJSON *JsonCreateService(oc_mqtt_profile_service_t *service_info)
+static int JsonWriteService(json_writer_t *writer, oc_mqtt_profile_template_t *tpl, oc_mqtt_profile_service_t *service_info)
 {
+    (void) json_writer_begin_object(writer);
 
-    cJSON *root;
-    cJSON *service_id;
-    cJSON *properties;
-    cJSON *event_time;
+    ///< the service_id could not be NULL
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICEID);
+    (void) json_writer_string(writer,service_info->service_id);
 
-    ///< build a root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
-    {
-       goto EXIT_MEM;
-    }
-
-    ///< add the service_id node to the root node
-    service_id = cJSON_CreateString(service_info->service_id);
-    if(NULL == service_id)
-    {
-       goto EXIT_MEM;
-    }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_SERVICEID,service_id);
-
-    ///< add the properties node to the root
-    properties = JsonCreateKvLst(service_info->service_property);
-    if(NULL == properties)
-    {
-       goto EXIT_MEM;
-    }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_PROPERTIES,properties);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_PROPERTIES);
+    (void) JsonWriteKvLst(writer,tpl,service_info->service_property);
 
-    ///< add the event time (optional) to the root
+    ///< add the event time (optional)
     if(NULL != service_info->event_time)
     {
-        event_time = cJSON_CreateString(service_info->event_time);
-        if(NULL == event_time)
-        {
-           goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_EVENTTIME,event_time);
+        (void) json_writer_key(writer,CN_OC_JSON_KEY_EVENTTIME);
+        (void) JsonWriteSlot(writer,tpl,NULL,&service_info->event_time);
     }
 
-    ///< OK, now we return it
-    return root;
-
-EXIT_MEM:
-    if(NULL != root)
-    {
-       cJSON_Delete(root);
-       root = NULL;
-    }
-    return root;
+    return json_writer_end_object(writer);
 }
 
-static cJSON *JsonCreateServices(oc_mqtt_profile_service_t *service_info)
+static int JsonWriteServices(json_writer_t *writer, oc_mqtt_profile_template_t *tpl, oc_mqtt_profile_service_t *service_info)
 {
-    cJSON *services = NULL;
-    cJSON *service;
     oc_mqtt_profile_service_t  *service_tmp;
 
-    ///< create the services array node
-    services = cJSON_CreateArray();
-    if(NULL == services)
-    {
-       goto EXIT_MEM;
-    }
+    (void) json_writer_begin_array(writer);
 
     service_tmp = service_info;
     while(NULL != service_tmp)
     {
-        service = JsonCreateService(service_tmp);
-        if(NULL == service)
-        {
-            goto EXIT_MEM;
-        }
-
-        cJSON_AddItemToArray(services,service);
+        (void) JsonWriteService(writer,tpl,service_tmp);
         service_tmp = service_tmp->nxt;
     }
 
-    ///< now we return the services
-    return services;
+    return json_writer_end_array(writer);
+}
 
-EXIT_MEM:
-    if(NULL != services)
-    {
-       cJSON_Delete(services);
-       services = NULL;
-    }
-    return services;
+int oc_mqtt_profile_write_propertyreport(json_writer_t *writer, oc_mqtt_profile_service_t *payload)
+{
+    (void) json_writer_begin_object(writer);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICES);
+    (void) JsonWriteServices(writer,NULL,payload);
+
+    return json_writer_end_object(writer);
 }
 
-char *oc_mqtt_profile_package_propertyreport(oc_mqtt_profile_service_t *payload)
+int oc_mqtt_profile_write_gwpropertyreport(json_writer_t *writer, oc_mqtt_profile_device_t *payload)
 {
-    char *ret = NULL;
-    cJSON *root;
-    cJSON *services;
+    oc_mqtt_profile_device_t *device_info;
 
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
-    {
-       goto EXIT_MEM;
-    }
+    (void) json_writer_begin_object(writer);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_DEVICES);
+    (void) json_writer_begin_array(writer);
 
-    ///< create the services array node to the root
-    services = JsonCreateServices(payload);
-    if(NULL == services)
+    ///< loop all the devices and add it to devices
+    device_info = payload;
+    while(NULL != device_info)
     {
-        goto EXIT_MEM;
+        (void) json_writer_begin_object(writer);
+        (void) json_writer_key(writer,CN_OC_JSON_KEY_DEVICEID);
+        (void) json_writer_string(writer,device_info->subdevice_id);
+        (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICES);
+        (void) JsonWriteServices(writer,NULL,device_info->subdevice_property);
+        (void) json_writer_end_object(writer);
+
+        device_info = device_info->nxt;
     }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_SERVICES,services);
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
+    (void) json_writer_end_array(writer);
 
-EXIT_MEM:
-    if(NULL != root)
-    {
-       cJSON_Delete(root);
-    }
-    return ret;
+    return json_writer_end_object(writer);
 }
 
-
-char *oc_mqtt_profile_package_gwpropertyreport(oc_mqtt_profile_device_t *payload)
+int oc_mqtt_profile_write_propertysetresp(json_writer_t *writer, oc_mqtt_profile_propertysetresp_t *payload)
 {
-    char *ret = NULL;
-    cJSON *root;
-    cJSON *services;
-    cJSON *devices;
-    cJSON *device;
-    cJSON *device_id;
-
-    oc_mqtt_profile_device_t *device_info;
+    (void) json_writer_begin_object(writer);
 
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
-    {
-       goto EXIT_MEM;
-    }
-
-    ///< create the devices node and add it to root
-    devices = cJSON_CreateArray();
-    if(NULL == devices)
+    if(NULL != payload)
     {
-        goto EXIT_MEM;
+        (void) json_writer_key(writer,CN_OC_JSON_KEY_RESULTCODE);
+        (void) json_writer_int(writer,payload->ret_code);
+        (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_RESULTDESC,payload->ret_description);
     }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_DEVICES,devices);
 
-    ///< loop all the devices and add it to devices
-    device_info = payload;
-    while(NULL != device_info)
-    {
-        device = cJSON_CreateObject();
-        if(NULL == device)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToArray(devices,device);
-
-        device_id = cJSON_CreateString(device_info->subdevice_id);
-        if(NULL == device_id)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(device,CN_OC_JSON_KEY_DEVICEID,device_id);
+    return json_writer_end_object(writer);
+}
 
-        services = JsonCreateServices(device_info->subdevice_property);
-        if(NULL == services)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(device,CN_OC_JSON_KEY_SERVICES,services);
+int oc_mqtt_profile_write_propertygetresp(json_writer_t *writer, oc_mqtt_profile_propertygetresp_t *payload)
+{
+    (void) json_writer_begin_object(writer);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICES);
+    (void) JsonWriteServices(writer,NULL,payload->services);
 
-        device_info = device_info->nxt;
-    }
+    return json_writer_end_object(writer);
+}
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
+int oc_mqtt_profile_write_cmdresp(json_writer_t *writer, oc_mqtt_profile_cmdresp_t *payload)
+{
+    (void) json_writer_begin_object(writer);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_RESULTCODE);
+    (void) json_writer_int(writer,payload->ret_code);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_RESULTDESC,payload->ret_name);
 
-EXIT_MEM:
-    if(NULL != root)
+    if(NULL != payload->paras)
     {
-       cJSON_Delete(root);
+        (void) json_writer_key(writer,CN_OC_JSON_KEY_PARAS);
+        (void) JsonWriteKvLst(writer,NULL,payload->paras);
     }
-    return ret;
+
+    return json_writer_end_object(writer);
 }
 
+int oc_mqtt_profile_write_shadowget(json_writer_t *writer, oc_mqtt_profile_shadowget_t *payload)
+{
+    (void) json_writer_begin_object(writer);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_OBJECTDEVICEID,payload->object_device_id);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_SERVICEID,payload->service_id);
 
+    return json_writer_end_object(writer);
+}
 
+/*** event json data format
+Topic: $oc/devices/{device_id}/sys/events/down
+{
+    "object_device_id": "{object_device_id}",
+    "services": [{
+        "service_id": "$ota",
+        "event_type": "version_query",
+        "event_time": "20151212T121212Z",
+         "paras": {
+         }
+    }]
+}
+*/
 
-char *oc_mqtt_profile_package_propertysetresp(oc_mqtt_profile_propertysetresp_t *payload)
+int oc_mqtt_profile_write_event(json_writer_t *writer, oc_mqtt_profile_event_t *payload)
 {
+    (void) json_writer_begin_object(writer);
 
-    char *ret = NULL;
-    cJSON *root;
-    cJSON *ret_code;
-    cJSON *ret_desc;
+    ///< if the device object_device_id is not NULL then add it
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_OBJECTDEVICEID,payload->object_device_id);
 
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
-    {
-       goto EXIT_MEM;
-    }
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICES);
+    (void) json_writer_begin_array(writer);
+    (void) json_writer_begin_object(writer);
 
-    ///< create retcode and retdesc and add it to the root
-    if(NULL != payload)
-    {
-        ret_code = cJSON_CreateNumber(payload->ret_code);
-        if(NULL == ret_code)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_RESULTCODE,ret_code);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICEID);
+    (void) json_writer_string(writer,payload->service_id);
+    (void) JsonWriteKeyString(writer,CN_OC_JSON_KEY_EVENTTIME,payload->event_time);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_EVENTTYPE);
+    (void) json_writer_string(writer,payload->event_type);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_PARAS);
+    (void) JsonWriteKvLst(writer,NULL,payload->paras);
 
-        if(NULL != payload->ret_description)
-        {
-            ret_desc = cJSON_CreateString(payload->ret_description);
-            if(NULL == ret_desc)
-            {
-                goto EXIT_MEM;
-            }
-            cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_RESULTDESC,ret_desc);
-        }
+    (void) json_writer_end_object(writer);
+    (void) json_writer_end_array(writer);
 
-    }
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
+    return json_writer_end_object(writer);
+}
 
-EXIT_MEM:
-    if(NULL != root)
+
+///< the same layout as the property report, while the values are left as the slots
+static int JsonWriteTemplate(json_writer_t *writer, oc_mqtt_profile_template_t *tpl, oc_mqtt_profile_service_t *payload)
+{
+    (void) json_writer_begin_object(writer);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICES);
+    (void) JsonWriteServices(writer,tpl,payload);
+
+    return json_writer_end_object(writer);
+}
+
+int oc_mqtt_profile_writer_init(json_writer_t *writer, char *buf, int buflen, int format)
+{
+    if(0 != json_writer_init(writer, buf, buflen, NULL, NULL))
     {
-       cJSON_Delete(root);
+        return -1;
     }
-    return ret;
 
+    return (format == EN_OC_MQTT_PROFILE_FORMAT_CBOR) ? json_writer_set_cbor(writer) : 0;
 }
 
-char *oc_mqtt_profile_package_propertygetresp(oc_mqtt_profile_propertygetresp_t *payload)
+oc_mqtt_profile_template_t *oc_mqtt_profile_template_compile(oc_mqtt_profile_service_t *payload, int format)
 {
+    oc_mqtt_profile_template_t  tpl;
+    oc_mqtt_profile_template_t *ret;
+    json_writer_t writer;
+    int len;
 
-    char *ret = NULL;
-    cJSON *root;
-    cJSON *services;
-
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
+    ///< measure the text without the values and count the slots
+    (void) memset(&tpl, 0, sizeof(tpl));
+    (void) oc_mqtt_profile_writer_init(&writer, NULL, 0, format);
+    if((0 != JsonWriteTemplate(&writer, &tpl, payload)) || ((len = json_writer_end(&writer)) < 0))
     {
-       goto EXIT_MEM;
+        return NULL;
     }
 
-    ///< create the services array node to the root
-    services = JsonCreateServices(payload->services);
-    if(NULL == services)
+    ///< the template, the slots and the text in one block
+    ret = osal_malloc(sizeof(oc_mqtt_profile_template_t) + tpl.slotnum * sizeof(oc_mqtt_profile_slot_t) + len + 1);
+    if(NULL == ret)
     {
-        goto EXIT_MEM;
+        return NULL;
     }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_SERVICES,services);
+    (void) memset(ret, 0, sizeof(oc_mqtt_profile_template_t));
+    ret->slots = (oc_mqtt_profile_slot_t *)(ret + 1);
+    ret->text = (char *)(ret->slots + tpl.slotnum);
+    ret->textlen = len;
+    ret->format = format;
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
-
-EXIT_MEM:
-    if(NULL != root)
+    (void) oc_mqtt_profile_writer_init(&writer, ret->text, len + 1, format);
+    if((0 != JsonWriteTemplate(&writer, ret, payload)) || (json_writer_end(&writer) != len))
     {
-       cJSON_Delete(root);
+        osal_free(ret);
+        ret = NULL;
     }
-    return ret;
 
+    return ret;
 }
 
-
-char *oc_mqtt_profile_package_cmdresp(oc_mqtt_profile_cmdresp_t *payload)
+int oc_mqtt_profile_write_template(json_writer_t *writer, oc_mqtt_profile_template_t *tpl)
 {
-    char *ret = NULL;
-    cJSON *root;
-    cJSON *ret_code;
-    cJSON *ret_name;
-    cJSON *paras;
-
+    oc_mqtt_profile_slot_t *slot;
+    int offset = 0;
+    int i;
 
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
+    ///< the text pieces and the values are all written at the top level, so no comma is added
+    for(i = 0; i < tpl->slotnum; i++)
     {
-       goto EXIT_MEM;
+        slot = &tpl->slots[i];
+        (void) json_writer_raw(writer, tpl->text + offset, slot->offset - offset);
+        (void) JsonWriteSlot(writer, NULL, slot->kv, slot->str);   ///< the NULL event time fails the writer
+        offset = slot->offset;
     }
 
-    ///< create retcode and retdesc and add it to the root
-    ret_code = cJSON_CreateNumber(payload->ret_code);
-    if(NULL == ret_code)
-    {
-        goto EXIT_MEM;
-    }
-    cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_RESULTCODE,ret_code);
+    return json_writer_raw(writer, tpl->text + offset, tpl->textlen - offset);
+}
+
+///< the varint is 7 bits a byte with the high bit for more, the signed value is zigzag mapped first
+static int BatchPutVarint(uint8_t *buf, unsigned long value)
+{
+    int len = 0;
 
-    if(NULL != payload->ret_name)
+    while(value >= 0x80)
     {
-        ret_name = cJSON_CreateString(payload->ret_name);
-        if(NULL == ret_name)
+        if(NULL != buf)
         {
-            goto EXIT_MEM;
+            buf[len] = (uint8_t)(value | 0x80);
         }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_RESULTDESC,ret_name);
+        len++;
+        value >>= 7;
     }
-
-    if(NULL != payload->paras)
+    if(NULL != buf)
     {
-        paras = JsonCreateKvLst(payload->paras);
-        if(NULL == paras)
-        {
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_PARAS,paras);
+        buf[len] = (uint8_t)value;
     }
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
+    return len + 1;
+}
 
-EXIT_MEM:
-    if(NULL != root)
-    {
-       cJSON_Delete(root);
-    }
+static unsigned long BatchGetVarint(const uint8_t **p)
+{
+    unsigned long value = 0;
+    int shift = 0;
 
-    return ret;
+    do
+    {
+        value |= (unsigned long)(**p & 0x7f) << shift;
+        shift += 7;
+    }while(*(*p)++ & 0x80);
 
+    return value;
 }
 
+static unsigned long BatchZigzag(long value)
+{
+    return ((unsigned long)value << 1) ^ ((value < 0) ? ~0ul : 0ul);
+}
 
+static long BatchUnzigzag(unsigned long value)
+{
+    return (long)(value >> 1) ^ -(long)(value & 1);
+}
 
-
-char *oc_mqtt_profile_package_shadowget(oc_mqtt_profile_shadowget_t *payload)
+///< put the sample to the buf, or only measure it when the buf is NULL; return the length while -1 failed
+static int BatchPutSample(oc_mqtt_profile_batch_t *batch, uint8_t *buf, long delta)
 {
-    char *ret = NULL;
-    cJSON *root = NULL;
-    cJSON *object_device_id = NULL;
-    cJSON *service_id = NULL;
+    oc_mqtt_profile_service_t *service;
+    oc_mqtt_profile_kv_t      *kv;
+    int len;
+    int strlength;
 
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root)
+    len = BatchPutVarint(buf, BatchZigzag(delta));
+    for(service = batch->layout; NULL != service; service = service->nxt)
     {
-       goto EXIT_MEM;
-    }
-    ///< create retcode and retdesc and add it to the root
-    if(NULL != payload->object_device_id)
-    {
-        object_device_id = cJSON_CreateString(payload->object_device_id);
-        if(NULL == object_device_id)
+        for(kv = service->service_property; NULL != kv; kv = kv->nxt)
         {
-            goto EXIT_MEM;
+            switch(kv->type)
+            {
+                case EN_OC_MQTT_PROFILE_VALUE_INT:
+                    len += BatchPutVarint((NULL == buf) ? NULL : buf + len, BatchZigzag((long)*(int *)kv->value));
+                    break;
+                case EN_OC_MQTT_PROFILE_VALUE_LONG:
+                    len += BatchPutVarint((NULL == buf) ? NULL : buf + len, BatchZigzag(*(long *)kv->value));
+                    break;
+                case EN_OC_MQTT_PROFILE_VALUE_FLOAT:
+                    if(NULL != buf)
+                    {
+                        (void) memcpy(buf + len, kv->value, sizeof(float));
+                    }
+                    len += sizeof(float);
+                    break;
+                case EN_OC_MQTT_PROFILE_VALUE_DOUBLE:
+                    if(NULL != buf)
+                    {
+                        (void) memcpy(buf + len, kv->value, sizeof(double));
+                    }
+                    len += sizeof(double);
+                    break;
+                case EN_OC_MQTT_PROFILE_VALUE_STRING:
+                    strlength = strlen((const char *)kv->value);
+                    len += BatchPutVarint((NULL == buf) ? NULL : buf + len, (unsigned long)strlength);
+                    if(NULL != buf)
+                    {
+                        (void) memcpy(buf + len, kv->value, strlength);
+                    }
+                    len += strlength;
+                    break;
+                default:
+                    return -1;
+            }
         }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_OBJECTDEVICEID,object_device_id);
     }
 
-    if(NULL != payload->service_id)
+    return len;
+}
+
+///< read the oldest sample at the cursor to the scratch, the cursor is a copy of the ring so nothing is dropped;
+///< return the sample length while -1 no more
+static int BatchGetSample(oc_mqtt_profile_batch_t *batch, ring_buffer_t *cursor)
+{
+    uint8_t head[5];
+    const uint8_t *p = head;
+    int len = 0;
+
+    do
     {
-        service_id = cJSON_CreateString(payload->service_id);
-        if(NULL == service_id)
+        if((len >= (int)sizeof(head)) || (1 != ring_buffer_read(cursor, &head[len], 1)))
         {
-            goto EXIT_MEM;
+            return -1;
         }
-        cJSON_AddItemToObjectCS(root,CN_OC_JSON_KEY_SERVICEID,service_id);
+    }while(head[len++] & 0x80);
+
+    len = (int)BatchGetVarint(&p);
+    if((len > batch->scratchlen) || (len != ring_buffer_read(cursor, batch->scratch, len)))
+    {
+        return -1;
     }
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
+    return len;
+}
+
+oc_mqtt_profile_batch_t *oc_mqtt_profile_batch_alloc(oc_mqtt_profile_service_t *payload, int size)
+{
+    oc_mqtt_profile_batch_t *ret;
 
-EXIT_MEM:
-    if(NULL != root)
+    if((NULL == payload) || (size <= 0))
     {
-       cJSON_Delete(root);
+        return NULL;
+    }
+
+    ret = osal_zalloc(sizeof(oc_mqtt_profile_batch_t) + size);
+    if(NULL != ret)
+    {
+        ret->layout = payload;
+        (void) ring_buffer_init(&ret->ring, (unsigned char *)(ret + 1), size, 0, 0);
     }
 
     return ret;
+}
 
+void oc_mqtt_profile_batch_free(oc_mqtt_profile_batch_t *batch)
+{
+    if(NULL != batch)
+    {
+        osal_free(batch->scratch);
+        osal_free(batch);
+    }
 }
 
-/*** event json data format
-Topic: $oc/devices/{device_id}/sys/events/down
+void oc_mqtt_profile_batch_clear(oc_mqtt_profile_batch_t *batch)
 {
-    "object_device_id": "{object_device_id}",
-    "services": [{
-        "service_id": "$ota",
-        "event_type": "version_query",
-        "event_time": "20151212T121212Z",
-         "paras": {
-         }
-    }]
+    (void) ring_buffer_reset(&batch->ring);
+    batch->count = 0;
 }
-*/
 
-char *oc_mqtt_profile_package_event(oc_mqtt_profile_event_t *payload)
-{
-    char *ret = NULL;
-    cJSON *root;
-    cJSON *objectDeviceID;
-    cJSON *services;
-    cJSON *service;
-    cJSON *serviceID;
-    cJSON *eventTime;
-    cJSON *eventType;
-    cJSON *paras;
-
-    ///< create the root node
-    root = cJSON_CreateObject();
-    if(NULL == root){
-       goto EXIT_MEM;
+int oc_mqtt_profile_batch_push(oc_mqtt_profile_batch_t *batch, unsigned long utc)
+{
+    ring_buffer_t cursor;
+    uint8_t *scratch;
+    const uint8_t *p;
+    long delta;
+    int len;
+    int head;
+    int dropped = 0;
+    int broken = 0;
+
+    delta = (batch->count > 0) ? (long)(utc - batch->last) : 0;
+    len = BatchPutSample(batch, NULL, delta);
+    head = BatchPutVarint(NULL, (unsigned long)len);
+    if((len < 0) || (len + head > batch->ring.buflen))
+    {
+        return -1;
     }
 
-    ///< if the device object_device_id is not NULL then add it
-    if(payload->object_device_id != NULL){
-        objectDeviceID = cJSON_CreateString(payload->object_device_id);
-        if(objectDeviceID == NULL){
-            goto EXIT_MEM;
+    ///< the scratch is as big as the biggest sample, which is used by the report too
+    if(len + head > batch->scratchlen)
+    {
+        scratch = osal_realloc(batch->scratch, len + head);
+        if(NULL == scratch)
+        {
+            return -1;
         }
-        cJSON_AddItemToObject(root, CN_OC_JSON_KEY_OBJECTDEVICEID, objectDeviceID);
+        batch->scratch = scratch;
+        batch->scratchlen = len + head;
     }
 
-    services = cJSON_CreateArray();
-    if(services == NULL){
-        goto EXIT_MEM;
-    }
-    cJSON_AddItemToObject(root,CN_OC_JSON_KEY_SERVICES,services);
+    ///< drop the oldest samples, the time of the next one is the new first
+    while(ring_buffer_freespace(&batch->ring) < len + head)
+    {
+        cursor = batch->ring;
+        if((batch->count <= 0) || (BatchGetSample(batch, &cursor) < 0))
+        {
+            broken = 1;
+            break;
+        }
+        batch->ring = cursor;
+        batch->count--;
+        dropped++;
 
-    service = cJSON_CreateObject();
-    if(service == NULL){
-        goto EXIT_MEM;
+        if(batch->count > 0)
+        {
+            if(BatchGetSample(batch, &cursor) < 0)
+            {
+                broken = 1;
+                break;
+            }
+            p = batch->scratch;
+            batch->first += BatchUnzigzag(BatchGetVarint(&p));
+        }
     }
-    cJSON_AddItemToArray(services, service);
 
-    serviceID = cJSON_CreateString(payload->service_id);
-    if(serviceID == NULL){
-        goto EXIT_MEM;
+    ///< the sample could not be read back, so the ring and the count disagree; drop them all and start again
+    if(broken)
+    {
+        dropped += batch->count;
+        oc_mqtt_profile_batch_clear(batch);
     }
-    cJSON_AddItemToObject(service, CN_OC_JSON_KEY_SERVICEID,serviceID);
 
-    if(payload->event_time != NULL){
-        eventTime = cJSON_CreateString(payload->event_time);
-        if(eventTime == NULL){
-            goto EXIT_MEM;
-        }
-        cJSON_AddItemToObject(service, CN_OC_JSON_KEY_EVENTTIME, eventTime);
+    if(batch->count == 0)
+    {
+        batch->first = utc;     ///< the delta of the oldest is not used, so it is kept as measured
     }
+    batch->last = utc;
+    (void) BatchPutVarint(batch->scratch, (unsigned long)len);
+    (void) BatchPutSample(batch, batch->scratch + head, delta);
+    (void) ring_buffer_write(&batch->ring, batch->scratch, len + head);
+    batch->count++;
 
-    eventType = cJSON_CreateString(payload->event_type);
-    if(eventType == NULL){
-        goto EXIT_MEM;
-    }
-    cJSON_AddItemToObject(service, CN_OC_JSON_KEY_EVENTTYPE, eventType);
+    return dropped;
+}
 
-    paras = JsonCreateKvLst(payload->paras);
-    if(paras == NULL){
-        goto EXIT_MEM;
-    }
-    cJSON_AddItemToObject(service,CN_OC_JSON_KEY_PARAS,paras);
+///< the event time format yyyyMMddTHHmmssZ of the utc time
+static void BatchEventTime(unsigned long utc, char *buf)
+{
+    long days = (long)(utc / 86400);
+    long secs = (long)(utc % 86400);
+    long era;
+    long doe;
+    long yoe;
+    long doy;
+    long mp;
+    long year;
+    long month;
+    long day;
+
+    ///< the civil date from the days since 1970-01-01
+    days += 719468;
+    era = days / 146097;
+    doe = days - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = (mp < 10) ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + ((month <= 2) ? 1 : 0);
+
+    (void) snprintf(buf, 17, "%04ld%02ld%02ldT%02ld%02ld%02ldZ", year, month, day, secs / 3600, (secs / 60) % 60, secs % 60);
+}
 
-    ///< OK, now we make it to a buffer
-    ret = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return ret;
+///< write the value of the type from the sample
+static int BatchWriteValue(json_writer_t *writer, en_oc_profile_data_t type, const uint8_t **p)
+{
+    float  f;
+    double d;
+    int    len;
 
-EXIT_MEM:
-    if(NULL != root)
+    switch(type)
     {
-       cJSON_Delete(root);
+        case EN_OC_MQTT_PROFILE_VALUE_INT:
+        case EN_OC_MQTT_PROFILE_VALUE_LONG:
+            return json_writer_int(writer, BatchUnzigzag(BatchGetVarint(p)));
+        case EN_OC_MQTT_PROFILE_VALUE_FLOAT:
+            (void) memcpy(&f, *p, sizeof(f));
+            *p += sizeof(f);
+            return json_writer_float(writer, f);
+        case EN_OC_MQTT_PROFILE_VALUE_DOUBLE:
+            (void) memcpy(&d, *p, sizeof(d));
+            *p += sizeof(d);
+            return json_writer_double(writer, d);
+        default:
+            len = (int)BatchGetVarint(p);
+            *p += len;
+            return json_writer_string_len(writer, (const char *)(*p - len), len);
     }
-    return ret;
 }
 
+///< all the samples in one property report, each service of each sample is an item of the services
+int oc_mqtt_profile_write_batch(json_writer_t *writer, oc_mqtt_profile_batch_t *batch)
+{
+    oc_mqtt_profile_service_t *service;
+    oc_mqtt_profile_kv_t      *kv;
+    ring_buffer_t  cursor;
+    const uint8_t *p;
+    unsigned long  utc;
+    long           delta;
+    char           event_time[17];
+    int            i;
+
+    (void) json_writer_begin_object(writer);
+    (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICES);
+    (void) json_writer_begin_array(writer);
+
+    cursor = batch->ring;
+    utc = batch->first;
+    for(i = 0; i < batch->count; i++)
+    {
+        if(BatchGetSample(batch, &cursor) < 0)
+        {
+            writer->err = -1;
+            break;
+        }
+        p = batch->scratch;
+        delta = BatchUnzigzag(BatchGetVarint(&p));
+        if(i > 0)
+        {
+            utc += (unsigned long)delta;     ///< the delta of the oldest is to the sample dropped
+        }
+        BatchEventTime(utc, event_time);
 
+        for(service = batch->layout; NULL != service; service = service->nxt)
+        {
+            (void) json_writer_begin_object(writer);
+            (void) json_writer_key(writer,CN_OC_JSON_KEY_SERVICEID);
+            (void) json_writer_string(writer,service->service_id);
+            (void) json_writer_key(writer,CN_OC_JSON_KEY_PROPERTIES);
+            (void) json_writer_begin_object(writer);
+            for(kv = service->service_property; NULL != kv; kv = kv->nxt)
+            {
+                (void) json_writer_key(writer,kv->key);
+                (void) BatchWriteValue(writer,kv->type,&p);
+            }
+            (void) json_writer_end_object(writer);
+            (void) json_writer_key(writer,CN_OC_JSON_KEY_EVENTTIME);
+            (void) json_writer_string(writer,event_time);
+            (void) json_writer_end_object(writer);
+        }
+    }
+
+    (void) json_writer_end_array(writer);
 
+    return json_writer_end_object(writer);
+}
+
+///< the writer keeps the first error, so the calls above need no check one by one; to make a
+///< string, measure the length first and then write it to the buffer of the exact size
+#define OC_MQTT_PROFILE_PACKAGE_STRING(name, type)                              \
+char *oc_mqtt_profile_encode_##name(type *payload, int format, int *msglen)     \
+{                                                                               \
+    json_writer_t writer;                                                       \
+    char *ret = NULL;                                                           \
+    int len;                                                                    \
+                                                                                \
+    (void) oc_mqtt_profile_writer_init(&writer, NULL, 0, format);               \
+    if((0 != oc_mqtt_profile_write_##name(&writer, payload)) ||                 \
+       ((len = json_writer_end(&writer)) < 0))                                  \
+    {                                                                           \
+        return ret;                                                             \
+    }                                                                           \
+                                                                                \
+    ret = osal_malloc(len + 1);                                                 \
+    if(NULL != ret)                                                             \
+    {                                                                           \
+        (void) oc_mqtt_profile_writer_init(&writer, ret, len + 1, format);      \
+        if((0 != oc_mqtt_profile_write_##name(&writer, payload)) ||             \
+           (json_writer_end(&writer) < 0))                                      \
+        {                                                                       \
+            osal_free(ret);                                                     \
+            ret = NULL;                                                         \
+        }                                                                       \
+        else if(NULL != msglen)                                                 \
+        {                                                                       \
+            *msglen = len;                                                      \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    return ret;                                                                 \
+}                                                                               \
+                                                                                \
+char *oc_mqtt_profile_package_##name(type *payload)                             \
+{                                                                               \
+    return oc_mqtt_profile_encode_##name(payload,                               \
+                                         EN_OC_MQTT_PROFILE_FORMAT_JSON, NULL); \
+}
 
+OC_MQTT_PROFILE_PACKAGE_STRING(msgup, oc_mqtt_profile_msgup_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(propertyreport, oc_mqtt_profile_service_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(gwpropertyreport, oc_mqtt_profile_device_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(propertysetresp, oc_mqtt_profile_propertysetresp_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(propertygetresp, oc_mqtt_profile_propertygetresp_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(cmdresp, oc_mqtt_profile_cmdresp_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(shadowget, oc_mqtt_profile_shadowget_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(event, oc_mqtt_profile_event_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(template, oc_mqtt_profile_template_t)
+OC_MQTT_PROFILE_PACKAGE_STRING(batch, oc_mqtt_profile_batch_t)
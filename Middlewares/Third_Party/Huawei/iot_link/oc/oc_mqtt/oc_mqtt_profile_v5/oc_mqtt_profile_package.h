@@ -41,9 +41,59 @@
 
 
 #include <oc_mqtt_profile.h>
+#include <link_json.h>
+#include <link_misc.h>
 
+///< the compiled property report: the text rendered without the values, and the slots where the values go
+typedef struct
+{
+    oc_mqtt_profile_kv_t    *kv;        ///< the property whose value is read at each report
+    char                   **str;       ///< the string such as the event time, used when kv is NULL
+    int                      offset;    ///< where the value goes in the text
+}oc_mqtt_profile_slot_t;
 
-///< defines for the package tools
+typedef struct
+{
+    char                    *topic;     ///< the report topic, filled by the owner
+    char                    *text;      ///< the text without the values
+    int                      textlen;
+    int                      slotnum;
+    oc_mqtt_profile_slot_t  *slots;     ///< in the text order
+    int                      format;    ///< en_oc_mqtt_profile_format_t, the text and the values in the same
+}oc_mqtt_profile_template_t;
+
+///< the property report samples kept in a ring: the keys are kept once in the layout, and each sample is the
+///< time delta to the previous sample and the values in the layout order
+typedef struct
+{
+    char                        *topic;     ///< the report topic, filled by the owner
+    oc_mqtt_profile_service_t   *layout;    ///< the services whose values are read when a sample is added
+    ring_buffer_t                ring;      ///< the samples, the ring memory is after this struct
+    uint8_t                     *scratch;   ///< one sample decoded from the ring
+    int                          scratchlen;
+    int                          count;     ///< how many samples in the ring
+    unsigned long                first;     ///< the time of the oldest sample
+    unsigned long                last;      ///< the time of the newest sample
+}oc_mqtt_profile_batch_t;
+
+///< alloc the batch with the ring of size bytes; release it by oc_mqtt_profile_batch_free
+oc_mqtt_profile_batch_t *oc_mqtt_profile_batch_alloc(oc_mqtt_profile_service_t *payload, int size);
+void oc_mqtt_profile_batch_free(oc_mqtt_profile_batch_t *batch);
+
+///< read the values as a sample of the utc time(seconds since 1970), the oldest samples are dropped when
+///< the ring is full; return how many samples dropped while -1 failed
+int oc_mqtt_profile_batch_push(oc_mqtt_profile_batch_t *batch, unsigned long utc);
+
+///< drop all the samples
+void oc_mqtt_profile_batch_clear(oc_mqtt_profile_batch_t *batch);
+
+///< initialize the writer for the format, json text or CBOR
+int oc_mqtt_profile_writer_init(json_writer_t *writer, char *buf, int buflen, int format);
+
+///< compile the property report layout, the text and the slots are in the returned block; release it by osal_free
+oc_mqtt_profile_template_t *oc_mqtt_profile_template_compile(oc_mqtt_profile_service_t *payload, int format);
+
+///< defines for the package tools, the string returned must be released by osal_free
 char *oc_mqtt_profile_package_msgup(oc_mqtt_profile_msgup_t *payload);
 char *oc_mqtt_profile_package_propertyreport(oc_mqtt_profile_service_t *payload);
 char *oc_mqtt_profile_package_gwpropertyreport(oc_mqtt_profile_device_t *payload);
@@ -52,5 +102,32 @@ char *oc_mqtt_profile_package_propertygetresp(oc_mqtt_profile_propertygetresp_t
 char *oc_mqtt_profile_package_cmdresp(oc_mqtt_profile_cmdresp_t *payload);
 char *oc_mqtt_profile_package_shadowget(oc_mqtt_profile_shadowget_t *payload);
 char *oc_mqtt_profile_package_event(oc_mqtt_profile_event_t *event);
+char *oc_mqtt_profile_package_template(oc_mqtt_profile_template_t *tpl);
+char *oc_mqtt_profile_package_batch(oc_mqtt_profile_batch_t *batch);
+
+///< the same as the package tools while in the format, the CBOR may contain '\0' so the length is returned by len
+char *oc_mqtt_profile_encode_msgup(oc_mqtt_profile_msgup_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_propertyreport(oc_mqtt_profile_service_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_gwpropertyreport(oc_mqtt_profile_device_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_propertysetresp(oc_mqtt_profile_propertysetresp_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_propertygetresp(oc_mqtt_profile_propertygetresp_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_cmdresp(oc_mqtt_profile_cmdresp_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_shadowget(oc_mqtt_profile_shadowget_t *payload, int format, int *len);
+char *oc_mqtt_profile_encode_event(oc_mqtt_profile_event_t *event, int format, int *len);
+char *oc_mqtt_profile_encode_template(oc_mqtt_profile_template_t *tpl, int format, int *len);
+char *oc_mqtt_profile_encode_batch(oc_mqtt_profile_batch_t *batch, int format, int *len);
+
+///< write the json text(or the CBOR, see oc_mqtt_profile_writer_init) with the writer, which could be a caller buffer or a sink; no memory
+///< allocated here. return 0 success while -1 failed(such as the buffer is too small)
+int oc_mqtt_profile_write_msgup(json_writer_t *writer, oc_mqtt_profile_msgup_t *payload);
+int oc_mqtt_profile_write_propertyreport(json_writer_t *writer, oc_mqtt_profile_service_t *payload);
+int oc_mqtt_profile_write_gwpropertyreport(json_writer_t *writer, oc_mqtt_profile_device_t *payload);
+int oc_mqtt_profile_write_propertysetresp(json_writer_t *writer, oc_mqtt_profile_propertysetresp_t *payload);
+int oc_mqtt_profile_write_propertygetresp(json_writer_t *writer, oc_mqtt_profile_propertygetresp_t *payload);
+int oc_mqtt_profile_write_cmdresp(json_writer_t *writer, oc_mqtt_profile_cmdresp_t *payload);
+int oc_mqtt_profile_write_shadowget(json_writer_t *writer, oc_mqtt_profile_shadowget_t *payload);
+int oc_mqtt_profile_write_event(json_writer_t *writer, oc_mqtt_profile_event_t *event);
+int oc_mqtt_profile_write_template(json_writer_t *writer, oc_mqtt_profile_template_t *tpl);
+int oc_mqtt_profile_write_batch(json_writer_t *writer, oc_mqtt_profile_batch_t *batch);
 
 #endif /* LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_PROFILE_OC_MQTT_PROFILE_PACKAGE_H_ */
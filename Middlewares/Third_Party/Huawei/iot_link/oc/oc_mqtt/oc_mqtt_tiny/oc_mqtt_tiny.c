@@ -219,6 +219,8 @@ static void hub_msg_default_deal(void *arg,mqtt_al_msgrcv_t  *msg)
         normal_msg.qos = msg->qos;
         normal_msg.retain = msg->retain;
         normal_msg.msg = msg->msg;
+        normal_msg.offset = msg->offset;
+        normal_msg.total = msg->total;
         if((NULL != msg->topic.data) && (NULL != s_oc_mqtt_tiny_cb->mqtt_para.default_sub_topic) \
                 && (0 == memcmp(s_oc_mqtt_tiny_cb->mqtt_para.default_sub_topic,msg->topic.data,msg->topic.len)))
         {
@@ -0,0 +1,674 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 19:59   The first version
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <osal.h>
+#include <link_misc.h>
+#include <oc_mqtt_al.h>
+#include "oc_mqtt_outbox.h"
+
+#define CN_OUTBOX_SECTORS      (CONFIG_OC_MQTT_OUTBOX_FLASHSIZE/CONFIG_OC_MQTT_OUTBOX_SECTOR)
+
+#if (CONFIG_OC_MQTT_OUTBOX_PARTITION >= 0) && (CN_OUTBOX_SECTORS >= 2)
+#define CN_OUTBOX_FLASH        1
+#include <crc.h>
+#include <partition.h>
+#else
+#define CN_OUTBOX_FLASH        0
+#endif
+
+///< the record is the head, the topic with its '\0' and the message; the flash record is padded
+///< to the double-word, the STM32L4 flash could only program each double-word once
+#define CN_OUTBOX_MAGIC        0xA5
+#define CN_OUTBOX_HEADLEN      16
+#define CN_OUTBOX_CRCLEN       12        ///< the crc covers the head before the crc and the body
+#define CN_OUTBOX_ALIGN        8
+#define CN_OUTBOX_ALIGNED(x)   (((x) + CN_OUTBOX_ALIGN - 1) & (~(CN_OUTBOX_ALIGN - 1)))
+
+#define CN_OUTBOX_LANENORMAL   0
+#define CN_OUTBOX_LANEALARM    1
+#define CN_OUTBOX_LANES        2
+#define CN_OUTBOX_SRCFLASH     2         ///< the peeked record is from the flash log
+#define CN_OUTBOX_SRCNONE      3         ///< nothing peeked
+
+typedef struct
+{
+    int       qos;
+    int       topiclen;      ///< including the '\0', 0 means the default topic
+    int       msglen;
+    uint32_t  seq;           ///< the flash log order
+    uint32_t  crc;
+}outbox_head_t;
+
+typedef struct
+{
+    ring_buffer_t  lane[CN_OUTBOX_LANES];
+    int            count[CN_OUTBOX_LANES];
+    uint8_t       *scratch;      ///< the peeked record or the record being moved
+    int            scratchlen;
+    int            peeked;       ///< CN_OUTBOX_LANEXXX or CN_OUTBOX_SRCXXX
+    int            peeklen;      ///< the peeked record length in its source
+#if CN_OUTBOX_FLASH
+    int            flashcount;
+    int            rsec;         ///< the sector to send from
+    uint32_t       roff;
+    int            wsec;         ///< the sector to append to
+    uint32_t       woff;
+    uint32_t       seq;
+#endif
+}oc_mqtt_outbox_t;
+
+static void outbox_put_le(uint8_t *buf, uint32_t value, int len)
+{
+    int i;
+
+    for(i = 0; i < len; i++)
+    {
+        buf[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t outbox_get_le(const uint8_t *buf, int len)
+{
+    uint32_t ret = 0;
+
+    while(len > 0)
+    {
+        len--;
+        ret = (ret << 8) | buf[len];
+    }
+
+    return ret;
+}
+
+static void outbox_head_pack(uint8_t *buf, const outbox_head_t *head)
+{
+    buf[0] = CN_OUTBOX_MAGIC;
+    buf[1] = (uint8_t)head->qos;
+    outbox_put_le(&buf[2], (uint32_t)head->topiclen, 2);
+    outbox_put_le(&buf[4], (uint32_t)head->msglen, 4);
+    outbox_put_le(&buf[8], head->seq, 4);
+    outbox_put_le(&buf[12], head->crc, 4);
+}
+
+///< return the record length while -1 means not a record head
+static int outbox_head_unpack(const uint8_t *buf, outbox_head_t *head, int limit)
+{
+    if(buf[0] != CN_OUTBOX_MAGIC)
+    {
+        return -1;
+    }
+    head->qos = buf[1];
+    head->topiclen = (int)outbox_get_le(&buf[2], 2);
+    head->msglen = (int)outbox_get_le(&buf[4], 4);
+    head->seq = outbox_get_le(&buf[8], 4);
+    head->crc = outbox_get_le(&buf[12], 4);
+    if((head->qos > (int)cn_oc_mqtt_qos_mask) || (head->msglen < 0) || \
+       (head->msglen > (limit - CN_OUTBOX_HEADLEN - head->topiclen)))
+    {
+        return -1;
+    }
+
+    return CN_OUTBOX_HEADLEN + head->topiclen + head->msglen;
+}
+
+///< read the oldest record of the lane to the scratch, return its length while -1 means none
+static int outbox_lane_read(oc_mqtt_outbox_t *outbox, ring_buffer_t *ring, outbox_head_t *head)
+{
+    int len;
+
+    if(CN_OUTBOX_HEADLEN != ring_buffer_read(ring, outbox->scratch, CN_OUTBOX_HEADLEN))
+    {
+        return -1;
+    }
+    len = outbox_head_unpack(outbox->scratch, head, outbox->scratchlen);
+    if((len < 0) || ((len > CN_OUTBOX_HEADLEN) && ((len - CN_OUTBOX_HEADLEN) != \
+        ring_buffer_read(ring, outbox->scratch + CN_OUTBOX_HEADLEN, len - CN_OUTBOX_HEADLEN))))
+    {
+        return -1;
+    }
+
+    return len;
+}
+
+#if CN_OUTBOX_FLASH
+
+#define CN_OUTBOX_NEXT(x)   (((x) + 1) % CN_OUTBOX_SECTORS)
+
+static int outbox_flash_empty(oc_mqtt_outbox_t *outbox)
+{
+    return (outbox->rsec == outbox->wsec) && (outbox->roff >= outbox->woff);
+}
+
+static uint32_t outbox_flash_crc(oc_mqtt_outbox_t *outbox, int len)
+{
+    uint32_t crc;
+
+    crc = calc_crc32(0, outbox->scratch, CN_OUTBOX_CRCLEN);
+    crc = calc_crc32(crc, outbox->scratch + CN_OUTBOX_HEADLEN, len - CN_OUTBOX_HEADLEN);
+
+    return crc;
+}
+
+///< read the record at the offset to the scratch, return the length in flash while -1 means none
+static int outbox_flash_read(oc_mqtt_outbox_t *outbox, int sec, uint32_t off, uint32_t end, outbox_head_t *head)
+{
+    int len;
+    uint32_t addr = (uint32_t)sec * CONFIG_OC_MQTT_OUTBOX_SECTOR + off;
+
+    if((off + CN_OUTBOX_HEADLEN > end) || \
+       (0 != storage_partition_read(CONFIG_OC_MQTT_OUTBOX_PARTITION, outbox->scratch, CN_OUTBOX_HEADLEN, addr)))
+    {
+        return -1;
+    }
+    len = outbox_head_unpack(outbox->scratch, head, outbox->scratchlen);
+    if((len < 0) || (off + CN_OUTBOX_ALIGNED(len) > end) || \
+       (0 != storage_partition_read(CONFIG_OC_MQTT_OUTBOX_PARTITION, outbox->scratch + CN_OUTBOX_HEADLEN, \
+                                    len - CN_OUTBOX_HEADLEN, addr + CN_OUTBOX_HEADLEN)) || \
+       (head->crc != outbox_flash_crc(outbox, len)))
+    {
+        return -1;
+    }
+
+    return CN_OUTBOX_ALIGNED(len);
+}
+
+///< the sector to send from is done, erase it so it will not be found again after the reboot
+static void outbox_flash_release(oc_mqtt_outbox_t *outbox)
+{
+    (void) storage_partition_erase(CONFIG_OC_MQTT_OUTBOX_PARTITION, \
+            (uint32_t)outbox->rsec * CONFIG_OC_MQTT_OUTBOX_SECTOR, CONFIG_OC_MQTT_OUTBOX_SECTOR);
+    outbox->rsec = CN_OUTBOX_NEXT(outbox->rsec);
+    outbox->roff = 0;
+}
+
+///< erase the sector if anything programmed, used when recovering
+static void outbox_flash_clean(oc_mqtt_outbox_t *outbox, int sec)
+{
+    uint32_t off;
+    int len;
+    int i;
+
+    for(off = 0; off < CONFIG_OC_MQTT_OUTBOX_SECTOR; off += len)
+    {
+        len = CONFIG_OC_MQTT_OUTBOX_SECTOR - off;
+        len = (len > outbox->scratchlen) ? outbox->scratchlen : len;
+        if(0 != storage_partition_read(CONFIG_OC_MQTT_OUTBOX_PARTITION, outbox->scratch, len, \
+                                       (uint32_t)sec * CONFIG_OC_MQTT_OUTBOX_SECTOR + off))
+        {
+            break;
+        }
+        for(i = 0; (i < len) && (outbox->scratch[i] == 0xff); i++)
+        {
+        }
+        if(i < len)
+        {
+            break;
+        }
+    }
+    if(off < CONFIG_OC_MQTT_OUTBOX_SECTOR)
+    {
+        (void) storage_partition_erase(CONFIG_OC_MQTT_OUTBOX_PARTITION, \
+                (uint32_t)sec * CONFIG_OC_MQTT_OUTBOX_SECTOR, CONFIG_OC_MQTT_OUTBOX_SECTOR);
+    }
+}
+
+///< the log is full, drop the sector to send from; only the heads are read to count the
+///< dropped records, the scratch holds the record being appended
+static void outbox_flash_drop(oc_mqtt_outbox_t *outbox)
+{
+    outbox_head_t head;
+    uint8_t buf[CN_OUTBOX_HEADLEN];
+    int len;
+    int dropped = 0;
+
+    while((outbox->roff + CN_OUTBOX_HEADLEN <= CONFIG_OC_MQTT_OUTBOX_SECTOR) && \
+          (0 == storage_partition_read(CONFIG_OC_MQTT_OUTBOX_PARTITION, buf, CN_OUTBOX_HEADLEN, \
+                (uint32_t)outbox->rsec * CONFIG_OC_MQTT_OUTBOX_SECTOR + outbox->roff)) && \
+          ((len = outbox_head_unpack(buf, &head, outbox->scratchlen)) > 0))
+    {
+        outbox->roff += CN_OUTBOX_ALIGNED(len);
+        dropped++;
+    }
+    outbox->flashcount = (outbox->flashcount > dropped) ? (outbox->flashcount - dropped) : 0;
+    LINK_LOG_DEBUG("outbox:flash full, %d messages dropped", dropped);
+    outbox_flash_release(outbox);
+}
+
+///< append the record in the scratch to the flash log
+static int outbox_flash_append(oc_mqtt_outbox_t *outbox, int len)
+{
+    outbox_head_t head;
+    int alen = CN_OUTBOX_ALIGNED(len);
+    int ret;
+
+    if(outbox->woff + alen > CONFIG_OC_MQTT_OUTBOX_SECTOR)
+    {
+        if(outbox_flash_empty(outbox))
+        {
+            outbox_flash_release(outbox);   ///< all sent, no need to wait the lazy release
+        }
+        else if(CN_OUTBOX_NEXT(outbox->wsec) == outbox->rsec)
+        {
+            outbox_flash_drop(outbox);
+        }
+        outbox->wsec = CN_OUTBOX_NEXT(outbox->wsec);
+        outbox->woff = 0;
+    }
+
+    (void) outbox_head_unpack(outbox->scratch, &head, outbox->scratchlen);
+    head.seq = outbox->seq++;
+    outbox_head_pack(outbox->scratch, &head);
+    head.crc = outbox_flash_crc(outbox, len);
+    outbox_head_pack(outbox->scratch, &head);
+    (void) memset(outbox->scratch + len, 0xff, alen - len);
+
+    ret = storage_partition_write(CONFIG_OC_MQTT_OUTBOX_PARTITION, outbox->scratch, alen, \
+            (uint32_t)outbox->wsec * CONFIG_OC_MQTT_OUTBOX_SECTOR + outbox->woff);
+    outbox->woff += alen;     ///< a failed area is not programmed again anyway
+    if(0 == ret)
+    {
+        outbox->flashcount++;
+    }
+
+    return ret;
+}
+
+///< read the oldest record of the flash log to the scratch
+static int outbox_flash_peek(oc_mqtt_outbox_t *outbox)
+{
+    outbox_head_t head;
+    int len = -1;
+    uint32_t end;
+
+    while(!outbox_flash_empty(outbox))
+    {
+        end = (outbox->rsec == outbox->wsec) ? outbox->woff : CONFIG_OC_MQTT_OUTBOX_SECTOR;
+        len = outbox_flash_read(outbox, outbox->rsec, outbox->roff, end, &head);
+        if(len > 0)
+        {
+            break;
+        }
+        ///< the rest of the sector is not usable
+        if(outbox->rsec == outbox->wsec)
+        {
+            outbox->roff = outbox->woff;
+            outbox->flashcount = 0;
+        }
+        else
+        {
+            outbox_flash_release(outbox);
+        }
+    }
+
+    return len;
+}
+
+///< find the live sectors by the sequence of their first records, the oldest one is sent first
+static void outbox_flash_recover(oc_mqtt_outbox_t *outbox)
+{
+    outbox_head_t head;
+    int sec;
+    int tail = -1;
+    int newest = -1;
+    uint32_t tailseq = 0;
+    uint32_t newestseq = 0;
+    uint32_t off;
+    int len;
+
+    for(sec = 0; sec < CN_OUTBOX_SECTORS; sec++)
+    {
+        if(outbox_flash_read(outbox, sec, 0, CONFIG_OC_MQTT_OUTBOX_SECTOR, &head) > 0)
+        {
+            if((tail < 0) || ((int32_t)(head.seq - tailseq) < 0))
+            {
+                tail = sec;
+                tailseq = head.seq;
+            }
+            if((newest < 0) || ((int32_t)(head.seq - newestseq) > 0))
+            {
+                newest = sec;
+                newestseq = head.seq;
+            }
+        }
+    }
+
+    outbox->flashcount = 0;
+    if(tail < 0)
+    {
+        for(sec = 0; sec < CN_OUTBOX_SECTORS; sec++)
+        {
+            outbox_flash_clean(outbox, sec);
+        }
+        outbox->rsec = 0;
+        outbox->roff = 0;
+        outbox->wsec = 0;
+        outbox->woff = 0;
+        outbox->seq = 0;
+        return;
+    }
+
+    outbox->seq = newestseq;
+    for(sec = tail; ; sec = CN_OUTBOX_NEXT(sec))
+    {
+        off = 0;
+        while((len = outbox_flash_read(outbox, sec, off, CONFIG_OC_MQTT_OUTBOX_SECTOR, &head)) > 0)
+        {
+            outbox->flashcount++;
+            outbox->seq = head.seq + 1;
+            off += len;
+        }
+        if(sec == newest)
+        {
+            break;
+        }
+    }
+    for(sec = CN_OUTBOX_NEXT(newest); sec != tail; sec = CN_OUTBOX_NEXT(sec))
+    {
+        outbox_flash_clean(outbox, sec);
+    }
+
+    ///< the newest sector may end with a torn record, so the next record starts a new sector
+    outbox->rsec = tail;
+    outbox->roff = 0;
+    outbox->wsec = newest;
+    outbox->woff = CONFIG_OC_MQTT_OUTBOX_SECTOR;
+    LINK_LOG_DEBUG("outbox:%d messages recovered", outbox->flashcount);
+}
+
+#endif
+
+///< move the oldest record of the lane to the flash log, or drop it; the lane which could not be read
+///< back is broken, so it is reset with all its records dropped
+static void outbox_lane_spill(oc_mqtt_outbox_t *outbox, int lane)
+{
+    outbox_head_t head;
+    int len;
+
+    len = outbox_lane_read(outbox, &outbox->lane[lane], &head);
+    if(len < 0)
+    {
+        LINK_LOG_DEBUG("outbox:lane %d broken, %d messages dropped", lane, outbox->count[lane]);
+        (void) ring_buffer_reset(&outbox->lane[lane]);
+        outbox->count[lane] = 0;
+        return;
+    }
+    outbox->count[lane]--;
+#if CN_OUTBOX_FLASH
+    if((len > 0) && (0 == outbox_flash_append(outbox, len)))
+    {
+        return;
+    }
+#else
+    (void) len;
+#endif
+    LINK_LOG_DEBUG("outbox:lane %d full, message dropped", lane);
+}
+
+void *oc_mqtt_outbox_create(void)
+{
+    oc_mqtt_outbox_t *outbox;
+    int scratchlen;
+    uint8_t *mem;
+
+    scratchlen = CONFIG_OC_MQTT_OUTBOX_RAMSIZE > CONFIG_OC_MQTT_OUTBOX_ALARMSIZE ? \
+                 CONFIG_OC_MQTT_OUTBOX_RAMSIZE : CONFIG_OC_MQTT_OUTBOX_ALARMSIZE;
+    scratchlen = CN_OUTBOX_ALIGNED(scratchlen);
+
+    outbox = osal_zalloc(sizeof(oc_mqtt_outbox_t) + CONFIG_OC_MQTT_OUTBOX_RAMSIZE + \
+                         CONFIG_OC_MQTT_OUTBOX_ALARMSIZE + scratchlen);
+    if(NULL == outbox)
+    {
+        return NULL;
+    }
+
+    mem = (uint8_t *)outbox + sizeof(oc_mqtt_outbox_t);
+    (void) ring_buffer_init(&outbox->lane[CN_OUTBOX_LANENORMAL], mem, CONFIG_OC_MQTT_OUTBOX_RAMSIZE, 0, 0);
+    mem += CONFIG_OC_MQTT_OUTBOX_RAMSIZE;
+    (void) ring_buffer_init(&outbox->lane[CN_OUTBOX_LANEALARM], mem, CONFIG_OC_MQTT_OUTBOX_ALARMSIZE, 0, 0);
+    mem += CONFIG_OC_MQTT_OUTBOX_ALARMSIZE;
+    outbox->scratch = mem;
+    outbox->scratchlen = scratchlen;
+    outbox->peeked = CN_OUTBOX_SRCNONE;
+
+#if CN_OUTBOX_FLASH
+    outbox_flash_recover(outbox);
+#endif
+
+    return outbox;
+}
+
+int oc_mqtt_outbox_put(void *outbox, const char *topic, const uint8_t *msg, int len, int qos)
+{
+    oc_mqtt_outbox_t *box = outbox;
+    outbox_head_t head;
+    uint8_t buf[CN_OUTBOX_HEADLEN];
+    ring_buffer_t *ring;
+    int lane;
+    int reclen;
+
+    if((NULL == box) || ((NULL == msg) && (len != 0)) || (len < 0))
+    {
+        return -1;
+    }
+
+    lane = (qos & cn_oc_mqtt_qos_alarm) ? CN_OUTBOX_LANEALARM : CN_OUTBOX_LANENORMAL;
+    ring = &box->lane[lane];
+    head.qos = qos & cn_oc_mqtt_qos_mask;
+    head.topiclen = (NULL == topic) ? 0 : (int)strlen(topic) + 1;
+    head.msglen = len;
+    head.seq = 0;
+    head.crc = 0;
+    reclen = CN_OUTBOX_HEADLEN + head.topiclen + len;
+    if((head.topiclen > 0xffff) || (len > ring_buffer_buflen(ring)) || (reclen > ring_buffer_buflen(ring)))
+    {
+        return -1;
+    }
+#if CN_OUTBOX_FLASH
+    if(CN_OUTBOX_ALIGNED(reclen) > CONFIG_OC_MQTT_OUTBOX_SECTOR)
+    {
+        return -1;
+    }
+#endif
+
+    box->peeked = CN_OUTBOX_SRCNONE;     ///< the spill below may move the peeked one
+    while(ring_buffer_freespace(ring) < reclen)
+    {
+        outbox_lane_spill(box, lane);
+    }
+
+    outbox_head_pack(buf, &head);
+    (void) ring_buffer_write(ring, buf, CN_OUTBOX_HEADLEN);
+    if(head.topiclen > 0)
+    {
+        (void) ring_buffer_write(ring, (unsigned char *)topic, head.topiclen);
+    }
+    if(len > 0)
+    {
+        (void) ring_buffer_write(ring, (unsigned char *)msg, len);
+    }
+    box->count[lane]++;
+
+    return 0;
+}
+
+int oc_mqtt_outbox_count(void *outbox, int qos)
+{
+    oc_mqtt_outbox_t *box = outbox;
+    int ret;
+
+    if(NULL == box)
+    {
+        return 0;
+    }
+
+    ret = box->count[CN_OUTBOX_LANEALARM];
+    if(0 == (qos & cn_oc_mqtt_qos_alarm))
+    {
+        ret += box->count[CN_OUTBOX_LANENORMAL];
+#if CN_OUTBOX_FLASH
+        ret += outbox_flash_empty(box) ? 0 : box->flashcount;
+#endif
+    }
+
+    return ret;
+}
+
+int oc_mqtt_outbox_peek(void *outbox, oc_mqtt_outbox_msg_t *msg)
+{
+    oc_mqtt_outbox_t *box = outbox;
+    outbox_head_t head;
+    ring_buffer_t cursor;
+    int len = -1;
+
+    if((NULL == box) || (NULL == msg))
+    {
+        return -1;
+    }
+
+    box->peeked = CN_OUTBOX_SRCNONE;
+    if(box->count[CN_OUTBOX_LANEALARM] > 0)
+    {
+        cursor = box->lane[CN_OUTBOX_LANEALARM];
+        len = outbox_lane_read(box, &cursor, &head);
+        box->peeked = CN_OUTBOX_LANEALARM;
+    }
+#if CN_OUTBOX_FLASH
+    if(len < 0)
+    {
+        len = outbox_flash_peek(box);
+        if(len > 0)
+        {
+            (void) outbox_head_unpack(box->scratch, &head, box->scratchlen);
+            box->peeked = CN_OUTBOX_SRCFLASH;
+        }
+    }
+#endif
+    if((len < 0) && (box->count[CN_OUTBOX_LANENORMAL] > 0))
+    {
+        cursor = box->lane[CN_OUTBOX_LANENORMAL];
+        len = outbox_lane_read(box, &cursor, &head);
+        box->peeked = CN_OUTBOX_LANENORMAL;
+    }
+    if(len < 0)
+    {
+        box->peeked = CN_OUTBOX_SRCNONE;
+        return -1;
+    }
+
+    box->peeklen = len;
+    msg->topic = (head.topiclen > 0) ? (char *)box->scratch + CN_OUTBOX_HEADLEN : NULL;
+    msg->msg = box->scratch + CN_OUTBOX_HEADLEN + head.topiclen;
+    msg->len = head.msglen;
+    msg->qos = head.qos;
+    if(head.topiclen > 0)
+    {
+        box->scratch[CN_OUTBOX_HEADLEN + head.topiclen - 1] = '\0';
+    }
+
+    return 0;
+}
+
+int oc_mqtt_outbox_pop(void *outbox)
+{
+    oc_mqtt_outbox_t *box = outbox;
+    ring_buffer_t *ring;
+
+    if((NULL == box) || (CN_OUTBOX_SRCNONE == box->peeked))
+    {
+        return -1;
+    }
+
+    if(box->peeked < CN_OUTBOX_LANES)
+    {
+        ring = &box->lane[box->peeked];
+        ring_buffer_dumpread(ring, box->peeklen);
+        box->count[box->peeked]--;
+    }
+#if CN_OUTBOX_FLASH
+    else
+    {
+        box->roff += box->peeklen;
+        box->flashcount = (box->flashcount > 0) ? (box->flashcount - 1) : 0;
+    }
+#endif
+    box->peeked = CN_OUTBOX_SRCNONE;
+
+    return 0;
+}
+
+int oc_mqtt_outbox_flush(void *outbox)
+{
+    int ret = -1;
+#if CN_OUTBOX_FLASH
+    oc_mqtt_outbox_t *box = outbox;
+    int lane;
+
+    if(NULL != box)
+    {
+        box->peeked = CN_OUTBOX_SRCNONE;
+        for(lane = CN_OUTBOX_LANEALARM; lane >= CN_OUTBOX_LANENORMAL; lane--)
+        {
+            while(box->count[lane] > 0)
+            {
+                outbox_lane_spill(box, lane);
+            }
+        }
+        ret = 0;
+    }
+#else
+    (void) outbox;
+#endif
+
+    return ret;
+}
+
+int oc_mqtt_outbox_delete(void *outbox)
+{
+    if(NULL == outbox)
+    {
+        return -1;
+    }
+    osal_free(outbox);
+
+    return 0;
+}
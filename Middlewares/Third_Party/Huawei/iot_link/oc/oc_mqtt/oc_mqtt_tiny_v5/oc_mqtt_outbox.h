@@ -0,0 +1,161 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 19:59   The first version
+ *
+ */
+#ifndef LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_TINY_OC_MQTT_OUTBOX_H_
+#define LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_TINY_OC_MQTT_OUTBOX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * the outbox keeps the publishes made while the connection is not ready, and the daemon
+ * sends them after the connection is built again:
+ *
+ * 1, there are two RAM lanes, the alarm lane(qos or-ed with cn_oc_mqtt_qos_alarm) is sent
+ *    first, then the flash log, then the normal lane
+ * 2, when a lane is full, its oldest messages are moved to the flash log, or dropped when
+ *    there is no flash partition configured; when the flash log is full, its oldest sector
+ *    is dropped
+ * 3, the flash log is a ring of sectors and each record is programmed only once, a sector
+ *    is erased after all its records are sent; the records of the sector being sent are
+ *    found again after the reboot, so the delivery is at least once
+ *
+ * */
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_ENABLE
+#define CONFIG_OC_MQTT_OUTBOX_ENABLE          0
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_RAMSIZE
+#define CONFIG_OC_MQTT_OUTBOX_RAMSIZE         2048     ///< the normal lane size
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_ALARMSIZE
+#define CONFIG_OC_MQTT_OUTBOX_ALARMSIZE       512      ///< the alarm lane size
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_PARTITION
+#define CONFIG_OC_MQTT_OUTBOX_PARTITION       -1       ///< the storage partition for the flash log, -1 means none
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_FLASHSIZE
+#define CONFIG_OC_MQTT_OUTBOX_FLASHSIZE       0x4000   ///< the flash log size from the partition start
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_SECTOR
+#define CONFIG_OC_MQTT_OUTBOX_SECTOR          2048     ///< the erase unit of the partition
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_DRAIN_BURST
+#define CONFIG_OC_MQTT_OUTBOX_DRAIN_BURST     4        ///< how many queued messages sent in each interval
+#endif
+
+#ifndef CONFIG_OC_MQTT_OUTBOX_DRAIN_INTERVAL
+#define CONFIG_OC_MQTT_OUTBOX_DRAIN_INTERVAL  1000     ///< unit:ms
+#endif
+
+typedef struct
+{
+    char     *topic;     ///< NULL means the default topic
+    uint8_t  *msg;
+    int       len;
+    int       qos;       ///< the mqtt qos, the alarm flag removed
+}oc_mqtt_outbox_msg_t;
+
+/**
+ * @brief:use this function to create the outbox, the flash log is recovered if configured
+ *
+ * @return:the outbox handle, while NULL failed
+ * */
+void *oc_mqtt_outbox_create(void);
+
+/**
+ * @brief:use this function to queue a message
+ *
+ * @param[in]:outbox, the outbox handle
+ * @param[in]:topic, the topic, NULL means the default topic
+ * @param[in]:msg, the message
+ * @param[in]:len, the message length
+ * @param[in]:qos, the mqtt qos, could be or-ed with cn_oc_mqtt_qos_alarm
+ *
+ * @return:0 success while -1 failed(the message is bigger than a lane or a sector)
+ * */
+int oc_mqtt_outbox_put(void *outbox, const char *topic, const uint8_t *msg, int len, int qos);
+
+/**
+ * @brief:use this function to know how many messages will be sent before a new message
+ *
+ * @param[in]:outbox, the outbox handle
+ * @param[in]:qos, the qos of the new message, only the alarm flag matters
+ *
+ * @return:the alarm lane count for the alarm, while all the queued messages for the others
+ * */
+int oc_mqtt_outbox_count(void *outbox, int qos);
+
+/**
+ * @brief:use this function to get the message to send next, it is kept until the pop
+ *
+ * @param[in]:outbox, the outbox handle
+ * @param[out]:msg, the message which points to the outbox memory, valid until the next call
+ *
+ * @return:0 success while -1 means nothing queued
+ * */
+int oc_mqtt_outbox_peek(void *outbox, oc_mqtt_outbox_msg_t *msg);
+
+/**
+ * @brief:use this function to remove the peeked message when it has been sent(acked for qos1)
+ *
+ * @return:0 success while -1 failed(no message peeked, or a put happened after the peek)
+ * */
+int oc_mqtt_outbox_pop(void *outbox);
+
+/**
+ * @brief:use this function to move the RAM lanes to the flash log, call it before power off
+ *
+ * @return:0 success while -1 failed(no flash log)
+ * */
+int oc_mqtt_outbox_flush(void *outbox);
+
+/**
+ * @brief:use this function to delete the outbox, the RAM lanes are lost if not flushed
+ *
+ * @return:0 success while -1 failed
+ * */
+int oc_mqtt_outbox_delete(void *outbox);
+
+#endif /* LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_TINY_OC_MQTT_OUTBOX_H_ */
@@ -0,0 +1,846 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 21:40   The first version
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <osal.h>
+#include <link_misc.h>
+#include "oc_mqtt_session.h"
+
+#if (CONFIG_OC_MQTT_SESSION_PARTITION >= 0)
+#define CN_SESSION_FLASH       1
+#include <crc.h>
+#include <partition.h>
+#else
+#define CN_SESSION_FLASH       0
+#endif
+
+#define CN_SESSION_SUB         1
+#define CN_SESSION_PUB         2
+
+typedef struct
+{
+    uint8_t   type;      ///< CN_SESSION_SUB or CN_SESSION_PUB, 0 means free
+    uint8_t   qos;
+    uint16_t  id;        ///< the packet id of the publish, 0 means not bound yet
+    uint32_t  handle;    ///< the publish handle
+    char     *topic;     ///< the subscription topic
+#if CN_SESSION_FLASH
+    uint32_t  off;       ///< where the publish record is in the bank
+    int       len;       ///< the publish record length in flash
+#endif
+}session_entry_t;
+
+typedef struct
+{
+    session_entry_t  entry[CONFIG_OC_MQTT_SESSION_ENTRIES];
+    osal_mutex_t     lock;       ///< the ack comes from the mqtt engine task
+    uint32_t         handle;     ///< the last publish handle
+#if CN_SESSION_FLASH
+    uint8_t         *scratch;    ///< the record being read or written
+    int              scratchlen;
+    int              bank;       ///< the sector to append to
+    uint32_t         woff;
+    uint32_t         gen;        ///< the generation of the bank, the newer one is taken after the reboot
+#endif
+}oc_mqtt_session_t;
+
+static session_entry_t *session_find(oc_mqtt_session_t *s, int type, const char *topic, uint32_t handle)
+{
+    session_entry_t *e;
+    int i;
+
+    for(i = 0; i < CONFIG_OC_MQTT_SESSION_ENTRIES; i++)
+    {
+        e = &s->entry[i];
+        if((type == e->type) && \
+           ((CN_SESSION_SUB == type) ? (0 == strcmp(e->topic, topic)) : (handle == e->handle)))
+        {
+            return e;
+        }
+    }
+
+    return NULL;
+}
+
+static session_entry_t *session_free_entry(oc_mqtt_session_t *s)
+{
+    return session_find(s, 0, NULL, 0);
+}
+
+static void session_release(session_entry_t *e)
+{
+    if(NULL != e->topic)
+    {
+        osal_free(e->topic);
+    }
+    (void) memset(e, 0, sizeof(session_entry_t));
+}
+
+///< keep the subscription in RAM, return NULL when no entry left
+static session_entry_t *session_keep_sub(oc_mqtt_session_t *s, const char *topic, int qos)
+{
+    session_entry_t *e;
+
+    e = session_find(s, CN_SESSION_SUB, topic, 0);
+    if(NULL == e)
+    {
+        e = session_free_entry(s);
+        if((NULL == e) || (NULL == (e->topic = osal_strdup(topic))))
+        {
+            return NULL;
+        }
+        e->type = CN_SESSION_SUB;
+    }
+    e->qos = (uint8_t)qos;
+
+    return e;
+}
+
+static void session_clear_sub(oc_mqtt_session_t *s)
+{
+    int i;
+
+    for(i = 0; i < CONFIG_OC_MQTT_SESSION_ENTRIES; i++)
+    {
+        if(CN_SESSION_SUB == s->entry[i].type)
+        {
+            session_release(&s->entry[i]);
+        }
+    }
+}
+
+#if CN_SESSION_FLASH
+
+///< the record is the head, the topic with its '\0' and the message, padded to the double-word
+///< for the STM32L4 flash could only program each double-word once
+#define CN_SESSION_MAGIC       0x5A
+#define CN_SESSION_HEADLEN     16
+#define CN_SESSION_CRCLEN      12        ///< the crc covers the head before the crc and the body
+#define CN_SESSION_ALIGN       8
+#define CN_SESSION_ALIGNED(x)  (((x) + CN_SESSION_ALIGN - 1) & (~(CN_SESSION_ALIGN - 1)))
+
+#define CN_SESSION_RECBANK     1         ///< the first record of the bank, the seq is the generation
+#define CN_SESSION_RECSUB      2         ///< the subscription topic with the granted qos
+#define CN_SESSION_RECUNSUB    3         ///< the subscription topic
+#define CN_SESSION_RECCLEAR    4         ///< all the subscriptions forgotten
+#define CN_SESSION_RECPUB      5         ///< the seq is the handle, the topic and the message
+#define CN_SESSION_RECPID      6         ///< the seq is the handle, with the packet id
+#define CN_SESSION_RECACK      7         ///< the seq is the handle
+
+typedef struct
+{
+    int       type;
+    int       qos;
+    int       id;
+    int       topiclen;      ///< including the '\0'
+    int       msglen;
+    uint32_t  seq;
+    uint32_t  crc;
+}session_head_t;
+
+static void session_put_le(uint8_t *buf, uint32_t value, int len)
+{
+    int i;
+
+    for(i = 0; i < len; i++)
+    {
+        buf[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t session_get_le(const uint8_t *buf, int len)
+{
+    uint32_t ret = 0;
+
+    while(len > 0)
+    {
+        len--;
+        ret = (ret << 8) | buf[len];
+    }
+
+    return ret;
+}
+
+static void session_head_pack(uint8_t *buf, const session_head_t *head)
+{
+    buf[0] = CN_SESSION_MAGIC;
+    buf[1] = (uint8_t)(head->type | (head->qos << 4));
+    session_put_le(&buf[2], (uint32_t)head->id, 2);
+    session_put_le(&buf[4], (uint32_t)head->topiclen, 2);
+    session_put_le(&buf[6], (uint32_t)head->msglen, 2);
+    session_put_le(&buf[8], head->seq, 4);
+    session_put_le(&buf[12], head->crc, 4);
+}
+
+///< return the record length while -1 means not a record head
+static int session_head_unpack(const uint8_t *buf, session_head_t *head, int limit)
+{
+    if(buf[0] != CN_SESSION_MAGIC)
+    {
+        return -1;
+    }
+    head->type = buf[1] & 0x0f;
+    head->qos = buf[1] >> 4;
+    head->id = (int)session_get_le(&buf[2], 2);
+    head->topiclen = (int)session_get_le(&buf[4], 2);
+    head->msglen = (int)session_get_le(&buf[6], 2);
+    head->seq = session_get_le(&buf[8], 4);
+    head->crc = session_get_le(&buf[12], 4);
+    if((head->type < CN_SESSION_RECBANK) || (head->type > CN_SESSION_RECACK) || (head->qos > 2) || \
+       (head->topiclen + head->msglen > limit - CN_SESSION_HEADLEN))
+    {
+        return -1;
+    }
+
+    return CN_SESSION_HEADLEN + head->topiclen + head->msglen;
+}
+
+static uint32_t session_flash_crc(oc_mqtt_session_t *s, int len)
+{
+    uint32_t crc;
+
+    crc = calc_crc32(0, s->scratch, CN_SESSION_CRCLEN);
+    crc = calc_crc32(crc, s->scratch + CN_SESSION_HEADLEN, len - CN_SESSION_HEADLEN);
+
+    return crc;
+}
+
+///< read the record at the offset to the scratch, return the length in flash while -1 means none
+static int session_flash_read(oc_mqtt_session_t *s, int bank, uint32_t off, session_head_t *head)
+{
+    int len;
+    uint32_t addr = (uint32_t)bank * CONFIG_OC_MQTT_SESSION_SECTOR + off;
+
+    if((off + CN_SESSION_HEADLEN > CONFIG_OC_MQTT_SESSION_SECTOR) || \
+       (0 != storage_partition_read(CONFIG_OC_MQTT_SESSION_PARTITION, s->scratch, CN_SESSION_HEADLEN, addr)))
+    {
+        return -1;
+    }
+    len = session_head_unpack(s->scratch, head, s->scratchlen);
+    if((len < 0) || (off + CN_SESSION_ALIGNED(len) > CONFIG_OC_MQTT_SESSION_SECTOR) || \
+       (0 != storage_partition_read(CONFIG_OC_MQTT_SESSION_PARTITION, s->scratch + CN_SESSION_HEADLEN, \
+                                    len - CN_SESSION_HEADLEN, addr + CN_SESSION_HEADLEN)) || \
+       (head->crc != session_flash_crc(s, len)))
+    {
+        return -1;
+    }
+
+    return CN_SESSION_ALIGNED(len);
+}
+
+///< program the head and the body in the scratch at the offset, return the length in flash
+static int session_flash_write(oc_mqtt_session_t *s, int bank, uint32_t off, session_head_t *head)
+{
+    int len = CN_SESSION_HEADLEN + head->topiclen + head->msglen;
+    int alen = CN_SESSION_ALIGNED(len);
+
+    session_head_pack(s->scratch, head);
+    head->crc = session_flash_crc(s, len);
+    session_head_pack(s->scratch, head);
+    (void) memset(s->scratch + len, 0xff, alen - len);
+    (void) storage_partition_write(CONFIG_OC_MQTT_SESSION_PARTITION, s->scratch, alen, \
+            (uint32_t)bank * CONFIG_OC_MQTT_SESSION_SECTOR + off);
+
+    return alen;
+}
+
+///< the live publishes in the publish order
+static int session_pubs(oc_mqtt_session_t *s, session_entry_t **pubs)
+{
+    session_entry_t *e;
+    int n = 0;
+    int i;
+    int j;
+
+    for(i = 0; i < CONFIG_OC_MQTT_SESSION_ENTRIES; i++)
+    {
+        e = &s->entry[i];
+        if(CN_SESSION_PUB != e->type)
+        {
+            continue;
+        }
+        for(j = n; (j > 0) && ((int32_t)(pubs[j - 1]->handle - e->handle) > 0); j--)
+        {
+            pubs[j] = pubs[j - 1];
+        }
+        pubs[j] = e;
+        n++;
+    }
+
+    return n;
+}
+
+///< copy the live entries to the other bank, the oldest publishes are dropped if they do not fit;
+///< the bank record is programmed last, so the old bank is still taken if it is torn
+static void session_flash_compact(oc_mqtt_session_t *s)
+{
+    session_entry_t *pubs[CONFIG_OC_MQTT_SESSION_ENTRIES];
+    session_entry_t *e;
+    session_head_t head;
+    int bank = 1 - s->bank;
+    uint32_t off = CN_SESSION_HEADLEN;
+    uint32_t total = 0;
+    int n;
+    int i;
+
+    (void) storage_partition_erase(CONFIG_OC_MQTT_SESSION_PARTITION, \
+            (uint32_t)bank * CONFIG_OC_MQTT_SESSION_SECTOR, CONFIG_OC_MQTT_SESSION_SECTOR);
+
+    (void) memset(&head, 0, sizeof(head));
+    for(i = 0; i < CONFIG_OC_MQTT_SESSION_ENTRIES; i++)
+    {
+        e = &s->entry[i];
+        if(CN_SESSION_SUB != e->type)
+        {
+            continue;
+        }
+        head.type = CN_SESSION_RECSUB;
+        head.qos = e->qos;
+        head.topiclen = (int)strlen(e->topic) + 1;
+        if((CN_SESSION_HEADLEN + head.topiclen > s->scratchlen) || \
+           (off + CN_SESSION_ALIGNED(CN_SESSION_HEADLEN + head.topiclen) > CONFIG_OC_MQTT_SESSION_SECTOR))
+        {
+            session_release(e);
+            continue;
+        }
+        (void) memcpy(s->scratch + CN_SESSION_HEADLEN, e->topic, head.topiclen);
+        off += session_flash_write(s, bank, off, &head);
+    }
+
+    n = session_pubs(s, pubs);
+    for(i = 0; i < n; i++)
+    {
+        total += pubs[i]->len;
+    }
+    for(i = 0; i < n; i++)
+    {
+        e = pubs[i];
+        if(off + total > CONFIG_OC_MQTT_SESSION_SECTOR)
+        {
+            LINK_LOG_DEBUG("session:full, publish %u dropped", (unsigned int)e->handle);
+            total -= e->len;
+            session_release(e);
+            continue;
+        }
+        total -= e->len;
+        if(session_flash_read(s, s->bank, e->off, &head) < 0)
+        {
+            session_release(e);
+            continue;
+        }
+        head.id = e->id;
+        e->off = off;
+        off += session_flash_write(s, bank, off, &head);
+    }
+
+    (void) memset(&head, 0, sizeof(head));
+    head.type = CN_SESSION_RECBANK;
+    head.seq = s->gen + 1;
+    (void) session_flash_write(s, bank, 0, &head);
+
+    s->bank = bank;
+    s->woff = off;
+    s->gen++;
+}
+
+///< append a record, return its offset while -1 failed
+static int session_flash_log(oc_mqtt_session_t *s, session_head_t *head, const char *topic, const uint8_t *msg)
+{
+    int len = CN_SESSION_HEADLEN + head->topiclen + head->msglen;
+    int off;
+
+    if(len > s->scratchlen)
+    {
+        return -1;
+    }
+    if(s->woff + CN_SESSION_ALIGNED(len) > CONFIG_OC_MQTT_SESSION_SECTOR)
+    {
+        session_flash_compact(s);
+        if(s->woff + CN_SESSION_ALIGNED(len) > CONFIG_OC_MQTT_SESSION_SECTOR)
+        {
+            return -1;
+        }
+    }
+    if(head->topiclen > 0)
+    {
+        (void) memcpy(s->scratch + CN_SESSION_HEADLEN, topic, head->topiclen);
+    }
+    if(head->msglen > 0)
+    {
+        (void) memcpy(s->scratch + CN_SESSION_HEADLEN + head->topiclen, msg, head->msglen);
+    }
+    off = (int)s->woff;
+    s->woff += session_flash_write(s, s->bank, s->woff, head);    ///< a failed area is not programmed again anyway
+
+    return off;
+}
+
+static int session_flash_note(oc_mqtt_session_t *s, int type, const char *topic, int qos, int id, uint32_t seq)
+{
+    session_head_t head;
+
+    (void) memset(&head, 0, sizeof(head));
+    head.type = type;
+    head.qos = qos;
+    head.id = id;
+    head.seq = seq;
+    head.topiclen = (NULL == topic) ? 0 : (int)strlen(topic) + 1;
+
+    return session_flash_log(s, &head, topic, NULL);
+}
+
+///< apply the record in the scratch to the RAM entries
+static void session_flash_replay(oc_mqtt_session_t *s, session_head_t *head, uint32_t off, int len)
+{
+    session_entry_t *e;
+    char *topic = (char *)s->scratch + CN_SESSION_HEADLEN;
+
+    if(head->topiclen > 0)
+    {
+        topic[head->topiclen - 1] = '\0';
+    }
+    switch(head->type)
+    {
+        case CN_SESSION_RECSUB:
+            (void) session_keep_sub(s, topic, head->qos);
+            break;
+        case CN_SESSION_RECUNSUB:
+            e = session_find(s, CN_SESSION_SUB, topic, 0);
+            if(NULL != e)
+            {
+                session_release(e);
+            }
+            break;
+        case CN_SESSION_RECCLEAR:
+            session_clear_sub(s);
+            break;
+        case CN_SESSION_RECPUB:
+            e = session_free_entry(s);
+            if(NULL != e)
+            {
+                e->type = CN_SESSION_PUB;
+                e->qos = (uint8_t)head->qos;
+                e->id = (uint16_t)head->id;
+                e->handle = head->seq;
+                e->off = off;
+                e->len = len;
+            }
+            if((int32_t)(head->seq - s->handle) > 0)
+            {
+                s->handle = head->seq;
+            }
+            break;
+        case CN_SESSION_RECPID:
+        case CN_SESSION_RECACK:
+            e = session_find(s, CN_SESSION_PUB, NULL, head->seq);
+            if((NULL != e) && (CN_SESSION_RECPID == head->type))
+            {
+                e->id = (uint16_t)head->id;
+            }
+            else if(NULL != e)
+            {
+                session_release(e);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+///< take the newer bank and replay it, then copy the live entries to the other bank, which also
+///< leaves the torn record behind
+static void session_flash_recover(oc_mqtt_session_t *s)
+{
+    session_head_t head;
+    uint32_t gen[2] = {0, 0};
+    int valid[2];
+    uint32_t off;
+    int bank;
+    int len;
+
+    for(bank = 0; bank < 2; bank++)
+    {
+        valid[bank] = (session_flash_read(s, bank, 0, &head) > 0) && (CN_SESSION_RECBANK == head.type);
+        gen[bank] = head.seq;
+    }
+    if(valid[0] && valid[1])
+    {
+        bank = ((int32_t)(gen[1] - gen[0]) > 0) ? 1 : 0;
+    }
+    else
+    {
+        bank = valid[0] ? 0 : (valid[1] ? 1 : -1);
+    }
+
+    if(bank < 0)
+    {
+        s->bank = 1;     ///< nothing to replay, the first copy goes to the bank 0
+        s->gen = 0;
+    }
+    else
+    {
+        s->bank = bank;
+        s->gen = gen[bank];
+        for(off = CN_SESSION_HEADLEN; (len = session_flash_read(s, bank, off, &head)) > 0; off += len)
+        {
+            session_flash_replay(s, &head, off, len);
+        }
+    }
+    session_flash_compact(s);
+    LINK_LOG_DEBUG("session:bank %d generation %u recovered", s->bank, (unsigned int)s->gen);
+}
+
+#endif
+
+void *oc_mqtt_session_create(void)
+{
+    oc_mqtt_session_t *s;
+    int scratchlen = 0;
+
+#if CN_SESSION_FLASH
+    scratchlen = CN_SESSION_ALIGNED(CN_SESSION_HEADLEN + CONFIG_OC_MQTT_SESSION_RECORDSIZE);
+#endif
+    s = osal_zalloc(sizeof(oc_mqtt_session_t) + scratchlen);
+    if(NULL == s)
+    {
+        return NULL;
+    }
+    if(false == osal_mutex_create(&s->lock))
+    {
+        osal_free(s);
+        return NULL;
+    }
+
+#if CN_SESSION_FLASH
+    s->scratch = (uint8_t *)s + sizeof(oc_mqtt_session_t);
+    s->scratchlen = scratchlen;
+    session_flash_recover(s);
+#endif
+
+    return s;
+}
+
+int oc_mqtt_session_sub(void *session, const char *topic, int qos)
+{
+    oc_mqtt_session_t *s = session;
+    session_entry_t *e;
+    int ret = -1;
+
+    if((NULL == s) || (NULL == topic))
+    {
+        return ret;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    e = session_find(s, CN_SESSION_SUB, topic, 0);
+    if((NULL != e) && (qos == e->qos))
+    {
+        ret = 0;
+    }
+    else if((NULL != e) || (NULL != session_free_entry(s)))
+    {
+#if CN_SESSION_FLASH
+        (void) session_flash_note(s, CN_SESSION_RECSUB, topic, qos, 0, 0);
+#endif
+        ret = (NULL == session_keep_sub(s, topic, qos)) ? -1 : 0;
+    }
+    (void) osal_mutex_unlock(s->lock);
+
+    return ret;
+}
+
+int oc_mqtt_session_unsub(void *session, const char *topic)
+{
+    oc_mqtt_session_t *s = session;
+    session_entry_t *e;
+    int ret = -1;
+
+    if((NULL == s) || (NULL == topic))
+    {
+        return ret;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    e = session_find(s, CN_SESSION_SUB, topic, 0);
+    if(NULL != e)
+    {
+#if CN_SESSION_FLASH
+        (void) session_flash_note(s, CN_SESSION_RECUNSUB, topic, 0, 0, 0);
+#endif
+        session_release(e);
+        ret = 0;
+    }
+    (void) osal_mutex_unlock(s->lock);
+
+    return ret;
+}
+
+int oc_mqtt_session_find(void *session, const char *topic)
+{
+    oc_mqtt_session_t *s = session;
+    session_entry_t *e;
+    int ret = -1;
+
+    if((NULL == s) || (NULL == topic))
+    {
+        return ret;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    e = session_find(s, CN_SESSION_SUB, topic, 0);
+    if(NULL != e)
+    {
+        ret = e->qos;
+    }
+    (void) osal_mutex_unlock(s->lock);
+
+    return ret;
+}
+
+int oc_mqtt_session_clear(void *session)
+{
+    oc_mqtt_session_t *s = session;
+    int i;
+
+    if(NULL == s)
+    {
+        return -1;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    for(i = 0; i < CONFIG_OC_MQTT_SESSION_ENTRIES; i++)
+    {
+        if(CN_SESSION_SUB == s->entry[i].type)
+        {
+#if CN_SESSION_FLASH
+            (void) session_flash_note(s, CN_SESSION_RECCLEAR, NULL, 0, 0, 0);
+#endif
+            session_clear_sub(s);
+            break;
+        }
+    }
+    (void) osal_mutex_unlock(s->lock);
+
+    return 0;
+}
+
+int oc_mqtt_session_pub(void *session, const char *topic, const uint8_t *msg, int len, int qos, uint32_t *handle)
+{
+    int ret = -1;
+#if CN_SESSION_FLASH
+    oc_mqtt_session_t *s = session;
+    session_entry_t *e;
+    session_head_t head;
+    int off;
+
+    if((NULL == s) || (NULL == topic) || ((NULL == msg) && (len != 0)) || (len < 0) || \
+       (qos < 1) || (qos > 2) || (NULL == handle))
+    {
+        return ret;
+    }
+
+    (void) memset(&head, 0, sizeof(head));
+    head.type = CN_SESSION_RECPUB;
+    head.qos = qos;
+    head.topiclen = (int)strlen(topic) + 1;
+    head.msglen = len;
+
+    (void) osal_mutex_lock(s->lock);
+    if((NULL != session_free_entry(s)) && \
+       (head.topiclen + len <= CONFIG_OC_MQTT_SESSION_RECORDSIZE))
+    {
+        s->handle = (0 == s->handle + 1) ? 1 : s->handle + 1;
+        head.seq = s->handle;
+        off = session_flash_log(s, &head, topic, msg);
+        e = session_free_entry(s);      ///< the compaction may have dropped some
+        if(off >= 0)
+        {
+            e->type = CN_SESSION_PUB;
+            e->qos = (uint8_t)qos;
+            e->handle = s->handle;
+            e->off = (uint32_t)off;
+            e->len = CN_SESSION_ALIGNED(CN_SESSION_HEADLEN + head.topiclen + len);
+            *handle = s->handle;
+            ret = 0;
+        }
+    }
+    (void) osal_mutex_unlock(s->lock);
+#else
+    (void) session;
+    (void) topic;
+    (void) msg;
+    (void) len;
+    (void) qos;
+    (void) handle;
+#endif
+
+    return ret;
+}
+
+int oc_mqtt_session_bind(void *session, uint32_t handle, uint16_t id)
+{
+    int ret = -1;
+#if CN_SESSION_FLASH
+    oc_mqtt_session_t *s = session;
+    session_entry_t *e;
+
+    if(NULL == s)
+    {
+        return ret;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    e = session_find(s, CN_SESSION_PUB, NULL, handle);
+    if(NULL != e)
+    {
+        if(id != e->id)
+        {
+            (void) session_flash_note(s, CN_SESSION_RECPID, NULL, 0, id, handle);
+            e = session_find(s, CN_SESSION_PUB, NULL, handle);     ///< dropped by the compaction maybe
+        }
+        if(NULL != e)
+        {
+            e->id = id;
+            ret = 0;
+        }
+    }
+    (void) osal_mutex_unlock(s->lock);
+#else
+    (void) session;
+    (void) handle;
+    (void) id;
+#endif
+
+    return ret;
+}
+
+int oc_mqtt_session_ack(void *session, uint32_t handle)
+{
+    int ret = -1;
+#if CN_SESSION_FLASH
+    oc_mqtt_session_t *s = session;
+    session_entry_t *e;
+
+    if(NULL == s)
+    {
+        return ret;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    e = session_find(s, CN_SESSION_PUB, NULL, handle);
+    if(NULL != e)
+    {
+        session_release(e);      ///< not copied by the compaction for the record below
+        (void) session_flash_note(s, CN_SESSION_RECACK, NULL, 0, 0, handle);
+        ret = 0;
+    }
+    (void) osal_mutex_unlock(s->lock);
+#else
+    (void) session;
+    (void) handle;
+#endif
+
+    return ret;
+}
+
+int oc_mqtt_session_walk(void *session, fn_oc_mqtt_session_walk walker, void *ctx)
+{
+    int ret = 0;
+#if CN_SESSION_FLASH
+    oc_mqtt_session_t *s = session;
+    session_entry_t *pubs[CONFIG_OC_MQTT_SESSION_ENTRIES];
+    session_head_t head;
+    oc_mqtt_session_msg_t msg;
+    int n;
+    int i;
+
+    if((NULL == s) || (NULL == walker))
+    {
+        return ret;
+    }
+
+    (void) osal_mutex_lock(s->lock);
+    n = session_pubs(s, pubs);
+    for(i = 0; i < n; i++)
+    {
+        if((session_flash_read(s, s->bank, pubs[i]->off, &head) < 0) || (head.topiclen < 1))
+        {
+            continue;
+        }
+        msg.handle = pubs[i]->handle;
+        msg.id = pubs[i]->id;
+        msg.qos = pubs[i]->qos;
+        msg.topic = (char *)s->scratch + CN_SESSION_HEADLEN;
+        msg.topic[head.topiclen - 1] = '\0';
+        msg.msg = s->scratch + CN_SESSION_HEADLEN + head.topiclen;
+        msg.len = head.msglen;
+        walker(ctx, &msg);
+        ret++;
+    }
+    (void) osal_mutex_unlock(s->lock);
+#else
+    (void) session;
+    (void) walker;
+    (void) ctx;
+#endif
+
+    return ret;
+}
+
+int oc_mqtt_session_delete(void *session)
+{
+    oc_mqtt_session_t *s = session;
+    int i;
+
+    if(NULL == s)
+    {
+        return -1;
+    }
+    for(i = 0; i < CONFIG_OC_MQTT_SESSION_ENTRIES; i++)
+    {
+        session_release(&s->entry[i]);
+    }
+    (void) osal_mutex_del(s->lock);
+    osal_free(s);
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 21:40   The first version
+ *
+ */
+#ifndef LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_TINY_OC_MQTT_SESSION_H_
+#define LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_TINY_OC_MQTT_SESSION_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * the session keeps what the server keeps for the connection without the clean session, so the
+ * reconnect(and the reboot) resumes it instead of subscribing and publishing all over again:
+ *
+ * 1, the subscriptions granted by the server, which are not subscribed again when the server says
+ *    the session is present, and are forgotten when it says not
+ * 2, the unacked qos1/2 publishes with their packet ids, which are resent after the connect until
+ *    acked; only kept when there is a flash partition configured
+ * 3, the flash log is two sectors used in turn, each change appends a small record and the live
+ *    entries are copied to the other sector when one is full(and after the reboot); the first
+ *    record of the sector is programmed last, so a torn copy is never taken
+ *
+ * */
+
+#ifndef CONFIG_OC_MQTT_SESSION_ENABLE
+#define CONFIG_OC_MQTT_SESSION_ENABLE         0
+#endif
+
+#ifndef CONFIG_OC_MQTT_SESSION_PARTITION
+#define CONFIG_OC_MQTT_SESSION_PARTITION      -1       ///< the storage partition for the log, -1 means RAM only
+#endif
+
+#ifndef CONFIG_OC_MQTT_SESSION_SECTOR
+#define CONFIG_OC_MQTT_SESSION_SECTOR         2048     ///< the erase unit, the log takes two from the partition start
+#endif
+
+#ifndef CONFIG_OC_MQTT_SESSION_ENTRIES
+#define CONFIG_OC_MQTT_SESSION_ENTRIES        16       ///< how many subscriptions and unacked publishes kept
+#endif
+
+#ifndef CONFIG_OC_MQTT_SESSION_RECORDSIZE
+#define CONFIG_OC_MQTT_SESSION_RECORDSIZE     512      ///< the largest publish(topic and message) kept
+#endif
+
+typedef struct
+{
+    uint32_t  handle;    ///< returned by the oc_mqtt_session_pub
+    uint16_t  id;        ///< the packet id, 0 means not bound yet
+    int       qos;
+    char     *topic;
+    uint8_t  *msg;
+    int       len;
+}oc_mqtt_session_msg_t;
+
+typedef void (*fn_oc_mqtt_session_walk)(void *ctx, oc_mqtt_session_msg_t *msg);
+
+/**
+ * @brief:use this function to create the session, the flash log is recovered if configured
+ *
+ * @return:the session handle, while NULL failed
+ * */
+void *oc_mqtt_session_create(void);
+
+/**
+ * @brief:use this function to keep the subscription granted by the server
+ *
+ * @param[in]:session, the session handle
+ * @param[in]:topic, the topic filter
+ * @param[in]:qos, the granted qos
+ *
+ * @return:0 success while -1 failed(no entry left)
+ * */
+int oc_mqtt_session_sub(void *session, const char *topic, int qos);
+
+/**
+ * @brief:use this function to forget the subscription
+ *
+ * @return:0 success while -1 failed(not kept)
+ * */
+int oc_mqtt_session_unsub(void *session, const char *topic);
+
+/**
+ * @brief:use this function to know if the subscription is kept
+ *
+ * @return:the granted qos while -1 means not kept
+ * */
+int oc_mqtt_session_find(void *session, const char *topic);
+
+/**
+ * @brief:use this function to forget all the subscriptions, when the server has lost the session
+ *
+ * @return:0 success while -1 failed
+ * */
+int oc_mqtt_session_clear(void *session);
+
+/**
+ * @brief:use this function to keep the qos1/2 publish before it is sent
+ *
+ * @param[in]:session, the session handle
+ * @param[in]:topic, the topic
+ * @param[in]:msg, the message
+ * @param[in]:len, the message length
+ * @param[in]:qos, the mqtt qos
+ * @param[out]:handle, used to bind and ack it, never 0
+ *
+ * @return:0 success while -1 failed(no flash log, no entry left or too large)
+ * */
+int oc_mqtt_session_pub(void *session, const char *topic, const uint8_t *msg, int len, int qos, uint32_t *handle);
+
+/**
+ * @brief:use this function to keep the packet id given by the mqtt engine
+ *
+ * @return:0 success while -1 failed(acked already)
+ * */
+int oc_mqtt_session_bind(void *session, uint32_t handle, uint16_t id);
+
+/**
+ * @brief:use this function to forget the publish acked by the server
+ *
+ * @return:0 success while -1 failed(not kept)
+ * */
+int oc_mqtt_session_ack(void *session, uint32_t handle);
+
+/**
+ * @brief:use this function to visit the unacked publishes in the publish order
+ *
+ * @param[in]:session, the session handle
+ * @param[in]:walker, called with the session locked, the msg is valid only in it
+ * @param[in]:ctx, passed to the walker
+ *
+ * @return:how many publishes visited
+ * */
+int oc_mqtt_session_walk(void *session, fn_oc_mqtt_session_walk walker, void *ctx);
+
+/**
+ * @brief:use this function to delete the session, the flash log is kept
+ *
+ * @return:0 success while -1 failed
+ * */
+int oc_mqtt_session_delete(void *session);
+
+#endif /* LITEOS_LAB_IOT_LINK_OC_OC_MQTT_OC_MQTT_TINY_OC_MQTT_SESSION_H_ */
@@ -55,8 +55,11 @@
 #include <oc_mqtt_al.h>
 #include <sal.h>
 
-#include <cJSON.h>           //json mode
+#include <link_json.h>       //json mode
+#include <link_topic.h>      //the user subscriptions
 #include "hmac.h"            //used to generate the user pwd
+#include "oc_mqtt_outbox.h"  //queue the publishes while offline
+#include "oc_mqtt_session.h" //resume the session over the reconnect and the reboot
 
 ////CRT FOR THE OC
 static const char s_oc_mqtt_ca_crt[] =
@@ -104,6 +107,32 @@ static const char s_oc_mqtt_ca_crt[] =
 #define CN_OC_MQTT_LIFELEAST           (30)
 #define CN_OC_MQTT_LIFEMAX             (1200)
 
+#ifndef CONFIG_OC_MQTT_CMD_POOLSIZE
+#define CONFIG_OC_MQTT_CMD_POOLSIZE    4        ///< the api callers could post the command at the same time
+#endif
+
+#define CN_OC_MQTT_OUTBOX_RETRY        3        ///< the queued message failed so many times while connected is dropped
+
+#ifndef CONFIG_OC_MQTT_PROTOCOL_5
+#define CONFIG_OC_MQTT_PROTOCOL_5      0        ///< 1 connects with mqtt 5, the repeated topics are sent as aliases
+#endif
+
+#ifndef CONFIG_OC_MQTT_PAYLOAD_FORMAT
+#define CONFIG_OC_MQTT_PAYLOAD_FORMAT  0        ///< mqtt 5 only:1 marks the publishes as utf-8 while 0 unspecified
+#endif
+
+#ifndef CONFIG_OC_MQTT_CONTENT_TYPE
+#define CONFIG_OC_MQTT_CONTENT_TYPE    ""       ///< mqtt 5 only:the content type of the publishes, "" sends none
+#endif
+
+#ifndef CONFIG_OC_MQTT_ASYNC_RINGSIZE
+#define CONFIG_OC_MQTT_ASYNC_RINGSIZE  1024     ///< the async publishes are copied here, 0 means publish in the caller
+#endif
+
+#ifndef CONFIG_OC_MQTT_ASYNC_BURST
+#define CONFIG_OC_MQTT_ASYNC_BURST     8        ///< how many async publishes done in each daemon loop
+#endif
+
 const char *s_new_topic_fmt[]=
 {
     "$oc/devices/%s/sys/messages/down",
@@ -148,10 +177,11 @@ typedef enum
 
 typedef struct
 {
-    void  *nxt;
-    char  *topic;
-    int    qos;
-}tiny_topic_sub_t;
+    char                *topic;
+    int                  qos;
+    fn_oc_mqtt_msg_deal  dealer;   ///< NULL means the config msg_deal
+    void                *arg;      ///< passed to the dealer
+}tiny_topic_sub_t;                 ///< the user subscription, kept in the topic trie
 
 
 typedef struct
@@ -174,9 +204,19 @@ typedef struct
     oc_bs_mqtt_cb_t     bs_cb;
     void               *task_daemon;                ///< oc mqtt lite daemon task
     queue_t            *task_daemon_cmd_queue;      ///< oc mqtt lite daemon task command queue
+    void               *daemon_cmd_pool;            ///< the daemon command object pool
     char                salt_time[16];              ///< salt time for the connect
     char               *hub_sub_topic[CN_NEW_TOPIC_NUM];
-    tiny_topic_sub_t   *subscribe_lst;
+    void               *subscribe_trie;             ///< the user subscriptions indexed by the topic filter
+    void               *outbox;                     ///< the publishes queued while offline, NULL if not enabled
+    osal_loop_timer_t   drain_timer;                ///< when to send the next burst of the queued messages
+    int                 drain_fails;                ///< how many times the queued message failed in a row
+    ring_buffer_t       async_ring;                 ///< the async publishes waiting for the daemon
+    uint8_t            *async_mem;                  ///< the ring memory and the scratch behind it
+    osal_mutex_t        async_lock;                 ///< the ring is written by the api callers
+    int                 async_kick;                 ///< the daemon has been woken up for the ring
+    void               *session;                    ///< the session kept for the reconnect, NULL if not enabled
+    int                 session_present;            ///< the server resumed the session at the last connect
 }oc_mqtt_tiny_cb_t;   ///< i think we may only got one mqtt
 static oc_mqtt_tiny_cb_t *s_oc_mqtt_tiny_cb;
 
@@ -200,6 +240,31 @@ typedef struct
     int                     retcode;   ///< this is the operation code for the command
 }oc_mqtt_daemon_cmd_t;                 ///< use this to do the command for the api
 
+///< only wakes up the daemon for the async ring, nobody waits for it
+static oc_mqtt_daemon_cmd_t s_oc_mqtt_async_cmd = {.cmd = en_oc_mqtt_daemon_cmd_send};
+
+typedef struct
+{
+    fn_oc_mqtt_pubdone      done;
+    void                   *arg;
+    int                     qos;
+    int                     topiclen;  ///< including the '\0', 0 means the default topic
+    int                     msglen;
+}tiny_async_head_t;                    ///< the async publish record head in the ring, then the topic and the message
+
+typedef struct
+{
+    fn_oc_mqtt_pubdone      done;
+    void                   *arg;
+    uint32_t                handle;    ///< the session handle, 0 means not kept in the session
+}tiny_async_done_t;                    ///< the async publish waiting for the ack in the mqtt window
+
+typedef struct
+{
+    mqtt_al_pubpara_t      *para;
+    int                     num;
+}tiny_resume_t;                        ///< the unacked publishes of the session taken by the connect
+
 
 ///< here we implement the hub and bootstrap server command dealer
 ///< the bs not debug yet
@@ -214,46 +279,53 @@ static void hub_msg_default_deal(void *arg,mqtt_al_msgrcv_t  *msg)
     return;
 }
 
+///< the user subscription messages, the arg is the tiny_topic_sub_t
+static void hub_msg_sub_deal(void *arg,mqtt_al_msgrcv_t  *msg)
+{
+    tiny_topic_sub_t *topic_sub = arg;
+
+    if((NULL != topic_sub) && (NULL != topic_sub->dealer) && (NULL != msg))
+    {
+        (void) topic_sub->dealer(topic_sub->arg,msg);
+    }
+    else
+    {
+        hub_msg_default_deal(arg,msg);
+    }
+    return;
+}
+
 ///< deal the bootstrap server messages
 static void bs_msg_default_deal(void *arg,mqtt_al_msgrcv_t *msg)
 {
-   cJSON  *root = NULL;
-   cJSON  *addr_item = NULL;
+   json_value_t addr_item;
+   int     addr_len;
    char   *port = NULL;
    char   *server = NULL;
 
-   char   *json_buf;
-
    LINK_LOG_DEBUG("bs topic:%s qos:%d",msg->topic.data,(int)msg->qos);
+   LINK_LOG_DEBUG("msg:%.*s",msg->msg.len,msg->msg.data);
 
-   json_buf = osal_malloc(msg->msg.len + 1);
-   if(NULL == json_buf)
+   ///< pick the address from the message in place, only the address itself is copied
+   if(0 == json_get(msg->msg.data,msg->msg.len,"address",&addr_item))
    {
-       return;
-   }
-
-   (void) memcpy(json_buf,msg->msg.data,msg->msg.len);
-   json_buf[msg->msg.len] = '\0';
-
-   LINK_LOG_DEBUG("msg:%s",json_buf);
-   root = cJSON_Parse(json_buf);
-   if(NULL != root)
-   {
-       addr_item = cJSON_GetObjectItem(root,"address");
-       if(NULL != addr_item)
+       addr_len = json_value_string(&addr_item,NULL,0);
+       server = (addr_len < 0) ? NULL : osal_malloc(addr_len + 1);
+       if(NULL != server)
        {
-           LINK_LOG_DEBUG("address:%s", addr_item->valuestring);
-           port = strrchr(addr_item->valuestring, ':');
+           (void) json_value_string(&addr_item,server,addr_len + 1);
+           LINK_LOG_DEBUG("address:%s", server);
+           port = strrchr(server, ':');
            if(NULL != port)
            {
-               server = addr_item->valuestring;
                *port = '\0';
                port++;
                osal_free(s_oc_mqtt_tiny_cb->bs_cb.hubserver_addr);
                osal_free(s_oc_mqtt_tiny_cb->bs_cb.hubserver_port);
 
-               s_oc_mqtt_tiny_cb->bs_cb.hubserver_addr = osal_strdup(server);
+               s_oc_mqtt_tiny_cb->bs_cb.hubserver_addr = server;
                s_oc_mqtt_tiny_cb->bs_cb.hubserver_port = osal_strdup(port);
+               server = NULL;
 
                if((NULL != s_oc_mqtt_tiny_cb->bs_cb.hubserver_addr) && \
                        (NULL != s_oc_mqtt_tiny_cb->bs_cb.hubserver_port))
@@ -262,10 +334,9 @@ static void bs_msg_default_deal(void *arg,mqtt_al_msgrcv_t *msg)
                }
 
            }
+           osal_free(server);
        }
-       cJSON_Delete(root);
    }
-   osal_free(json_buf);
    ///<any way, we still pass this message to the client and let the client known this message
    if ((msg != NULL) && ( msg->msg.data != NULL) &&(msg->msg.len > 0 ) \
        &&(NULL != s_oc_mqtt_tiny_cb->config.msg_deal))
@@ -324,7 +395,7 @@ static int daemon_cmd_post(en_oc_mqtt_daemon_cmd cmd, void *arg)
     int ret = (int)en_oc_mqtt_err_system;
     oc_mqtt_daemon_cmd_t *daemon_cmd;
 
-    daemon_cmd = osal_malloc(sizeof(oc_mqtt_daemon_cmd_t));
+    daemon_cmd = osal_pool_alloc(s_oc_mqtt_tiny_cb->daemon_cmd_pool);
     if(NULL != daemon_cmd)
     {
         daemon_cmd->cmd = cmd;
@@ -339,19 +410,22 @@ static int daemon_cmd_post(en_oc_mqtt_daemon_cmd cmd, void *arg)
             }
             (void) osal_semp_del(daemon_cmd->signal);
         }
-        osal_free(daemon_cmd);
+        osal_pool_free(s_oc_mqtt_tiny_cb->daemon_cmd_pool,daemon_cmd);
     }
 
     return ret;
 }
 
 
+///< release the subscription when walking the trie
+static void subscribe_release(void *ctx, void *handler, void *arg)
+{
+    osal_free(arg);
+}
+
 ///< release the config parameters
 static int config_parameter_release(oc_mqtt_tiny_cb_t *cb)
 {
-    tiny_topic_sub_t  *sub_topic;
-    tiny_topic_sub_t  *sub_topic_nxt;
-
     if( NULL != cb->config_mem )
     {
         osal_free(cb->config_mem);
@@ -383,16 +457,9 @@ static int config_parameter_release(oc_mqtt_tiny_cb_t *cb)
 
     cb->flag.bits.bit_daemon_status = en_daemon_status_idle;
 
-    sub_topic = cb->subscribe_lst;
-    cb->subscribe_lst = NULL;
-
-    while( NULL != sub_topic)
-    {
-        sub_topic_nxt = sub_topic->nxt;
-        osal_free ( sub_topic );
-
-        sub_topic = sub_topic_nxt;
-    }
+    (void) topic_trie_walk(cb->subscribe_trie,subscribe_release,NULL);
+    (void) topic_trie_delete(cb->subscribe_trie);
+    cb->subscribe_trie = NULL;
 
     return (int)en_oc_mqtt_err_ok;
 }
@@ -666,13 +733,85 @@ EXIT_MEM:
 
 
 ///< return the reason code defined by the mqtt_al.h
+///< called by the mqtt engine when the publish kept in the session is acked or aborted, the arg is the handle
+static void hub_session_done(void *arg, int ret)
+{
+    if((0 == ret) && (NULL != s_oc_mqtt_tiny_cb))
+    {
+        (void) oc_mqtt_session_ack(s_oc_mqtt_tiny_cb->session, (uint32_t)(uintptr_t)arg);
+    }
+
+    return;
+}
+
+///< the mqtt 5 properties of the publishes, ignored by the engine for the 3.1.1
+static void dmp_pub_props(mqtt_al_pubpara_t *para)
+{
+    para->payloadformat = CONFIG_OC_MQTT_PAYLOAD_FORMAT;
+    para->contenttype.data = CONFIG_OC_MQTT_CONTENT_TYPE;
+    para->contenttype.len = sizeof(CONFIG_OC_MQTT_CONTENT_TYPE) - 1;
+}
+
+///< copy the unacked publish of the session for the connect, the engine keeps its own copy
+static void dmp_resume_copy(void *ctx, oc_mqtt_session_msg_t *msg)
+{
+    tiny_resume_t *resume = ctx;
+    mqtt_al_pubpara_t *para;
+    int topiclen;
+
+    if(resume->num >= CONFIG_OC_MQTT_SESSION_ENTRIES)
+    {
+        return;
+    }
+    para = &resume->para[resume->num];
+    (void) memset(para,0,sizeof(mqtt_al_pubpara_t));
+    topiclen = strlen(msg->topic);
+    para->topic.data = osal_malloc(topiclen + 1 + msg->len);
+    if(NULL == para->topic.data)
+    {
+        return;
+    }
+    (void) memcpy(para->topic.data, msg->topic, topiclen + 1);
+    para->topic.len = topiclen;
+    para->msg.data = para->topic.data + topiclen + 1;
+    (void) memcpy(para->msg.data, msg->msg, msg->len);
+    para->msg.len = msg->len;
+    para->qos = (en_mqtt_al_qos_t)msg->qos;
+    para->id = msg->id;
+    dmp_pub_props(para);
+    para->done = hub_session_done;
+    para->done_arg = (void *)(uintptr_t)msg->handle;
+    resume->num++;
+}
+
+///< keep the ids the engine sent them with after a successful connect, and free the copies; the
+///< failed connect sent nothing, so the ids kept before stay
+static void dmp_resume_release(oc_mqtt_tiny_cb_t *cb, tiny_resume_t *resume, int connected)
+{
+    int i;
+
+    for(i = 0; i < resume->num; i++)
+    {
+        if(connected && (0 != resume->para[i].id))
+        {
+            (void) oc_mqtt_session_bind(cb->session, (uint32_t)(uintptr_t)resume->para[i].done_arg, resume->para[i].id);
+        }
+        osal_free(resume->para[i].topic.data);
+    }
+    osal_free(resume->para);
+    resume->para = NULL;
+    resume->num = 0;
+}
+
 static int dmp_connect(oc_mqtt_tiny_cb_t *cb)
 {
     int  ret = (int)en_oc_mqtt_err_system;
 
     mqtt_al_conpara_t conpara;
+    tiny_resume_t     resume;
 
     (void) memset(&conpara,0,sizeof(conpara));
+    (void) memset(&resume,0,sizeof(resume));
 
     conpara.clientid.data = cb->mqtt_para.mqtt_clientid;
     conpara.clientid.len = strlen(conpara.clientid.data);
@@ -687,23 +826,48 @@ static int dmp_connect(oc_mqtt_tiny_cb_t *cb)
     }
 
     conpara.cleansession = 1;
+    if((NULL != cb->session) && (cb->flag.bits.bit_daemon_status != (int)en_daemon_status_bs_getaddr))
+    {
+        ///< the server keeps the subscriptions and the unacked publishes, which are resent after the connack
+        conpara.cleansession = 0;
+        resume.para = osal_malloc(CONFIG_OC_MQTT_SESSION_ENTRIES * sizeof(mqtt_al_pubpara_t));
+        if(NULL != resume.para)
+        {
+            (void) oc_mqtt_session_walk(cb->session, dmp_resume_copy, &resume);
+        }
+        conpara.resume = resume.para;
+        conpara.resume_num = resume.num;
+    }
     conpara.keepalivetime = cb->config.lifetime;
     conpara.security = &cb->config.security;
     conpara.serveraddr.data = (char *)cb->mqtt_para.server_addr;
     conpara.serveraddr.len = strlen(conpara.serveraddr.data);
     conpara.serverport = atoi(cb->mqtt_para.server_port);
     conpara.timeout = CN_OC_MQTT_TIMEOUT;
-    conpara.version = en_mqtt_al_version_3_1_1;
+    conpara.version = (CONFIG_OC_MQTT_PROTOCOL_5) ? en_mqtt_al_version_5 : en_mqtt_al_version_3_1_1;
     conpara.willmsg = NULL;
 
     LINK_LOG_DEBUG("oc_mqtt_connect:server:%s port:%s",cb->mqtt_para.server_addr,cb->mqtt_para.server_port);
     LINK_LOG_DEBUG("oc_mqtt_connect:client_id:%s",cb->mqtt_para.mqtt_clientid);
     LINK_LOG_DEBUG("oc_mqtt_connect:user:%s passwd:%s",cb->mqtt_para.mqtt_user,(cb->mqtt_para.mqtt_passwd==NULL)?"NULL":cb->mqtt_para.mqtt_passwd);
     cb->mqtt_para.mqtt_handle = mqtt_al_connect(&conpara);
+    if(NULL != resume.para)
+    {
+        dmp_resume_release(cb, &resume, NULL != cb->mqtt_para.mqtt_handle);
+    }
+    cb->session_present = 0;
 
     if(NULL != cb->mqtt_para.mqtt_handle)
     {
         ret = (int)en_oc_mqtt_err_ok;
+        if(0 == conpara.cleansession)
+        {
+            cb->session_present = conpara.sessionpresent;
+            if(0 == cb->session_present)
+            {
+                (void) oc_mqtt_session_clear(cb->session);   ///< the server has lost them, subscribe again
+            }
+        }
     }
     else
     {
@@ -735,6 +899,59 @@ static int dmp_connect(oc_mqtt_tiny_cb_t *cb)
 
 }
 
+///< subscribe the topic, only the dealer is installed when the server has kept it in the session
+static int dmp_subscribe_topic(oc_mqtt_tiny_cb_t *cb, mqtt_al_subpara_t *subpara)
+{
+    int ret;
+
+    subpara->local = (cb->session_present && \
+                     ((int)subpara->qos == oc_mqtt_session_find(cb->session, subpara->topic.data))) ? 1 : 0;
+    ret = mqtt_al_subscribe(cb->mqtt_para.mqtt_handle, subpara);
+    if((0 == ret) && (0 == subpara->local) && (cb->flag.bits.bit_daemon_status != (int)en_daemon_status_bs_getaddr))
+    {
+        (void) oc_mqtt_session_sub(cb->session, subpara->topic.data, (int)subpara->qos);
+    }
+
+    return ret;
+}
+
+typedef struct
+{
+    oc_mqtt_tiny_cb_t  *cb;
+    int                 ret;   ///< the first failure
+}tiny_resubscribe_t;
+
+///< subscribe the user topic when walking the trie
+static void dmp_resubscribe(void *ctx, void *handler, void *arg)
+{
+    tiny_resubscribe_t *resub = ctx;
+    tiny_topic_sub_t   *topic_sub = arg;
+    mqtt_al_subpara_t   subpara;
+    int                 ret;
+
+    if(0 != resub->ret)
+    {
+        return;
+    }
+    (void) memset(&subpara,0,sizeof(subpara));
+    subpara.dealer = hub_msg_sub_deal;
+    subpara.arg = topic_sub;
+    subpara.qos = (en_mqtt_al_qos_t)topic_sub->qos;
+    subpara.topic.data = topic_sub->topic ;
+    subpara.topic.len = strlen(subpara.topic.data );
+    subpara.timeout = CN_OC_MQTT_TIMEOUT;
+
+    LINK_LOG_DEBUG("oc_mqtt_subscribe:topic:%s",subpara.topic.data);
+
+    ret = dmp_subscribe_topic(resub->cb,&subpara);
+
+    LINK_LOG_DEBUG("oc_mqtt_subscribe:retcode:%d:%s\n\r",ret,oc_mqtt_err(ret));
+    if(0 != ret)
+    {
+         resub->ret = (int)en_oc_mqtt_err_subscribe;
+    }
+}
+
 static int dmp_subscribe(oc_mqtt_tiny_cb_t *cb)
 {
     int  ret = (int)en_oc_mqtt_err_system;
@@ -767,7 +984,7 @@ static int dmp_subscribe(oc_mqtt_tiny_cb_t *cb)
 
     LINK_LOG_DEBUG("oc_mqtt_default_subscribe:topic:%s",subpara.topic.data);
 
-    ret = mqtt_al_subscribe(cb->mqtt_para.mqtt_handle,&subpara);
+    ret = dmp_subscribe_topic(cb,&subpara);
     if(0 != ret)
     {
         ret = (int)en_oc_mqtt_err_subscribe;
@@ -789,7 +1006,7 @@ static int dmp_subscribe(oc_mqtt_tiny_cb_t *cb)
 
             LINK_LOG_DEBUG("oc_mqtt_subscribe:topic:%s",subpara.topic.data);
 
-            ret = mqtt_al_subscribe(cb->mqtt_para.mqtt_handle,&subpara);
+            ret = dmp_subscribe_topic(cb,&subpara);
 
             LINK_LOG_DEBUG("oc_mqtt_subscribe:retcode:%d:%s",ret,oc_mqtt_err(ret));
             if(0 != ret)
@@ -800,27 +1017,12 @@ static int dmp_subscribe(oc_mqtt_tiny_cb_t *cb)
         }
 
         ///< subscribe the user topic
-        tiny_topic_sub_t  *topic_sub;
-        topic_sub = cb->subscribe_lst;
-        while(NULL != topic_sub)
+        tiny_resubscribe_t resub;
+        resub.cb = cb;
+        resub.ret = 0;
+        if(topic_trie_walk(cb->subscribe_trie,dmp_resubscribe,&resub) > 0)
         {
-            subpara.arg = cb;
-            subpara.qos = en_mqtt_al_qos_1;
-            subpara.topic.data = topic_sub->topic ;
-            subpara.topic.len = strlen(subpara.topic.data );
-            subpara.timeout = CN_OC_MQTT_TIMEOUT;
-
-            LINK_LOG_DEBUG("oc_mqtt_subscribe:topic:%s",subpara.topic.data);
-
-            ret = mqtt_al_subscribe(cb->mqtt_para.mqtt_handle,&subpara);
-
-            LINK_LOG_DEBUG("oc_mqtt_subscribe:retcode:%d:%s\n\r",ret,oc_mqtt_err(ret));
-            if(0 != ret)
-            {
-                 ret = (int)en_oc_mqtt_err_subscribe;
-                 break;
-            }
-            topic_sub = topic_sub->nxt;
+            ret = resub.ret;
         }
     }
 
@@ -848,6 +1050,7 @@ static int dmp_publish(oc_mqtt_tiny_cb_t *cb,char *topic, uint8_t *msg, int len,
     pubpara.topic.len =strlen(pubpara.topic.data );
     pubpara.msg.data = (char *)msg;
     pubpara.msg.len = len;
+    dmp_pub_props(&pubpara);
     ret = mqtt_al_publish(cb->mqtt_para.mqtt_handle, &pubpara);
     if(ret != 0)
     {
@@ -855,6 +1058,209 @@ static int dmp_publish(oc_mqtt_tiny_cb_t *cb,char *topic, uint8_t *msg, int len,
     }
     return ret;
 }
+///< publish the api message, or queue it to the outbox when it could not be sent now
+static int hub_publish(oc_mqtt_tiny_cb_t *cb, mqtt_al_pubpara_t *pubpara)
+{
+    int ret = (int)en_oc_mqtt_err_noconected;
+    int qos = (int)pubpara->qos;    ///< may be or-ed with cn_oc_mqtt_qos_alarm
+
+    ///< never overtake the queued messages of the same lane
+    if(((int)en_daemon_status_hub_keep == cb->flag.bits.bit_daemon_status) &&\
+       (en_mqtt_al_connect_ok == mqtt_al_check_status(cb->mqtt_para.mqtt_handle)) &&\
+       (0 == oc_mqtt_outbox_count(cb->outbox, qos)))
+    {
+        ret = dmp_publish(cb, pubpara->topic.data,(uint8_t *)pubpara->msg.data,\
+                          pubpara->msg.len, qos & cn_oc_mqtt_qos_mask);
+    }
+
+    if((ret != (int)en_oc_mqtt_err_ok) && (NULL != cb->outbox) && \
+       (0 == oc_mqtt_outbox_put(cb->outbox, pubpara->topic.data, (uint8_t *)pubpara->msg.data,\
+                                pubpara->msg.len, qos)))
+    {
+        ret = (int)en_oc_mqtt_err_ok;
+    }
+
+    return ret;
+}
+
+///< send the queued messages, at most CONFIG_OC_MQTT_OUTBOX_DRAIN_BURST in each interval
+static void hub_drain(oc_mqtt_tiny_cb_t *cb)
+{
+    oc_mqtt_outbox_msg_t msg;
+    int i;
+
+    if((NULL == cb->outbox) || (0 == osal_loop_timer_expired(&cb->drain_timer)) || \
+       ((int)en_daemon_status_hub_keep != cb->flag.bits.bit_daemon_status) || \
+       (en_mqtt_al_connect_ok != mqtt_al_check_status(cb->mqtt_para.mqtt_handle)))
+    {
+        return;
+    }
+
+    for(i = 0; (i < CONFIG_OC_MQTT_OUTBOX_DRAIN_BURST) && (0 == oc_mqtt_outbox_peek(cb->outbox, &msg)); i++)
+    {
+        ///< the qos1 publish returns ok only when the puback received, so pop it then
+        if((int)en_oc_mqtt_err_ok == dmp_publish(cb, msg.topic, msg.msg, msg.len, msg.qos))
+        {
+            cb->drain_fails = 0;
+            (void) oc_mqtt_outbox_pop(cb->outbox);
+        }
+        else
+        {
+            if((en_mqtt_al_connect_ok == mqtt_al_check_status(cb->mqtt_para.mqtt_handle)) && \
+               (++cb->drain_fails >= CN_OC_MQTT_OUTBOX_RETRY))
+            {
+                LINK_LOG_DEBUG("outbox:drop the message failed %d times", cb->drain_fails);
+                cb->drain_fails = 0;
+                (void) oc_mqtt_outbox_pop(cb->outbox);
+            }
+            break;
+        }
+    }
+    osal_loop_timer_count_downms(&cb->drain_timer, CONFIG_OC_MQTT_OUTBOX_DRAIN_INTERVAL);
+
+    return;
+}
+
+///< called by the mqtt engine when the windowed publish is acked or aborted
+static void hub_async_done(void *arg, int ret)
+{
+    tiny_async_done_t *ctx = arg;
+
+    if(NULL != ctx)
+    {
+        if(0 != ctx->handle)
+        {
+            hub_session_done((void *)(uintptr_t)ctx->handle, ret);
+        }
+        if(NULL != ctx->done)
+        {
+            ctx->done(ctx->arg, (0 == ret) ? (int)en_oc_mqtt_err_ok : (int)en_oc_mqtt_err_publish);
+        }
+        osal_free(ctx);
+    }
+
+    return;
+}
+
+///< publish the qos1/2 async message without waiting for the ack, so several could be on the way;
+///< return 0 when the engine has taken it, and the done will be called by the engine
+static int hub_async_window(oc_mqtt_tiny_cb_t *cb, mqtt_al_pubpara_t *pubpara, tiny_async_head_t *head)
+{
+    mqtt_al_pubpara_t para;
+    tiny_async_done_t *ctx = NULL;
+    uint32_t handle;
+    int qos = head->qos & cn_oc_mqtt_qos_mask;
+
+    ///< the same condition as the hub_publish, never overtake the queued messages of the same lane
+    if((0 == qos) || ((int)en_daemon_status_hub_keep != cb->flag.bits.bit_daemon_status) || \
+       (en_mqtt_al_connect_ok != mqtt_al_check_status(cb->mqtt_para.mqtt_handle)) || \
+       (0 != oc_mqtt_outbox_count(cb->outbox, head->qos)))
+    {
+        return -1;
+    }
+    if((NULL != head->done) || (NULL != cb->session))
+    {
+        ctx = osal_malloc(sizeof(tiny_async_done_t));
+        if(NULL == ctx)
+        {
+            return -1;
+        }
+        ctx->done = head->done;
+        ctx->arg = head->arg;
+        ctx->handle = 0;
+    }
+
+    para = *pubpara;
+    para.qos = (en_mqtt_al_qos_t)qos;
+    if(NULL == para.topic.data)
+    {
+        para.topic.data = cb->mqtt_para.default_pub_topic;
+    }
+    para.topic.len = strlen(para.topic.data);
+    para.done = hub_async_done;
+    para.done_arg = ctx;
+    dmp_pub_props(&para);
+
+    ///< kept in the session before sent, so it is resent after the reboot until acked
+    if((NULL != ctx) && (0 != oc_mqtt_session_pub(cb->session, para.topic.data, (uint8_t *)para.msg.data,\
+                                                  para.msg.len, qos, &ctx->handle)))
+    {
+        ctx->handle = 0;
+    }
+    handle = (NULL == ctx) ? 0 : ctx->handle;    ///< the ctx may be freed by the done before the publish returns
+    if(0 != mqtt_al_publish(cb->mqtt_para.mqtt_handle, &para))
+    {
+        (void) oc_mqtt_session_ack(cb->session, handle);   ///< not taken, forget it
+        osal_free(ctx);
+        return -1;
+    }
+    if(0 != handle)
+    {
+        (void) oc_mqtt_session_bind(cb->session, handle, para.id);
+    }
+
+    return 0;
+}
+
+///< publish the async messages, the ring is only locked to copy the record out
+static void hub_async(oc_mqtt_tiny_cb_t *cb)
+{
+    tiny_async_head_t head;
+    mqtt_al_pubpara_t pubpara;
+    uint8_t *scratch;
+    int ret;
+    int i;
+
+    if(NULL == cb->async_mem)
+    {
+        return;
+    }
+    scratch = cb->async_mem + CONFIG_OC_MQTT_ASYNC_RINGSIZE;
+
+    for(i = 0; i < CONFIG_OC_MQTT_ASYNC_BURST; i++)
+    {
+        (void) osal_mutex_lock(cb->async_lock);
+        if(ring_buffer_datalen(&cb->async_ring) <= 0)
+        {
+            cb->async_kick = 0;
+            (void) osal_mutex_unlock(cb->async_lock);
+            break;
+        }
+        (void) ring_buffer_read(&cb->async_ring, (unsigned char *)&head, sizeof(head));
+        if((head.topiclen + head.msglen) > 0)
+        {
+            (void) ring_buffer_read(&cb->async_ring, scratch, head.topiclen + head.msglen);
+        }
+        (void) osal_mutex_unlock(cb->async_lock);
+
+        (void) memset(&pubpara, 0, sizeof(pubpara));
+        pubpara.qos = (en_mqtt_al_qos_t)head.qos;
+        pubpara.timeout = 1000;
+        pubpara.topic.data = (head.topiclen > 0) ? (char *)scratch : NULL;
+        pubpara.msg.data = (char *)scratch + head.topiclen;
+        pubpara.msg.len = head.msglen;
+
+        if((int)en_daemon_status_idle == cb->flag.bits.bit_daemon_status)
+        {
+            ret = (int)en_oc_mqtt_err_noconfigured;    ///< deconfigured after it was accepted
+        }
+        else if(0 == hub_async_window(cb, &pubpara, &head))
+        {
+            continue;                                  ///< the engine calls the done when acked
+        }
+        else
+        {
+            ret = hub_publish(cb, &pubpara);
+        }
+        if(NULL != head.done)
+        {
+            head.done(head.arg, ret);
+        }
+    }
+
+    return;
+}
+
 static int hub_step(oc_mqtt_tiny_cb_t  *cb)
 {
     int ret = (int)en_oc_mqtt_err_system;
@@ -957,10 +1363,12 @@ static int deal_api_subscribe( oc_mqtt_tiny_cb_t  *cb, oc_mqtt_daemon_cmd_t *cmd
 {
     int ret = (int)en_oc_mqtt_err_noconfigured;
     tiny_topic_sub_t  *topic_sub;
+    tiny_topic_sub_t  *sub_req;
     mqtt_al_subpara_t *subpara;
     mqtt_al_subpara_t  sub_new;
 
     subpara = cmd->arg;
+    sub_req = subpara->arg;
     if((int)en_daemon_status_idle == cb->flag.bits.bit_daemon_status)
     {
         ret = (int)en_oc_mqtt_err_noconfigured;
@@ -969,17 +1377,16 @@ static int deal_api_subscribe( oc_mqtt_tiny_cb_t  *cb, oc_mqtt_daemon_cmd_t *cmd
             (en_mqtt_al_connect_ok == mqtt_al_check_status(cb->mqtt_para.mqtt_handle)))
     {
         ///< checkif the topic has been subscribe
-        topic_sub = cb->subscribe_lst;
-        while(NULL != topic_sub)
+        if(NULL == cb->subscribe_trie)
         {
-            if(0 == strcmp(topic_sub->topic, subpara->topic.data))
-            {
-                break;
-            }
-            topic_sub = topic_sub->nxt;
+            cb->subscribe_trie = topic_trie_create();
         }
 
-        if(NULL != topic_sub) ///< THERE HAS BEEN ONE
+        if(NULL == cb->subscribe_trie)
+        {
+            ret = (int)en_oc_mqtt_err_sysmem;
+        }
+        else if(0 == topic_trie_find(cb->subscribe_trie,subpara->topic.data,subpara->topic.len,NULL,NULL)) ///< THERE HAS BEEN ONE
         {
             LINK_LOG_DEBUG("RESUBSCRIBED THE SAME TOPIC");
             ret = (int)en_oc_mqtt_err_subscribe;
@@ -991,26 +1398,32 @@ static int deal_api_subscribe( oc_mqtt_tiny_cb_t  *cb, oc_mqtt_daemon_cmd_t *cmd
             {
                 ///< initialize the subtopic and add it to the subscribe list when success
                 topic_sub->qos = (int) subpara->qos;
+                topic_sub->dealer = (NULL == sub_req) ? NULL : sub_req->dealer;
+                topic_sub->arg = (NULL == sub_req) ? NULL : sub_req->arg;
                 topic_sub->topic = (char *)topic_sub + sizeof(tiny_topic_sub_t);
                 (void) strncpy(topic_sub->topic, subpara->topic.data,subpara->topic.len);
                 topic_sub->topic[subpara->topic.len] = '\0';
 
                 ///< copy the old parameters to the new one, for we could not change the user's memory
                 (void)memset(&sub_new,0,sizeof(sub_new));
-                sub_new.arg = cb;
-                sub_new.dealer = hub_msg_default_deal;
+                sub_new.arg = topic_sub;
+                sub_new.dealer = hub_msg_sub_deal;
                 sub_new.timeout = CN_OC_MQTT_TIMEOUT;
                 sub_new.qos = topic_sub->qos;
                 sub_new.topic.data  = topic_sub->topic;
                 sub_new.topic.len = subpara->topic.len;
-                if( 0  == mqtt_al_subscribe( cb->mqtt_para.mqtt_handle, &sub_new) )
+                if(0 != topic_trie_add(cb->subscribe_trie,topic_sub->topic,sub_new.topic.len,NULL,topic_sub))
+                {
+                    osal_free ( topic_sub );
+                    ret = (int)en_oc_mqtt_err_parafmt;   ///< the bad filter or no memory
+                }
+                else if( 0  == dmp_subscribe_topic( cb, &sub_new) )
                 {
-                    topic_sub->nxt = cb->subscribe_lst;
-                    cb->subscribe_lst = topic_sub;
                     ret = (int)en_oc_mqtt_err_ok;
                 }
                 else
                 {
+                    (void) topic_trie_remove(cb->subscribe_trie,topic_sub->topic,sub_new.topic.len);
                     osal_free ( topic_sub );
                     ret = (int)en_oc_mqtt_err_subscribe;
                 }
@@ -1037,8 +1450,7 @@ static int deal_api_subscribe( oc_mqtt_tiny_cb_t  *cb, oc_mqtt_daemon_cmd_t *cmd
 static int deal_api_unsubscribe( oc_mqtt_tiny_cb_t  *cb, oc_mqtt_daemon_cmd_t *cmd)
 {
     int ret = (int)en_oc_mqtt_err_noconfigured;
-    tiny_topic_sub_t  *topic_sub;
-    tiny_topic_sub_t  *topic_sub_nxt;
+    void              *topic_sub;
     mqtt_al_unsubpara_t *unsubpara;
 
     unsubpara = cmd->arg;
@@ -1053,33 +1465,12 @@ static int deal_api_unsubscribe( oc_mqtt_tiny_cb_t  *cb, oc_mqtt_daemon_cmd_t *c
 
         if( 0  == mqtt_al_unsubscribe( cb->mqtt_para.mqtt_handle, unsubpara) )
         {
-            ///< remove the topic from the subscribe list;
-            topic_sub = cb->subscribe_lst;
-            if(NULL != topic_sub)
+            (void) oc_mqtt_session_unsub(cb->session, unsubpara->topic.data);
+            ///< remove the topic from the subscribe trie;
+            if(0 == topic_trie_find(cb->subscribe_trie,unsubpara->topic.data,unsubpara->topic.len,NULL,&topic_sub))
             {
-                if  ( 0 == strcmp( unsubpara->topic.data, topic_sub->topic ))
-                {
-                    cb->subscribe_lst = topic_sub->nxt;
-                    osal_free(topic_sub);
-                }
-                else
-                {
-                    topic_sub_nxt = topic_sub->nxt;
-                    while( NULL != topic_sub_nxt )
-                    {
-                        if ( 0 == strcmp( unsubpara->topic.data, topic_sub_nxt->topic))
-                        {
-                            topic_sub->nxt = topic_sub_nxt->nxt;
-                            osal_free(topic_sub_nxt);
-                            break;
-                        }
-                        else
-                        {
-                            topic_sub = topic_sub_nxt;
-                            topic_sub_nxt = topic_sub_nxt->nxt;
-                        }
-                    }
-                }
+                (void) topic_trie_remove(cb->subscribe_trie,unsubpara->topic.data,unsubpara->topic.len);
+                osal_free(topic_sub);
             }
             ret = (int)en_oc_mqtt_err_ok;
         }
@@ -1117,13 +1508,27 @@ int daemon_entry_exit( oc_mqtt_tiny_cb_t  *cb)
 static int daemon_entry(void *arg)
 {
     int ret = (int)en_oc_mqtt_err_ok;
+    int timeout;
     oc_mqtt_tiny_cb_t  *cb;
     oc_mqtt_daemon_cmd_t   *daemon_cmd = NULL;
 
     cb = arg;
     while((NULL != cb) && (0 == cb->daemon_exit))
     {
-        if(0 == queue_pop(cb->task_daemon_cmd_queue,(void **)&daemon_cmd,10*1000))
+        timeout = 10*1000;
+        if(((int)en_daemon_status_hub_keep == cb->flag.bits.bit_daemon_status) && \
+           (en_mqtt_al_connect_ok == mqtt_al_check_status(cb->mqtt_para.mqtt_handle)) && \
+           (oc_mqtt_outbox_count(cb->outbox, 0) > 0))
+        {
+            timeout = osal_loop_timer_left(&cb->drain_timer);   ///< wake up for the next burst
+            timeout = (timeout > 0) ? timeout : 1;
+        }
+        if(cb->async_kick)
+        {
+            timeout = 1;    ///< the async ring is not empty yet
+        }
+
+        if(0 == queue_pop(cb->task_daemon_cmd_queue,(void **)&daemon_cmd,timeout))
         {
             switch (daemon_cmd->cmd)             ///< execute the command here
             {
@@ -1166,6 +1571,7 @@ static int daemon_entry(void *arg)
                     }
                     else
                     {
+                        (void) oc_mqtt_outbox_flush(cb->outbox);   ///< keep the queued messages over the power off
                         (void) oc_mqtt_para_release(cb);
 
                         daemon_cmd->retcode = config_parameter_release(cb);
@@ -1176,17 +1582,9 @@ static int daemon_entry(void *arg)
                     {
                         daemon_cmd->retcode = (int)en_oc_mqtt_err_noconfigured;
                     }
-                    else if(((int)en_daemon_status_hub_keep == cb->flag.bits.bit_daemon_status) &&\
-                            (en_mqtt_al_connect_ok == mqtt_al_check_status(cb->mqtt_para.mqtt_handle)))
-                    {
-                        mqtt_al_pubpara_t *pubpara;
-                        pubpara = daemon_cmd->arg;
-                        daemon_cmd->retcode = dmp_publish(cb, pubpara->topic.data,\
-                                   (uint8_t *)pubpara->msg.data,pubpara->msg.len,(int)pubpara->qos);
-                    }
                     else
                     {
-                        daemon_cmd->retcode = (int)en_oc_mqtt_err_noconected;
+                        daemon_cmd->retcode = hub_publish(cb, daemon_cmd->arg);
                     }
                     break;
                 case en_oc_mqtt_daemon_cmd_subscribe:
@@ -1200,11 +1598,16 @@ static int daemon_entry(void *arg)
                     LINK_LOG_DEBUG("daemon:unsubscribe exit");
                     break;
 
+                case en_oc_mqtt_daemon_cmd_send:
+                    break;                 ///< the async ring is dealt below
                 default:
                     break;
 
             }
-            (void) osal_semp_post(daemon_cmd->signal); ///< activate the commander
+            if(daemon_cmd != &s_oc_mqtt_async_cmd)
+            {
+                (void) osal_semp_post(daemon_cmd->signal); ///< activate the commander
+            }
         }
 
         ///< timeout we should check if we should do the reconnect
@@ -1233,6 +1636,9 @@ static int daemon_entry(void *arg)
         {
             ///< do nothing here
         }
+
+        hub_async(cb);
+        hub_drain(cb);
     }
 
     LINK_LOG_DEBUG("%s:quit",__FUNCTION__);
@@ -1301,7 +1707,8 @@ static int tiny_publish(char *topic,uint8_t *payload, int len,int qos )
     mqtt_al_pubpara_t pubpara;
     int  ret = (int)en_oc_mqtt_err_parafmt;
 
-    if(qos >= (int)en_mqtt_al_qos_err)
+    if(((qos & cn_oc_mqtt_qos_mask) >= (int)en_mqtt_al_qos_err) || \
+       (0 != (qos & (~(cn_oc_mqtt_qos_mask | cn_oc_mqtt_qos_alarm)))))
     {
         return ret;
     }
@@ -1313,7 +1720,7 @@ static int tiny_publish(char *topic,uint8_t *payload, int len,int qos )
 
     ///< pub the mqtt request
     (void) memset(&pubpara, 0, sizeof(pubpara));
-    pubpara.qos = (en_mqtt_al_qos_t)qos;
+    pubpara.qos = (en_mqtt_al_qos_t)qos;      ///< the alarm flag is removed by the daemon
     pubpara.retain = 0;
     pubpara.timeout = 1000;
     pubpara.topic.data = topic;
@@ -1325,15 +1732,91 @@ static int tiny_publish(char *topic,uint8_t *payload, int len,int qos )
     return ret;
 }
 
+///< use this function to publish message without waiting, the message is copied to the async ring
+static int tiny_publish_async(char *topic,uint8_t *payload,int len,int qos,fn_oc_mqtt_pubdone done,void *arg)
+{
+    oc_mqtt_tiny_cb_t *cb = s_oc_mqtt_tiny_cb;
+    tiny_async_head_t head;
+    int  ret = (int)en_oc_mqtt_err_parafmt;
+    int  kick = 0;
+
+    if(((qos & cn_oc_mqtt_qos_mask) >= (int)en_mqtt_al_qos_err) || \
+       (0 != (qos & (~(cn_oc_mqtt_qos_mask | cn_oc_mqtt_qos_alarm)))) || \
+       (len < 0) || ((NULL == payload) && (len > 0)))
+    {
+        return ret;
+    }
+    if(NULL == cb)
+    {
+        ret = (int)en_oc_mqtt_err_system;
+        return ret;
+    }
+    if(NULL == cb->async_mem)
+    {
+        ret = tiny_publish(topic, payload, len, qos);
+        if(((int)en_oc_mqtt_err_ok == ret) && (NULL != done))
+        {
+            done(arg, ret);
+        }
+        return ret;
+    }
+    if((int)en_daemon_status_idle == cb->flag.bits.bit_daemon_status)
+    {
+        ret = (int)en_oc_mqtt_err_noconfigured;
+        return ret;
+    }
+
+    head.done = done;
+    head.arg = arg;
+    head.qos = qos;
+    head.topiclen = (NULL == topic) ? 0 : (int)strlen(topic) + 1;
+    head.msglen = len;
+
+    ///< the message never fits the ring, which is not a temporary shortage
+    if((int)sizeof(head) + head.topiclen + len > cb->async_ring.buflen)
+    {
+        ret = (int)en_oc_mqtt_err_parafmt;
+        return ret;
+    }
+
+    ret = (int)en_oc_mqtt_err_sysmem;
+    (void) osal_mutex_lock(cb->async_lock);
+    if(ring_buffer_freespace(&cb->async_ring) >= (int)sizeof(head) + head.topiclen + len)
+    {
+        (void) ring_buffer_write(&cb->async_ring, (unsigned char *)&head, sizeof(head));
+        if(head.topiclen > 0)
+        {
+            (void) ring_buffer_write(&cb->async_ring, (unsigned char *)topic, head.topiclen);
+        }
+        if(len > 0)
+        {
+            (void) ring_buffer_write(&cb->async_ring, payload, len);
+        }
+        kick = (0 == cb->async_kick);
+        cb->async_kick = 1;
+        ret = (int)en_oc_mqtt_err_ok;
+    }
+    (void) osal_mutex_unlock(cb->async_lock);
+
+    ///< when the command queue is full, the daemon is awake and will find the ring anyway
+    if(kick)
+    {
+        (void) queue_push(cb->task_daemon_cmd_queue, &s_oc_mqtt_async_cmd, 0);
+    }
+
+    return ret;
+}
+
 ///< use this function to subscribe a topic
-static int tiny_subscribe(char *topic, int qos)
+static int tiny_subscribe_ex(char *topic, int qos, fn_oc_mqtt_msg_deal dealer, void *arg)
 {
     ///< use this function to subscribe a topic
     mqtt_al_subpara_t  subpara;
+    tiny_topic_sub_t   sub_req;
 
     int  ret = (int)en_oc_mqtt_err_parafmt;
 
-    if(qos >= (int)en_mqtt_al_qos_err)
+    if((NULL == topic) || (qos >= (int)en_mqtt_al_qos_err))
     {
         return ret;
     }
@@ -1343,16 +1826,25 @@ static int tiny_subscribe(char *topic, int qos)
         return ret;
     }
 
-    ///< pub the mqtt request
+    ///< pub the mqtt request, the dealer is carried by the arg
+    (void) memset(&sub_req, 0, sizeof(sub_req));
+    sub_req.dealer = dealer;
+    sub_req.arg = arg;
     (void) memset(&subpara, 0, sizeof(subpara));
     subpara.qos = (en_mqtt_al_qos_t)qos;
     subpara.topic.data = topic;
     subpara.topic.len = strlen(topic);
+    subpara.arg = &sub_req;
 
     ret = daemon_cmd_post(en_oc_mqtt_daemon_cmd_subscribe,&subpara);
 
     return ret;
 }
+
+static int tiny_subscribe(char *topic, int qos)
+{
+    return tiny_subscribe_ex(topic,qos,NULL,NULL);
+}
 ///< use this function to unsubscribe a topic
 static int tiny_unsubscribe(char *topic)
 {
@@ -1397,6 +1889,8 @@ static const oc_mqtt_t s_oc_mqtt_tiny = \
         .publish = tiny_publish,
         .subscribe = tiny_subscribe,
         .unsubscribe = tiny_unsubscribe,
+        .publish_async = tiny_publish_async,
+        .subscribe_ex = tiny_subscribe_ex,
     },
 };
 
@@ -1414,12 +1908,40 @@ int oc_mqtt_imp_init()
     }
     (void) memset(cb,0,sizeof(oc_mqtt_tiny_cb_t));
 
+#if CONFIG_OC_MQTT_OUTBOX_ENABLE
+    cb->outbox = oc_mqtt_outbox_create();     ///< without the outbox, the offline publish fails
+    osal_loop_timer_init(&cb->drain_timer);
+#endif
+#if CONFIG_OC_MQTT_SESSION_ENABLE
+    cb->session = oc_mqtt_session_create();   ///< without the session, each connect cleans the session
+#endif
+
+    ///< without the async ring, the async publish is done in the caller
+    if((CONFIG_OC_MQTT_ASYNC_RINGSIZE > 0) && (true == osal_mutex_create(&cb->async_lock)))
+    {
+        cb->async_mem = osal_malloc(2 * CONFIG_OC_MQTT_ASYNC_RINGSIZE);
+        if(NULL == cb->async_mem)
+        {
+            (void) osal_mutex_del(cb->async_lock);
+        }
+        else
+        {
+            (void) ring_buffer_init(&cb->async_ring, cb->async_mem, CONFIG_OC_MQTT_ASYNC_RINGSIZE, 0, 0);
+        }
+    }
+
     cb->task_daemon_cmd_queue = queue_create("daemon_cmd_queue",10,1);
     if(NULL == cb->task_daemon_cmd_queue)
     {
         goto EXIT_QUEUE;
     }
 
+    cb->daemon_cmd_pool = osal_pool_create("oc_mqtt_cmd",sizeof(oc_mqtt_daemon_cmd_t),CONFIG_OC_MQTT_CMD_POOLSIZE,1);
+    if(NULL == cb->daemon_cmd_pool)
+    {
+        goto EXIT_POOL;
+    }
+
     cb->task_daemon = osal_task_create("oc_mqtt_tiny",daemon_entry,\
                                         cb,0x1800,NULL,10);
     if(NULL == cb->task_daemon)
@@ -1442,10 +1964,21 @@ EXIT_REGISTER:
     cb->task_daemon = NULL;
 
 EXIT_TASK:
+    (void) osal_pool_delete(cb->daemon_cmd_pool);
+    cb->daemon_cmd_pool = NULL;
+
+EXIT_POOL:
     (void) queue_delete(cb->task_daemon_cmd_queue);
     cb->task_daemon_cmd_queue = NULL;
 
 EXIT_QUEUE:
+    if(NULL != cb->async_mem)
+    {
+        osal_free(cb->async_mem);
+        (void) osal_mutex_del(cb->async_lock);
+    }
+    (void) oc_mqtt_outbox_delete(cb->outbox);
+    (void) oc_mqtt_session_delete(cb->session);
     osal_free(cb);
     cb = NULL;
 
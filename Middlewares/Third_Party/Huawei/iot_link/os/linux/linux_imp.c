@@ -0,0 +1,575 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) <2018>, <Huawei Technologies Co., Ltd>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------
+ * Notice of Export Control Law
+ * ===============================================
+ * Huawei LiteOS may be subject to applicable export control laws and regulations, which might
+ * include those applicable to Huawei LiteOS of U.S. and the country in which you are located.
+ * Import, export and usage of Huawei LiteOS in any manner by you shall be in compliance with such
+ * applicable export control laws and regulations.
+ *---------------------------------------------------------------------------*/
+/**
+ *  DATE                      INSTRUCTION
+ *  2026-10-18 21:10   The first version
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <osal_imp.h>
+#include <linux_imp.h>
+
+static void __deadline(struct timespec *ts, unsigned int ms)
+{
+    (void) clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000;
+    if(ts->tv_nsec >= 1000000000)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+///< the cond waits on the monotonic clock, so changing the wall time never breaks the timeout
+static void __cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+
+    (void) pthread_condattr_init(&attr);
+    (void) pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    (void) pthread_cond_init(cond, &attr);
+    (void) pthread_condattr_destroy(&attr);
+}
+
+///< wait the cond with the lock held, false if timeout
+static bool_t __cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, const struct timespec *ts)
+{
+    if(NULL == ts)
+    {
+        return (0 == pthread_cond_wait(cond, lock)) ? true : false;
+    }
+
+    return (0 == pthread_cond_timedwait(cond, lock, ts)) ? true : false;
+}
+
+
+///< this is implement for the task
+typedef struct
+{
+    int  (*entry)(void *args);
+    void  *args;
+}linux_task_t;
+
+static void *__task_entry(void *arg)
+{
+    linux_task_t task;
+
+    task = *(linux_task_t *)arg;
+    free(arg);
+    (void) task.entry(task.args);
+
+    return NULL;
+}
+
+static void __task_sleep(int ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000;
+    (void) nanosleep(&ts, NULL);
+    return;
+}
+
+///< the stack size and the priority are for the mcu, the thread keeps the default of the host
+static void *__task_create(const char *name,int (*task_entry)(void *args),\
+        void *args,int stack_size,void *stack,int prior)
+{
+    pthread_t       tid;
+    pthread_attr_t  attr;
+    linux_task_t   *task;
+    char            thread_name[16];
+
+    task = malloc(sizeof(linux_task_t));
+    if(NULL == task)
+    {
+        return NULL;
+    }
+    task->entry = task_entry;
+    task->args = args;
+
+    (void) pthread_attr_init(&attr);
+    (void) pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if(0 != pthread_create(&tid, &attr, __task_entry, task))
+    {
+        (void) pthread_attr_destroy(&attr);
+        free(task);
+        return NULL;
+    }
+    (void) pthread_attr_destroy(&attr);
+
+    if(NULL != name)
+    {
+        (void) strncpy(thread_name, name, sizeof(thread_name) - 1);
+        thread_name[sizeof(thread_name) - 1] = '\0';
+        (void) pthread_setname_np(tid, thread_name);
+    }
+
+    return (void *)tid;
+}
+
+static int __task_kill(void *task)
+{
+    int ret = -1;
+
+    if((NULL != task) && (0 == pthread_cancel((pthread_t)task)))
+    {
+        ret = 0;
+    }
+
+    return ret;
+}
+
+static void __task_exit()
+{
+    pthread_exit(NULL);
+}
+
+
+///< this is implement for the mutex, which could be locked again by the owner as the liteos does
+static bool_t  __mutex_create(osal_mutex_t *mutex)
+{
+    pthread_mutex_t     *lock;
+    pthread_mutexattr_t  attr;
+
+    lock = malloc(sizeof(pthread_mutex_t));
+    if(NULL == lock)
+    {
+        return false;
+    }
+    (void) pthread_mutexattr_init(&attr);
+    (void) pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    (void) pthread_mutex_init(lock, &attr);
+    (void) pthread_mutexattr_destroy(&attr);
+    *mutex = lock;
+
+    return true;
+}
+
+static bool_t  __mutex_lock(osal_mutex_t mutex)
+{
+    return (0 == pthread_mutex_lock((pthread_mutex_t *)mutex)) ? true : false;
+}
+
+static bool_t  __mutex_unlock(osal_mutex_t mutex)
+{
+    return (0 == pthread_mutex_unlock((pthread_mutex_t *)mutex)) ? true : false;
+}
+
+static bool_t  __mutex_del(osal_mutex_t mutex)
+{
+    if(0 != pthread_mutex_destroy((pthread_mutex_t *)mutex))
+    {
+        return false;
+    }
+    free(mutex);
+
+    return true;
+}
+
+
+///< this is implement for the semp
+typedef struct
+{
+    pthread_mutex_t  lock;
+    pthread_cond_t   cond;
+    int              count;
+    int              limit;
+}linux_semp_t;
+
+static bool_t  __semp_create(osal_semp_t *semp,int limit,int initvalue)
+{
+    linux_semp_t *sem;
+
+    sem = malloc(sizeof(linux_semp_t));
+    if(NULL == sem)
+    {
+        return false;
+    }
+    (void) pthread_mutex_init(&sem->lock, NULL);
+    __cond_init(&sem->cond);
+    sem->count = initvalue;
+    sem->limit = limit;
+    *semp = sem;
+
+    return true;
+}
+
+static bool_t  __semp_pend(osal_semp_t semp,unsigned int timeout)
+{
+    linux_semp_t    *sem = semp;
+    struct timespec  ts;
+    bool_t           ret = true;
+
+    if(cn_osal_timeout_forever != timeout)
+    {
+        __deadline(&ts, timeout);
+    }
+    (void) pthread_mutex_lock(&sem->lock);
+    while((0 == sem->count) && ret)
+    {
+        ret = (0 == timeout) ? false : \
+              __cond_wait(&sem->cond, &sem->lock, (cn_osal_timeout_forever == timeout) ? NULL : &ts);
+    }
+    if(sem->count > 0)
+    {
+        sem->count--;
+        ret = true;
+    }
+    (void) pthread_mutex_unlock(&sem->lock);
+
+    return ret;
+}
+
+static bool_t  __semp_post(osal_semp_t semp)
+{
+    linux_semp_t *sem = semp;
+
+    (void) pthread_mutex_lock(&sem->lock);
+    if(sem->count < sem->limit)
+    {
+        sem->count++;
+    }
+    (void) pthread_cond_signal(&sem->cond);
+    (void) pthread_mutex_unlock(&sem->lock);
+
+    return true;
+}
+
+static bool_t  __semp_del(osal_semp_t semp)
+{
+    linux_semp_t *sem = semp;
+
+    (void) pthread_cond_destroy(&sem->cond);
+    (void) pthread_mutex_destroy(&sem->lock);
+    free(sem);
+
+    return true;
+}
+
+
+///< this is implement for the queue, each message slot keeps the message length before the data
+typedef struct
+{
+    pthread_mutex_t  lock;
+    pthread_cond_t   cond_send;
+    pthread_cond_t   cond_recv;
+    int              len;
+    int              msgsize;
+    int              head;
+    int              count;
+    unsigned char   *slots;
+}linux_queue_t;
+
+#define CN_LINUX_QUEUE_SLOT(q,i)  ((q)->slots + (size_t)(i) * (sizeof(unsigned int) + (size_t)(q)->msgsize))
+
+static bool_t __queue_create(osal_queue_t *queue,int len,int msgsize)
+{
+    linux_queue_t *q;
+
+    if((len <= 0) || (msgsize <= 0))
+    {
+        return false;
+    }
+    q = malloc(sizeof(linux_queue_t) + (size_t)len * (sizeof(unsigned int) + (size_t)msgsize));
+    if(NULL == q)
+    {
+        return false;
+    }
+    (void) pthread_mutex_init(&q->lock, NULL);
+    __cond_init(&q->cond_send);
+    __cond_init(&q->cond_recv);
+    q->len = len;
+    q->msgsize = msgsize;
+    q->head = 0;
+    q->count = 0;
+    q->slots = (unsigned char *)(q + 1);
+    *queue = q;
+
+    return true;
+}
+
+static bool_t __queue_send(osal_queue_t queue, void *pbuf, unsigned int bufsize, unsigned int timeout)
+{
+    linux_queue_t   *q = queue;
+    struct timespec  ts;
+    unsigned char   *slot;
+    bool_t           ret = true;
+
+    if(bufsize > (unsigned int)q->msgsize)
+    {
+        return false;
+    }
+    if(cn_osal_timeout_forever != timeout)
+    {
+        __deadline(&ts, timeout);
+    }
+    (void) pthread_mutex_lock(&q->lock);
+    while((q->count == q->len) && ret)
+    {
+        ret = (0 == timeout) ? false : \
+              __cond_wait(&q->cond_send, &q->lock, (cn_osal_timeout_forever == timeout) ? NULL : &ts);
+    }
+    if(q->count < q->len)
+    {
+        slot = CN_LINUX_QUEUE_SLOT(q, (q->head + q->count) % q->len);
+        (void) memcpy(slot, &bufsize, sizeof(bufsize));
+        (void) memcpy(slot + sizeof(bufsize), pbuf, bufsize);
+        q->count++;
+        (void) pthread_cond_signal(&q->cond_recv);
+        ret = true;
+    }
+    (void) pthread_mutex_unlock(&q->lock);
+
+    return ret;
+}
+
+///< the message longer than the buffer is cut to the buffer
+static bool_t __queue_recv(osal_queue_t queue, void *pbuf, unsigned int bufsize, unsigned int timeout)
+{
+    linux_queue_t   *q = queue;
+    struct timespec  ts;
+    unsigned char   *slot;
+    unsigned int     msglen;
+    bool_t           ret = true;
+
+    if(cn_osal_timeout_forever != timeout)
+    {
+        __deadline(&ts, timeout);
+    }
+    (void) pthread_mutex_lock(&q->lock);
+    while((0 == q->count) && ret)
+    {
+        ret = (0 == timeout) ? false : \
+              __cond_wait(&q->cond_recv, &q->lock, (cn_osal_timeout_forever == timeout) ? NULL : &ts);
+    }
+    if(q->count > 0)
+    {
+        slot = CN_LINUX_QUEUE_SLOT(q, q->head);
+        (void) memcpy(&msglen, slot, sizeof(msglen));
+        (void) memcpy(pbuf, slot + sizeof(msglen), (msglen < bufsize) ? msglen : bufsize);
+        q->head = (q->head + 1) % q->len;
+        q->count--;
+        (void) pthread_cond_signal(&q->cond_send);
+        ret = true;
+    }
+    (void) pthread_mutex_unlock(&q->lock);
+
+    return ret;
+}
+
+static bool_t __queue_del(osal_queue_t queue)
+{
+    linux_queue_t *q = queue;
+
+    (void) pthread_cond_destroy(&q->cond_send);
+    (void) pthread_cond_destroy(&q->cond_recv);
+    (void) pthread_mutex_destroy(&q->lock);
+    free(q);
+
+    return true;
+}
+
+
+///< this implement for the memory management, each block keeps its size before it for the statistics
+#define CN_LINUX_MEM_HEAD   16      ///< keeps the block aligned as the malloc does
+
+static pthread_mutex_t  s_mem_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t           s_mem_used;
+static size_t           s_mem_peak;
+
+static void __mem_count(size_t add, size_t sub)
+{
+    (void) pthread_mutex_lock(&s_mem_lock);
+    s_mem_used = s_mem_used + add - sub;
+    if(s_mem_used > s_mem_peak)
+    {
+        s_mem_peak = s_mem_used;
+    }
+    (void) pthread_mutex_unlock(&s_mem_lock);
+}
+
+static void *__mem_malloc(int size)
+{
+    unsigned char *blk;
+
+    if(size <= 0)
+    {
+        return NULL;
+    }
+    blk = malloc(CN_LINUX_MEM_HEAD + (size_t)size);
+    if(NULL == blk)
+    {
+        return NULL;
+    }
+    *(size_t *)blk = (size_t)size;
+    __mem_count((size_t)size, 0);
+
+    return blk + CN_LINUX_MEM_HEAD;
+}
+
+static void __mem_free(void *addr)
+{
+    unsigned char *blk;
+
+    if(NULL == addr)
+    {
+        return;
+    }
+    blk = (unsigned char *)addr - CN_LINUX_MEM_HEAD;
+    __mem_count(0, *(size_t *)blk);
+    free(blk);
+}
+
+static void *__mem_realloc(void *ptr, int newsize)
+{
+    unsigned char *blk;
+    size_t         oldsize;
+
+    if(NULL == ptr)
+    {
+        return __mem_malloc(newsize);
+    }
+    if(newsize <= 0)
+    {
+        __mem_free(ptr);
+        return NULL;
+    }
+    blk = (unsigned char *)ptr - CN_LINUX_MEM_HEAD;
+    oldsize = *(size_t *)blk;
+    blk = realloc(blk, CN_LINUX_MEM_HEAD + (size_t)newsize);
+    if(NULL == blk)
+    {
+        return NULL;
+    }
+    *(size_t *)blk = (size_t)newsize;
+    __mem_count((size_t)newsize, oldsize);
+
+    return blk + CN_LINUX_MEM_HEAD;
+}
+
+void linux_mem_stat(size_t *used, size_t *peak)
+{
+    (void) pthread_mutex_lock(&s_mem_lock);
+    if(NULL != used)
+    {
+        *used = s_mem_used;
+    }
+    if(NULL != peak)
+    {
+        *peak = s_mem_peak;
+    }
+    (void) pthread_mutex_unlock(&s_mem_lock);
+}
+
+void linux_mem_peak_reset(void)
+{
+    (void) pthread_mutex_lock(&s_mem_lock);
+    s_mem_peak = s_mem_used;
+    (void) pthread_mutex_unlock(&s_mem_lock);
+}
+
+
+///< sys time
+static unsigned long long __get_sys_time()
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long long)ts.tv_sec * 1000 + (unsigned long long)ts.tv_nsec / 1000000;
+}
+
+///< the process could not reboot itself, leave it to whom started it
+static int __reboot()
+{
+    return -1;
+}
+
+
+static const tag_os_ops s_linux_ops =
+{
+    .task_sleep = __task_sleep,
+    .task_create = __task_create,
+    .task_kill = __task_kill,
+    .task_exit = __task_exit,
+
+    .mutex_create = __mutex_create,
+    .mutex_lock = __mutex_lock,
+    .mutex_unlock = __mutex_unlock,
+    .mutex_del = __mutex_del,
+
+    .semp_create = __semp_create,
+    .semp_pend = __semp_pend,
+    .semp_post = __semp_post,
+    .semp_del = __semp_del,
+
+    .queue_create = __queue_create,
+    .queue_send = __queue_send,
+    .queue_recv = __queue_recv,
+    .queue_del = __queue_del,
+
+    .malloc = __mem_malloc,
+    .free = __mem_free,
+    .realloc = __mem_realloc,
+
+    .get_sys_time = __get_sys_time,
+    .reboot = __reboot,
+};
+
+
+static const tag_os s_link_linux =
+{
+    .name = "Linux",
+    .ops = &s_linux_ops,
+};
+
+int os_imp_init(void)
+{
+    int ret = -1;
+
+    ret = osal_install(&s_link_linux);
+
+    return ret;
+}
@@ -0,0 +1,13 @@
+################################################################################
+# this is used for compile the iotlink on the linux host, the osal runs on the pthread
+################################################################################
+
+linux_os_src = ${wildcard $(iot_link_root)/os/linux/*.c}
+C_SOURCES += $(linux_os_src)
+
+linux_os_inc = -I $(iot_link_root)/os/linux
+C_INCLUDES += $(linux_os_inc)
+
+LIBS += -lpthread
+
+C_DEFS += -D CONFIG_LINUXOS_ENABLE=1
@@ -148,6 +148,9 @@ LITE_OS_SEC_TEXT WEAK VOID osIdleTask(VOID)
 {
     while (1)
     {
+#if (LOSCFG_HEAP_IMPROVED == YES) && (LOSCFG_HEAP_CANARY == YES)
+        osHeapCanarySweep();
+#endif
 #if (LOSCFG_KERNEL_TICKLESS == YES)
         osTicklessHandler();
 #else
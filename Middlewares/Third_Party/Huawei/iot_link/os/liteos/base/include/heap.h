@@ -85,11 +85,44 @@ typedef struct mem_stat
 } mem_stat_t;
 #endif
 
+#if (LOSCFG_HEAP_CANARY == YES)
+
+/*
+ * the canary layout of an allocated memory block:
+ *
+ * +-----+------------+-----+-------------+------+
+ * | ACH | size|magic | pad | user memory | tail |
+ * +-----+------------+-----+-------------+------+
+ *        \                  *         `-- raw           `-- user, the word before user is always magic
+ *
+ * the low 16 bits of magic is the offset from raw to user, which is 8 for the
+ * normal allocation and the alignment for the aligned allocation
+ */
+
+#define HEAP_CANARY_MAGIC       0xCA5A0000
+#define HEAP_CANARY_MAGIC_MASK  0xFFFF0000
+#define HEAP_CANARY_OFFSET_MASK 0x0000FFFF
+#define HEAP_CANARY_TAIL        0x5AC3A55C
+#define HEAP_CANARY_HEAD_SIZE   (sizeof (canary_t))
+#define HEAP_CANARY_TAIL_SIZE   (sizeof (UINT32))
+
+typedef struct canary
+{
+    UINT32 size;                /* the size user wanted     */
+    UINT32 magic;               /* magic | offset           */
+} canary_t;
+#endif
+
 typedef struct heap
 {
     chunk_mgr_t        cm;
     block_t          * blocks;
     UINT32             mux;
+#if (LOSCFG_HEAP_CANARY == YES)
+    block_t          * canary_block;    /* the block the sweep cursor in */
+    chunk_t          * canary_cursor;   /* the next chunk to sweep       */
+    UINT32             canary_errors;   /* corrupted blocks found        */
+#endif
 #if (LOSCFG_MEM_STATISTICS == YES)
     struct mem_stat    stat;
 #endif
@@ -133,6 +166,16 @@ static inline void __stat_chunk_free (mem_stat_t * stat, chunk_t * chunk)
     stat->cum_freed++;
     stat->cum_size_freed += chunk->size;
 }
+
+static inline void __stat_chunk_resize (mem_stat_t * stat, int delta)
+{
+    stat->busy_size += delta;
+
+    if (stat->busy_size > stat->max_busy_size)
+    {
+        stat->max_busy_size = stat->busy_size;
+    }
+}
 #endif
 
 /* externs */
@@ -147,6 +190,9 @@ extern void __dump_heap        (heap_t * heap, bool show_chunk);
 #if (LOSCFG_MEM_STATISTICS == YES)
 extern int    heap_stat_get    (heap_t * heap, mem_stat_t * stat);
 #endif
+#if (LOSCFG_HEAP_CANARY == YES)
+extern int    heap_canary_check (heap_t * heap, unsigned int chunks, bool wait);
+#endif
 
 #endif  /* __HEAP_H__ */
 
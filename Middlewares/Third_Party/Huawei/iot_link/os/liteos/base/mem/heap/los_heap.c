@@ -65,6 +65,20 @@ static inline void __del_chunk (heap_t * heap, chunk_t * chunk)
 #endif
 }
 
+#if (LOSCFG_HEAP_CANARY == YES)
+static inline void __canary_cursor_fix (heap_t * heap, chunk_t * gone, chunk_t * into)
+{
+    /* the chunk header is gone when merged, move the sweep cursor to the new one */
+
+    if (heap->canary_cursor == gone)
+    {
+        heap->canary_cursor = into;
+    }
+}
+#else
+#define __canary_cursor_fix(heap, gone, into)
+#endif
+
 static inline chunk_t * __get_chunk (heap_t * heap, size_t size)
 {
     chunk_t * chunk = __cm_get_chunk (&heap->cm, size);
@@ -341,7 +355,7 @@ static inline char * __carve_extra (heap_t * heap, chunk_t * chunk,
 }
 
 /**
- * heap_alloc_align - allocate a block of memory from a heap with alignment
+ * __heap_alloc_align - allocate a block of memory from a heap with alignment
  * @heap:  the heap to allocate from
  * @bytes: size of memory in bytes to allocate
  * @align: the expected alignment value
@@ -349,7 +363,7 @@ static inline char * __carve_extra (heap_t * heap, chunk_t * chunk,
  * return: the allocated memory block or NULL if fail
  */
 
-char * heap_alloc_align (heap_t * heap, size_t align, size_t bytes)
+static char * __heap_alloc_align (heap_t * heap, size_t align, size_t bytes)
 {
     chunk_t * chunk;
     char    * mem = NULL;
@@ -397,26 +411,13 @@ char * heap_alloc_align (heap_t * heap, size_t align, size_t bytes)
 }
 
 /**
- * heap_alloc - allocate a block of memory from a heap
- * @heap:  the heap to allocate from
- * @bytes: size of memory in bytes to allocate
- *
- * return: the allocated memory block or NULL if fail
- */
-
-char * heap_alloc (heap_t * heap, size_t bytes)
-{
-    return heap_alloc_align (heap, ALLOC_ALIGN_SIZE, bytes);
-}
-
-/**
- * heap_free - free a block of memory
+ * __heap_free - free a block of memory
  * @heap:  the heap to allocate from
  *
  * return: 0 on sucess
  */
 
-int heap_free (heap_t * heap, char * mem)
+static int __heap_free (heap_t * heap, char * mem)
 {
     chunk_t * chunk;
     chunk_t * prev_chunk;
@@ -454,6 +455,7 @@ int heap_free (heap_t * heap, char * mem)
     {
         __del_chunk (heap, prev_chunk);
         prev_chunk->size += chunk->size;
+        __canary_cursor_fix (heap, chunk, prev_chunk);
         chunk = prev_chunk;
     }
 
@@ -461,6 +463,7 @@ int heap_free (heap_t * heap, char * mem)
     {
         __del_chunk (heap, next_chunk);
         chunk->size += next_chunk->size;
+        __canary_cursor_fix (heap, next_chunk, chunk);
 
         next_chunk = __get_next_chunk (chunk);
     }
@@ -475,7 +478,7 @@ int heap_free (heap_t * heap, char * mem)
 }
 
 /**
- * heap_realloc - realloc memory from a heap
+ * __heap_realloc - realloc memory from a heap
  * @heap: the heap to allocate from
  * @ptr:  the original memory
  * @size: the new size
@@ -483,7 +486,7 @@ int heap_free (heap_t * heap, char * mem)
  * return: the allocated memory block or NULL if fail
  */
 
-char * heap_realloc (heap_t * heap, char * ptr, size_t size)
+static char * __heap_realloc (heap_t * heap, char * ptr, size_t size)
 {
     char    * mem;
     size_t    usable_size;
@@ -494,12 +497,12 @@ char * heap_realloc (heap_t * heap, char * ptr, size_t size)
 
     if (ptr == NULL)
     {
-        return heap_alloc (heap, size);
+        return __heap_alloc_align (heap, ALLOC_ALIGN_SIZE, size);
     }
 
     if (size == 0)
     {
-        heap_free (heap, ptr);
+        __heap_free (heap, ptr);
         return NULL;
     }
 
@@ -513,18 +516,61 @@ char * heap_realloc (heap_t * heap, char * ptr, size_t size)
     }
 
     chunk = (chunk_t *) __get_ach_from_mem (ptr);
+
+    if (LOS_MuxPend (heap->mux, LOS_WAIT_FOREVER) != LOS_OK)
+    {
+        return NULL;
+    }
+
     next  = __get_next_chunk (chunk);
 
     usable_size = ((char *) next) - ptr;
 
+    if ((usable_size < size) && __is_free (next) && ((usable_size + next->size) >= size))
+    {
+
+        /*
+         * the next chunk is free and big enough, absorb it and grow in place,
+         * the extra memory will be carved as the shrink case below:
+         *
+         * +-----+-------------+-----+----------------+------------+ ~ ...
+         * | ACH | used memory | FCH | free memory    | next chunk | ~ ...
+         * +-----+-------------+-----+----------------+------------+ ~ ...
+         *
+         * ==>
+         *
+         * +-----+----------------------------------+------------+ ~ ...
+         * | ACH | used memory (grown)              | next chunk | ~ ...
+         * +-----+----------------------------------+------------+ ~ ...
+         */
+
+        __del_chunk (heap, next);
+
+        chunk->size += next->size;
+
+#if (LOSCFG_MEM_STATISTICS == YES)
+        __stat_chunk_resize (&heap->stat, (int) next->size);
+#endif
+
+        __canary_cursor_fix (heap, next, chunk);
+
+        next = __get_next_chunk (chunk);
+
+        next->prev = chunk;
+
+        usable_size = ((char *) next) - ptr;
+    }
+
+    (void) LOS_MuxPost (heap->mux);
+
     if (usable_size < size)
     {
-        mem = heap_alloc (heap, size);
+        mem = __heap_alloc_align (heap, ALLOC_ALIGN_SIZE, size);
 
         if (mem != NULL)
         {
             memcpy (mem, ptr, usable_size);
-            heap_free (heap, ptr);
+            __heap_free (heap, ptr);
         }
 
         return mem;
@@ -552,10 +598,15 @@ char * heap_realloc (heap_t * heap, char * ptr, size_t size)
 
     chunk->size -= left_size;
 
+#if (LOSCFG_MEM_STATISTICS == YES)
+    __stat_chunk_resize (&heap->stat, -(int) left_size);
+#endif
+
     if (__is_free (next))
     {
         new->size = left_size + next->size;
         __del_chunk (heap, next);
+        __canary_cursor_fix (heap, next, new);
         next = __get_next_chunk (new);
     }
     else
@@ -572,6 +623,303 @@ char * heap_realloc (heap_t * heap, char * ptr, size_t size)
     return ptr;
 }
 
+#if (LOSCFG_HEAP_CANARY == YES)
+
+static inline void __canary_set (char * raw, size_t off, size_t bytes)
+{
+    canary_t * head = (canary_t *) raw;
+    char     * user = raw + off;
+    UINT32     tail = HEAP_CANARY_TAIL;
+
+    head->size = bytes;
+    head->magic = HEAP_CANARY_MAGIC | off;
+
+    ((UINT32 *) user) [-1] = head->magic;
+
+    /* the tail may be unaligned, the overrun in the round up padding is caught too */
+
+    memcpy (user + bytes, &tail, HEAP_CANARY_TAIL_SIZE);
+}
+
+/**
+ * __canary_verify - verify the guard words of an allocated block
+ * @raw:   the raw memory block
+ * @limit: the end of the chunk, the size in the head must not beyond it
+ *
+ * return: 0 if the guard words are intact, -1 if corrupted
+ */
+
+static inline int __canary_verify (char * raw, char * limit)
+{
+    canary_t * head = (canary_t *) raw;
+    size_t     off  = head->magic & HEAP_CANARY_OFFSET_MASK;
+    char     * user = raw + off;
+    UINT32     tail;
+
+    if (((head->magic & HEAP_CANARY_MAGIC_MASK) != HEAP_CANARY_MAGIC) ||
+        (off < HEAP_CANARY_HEAD_SIZE) ||
+        ((user + head->size + HEAP_CANARY_TAIL_SIZE) > limit) ||
+        (((UINT32 *) user) [-1] != head->magic))
+    {
+        return -1;
+    }
+
+    memcpy (&tail, user + head->size, HEAP_CANARY_TAIL_SIZE);
+
+    return tail == HEAP_CANARY_TAIL ? 0 : -1;
+}
+
+/**
+ * __canary_raw - get the raw memory block and check the guard words
+ * @mem: the memory returned to the user
+ *
+ * return: the raw memory block or NULL if corrupted
+ */
+
+static char * __canary_raw (char * mem)
+{
+    UINT32    magic = ((UINT32 *) mem) [-1];
+    char    * raw;
+    chunk_t * chunk;
+
+    if ((magic & HEAP_CANARY_MAGIC_MASK) != HEAP_CANARY_MAGIC)
+    {
+        PRINT_ERR ("heap canary: %p head corrupted\n\r", mem);
+        return NULL;
+    }
+
+    raw   = mem - (magic & HEAP_CANARY_OFFSET_MASK);
+    chunk = (chunk_t *) __get_ach_from_mem (raw);
+
+    if (__canary_verify (raw, (char *) __get_next_chunk (chunk)) != 0)
+    {
+        PRINT_ERR ("heap canary: %p size %d corrupted\n\r", mem, ((canary_t *) raw)->size);
+        return NULL;
+    }
+
+    return raw;
+}
+
+char * heap_alloc_align (heap_t * heap, size_t align, size_t bytes)
+{
+    char   * raw;
+    size_t   off = align < HEAP_CANARY_HEAD_SIZE ? HEAP_CANARY_HEAD_SIZE : align;
+
+    if (off > HEAP_CANARY_OFFSET_MASK)
+    {
+        return NULL;
+    }
+
+    raw = __heap_alloc_align (heap, align, off + bytes + HEAP_CANARY_TAIL_SIZE);
+
+    if (raw == NULL)
+    {
+        return NULL;
+    }
+
+    __canary_set (raw, off, bytes);
+
+    return raw + off;
+}
+
+int heap_free (heap_t * heap, char * mem)
+{
+    char * raw;
+
+    if ((heap == NULL) || (mem == NULL))
+    {
+        return heap == NULL ? -1 : 0;
+    }
+
+    raw = __canary_raw (mem);
+
+    if (raw == NULL)
+    {
+        heap->canary_errors++;
+
+        return -1;              /* leak it rather than spread the corruption */
+    }
+
+    return __heap_free (heap, raw);
+}
+
+char * heap_realloc (heap_t * heap, char * ptr, size_t size)
+{
+    char   * raw;
+    size_t   off;
+
+    if ((ptr == NULL) || (size == 0))
+    {
+        if (ptr == NULL)
+        {
+            return heap_alloc (heap, size);
+        }
+
+        (void) heap_free (heap, ptr);
+        return NULL;
+    }
+
+    raw = __canary_raw (ptr);
+
+    if (raw == NULL)
+    {
+        heap->canary_errors++;
+
+        return NULL;
+    }
+
+    off = ((canary_t *) raw)->magic & HEAP_CANARY_OFFSET_MASK;
+
+    raw = __heap_realloc (heap, raw, off + size + HEAP_CANARY_TAIL_SIZE);
+
+    if (raw == NULL)
+    {
+        return NULL;
+    }
+
+    __canary_set (raw, off, size);
+
+    return raw + off;
+}
+
+/**
+ * __canary_chunk_verify - verify an allocated chunk found by the sweep
+ * @chunk: the allocated chunk
+ *
+ * return: 0 if the guard words are intact, -1 if corrupted
+ */
+
+static int __canary_chunk_verify (chunk_t * chunk)
+{
+    char      * mem   = __get_mem_block (chunk);
+    char      * limit = (char *) __get_next_chunk (chunk);
+    uintptr_t * p;
+
+    if (__canary_verify (mem, limit) == 0)
+    {
+        return 0;
+    }
+
+    /*
+     * after an aligned alloc, there may be a pointer to the chunk in front of
+     * the raw memory block, refer to <__get_ach_from_mem>; the scan must stay
+     * in this chunk, the head of the next chunk points back to this one too
+     */
+
+    for (p = (uintptr_t *) mem; (char *) p < (mem + sizeof (chunk_t)); p++)
+    {
+        if ((char *) (p + 1) + HEAP_CANARY_HEAD_SIZE > limit)
+        {
+            break;
+        }
+
+        if (*p == (uintptr_t) chunk)
+        {
+            return __canary_verify ((char *) (p + 1), limit);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * heap_canary_check - check the guard words of the allocated blocks
+ * @heap:   the heap to check
+ * @chunks: how many chunks to check, the next call continues from where stopped
+ * @wait:   wait for the heap lock or give up when it is busy
+ *
+ * return: how many corrupted blocks found, negtive value on error
+ */
+
+int heap_canary_check (heap_t * heap, unsigned int chunks, bool wait)
+{
+    int       errors = 0;
+    chunk_t * chunk;
+
+    if (heap == NULL)
+    {
+        return -1;
+    }
+
+    if (LOS_MuxPend (heap->mux, wait ? LOS_WAIT_FOREVER : 0) != LOS_OK)
+    {
+        return 0;
+    }
+
+    while ((chunks-- > 0) && (heap->blocks != NULL))
+    {
+        if (heap->canary_cursor == NULL)
+        {
+            heap->canary_block = (heap->canary_block == NULL) ? heap->blocks :
+                                  heap->canary_block->next;
+
+            if (heap->canary_block == NULL)
+            {
+                heap->canary_block = heap->blocks;
+            }
+
+            heap->canary_cursor = (chunk_t *) (heap->canary_block + 1);
+        }
+
+        chunk = heap->canary_cursor;
+
+        /* the ending guard, step to the next block */
+
+        if ((chunk->prev != NULL) && (chunk->size == (sizeof (ach_t) | 1)))
+        {
+            heap->canary_cursor = NULL;
+            continue;
+        }
+
+        if ((chunk->prev != NULL) && !__is_free (chunk) &&
+            (__canary_chunk_verify (chunk) != 0))
+        {
+            PRINT_ERR ("heap canary: chunk %p size %d corrupted\n\r", chunk, chunk->size & ~1);
+            errors++;
+        }
+
+        heap->canary_cursor = __get_next_chunk (chunk);
+    }
+
+    heap->canary_errors += errors;
+
+    (void) LOS_MuxPost (heap->mux);
+
+    return errors;
+}
+
+#else
+
+char * heap_alloc_align (heap_t * heap, size_t align, size_t bytes)
+{
+    return __heap_alloc_align (heap, align, bytes);
+}
+
+int heap_free (heap_t * heap, char * mem)
+{
+    return __heap_free (heap, mem);
+}
+
+char * heap_realloc (heap_t * heap, char * ptr, size_t size)
+{
+    return __heap_realloc (heap, ptr, size);
+}
+
+#endif
+
+/**
+ * heap_alloc - allocate a block of memory from a heap
+ * @heap:  the heap to allocate from
+ * @bytes: size of memory in bytes to allocate
+ *
+ * return: the allocated memory block or NULL if fail
+ */
+
+char * heap_alloc (heap_t * heap, size_t bytes)
+{
+    return heap_alloc_align (heap, ALLOC_ALIGN_SIZE, bytes);
+}
+
 #if (LOSCFG_MEM_STATISTICS == YES)
 int heap_stat_get (heap_t * heap, mem_stat_t * stat)
     {
@@ -40,6 +40,8 @@
 
 #include <mem.h>
 #include <heap.h>
+#include <los_sys.h>
+#include <los_memory.ph>
 
 #ifdef LOSCFG_ENABLE_MPU
 #include <los_task.ph>
@@ -225,6 +227,34 @@ LITE_OS_SEC_TEXT VOID *LOS_MemAllocAlign(VOID *pPool, UINT32 uwSize, UINT32 uwBo
 *****************************************************************************/
 LITE_OS_SEC_TEXT_MINOR VOID *LOS_MemRealloc(VOID *pPool, VOID *pPtr, UINT32 uwSize)
 {
+#if (LOSCFG_KERNEL_MEM_SLAB == YES)
+    VOID *pRet;
+    UINT32 uwOldSize;
+
+    if ((NULL != pPool) && (NULL != pPtr) && (0 != uwSize))
+    {
+        /* the slab block can not grow, move it while the heap block grows in place if possible */
+
+        uwOldSize = osSlabMemCheck(pPool, pPtr);
+        if (uwOldSize != (UINT32)-1)
+        {
+            if (uwSize <= uwOldSize)
+            {
+                return pPtr;
+            }
+
+            pRet = osHeapAlloc((heap_t *) pPool, uwSize);
+            if (pRet != NULL)
+            {
+                (VOID)memcpy(pRet, pPtr, uwOldSize);
+                (VOID)osSlabMemFree(pPool, pPtr);
+            }
+
+            return pRet;
+        }
+    }
+#endif
+
     return osHeapRealloc((heap_t *) pPool, pPtr, uwSize);
 }
 
@@ -263,6 +293,45 @@ VOID * osSlabCtrlHdrGet (VOID * pPool)
 #endif
 }
 
+#if (LOSCFG_HEAP_CANARY == YES)
+/*****************************************************************************
+ Function : LOS_MemCanaryCheck
+ Description : Check the canary guard words of the allocated memory
+ Input       : pPool    --- Pointer to memory pool, NULL means the kernel pool
+               uwChunks --- How many memory nodes to check
+ Output      : None
+ Return      : LOS_OK - no corrupted memory, LOS_NOK - corrupted memory found
+*****************************************************************************/
+LITE_OS_SEC_TEXT_MINOR UINT32 LOS_MemCanaryCheck(VOID *pPool, UINT32 uwChunks)
+{
+    heap_t * pHeap = pPool == NULL ? (heap_t *) m_aucSysMem0 : (heap_t *) pPool;
+
+    return heap_canary_check (pHeap, uwChunks, true) == 0 ? LOS_OK : LOS_NOK;
+}
+
+/*****************************************************************************
+ Function : osHeapCanarySweep
+ Description : Rate-limited canary sweep of the kernel pool, called by the idle task
+ Input       : None
+ Output      : None
+ Return      : None
+*****************************************************************************/
+LITE_OS_SEC_TEXT VOID osHeapCanarySweep(VOID)
+{
+    static UINT64 ullLastTick = 0;
+    UINT64        ullTick = LOS_TickCountGet();
+
+    if ((m_aucSysMem0 == NULL) || ((ullTick - ullLastTick) < LOSCFG_HEAP_CANARY_SWEEP_TICKS))
+    {
+        return;
+    }
+
+    ullLastTick = ullTick;
+
+    (VOID) heap_canary_check ((heap_t *) m_aucSysMem0, LOSCFG_HEAP_CANARY_SWEEP_CHUNKS, false);
+}
+#endif
+
 VOID LOS_MemInfo (VOID * pPool, BOOL bShowDetail)
     {
     heap_t * pHeap = pPool == NULL ? (heap_t *) m_aucSysMem0 : (heap_t *) pPool;
@@ -36,6 +36,16 @@
 #include "los_hwi.h"
 #include "los_membox.ph"
 
+#if (LOSCFG_MEMBOX_LOCKFREE == YES)
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#include "cmsis_compiler.h"
+#define OS_MEMBOX_CAS_LDREX
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define OS_MEMBOX_CAS_C11
+#endif
+#endif
+
 #if (LOSCFG_PLATFORM_EXC == YES)
 #include "los_memcheck.ph"
 #endif
@@ -75,6 +85,101 @@ extern "C" {
 #define OS_MEMBOX_USER_ADDR(addr)  ((VOID *)((UINT8 *)(addr) + LOS_MEMBOX_MAGIC_SIZE))
 #define OS_MEMBOX_NODE_ADDR(addr)  ((LOS_MEMBOX_NODE *)((UINT8 *)(addr) - LOS_MEMBOX_MAGIC_SIZE))
 
+#if (LOSCFG_MEMBOX_LOCKFREE == YES)
+/**
+ * The lock-free free list head keeps a 16 bits ABA tag in the high half and the index + 1 of the
+ * first free block in the low half, 0 in the low half means the free list is empty.
+ * A free block keeps the encoded index of the next free block in its first word.
+ */
+#define OS_MEMBOX_HEAD_IDX_MASK          0x0000FFFF
+#define OS_MEMBOX_HEAD_TAG_STEP          0x00010000
+#define OS_MEMBOX_HEAD_IDX(head)         ((head) & OS_MEMBOX_HEAD_IDX_MASK)
+#define OS_MEMBOX_HEAD_MAKE(head, idx)   ((((head) + OS_MEMBOX_HEAD_TAG_STEP) & ~OS_MEMBOX_HEAD_IDX_MASK) | (idx))
+#define OS_MEMBOX_NODE_LINK(node)        (*(volatile UINT32 *)(node))
+#define OS_MEMBOX_NODE_AT(info, idx)     ((LOS_MEMBOX_NODE *)((UINT8 *)((info) + 1) + ((idx) - 1) * (info)->uwBlkSize))
+#define OS_MEMBOX_NODE_IDX(info, node)   ((((UINT32)((UINT8 *)(node) - (UINT8 *)((info) + 1))) / (info)->uwBlkSize) + 1)
+
+/*****************************************************************************
+ Function : osMemboxCas
+ Description : Compare and swap a word, LDREX/STREX on armv7-m, C11 atomics on the host,
+               and a short interrupt lock on the cores without exclusive access (armv6-m)
+ Input       : puwAddr  --- Pointer to the word
+               uwOld    --- The expected value
+               uwNew    --- The value to store
+ Output      : None
+ Return      : TRUE - swapped, FALSE - the word has been changed by others
+*****************************************************************************/
+LITE_OS_SEC_TEXT static INLINE BOOL osMemboxCas(volatile UINT32 *puwAddr, UINT32 uwOld, UINT32 uwNew)
+{
+#if defined(OS_MEMBOX_CAS_LDREX)
+    if (__LDREXW(puwAddr) != uwOld)
+    {
+        __CLREX();
+        return FALSE;
+    }
+    return (__STREXW(uwNew, puwAddr) == 0) ? TRUE : FALSE;
+#elif defined(OS_MEMBOX_CAS_C11)
+    return atomic_compare_exchange_weak((volatile _Atomic UINT32 *)puwAddr, &uwOld, uwNew) ? TRUE : FALSE;
+#else
+    BOOL bRet = FALSE;
+    UINTPTR uvIntSave;
+
+    uvIntSave = LOS_IntLock();
+    if (*puwAddr == uwOld)
+    {
+        *puwAddr = uwNew;
+        bRet = TRUE;
+    }
+    (VOID)LOS_IntRestore(uvIntSave);
+
+    return bRet;
+#endif
+}
+
+/*****************************************************************************
+ Function : osMemboxAtomicAdd
+ Description : Add a signed value to a word and return the new value
+ Input       : puwAddr  --- Pointer to the word
+               swValue  --- The value to add
+ Output      : None
+ Return      : The new value
+*****************************************************************************/
+LITE_OS_SEC_TEXT static INLINE UINT32 osMemboxAtomicAdd(volatile UINT32 *puwAddr, INT32 swValue)
+{
+    UINT32 uwOld;
+
+    do
+    {
+        uwOld = *puwAddr;
+    } while (osMemboxCas(puwAddr, uwOld, uwOld + (UINT32)swValue) != TRUE);
+
+    return uwOld + (UINT32)swValue;
+}
+
+/*****************************************************************************
+ Function : osMemboxPeakUpdate
+ Description : Raise the peak number of allocated blocks if it is exceeded
+ Input       : pstBoxInfo  --- Pointer to the memory pool
+               uwBlkCnt    --- The number of allocated blocks now
+ Output      : None
+ Return      : None
+*****************************************************************************/
+LITE_OS_SEC_TEXT static INLINE VOID osMemboxPeakUpdate(LOS_MEMBOX_INFO *pstBoxInfo, UINT32 uwBlkCnt)
+{
+    volatile UINT32 *puwPeak = (volatile UINT32 *)&pstBoxInfo->uwMaxBlkCnt;
+    UINT32 uwOld;
+
+    do
+    {
+        uwOld = *puwPeak;
+        if (uwOld >= uwBlkCnt)
+        {
+            return;
+        }
+    } while (osMemboxCas(puwPeak, uwOld, uwBlkCnt) != TRUE);
+}
+#endif
+
 
 /*****************************************************************************
  Function : osCheckBoxMem
@@ -142,6 +247,8 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pBoxMem, UINT32 uwBoxSize, UIN
     pstBoxInfo->uwBlkSize = LOS_MEMBOX_ALIGNED(uwBlkSize + LOS_MEMBOX_MAGIC_SIZE);
     pstBoxInfo->uwBlkNum = (uwBoxSize - sizeof(LOS_MEMBOX_INFO)) / pstBoxInfo->uwBlkSize;
     pstBoxInfo->uwBlkCnt = 0;
+    pstBoxInfo->uwMaxBlkCnt = 0;
+    pstBoxInfo->uwFailCnt = 0;
 
     if (pstBoxInfo->uwBlkNum == 0)
     {
@@ -149,6 +256,26 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pBoxMem, UINT32 uwBoxSize, UIN
         return LOS_NOK;
     }
 
+#if (LOSCFG_MEMBOX_LOCKFREE == YES)
+    /*
+     * The free list is linked by block index, the blocks beyond the index range are ignored.
+     */
+    if (pstBoxInfo->uwBlkNum > LOS_MEMBOX_LOCKFREE_BLK_MAX)
+    {
+        pstBoxInfo->uwBlkNum = LOS_MEMBOX_LOCKFREE_BLK_MAX;
+    }
+
+    pstNode = (LOS_MEMBOX_NODE *)(pstBoxInfo + 1);
+    pstBoxInfo->stFreeList.pstNext = NULL;
+    pstBoxInfo->uwFreeHead = 1;
+
+    for (i = 1; i < pstBoxInfo->uwBlkNum; ++i)
+    {
+        OS_MEMBOX_NODE_LINK(pstNode) = i + 1;
+        pstNode = OS_MEMBOX_NODE_NEXT(pstNode, pstBoxInfo->uwBlkSize);
+    }
+    OS_MEMBOX_NODE_LINK(pstNode) = 0;  /* The last node */
+#else
     pstNode = (LOS_MEMBOX_NODE *)(pstBoxInfo + 1);
     pstBoxInfo->stFreeList.pstNext = pstNode;
 
@@ -158,6 +285,7 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pBoxMem, UINT32 uwBoxSize, UIN
         pstNode = pstNode->pstNext;
     }
     pstNode->pstNext = (LOS_MEMBOX_NODE *)NULL;  /* The last node */
+#endif
 
 #if ((LOSCFG_PLATFORM_EXC == YES) && (LOSCFG_SAVE_EXC_INFO == YES))
     osMemInfoUpdate(pBoxMem, uwBoxSize, MEM_MANG_MEMBOX);
@@ -175,6 +303,42 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_MemboxInit(VOID *pBoxMem, UINT32 uwBoxSize, UIN
  Output      : None
  Return      : Pointer to allocated memory block
 *****************************************************************************/
+#if (LOSCFG_MEMBOX_LOCKFREE == YES)
+LITE_OS_SEC_TEXT VOID *LOS_MemboxAlloc(VOID *pBoxMem)
+{
+    LOS_MEMBOX_INFO *pstBoxInfo = (LOS_MEMBOX_INFO *)pBoxMem;
+    LOS_MEMBOX_NODE *pRet = NULL;
+    UINT32 uwHead;
+    UINT32 uwNext;
+
+    if (pBoxMem == NULL)
+    {
+        return NULL;
+    }
+
+    /*
+     * Treiber stack pop, the link read from a block which has been taken by others may be garbage,
+     * but the tag of the head has changed then and the swap fails.
+     */
+    do
+    {
+        uwHead = pstBoxInfo->uwFreeHead;
+        if (OS_MEMBOX_HEAD_IDX(uwHead) == 0)
+        {
+            (VOID)osMemboxAtomicAdd(&pstBoxInfo->uwFailCnt, 1);
+            return NULL;
+        }
+
+        pRet = OS_MEMBOX_NODE_AT(pstBoxInfo, OS_MEMBOX_HEAD_IDX(uwHead));
+        uwNext = OS_MEMBOX_NODE_LINK(pRet) & OS_MEMBOX_HEAD_IDX_MASK;
+    } while (osMemboxCas(&pstBoxInfo->uwFreeHead, uwHead, OS_MEMBOX_HEAD_MAKE(uwHead, uwNext)) != TRUE);
+
+    OS_MEMBOX_SET_MAGIC(pRet);
+    osMemboxPeakUpdate(pstBoxInfo, osMemboxAtomicAdd(&pstBoxInfo->uwBlkCnt, 1));
+
+    return OS_MEMBOX_USER_ADDR(pRet);
+}
+#else
 LITE_OS_SEC_TEXT VOID *LOS_MemboxAlloc(VOID *pBoxMem)
 {
     LOS_MEMBOX_INFO *pstBoxInfo = (LOS_MEMBOX_INFO *)pBoxMem;
@@ -196,12 +360,21 @@ LITE_OS_SEC_TEXT VOID *LOS_MemboxAlloc(VOID *pBoxMem)
         pstNode->pstNext = pRet->pstNext;
         OS_MEMBOX_SET_MAGIC(pRet);
         pstBoxInfo->uwBlkCnt++;
+        if (pstBoxInfo->uwBlkCnt > pstBoxInfo->uwMaxBlkCnt)
+        {
+            pstBoxInfo->uwMaxBlkCnt = pstBoxInfo->uwBlkCnt;
+        }
+    }
+    else
+    {
+        pstBoxInfo->uwFailCnt++;
     }
 
     (VOID)LOS_IntRestore(uvIntSave);
 
     return pRet == NULL ? NULL : OS_MEMBOX_USER_ADDR(pRet);
 }
+#endif
 
 /*****************************************************************************
  Function : LOS_MemboxFree
@@ -211,6 +384,40 @@ LITE_OS_SEC_TEXT VOID *LOS_MemboxAlloc(VOID *pBoxMem)
  Output      : None
  Return      : LOS_OK - OK, LOS_NOK - Error
 *****************************************************************************/
+#if (LOSCFG_MEMBOX_LOCKFREE == YES)
+LITE_OS_SEC_TEXT UINT32 LOS_MemboxFree(VOID *pBoxMem, VOID *pBox)
+{
+    LOS_MEMBOX_INFO *pstBoxInfo = (LOS_MEMBOX_INFO *)pBoxMem;
+    LOS_MEMBOX_NODE *pstNode = NULL;
+    UINT32 uwHead;
+    UINT32 uwIdx;
+
+    if (pBoxMem == NULL || pBox == NULL)
+    {
+        return LOS_NOK;
+    }
+
+    pstNode = OS_MEMBOX_NODE_ADDR(pBox);
+    if (osCheckBoxMem(pstBoxInfo, pstNode) != LOS_OK)
+    {
+        return LOS_NOK;
+    }
+
+    uwIdx = OS_MEMBOX_NODE_IDX(pstBoxInfo, pstNode);
+
+    /* count down before the block is visible to others, so the count never exceeds the blocks in use */
+    (VOID)osMemboxAtomicAdd(&pstBoxInfo->uwBlkCnt, -1);
+
+    /* the link overwrites the magic word, so a second free of this block is rejected above */
+    do
+    {
+        uwHead = pstBoxInfo->uwFreeHead;
+        OS_MEMBOX_NODE_LINK(pstNode) = OS_MEMBOX_HEAD_IDX(uwHead);
+    } while (osMemboxCas(&pstBoxInfo->uwFreeHead, uwHead, OS_MEMBOX_HEAD_MAKE(uwHead, uwIdx)) != TRUE);
+
+    return LOS_OK;
+}
+#else
 LITE_OS_SEC_TEXT UINT32 LOS_MemboxFree(VOID *pBoxMem, VOID *pBox)
 {
     LOS_MEMBOX_INFO *pstBoxInfo = (LOS_MEMBOX_INFO *)pBoxMem;
@@ -243,6 +450,7 @@ LITE_OS_SEC_TEXT UINT32 LOS_MemboxFree(VOID *pBoxMem, VOID *pBox)
 
     return uwRet;
 }
+#endif
 
 /*****************************************************************************
  Function : LOS_MemboxClr
@@ -287,6 +495,27 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_MemboxStatisticsGet(VOID *pBoxMem, UINT32 *puw
     return LOS_OK;
 }
 
+/*****************************************************************************
+ Function : LOS_MemboxWaterLineGet
+ Description : Get the water line of membox
+ Input       : pBoxMem       --- Pointer to the membox
+ Output      : puwMaxBlkCnt  --- Record the peak number of allocated blocks
+               puwFailCnt    --- Record the number of failed allocations
+ Return      : LOS_OK - OK, LOS_NOK - Error
+*****************************************************************************/
+LITE_OS_SEC_TEXT_MINOR UINT32 LOS_MemboxWaterLineGet(VOID *pBoxMem, UINT32 *puwMaxBlkCnt, UINT32 *puwFailCnt)
+{
+    if ((NULL == pBoxMem) || (NULL == puwMaxBlkCnt) || (NULL == puwFailCnt))
+    {
+        return LOS_NOK;
+    }
+
+    *puwMaxBlkCnt = ((LOS_MEMBOX_INFO *)pBoxMem)->uwMaxBlkCnt;  /* The peak number of allocated blocks */
+    *puwFailCnt = ((LOS_MEMBOX_INFO *)pBoxMem)->uwFailCnt;      /* The number of failed allocations */
+
+    return LOS_OK;
+}
+
 #ifdef __cplusplus
 #if __cplusplus
 }
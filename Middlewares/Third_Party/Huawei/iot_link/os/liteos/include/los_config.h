@@ -436,6 +436,39 @@ extern UINT32 g_sys_mem_addr_end;
 #define LOSCFG_MEM_MUL_POOL                                 NO
 #endif
 
+/**
+ * @ingroup los_config
+ * Configuration item for the lock-free membox, alloc and free will not disable the interrupt
+ */
+#ifndef LOSCFG_MEMBOX_LOCKFREE
+#define LOSCFG_MEMBOX_LOCKFREE                              NO
+#endif
+
+/**
+ * @ingroup los_config
+ * Configuration item for the heap canary, every heap block gets the head and tail guard words
+ * which are verified on free and by the rate-limited sweep in the idle task
+ */
+#ifndef LOSCFG_HEAP_CANARY
+#define LOSCFG_HEAP_CANARY                                  NO
+#endif
+
+/**
+ * @ingroup los_config
+ * The idle task sweeps the heap canary every LOSCFG_HEAP_CANARY_SWEEP_TICKS ticks
+ */
+#ifndef LOSCFG_HEAP_CANARY_SWEEP_TICKS
+#define LOSCFG_HEAP_CANARY_SWEEP_TICKS                      100
+#endif
+
+/**
+ * @ingroup los_config
+ * How many heap blocks are checked in each canary sweep
+ */
+#ifndef LOSCFG_HEAP_CANARY_SWEEP_CHUNKS
+#define LOSCFG_HEAP_CANARY_SWEEP_CHUNKS                     16
+#endif
+
 /**
  * @ingroup los_config
  * Configuration module tailoring of slab memory
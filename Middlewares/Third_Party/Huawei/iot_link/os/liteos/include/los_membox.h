@@ -72,9 +72,20 @@ typedef struct
    UINT32           uwBlkSize;                  /* Block size */
    UINT32           uwBlkNum;                   /* Total number of blocks */
    UINT32           uwBlkCnt;                   /* The number of allocated blocks */
+   UINT32           uwMaxBlkCnt;                /* The peak number of allocated blocks */
+   UINT32           uwFailCnt;                  /* The number of failed allocations */
+#if (LOSCFG_MEMBOX_LOCKFREE == YES)
+   volatile UINT32  uwFreeHead;                 /* Lock-free free list head: tag(16) | index + 1(16) */
+#endif
    LOS_MEMBOX_NODE  stFreeList;                 /* Free list */
 } LOS_MEMBOX_INFO;
 
+/**
+ * @ingroup los_membox
+ * Maximum number of blocks in a lock-free memory pool, the free list head keeps the block index in 16 bits
+ */
+#define LOS_MEMBOX_LOCKFREE_BLK_MAX         0xFFFF
+
 /**
  * @ingroup los_membox
  * Default enabled membox's magic word detection function, this makes each block of membox
@@ -239,6 +250,33 @@ extern VOID LOS_MemboxClr(VOID *pBoxMem, VOID *pBox);
  */
 extern UINT32 LOS_MemboxStatisticsGet(VOID *pBoxMem, UINT32 *puwMaxBlk, UINT32 *puwBlkCnt, UINT32 *puwBlkSize);
 
+/**
+ *@ingroup los_membox
+ *@brief Get the water line of a membox.
+ *
+ *@par Description:
+ *<ul>
+ *<li>This API is used to get the peak number of allocated blocks and the number of failed allocations of a membox.</li>
+ *</ul>
+ *@attention
+ *<ul>
+ *<li>The counters are updated without disabling interrupts when LOSCFG_MEMBOX_LOCKFREE is enabled, so the
+ *values read here are a snapshot and may be stale as soon as they are returned.</li>
+ *</ul>
+ *
+ *@param  pBoxMem        [IN]  Type  #VOID*   Pointer to the membox.
+ *@param  puwMaxBlkCnt   [OUT] Type  #UINT32* Record the peak number of allocated blocks.
+ *@param  puwFailCnt     [OUT] Type  #UINT32* Record the number of failed allocations.
+ *
+ *@retval #LOS_OK        The water line is got successfully.
+ *@retval #LOS_NOK       The input parameter is invalid.
+ *@par Dependency:
+ *<ul><li>los_membox.h: the header file that contains the API declaration.</li></ul>
+ *@see LOS_MemboxStatisticsGet
+ *@since Huawei LiteOS V100R001C00
+ */
+extern UINT32 LOS_MemboxWaterLineGet(VOID *pBoxMem, UINT32 *puwMaxBlkCnt, UINT32 *puwFailCnt);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -582,6 +582,35 @@ extern UINT32 LOS_MemPoolList(VOID);
  */
 
 extern VOID LOS_MemInfo (VOID * pPool, BOOL bShowDetail);
+
+#if (LOSCFG_HEAP_CANARY == YES)
+/**
+ *@ingroup los_memory
+ *@brief Check the canary guard words of the allocated memory.
+ *
+ *@par Description:
+ *<ul>
+ *<li>This API is used to check the head and tail guard words of the allocated memory in a pool.</li>
+ *</ul>
+ *@attention
+ *<ul>
+ *<li>The check continues from where the last call stopped, so the whole pool is covered by the successive calls.</li>
+ *<li>The idle task calls it on the kernel pool every LOSCFG_HEAP_CANARY_SWEEP_TICKS ticks.</li>
+ *</ul>
+ *
+ *@param pPool          [IN] Starting address of pool, if NULL, use kernel pool.
+ *@param uwChunks       [IN] How many memory nodes to check.
+ *
+ *@retval #LOS_OK       No corrupted memory found.
+ *@retval #LOS_NOK      Corrupted memory found, the details are printed.
+ *@par Dependency:
+ *<ul>
+ *<li>los_memory.h: the header file that contains the API declaration.</li>
+ *</ul>
+ *@see LOS_MemInfo
+ */
+extern UINT32 LOS_MemCanaryCheck(VOID *pPool, UINT32 uwChunks);
+#endif
 #endif
 
 #ifdef __cplusplus
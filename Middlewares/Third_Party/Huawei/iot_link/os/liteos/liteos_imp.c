@@ -210,6 +210,68 @@ static bool_t  __semp_del(osal_semp_t semp)
 }
 
 
+///< this is implement for the queue, which copies the message
+static bool_t  __queue_create(osal_queue_t *queue,int len,int msgsize)
+{
+    if(LOS_OK == LOS_QueueCreate("osal",(UINT16)len,(UINT32 *)queue,0,(UINT16)msgsize))
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+static bool_t  __queue_send(osal_queue_t queue,void *pbuf,unsigned int bufsize,unsigned int timeout)
+{
+    if(timeout == cn_osal_timeout_forever)
+    {
+        timeout = LOS_WAIT_FOREVER;
+    }
+
+    if(LOS_OK == LOS_QueueWriteCopy((UINT32)(uintptr_t)queue,pbuf,(UINT32)bufsize,(UINT32)timeout))
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+static bool_t  __queue_recv(osal_queue_t queue,void *pbuf,unsigned int bufsize,unsigned int timeout)
+{
+    UINT32 size = (UINT32)bufsize;
+
+    if(timeout == cn_osal_timeout_forever)
+    {
+        timeout = LOS_WAIT_FOREVER;
+    }
+
+    if(LOS_OK == LOS_QueueReadCopy((UINT32)(uintptr_t)queue,pbuf,&size,(UINT32)timeout))
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+static bool_t  __queue_del(osal_queue_t queue)
+{
+    if(LOS_OK == LOS_QueueDelete((UINT32)(uintptr_t)queue))
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
 ///< this implement for the memory management
 #include <los_memory.h>
 
@@ -237,6 +299,92 @@ void *los_mem_realloc(void *old, int newlen)
     return LOS_MemRealloc(m_aucSysMem0, old, newlen);
 }
 
+static void *__mem_pool_create(void *base, int size)
+{
+    void *ret = NULL;
+
+    if((size > 0) && (LOS_OK == LOS_MemInit(base, (UINT32)size)))
+    {
+        ret = base;
+    }
+
+    return ret;
+}
+
+static void *__mem_pool_malloc(void *pool, int size)
+{
+    void *ret = NULL;
+
+    if(size > 0)
+    {
+        ret = LOS_MemAlloc(pool, (UINT32)size);
+    }
+
+    return ret;
+}
+
+static void __mem_pool_free(void *pool, void *addr)
+{
+    (void) LOS_MemFree(pool, addr);
+}
+
+static void *__mem_pool_realloc(void *pool, void *addr, int newsize)
+{
+    void *ret = NULL;
+
+    if(newsize > 0)
+    {
+        ret = LOS_MemRealloc(pool, addr, (UINT32)newsize);
+    }
+
+    return ret;
+}
+
+
+///< this implement for the fixed block memory used by the object pool
+#include <los_membox.h>
+
+static int __box_size(int blksize, int blknum)
+{
+    return (int)LOS_MEMBOX_SIZE((UINT32)blksize, (UINT32)blknum);
+}
+
+static bool_t __box_init(void *box, int size, int blksize)
+{
+    return (LOS_OK == LOS_MemboxInit(box, (UINT32)size, (UINT32)blksize)) ? true : false;
+}
+
+static void *__box_alloc(void *box)
+{
+    return LOS_MemboxAlloc(box);
+}
+
+static void __box_free(void *box, void *blk)
+{
+    (void) LOS_MemboxFree(box, blk);
+}
+
+static int __box_stat(void *box, int *used, int *peak, int *fail)
+{
+    UINT32 max_blk;
+    UINT32 blk_cnt;
+    UINT32 blk_size;
+    UINT32 max_cnt;
+    UINT32 fail_cnt;
+
+    if((LOS_OK != LOS_MemboxStatisticsGet(box, &max_blk, &blk_cnt, &blk_size)) || \
+       (LOS_OK != LOS_MemboxWaterLineGet(box, &max_cnt, &fail_cnt)))
+    {
+        return -1;
+    }
+
+    *used = (int)blk_cnt;
+    *peak = (int)max_cnt;
+    *fail = (int)fail_cnt;
+
+    return 0;
+}
+
 
 ///< sys time
 #include <los_sys.ph>
@@ -284,8 +432,22 @@ static const tag_os_ops s_liteos_ops =
     .semp_post = __semp_post,
     .semp_del = __semp_del,
 
+    .queue_create = __queue_create,
+    .queue_send = __queue_send,
+    .queue_recv = __queue_recv,
+    .queue_del = __queue_del,
+
     .malloc = __mem_malloc,
     .free = __mem_free,
+    .mem_pool_create = __mem_pool_create,
+    .mem_pool_malloc = __mem_pool_malloc,
+    .mem_pool_free = __mem_pool_free,
+    .mem_pool_realloc = __mem_pool_realloc,
+    .box_size = __box_size,
+    .box_init = __box_init,
+    .box_alloc = __box_alloc,
+    .box_free = __box_free,
+    .box_stat = __box_stat,
 
     .get_sys_time = __get_sys_time,
     .reboot = liteos_reboot,
@@ -48,6 +48,38 @@
 
 static const tag_os *s_os_cb = NULL;
 
+#ifndef CONFIG_OSAL_MEM_REGION_MAX
+#define CONFIG_OSAL_MEM_REGION_MAX   4
+#endif
+
+#ifndef CONFIG_OSAL_MEM_LARGE_SIZE
+#define CONFIG_OSAL_MEM_LARGE_SIZE   4096
+#endif
+
+#ifndef CONFIG_OSAL_SYSHEAP_ATTR
+#define CONFIG_OSAL_SYSHEAP_ATTR     (cn_osal_mem_attr_fast | cn_osal_mem_attr_dma)
+#endif
+
+#define cn_osal_mem_attr_speed       (cn_osal_mem_attr_fast | cn_osal_mem_attr_slow)
+#define cn_osal_mem_region_align     8
+
+typedef struct
+{
+    const char  *name;
+    uintptr_t    start;
+    uintptr_t    end;
+    void        *pool;
+    int          attr;
+}osal_mem_region_t;
+
+typedef struct
+{
+    int                 num;
+    osal_mem_region_t   tab[CONFIG_OSAL_MEM_REGION_MAX];
+}osal_mem_region_cb_t;
+
+static osal_mem_region_cb_t s_mem_region_cb;
+
 int osal_install(const tag_os *os)
 {
     int ret = -1;
@@ -221,6 +253,58 @@ bool_t  osal_semp_del(osal_semp_t semp)
 
 }
 
+bool_t  osal_queue_create(osal_queue_t *queue,int len,int msgsize)
+{
+    bool_t ret = false;
+
+    if((NULL != s_os_cb) &&(NULL != s_os_cb->ops) &&(NULL != s_os_cb->ops->queue_create))
+    {
+        ret = s_os_cb->ops->queue_create(queue,len,msgsize);
+    }
+
+    return ret;
+
+}
+
+bool_t  osal_queue_send(osal_queue_t queue,void *pbuf,unsigned int bufsize,unsigned int timeout)
+{
+    bool_t ret = false;
+
+    if((NULL != s_os_cb) &&(NULL != s_os_cb->ops) &&(NULL != s_os_cb->ops->queue_send))
+    {
+        ret = s_os_cb->ops->queue_send(queue,pbuf,bufsize,timeout);
+    }
+
+    return ret;
+
+}
+
+bool_t  osal_queue_recv(osal_queue_t queue,void *pbuf,unsigned int bufsize,unsigned int timeout)
+{
+    bool_t ret = false;
+
+    if((NULL != s_os_cb) &&(NULL != s_os_cb->ops) &&(NULL != s_os_cb->ops->queue_recv))
+    {
+        ret = s_os_cb->ops->queue_recv(queue,pbuf,bufsize,timeout);
+    }
+
+    return ret;
+
+}
+
+bool_t  osal_queue_del(osal_queue_t queue)
+{
+    bool_t ret = false;
+
+    if((NULL != s_os_cb) &&(NULL != s_os_cb->ops) &&(NULL != s_os_cb->ops->queue_del))
+    {
+        ret = s_os_cb->ops->queue_del(queue);
+    }
+
+    return ret;
+
+}
+
 
 
 void *osal_malloc(size_t size)
@@ -236,10 +320,41 @@ void *osal_malloc(size_t size)
 
 }
 
+static osal_mem_region_t *mem_region_find(void *addr)
+{
+    int i;
+    osal_mem_region_t *region;
+
+    for(i = 0; i < s_mem_region_cb.num; i++)
+    {
+        region = &s_mem_region_cb.tab[i];
+        if(((uintptr_t)addr >= region->start) && ((uintptr_t)addr < region->end))
+        {
+            return region;
+        }
+    }
+
+    return NULL;
+}
+
 void  osal_free(void *addr)
 {
+    osal_mem_region_t *region;
 
-    if((NULL != addr) && (NULL != s_os_cb) &&(NULL != s_os_cb->ops) &&(NULL != s_os_cb->ops->free))
+    if((NULL == addr) || (NULL == s_os_cb) || (NULL == s_os_cb->ops))
+    {
+        return;
+    }
+
+    region = mem_region_find(addr);
+    if(NULL != region)
+    {
+        if(NULL != s_os_cb->ops->mem_pool_free)
+        {
+            s_os_cb->ops->mem_pool_free(region->pool, addr);
+        }
+    }
+    else if(NULL != s_os_cb->ops->free)
     {
         s_os_cb->ops->free(addr);
     }
@@ -247,6 +362,111 @@ void  osal_free(void *addr)
     return;
 }
 
+int osal_mem_region_add(const char *name, void *base, size_t size, int attr)
+{
+    int ret = -1;
+    uintptr_t start;
+    uintptr_t end;
+    void *pool;
+    osal_mem_region_t *region;
+
+    if((NULL == base) || (NULL == s_os_cb) || (NULL == s_os_cb->ops) || \
+       (NULL == s_os_cb->ops->mem_pool_create) || (NULL == s_os_cb->ops->mem_pool_malloc) ||\
+       (s_mem_region_cb.num >= CONFIG_OSAL_MEM_REGION_MAX))
+    {
+        return ret;
+    }
+
+    start = ((uintptr_t)base + cn_osal_mem_region_align - 1) & ~((uintptr_t)cn_osal_mem_region_align - 1);
+    end = (uintptr_t)base + size;
+    if(end <= start)
+    {
+        return ret;
+    }
+
+    pool = s_os_cb->ops->mem_pool_create((void *)start, (int)(end - start));
+    if(NULL != pool)
+    {
+        region = &s_mem_region_cb.tab[s_mem_region_cb.num];
+        region->name = name;
+        region->start = start;
+        region->end = end;
+        region->pool = pool;
+        region->attr = attr;
+        s_mem_region_cb.num++;
+
+        ret = 0;
+    }
+
+    return ret;
+}
+
+///< return 1 if the attributes have all the must ones and the speed wanted(0 means any speed)
+static int mem_region_match(int attr, int must, int speed)
+{
+    if((attr & must) != must)
+    {
+        return 0;
+    }
+
+    if((0 != speed) && (0 == (attr & speed)))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+static void *mem_region_malloc(size_t size, int must, int speed)
+{
+    int i;
+    void *ret = NULL;
+    osal_mem_region_t *region;
+
+    for(i = 0; (NULL == ret) && (i < s_mem_region_cb.num); i++)
+    {
+        region = &s_mem_region_cb.tab[i];
+        if(mem_region_match(region->attr, must, speed))
+        {
+            ret = s_os_cb->ops->mem_pool_malloc(region->pool, (int)size);
+        }
+    }
+
+    if((NULL == ret) && mem_region_match(CONFIG_OSAL_SYSHEAP_ATTR, must, speed) && (NULL != s_os_cb->ops->malloc))
+    {
+        ret = s_os_cb->ops->malloc(size);
+    }
+
+    return ret;
+}
+
+void *osal_malloc_ex(size_t size, int flags)
+{
+    void *ret = NULL;
+    int must;
+    int speed;
+
+    if((0 == size) || (NULL == s_os_cb) || (NULL == s_os_cb->ops))
+    {
+        return ret;
+    }
+
+    must = flags & cn_osal_mem_attr_dma;
+    speed = flags & cn_osal_mem_attr_speed;
+    if(0 == speed)
+    {
+        speed = (size >= CONFIG_OSAL_MEM_LARGE_SIZE) ? cn_osal_mem_attr_slow : cn_osal_mem_attr_fast;
+    }
+
+    ret = mem_region_malloc(size, must, speed);
+    if((NULL == ret) && (0 == (flags & cn_osal_mem_flag_strict)))
+    {
+        ret = mem_region_malloc(size, must, 0);
+    }
+
+    return ret;
+}
+
 void *osal_zalloc(size_t size)
 {
     void *ret = NULL;
@@ -267,8 +487,24 @@ void *osal_zalloc(size_t size)
 void *osal_realloc(void *ptr,size_t newsize)
 {
     void *ret = NULL;
+    osal_mem_region_t *region;
+
+    if((NULL == s_os_cb) || (NULL == s_os_cb->ops))
+    {
+        return ret;
+    }
 
-    if((NULL != s_os_cb) &&(NULL != s_os_cb->ops) &&(NULL != s_os_cb->ops->realloc))
+    ///< the block of a region is resized in its own pool, which keeps its attributes; the system heap
+    ///< never takes it, and the os without the pool realloc leaves it as it was
+    region = (NULL != ptr) ? mem_region_find(ptr) : NULL;
+    if(NULL != region)
+    {
+        if((newsize > 0) && (NULL != s_os_cb->ops->mem_pool_realloc))
+        {
+            ret = s_os_cb->ops->mem_pool_realloc(region->pool, ptr, (int)newsize);
+        }
+    }
+    else if(NULL != s_os_cb->ops->realloc)
     {
         ret = s_os_cb->ops->realloc(ptr,newsize);
     }
@@ -293,6 +529,413 @@ void *osal_calloc(size_t n, size_t size)
     return ret;
 }
 
+///< the object pool, each segment is a fixed block memory supplied by the os
+typedef struct osal_pool_seg
+{
+    struct osal_pool_seg *volatile nxt;
+    uintptr_t                      start;   ///< the box memory start
+    uintptr_t                      end;     ///< the box memory end
+}osal_pool_seg_t;
+#define cn_osal_pool_seg_hdr   ((sizeof(osal_pool_seg_t) + 7) & (~(size_t)7))
+#define osal_pool_seg_box(seg) ((void *)((uintptr_t)(seg) + cn_osal_pool_seg_hdr))
+
+///< the object served by the heap when the pool is exhausted, kept in the list to be told from the
+///< oversize objects the caller got from osal_malloc itself
+typedef struct osal_pool_spill
+{
+    struct osal_pool_spill *nxt;
+}osal_pool_spill_t;
+#define cn_osal_pool_spill_hdr      ((sizeof(osal_pool_spill_t) + 7) & (~(size_t)7))
+#define osal_pool_spill_obj(spill)  ((void *)((uintptr_t)(spill) + cn_osal_pool_spill_hdr))
+
+typedef struct osal_pool
+{
+    struct osal_pool   *nxt;      ///< used for the pool list
+    const char         *name;
+    int                 objsize;
+    int                 count;    ///< objects in each segment
+    int                 grow;     ///< how many segments could be added yet
+    int                 segs;
+    osal_pool_seg_t    *seg_lst;  ///< appended only, so the alloc and free could walk it without lock
+    osal_mutex_t        mutex;    ///< used to protect the segment grow and the statistics here
+    int                 used;     ///< the statistics for the box method not supplied
+    int                 peak;
+    osal_pool_spill_t  *spill_lst;///< the objects from the heap in use
+    int                 heap;     ///< how many in the spill_lst
+    int                 heap_total;
+    int                 fail;
+}osal_pool_t;
+
+static osal_pool_t  *s_pool_lst = NULL;
+static osal_mutex_t  s_pool_mutex = cn_mutex_invalid;
+
+static int pool_box_supported(void)
+{
+    return ((NULL != s_os_cb) && (NULL != s_os_cb->ops) && (NULL != s_os_cb->ops->box_size) &&\
+            (NULL != s_os_cb->ops->box_init) && (NULL != s_os_cb->ops->box_alloc) &&\
+            (NULL != s_os_cb->ops->box_free));
+}
+
+static osal_pool_seg_t *pool_seg_create(osal_pool_t *pool)
+{
+    osal_pool_seg_t *seg;
+    int size;
+
+    size = s_os_cb->ops->box_size(pool->objsize, pool->count);
+    seg = osal_malloc(cn_osal_pool_seg_hdr + size);
+    if(NULL == seg)
+    {
+        return seg;
+    }
+
+    if(false == s_os_cb->ops->box_init(osal_pool_seg_box(seg), size, pool->objsize))
+    {
+        osal_free(seg);
+        return NULL;
+    }
+    seg->nxt = NULL;
+    seg->start = (uintptr_t)osal_pool_seg_box(seg);
+    seg->end = seg->start + size;
+
+    return seg;
+}
+
+static void *pool_seg_alloc(osal_pool_t *pool)
+{
+    void *ret = NULL;
+    osal_pool_seg_t *seg;
+
+    for(seg = pool->seg_lst; (NULL == ret) && (NULL != seg); seg = seg->nxt)
+    {
+        ret = s_os_cb->ops->box_alloc(osal_pool_seg_box(seg));
+    }
+
+    return ret;
+}
+
+static osal_pool_seg_t *pool_seg_find(osal_pool_t *pool, void *obj)
+{
+    osal_pool_seg_t *seg;
+
+    for(seg = pool->seg_lst; NULL != seg; seg = seg->nxt)
+    {
+        if(((uintptr_t)obj >= seg->start) && ((uintptr_t)obj < seg->end))
+        {
+            break;
+        }
+    }
+
+    return seg;
+}
+
+void *osal_pool_create(const char *name, size_t objsize, int count, int grow)
+{
+    osal_pool_t *pool;
+
+    if((0 == objsize) || (count <= 0) || (grow < 0))
+    {
+        return NULL;
+    }
+
+    pool = osal_zalloc(sizeof(osal_pool_t));
+    if(NULL == pool)
+    {
+        return pool;
+    }
+    pool->name = name;
+    pool->objsize = (int)objsize;
+    pool->count = count;
+    pool->grow = grow;
+    pool->mutex = cn_mutex_invalid;
+    if(false == osal_mutex_create(&pool->mutex))
+    {
+        pool->mutex = cn_mutex_invalid;
+        goto EXIT_ERR;
+    }
+
+    if(pool_box_supported())
+    {
+        pool->seg_lst = pool_seg_create(pool);
+        if(NULL == pool->seg_lst)
+        {
+            goto EXIT_ERR;
+        }
+        pool->segs = 1;
+    }
+
+    if(true == osal_mutex_lock(s_pool_mutex))
+    {
+        pool->nxt = s_pool_lst;
+        s_pool_lst = pool;
+        (void) osal_mutex_unlock(s_pool_mutex);
+    }
+
+    return pool;
+
+EXIT_ERR:
+    if(cn_mutex_invalid != pool->mutex)
+    {
+        (void) osal_mutex_del(pool->mutex);
+    }
+    osal_free(pool);
+    return NULL;
+}
+
+void *osal_pool_alloc(void *pool)
+{
+    void *ret = NULL;
+    osal_pool_t *p = pool;
+    osal_pool_seg_t *seg;
+    osal_pool_seg_t *tail;
+    osal_pool_spill_t *spill;
+
+    if(NULL == p)
+    {
+        return ret;
+    }
+
+    if(NULL == p->seg_lst)   ///< no box method supplied by the os
+    {
+        ret = osal_malloc(p->objsize);
+        (void) osal_mutex_lock(p->mutex);
+        if(NULL != ret)
+        {
+            p->used++;
+            p->peak = (p->used > p->peak) ? p->used : p->peak;
+        }
+        else
+        {
+            p->fail++;
+        }
+        (void) osal_mutex_unlock(p->mutex);
+        return ret;
+    }
+
+    ret = pool_seg_alloc(p);
+    if((NULL == ret) && (true == osal_mutex_lock(p->mutex)))
+    {
+        ret = pool_seg_alloc(p);     ///< may be some one has grown it
+        if((NULL == ret) && (p->grow > 0))
+        {
+            seg = pool_seg_create(p);
+            if(NULL != seg)
+            {
+                ret = s_os_cb->ops->box_alloc(osal_pool_seg_box(seg));
+                for(tail = p->seg_lst; NULL != tail->nxt; tail = tail->nxt)
+                {
+                }
+                tail->nxt = seg;
+                p->grow--;
+                p->segs++;
+            }
+        }
+        ///< the pool and its growth are exhausted, the heap serves it as before the pool was there,
+        ///< and osal_pool_free finds it in the spill list to release it
+        if(NULL == ret)
+        {
+            spill = osal_malloc(cn_osal_pool_spill_hdr + p->objsize);
+            if(NULL != spill)
+            {
+                spill->nxt = p->spill_lst;
+                p->spill_lst = spill;
+                p->heap++;
+                p->heap_total++;
+                ret = osal_pool_spill_obj(spill);
+            }
+            else
+            {
+                p->fail++;
+            }
+        }
+        (void) osal_mutex_unlock(p->mutex);
+    }
+
+    return ret;
+}
+
+///< take the object out of the spill list, return the memory to release while NULL means not spilled
+static void *pool_spill_take(osal_pool_t *p, void *obj)
+{
+    osal_pool_spill_t **pre;
+    osal_pool_spill_t *spill = NULL;
+
+    (void) osal_mutex_lock(p->mutex);
+    for(pre = &p->spill_lst; NULL != *pre; pre = &(*pre)->nxt)
+    {
+        if(osal_pool_spill_obj(*pre) == obj)
+        {
+            spill = *pre;
+            *pre = spill->nxt;
+            p->heap--;
+            break;
+        }
+    }
+    (void) osal_mutex_unlock(p->mutex);
+
+    return spill;
+}
+
+void osal_pool_free(void *pool, void *obj)
+{
+    osal_pool_t *p = pool;
+    osal_pool_seg_t *seg = NULL;
+    void *spill = NULL;
+
+    if(NULL == obj)
+    {
+        return;
+    }
+
+    if(NULL != p)
+    {
+        seg = pool_seg_find(p, obj);
+    }
+
+    if(NULL != seg)
+    {
+        s_os_cb->ops->box_free(osal_pool_seg_box(seg), obj);
+    }
+    else if((NULL != p) && (NULL != p->spill_lst) && (NULL != (spill = pool_spill_take(p, obj))))
+    {
+        osal_free(spill);
+    }
+    else
+    {
+        if((NULL != p) && (NULL == p->seg_lst))
+        {
+            (void) osal_mutex_lock(p->mutex);
+            p->used = (p->used > 0) ? (p->used - 1) : 0;
+            (void) osal_mutex_unlock(p->mutex);
+        }
+        osal_free(obj);
+    }
+
+    return;
+}
+
+int osal_pool_stat(void *pool, osal_pool_stat_t *stat)
+{
+    osal_pool_t *p = pool;
+    osal_pool_seg_t *seg;
+    int used;
+    int peak;
+    int fail;
+
+    if((NULL == p) || (NULL == stat))
+    {
+        return -1;
+    }
+
+    (void) memset(stat, 0, sizeof(osal_pool_stat_t));
+    stat->name = p->name;
+    stat->objsize = p->objsize;
+    (void) osal_mutex_lock(p->mutex);
+    stat->segs = p->segs;
+    stat->heap = p->heap;
+    stat->heap_total = p->heap_total;
+    stat->fail = p->fail;
+    if(NULL == p->seg_lst)
+    {
+        stat->used = p->used;
+        stat->peak = p->peak;
+        stat->total = p->count;
+    }
+    (void) osal_mutex_unlock(p->mutex);
+
+    for(seg = p->seg_lst; NULL != seg; seg = seg->nxt)
+    {
+        stat->total += p->count;
+        if((NULL != s_os_cb->ops->box_stat) && \
+           (0 == s_os_cb->ops->box_stat(osal_pool_seg_box(seg), &used, &peak, &fail)))
+        {
+            stat->used += used;
+            stat->peak += peak;
+        }
+    }
+
+    return 0;
+}
+
+int osal_pool_delete(void *pool)
+{
+    osal_pool_t *p = pool;
+    osal_pool_t *tmp;
+    osal_pool_seg_t *seg;
+    osal_pool_stat_t stat;
+
+    if(0 != osal_pool_stat(p, &stat))
+    {
+        return -1;
+    }
+    if((0 != stat.used) || (0 != stat.heap))
+    {
+        LINK_LOG_DEBUG("pool %s not deleted, %d objects and %d from the heap in use\n\r",\
+                (NULL == stat.name) ? "UNKNOWN" : stat.name, stat.used, stat.heap);
+        return -1;
+    }
+
+    if(true == osal_mutex_lock(s_pool_mutex))
+    {
+        if(s_pool_lst == p)
+        {
+            s_pool_lst = p->nxt;
+        }
+        else
+        {
+            for(tmp = s_pool_lst; NULL != tmp; tmp = tmp->nxt)
+            {
+                if(tmp->nxt == p)
+                {
+                    tmp->nxt = p->nxt;
+                    break;
+                }
+            }
+        }
+        (void) osal_mutex_unlock(s_pool_mutex);
+    }
+
+    while(NULL != p->seg_lst)
+    {
+        seg = p->seg_lst;
+        p->seg_lst = seg->nxt;
+        osal_free(seg);
+    }
+
+    if(cn_mutex_invalid != p->mutex)
+    {
+        (void) osal_mutex_del(p->mutex);
+    }
+    osal_free(p);
+
+    return 0;
+}
+
+#ifdef CONFIG_SHELL_ENABLE
+#include <shell.h>
+static int pool_print(int argc, const char *argv[])
+{
+    osal_pool_t *p;
+    osal_pool_stat_t stat;
+
+    if(true == osal_mutex_lock(s_pool_mutex))
+    {
+        LINK_LOG_DEBUG("%-16s %-8s %-8s %-8s %-8s %-8s %-8s %-8s %s\n\r",\
+                "Pool-Name","ObjSize","Total","Used","Peak","Heap","HeapAll","Fail","Segs");
+        for(p = s_pool_lst; NULL != p; p = p->nxt)
+        {
+            (void) osal_pool_stat(p, &stat);
+            LINK_LOG_DEBUG("%-16s %-8d %-8d %-8d %-8d %-8d %-8d %-8d %d\n\r",\
+                    (NULL == stat.name) ? "UNKNOWN" : stat.name, stat.objsize,\
+                    stat.total, stat.used, stat.peak, stat.heap, stat.heap_total, stat.fail, stat.segs);
+        }
+        (void) osal_mutex_unlock(s_pool_mutex);
+    }
+
+    return 0;
+}
+OSSHELL_EXPORT_CMD(pool_print,"pool","pool");
+#endif
+
 
 
 unsigned long long osal_sys_time()
@@ -376,6 +1019,10 @@ int osal_init(void)
 {
     int ret = -1;
     ret = os_imp_init();
+    if(0 == ret)
+    {
+        (void) osal_mutex_create(&s_pool_mutex);   ///< protect the object pool list
+    }
     return ret;
 }
 
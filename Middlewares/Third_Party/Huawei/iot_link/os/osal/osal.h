@@ -110,6 +110,15 @@ bool_t  osal_semp_pend(osal_semp_t semp,unsigned int timeout);
 bool_t  osal_semp_post(osal_semp_t semp);
 bool_t  osal_semp_del(osal_semp_t semp);
 
+/**
+ *@brief: the queue method, which copies the message in and out; the os without it returns false
+ *
+ **/
+bool_t  osal_queue_create(osal_queue_t *queue,int len,int msgsize);
+bool_t  osal_queue_send(osal_queue_t queue,void *pbuf,unsigned int bufsize,unsigned int timeout);
+bool_t  osal_queue_recv(osal_queue_t queue,void *pbuf,unsigned int bufsize,unsigned int timeout);
+bool_t  osal_queue_del(osal_queue_t queue);
+
 
 /**
  *@brief: the memory method that the os must supplied for the link
@@ -121,6 +130,113 @@ void *osal_zalloc(size_t size);
 void *osal_realloc(void *ptr,size_t newsize);
 void *osal_calloc(size_t n, size_t size);
 
+/**
+ *@brief: the memory region attributes and the placement flags for osal_malloc_ex
+ *
+ **/
+#define cn_osal_mem_attr_fast      (1<<0)   ///< low latency memory, such as the internal SRAM
+#define cn_osal_mem_attr_slow      (1<<1)   ///< bulk memory, such as the external PSRAM
+#define cn_osal_mem_attr_dma       (1<<2)   ///< the memory could be accessed by the DMA
+#define cn_osal_mem_flag_strict    (1<<8)   ///< only for osal_malloc_ex, never fall back to other regions
+
+/**
+ * @brief:use this function to add a memory region which will be managed as a separate heap
+ *
+ * @param[in]:name, the region name
+ * @param[in]:base, the region start address
+ * @param[in]:size, the region size
+ * @param[in]:attr, the region attributes, cn_osal_mem_attr_xxx
+ *
+ * @return:0 success while -1 failed
+ *
+ * @note: the system heap used by osal_malloc is always there as a region with the
+ *        attributes CONFIG_OSAL_SYSHEAP_ATTR; call this function before any osal_malloc_ex
+ * */
+int osal_mem_region_add(const char *name, void *base, size_t size, int attr);
+
+/**
+ * @brief:use this function to allocate memory by the placement policy
+ *
+ * @param[in]:size, the memory size
+ * @param[in]:flags, the attributes wanted, cn_osal_mem_attr_xxx and cn_osal_mem_flag_xxx
+ *
+ * @return:the memory, while NULL failed; release it with osal_free, and osal_realloc resizes
+ *         it in its own region, which fails when the region is full
+ *
+ * @note: cn_osal_mem_attr_dma is a must; the speed attribute is a preference, and without
+ *        any speed attribute, the request not less than CONFIG_OSAL_MEM_LARGE_SIZE prefers
+ *        the slow region while the others prefer the fast region; when the preferred regions
+ *        are exhausted, the other regions with the must attributes are tried unless strict
+ * */
+void *osal_malloc_ex(size_t size, int flags);
+
+/**
+ *@brief: the object pool for the fixed size objects, alloc and free in constant time
+ *
+ **/
+typedef struct
+{
+    const char *name;     ///< the pool name
+    int         objsize;  ///< the object size
+    int         total;    ///< how many objects in all the segments
+    int         used;     ///< how many objects in use now
+    int         peak;     ///< the water line of the used objects
+    int         heap;     ///< how many objects from the heap in use now, served when the pool was exhausted
+    int         heap_total;///< how many objects the heap has served in all
+    int         fail;     ///< how many times the alloc failed, the heap failed too
+    int         segs;     ///< how many segments, the first one and the grown ones
+}osal_pool_stat_t;
+
+/**
+ * @brief:use this function to create an object pool
+ *
+ * @param[in]:name, the pool name, must be static
+ * @param[in]:objsize, the object size
+ * @param[in]:count, how many objects in each segment
+ * @param[in]:grow, how many segments could be added when the pool is exhausted
+ *
+ * @return:the pool handle, while NULL failed
+ *
+ * @note: the segment is a fixed block memory supplied by the os(membox for LiteOS); when
+ *        the os has no such method, the pool degrades to osal_malloc with the statistics
+ * */
+void *osal_pool_create(const char *name, size_t objsize, int count, int grow);
+
+/**
+ * @brief:use this function to get an object from the pool
+ *
+ * @param[in]:pool, the pool created by osal_pool_create
+ *
+ * @return:the object, while NULL failed; when the pool and its grown segments are exhausted,
+ *         the object comes from osal_malloc, which is counted by the heap of the statistics until freed
+ * */
+void *osal_pool_alloc(void *pool);
+
+/**
+ * @brief:use this function to return an object to the pool
+ *
+ * @param[in]:pool, the pool created by osal_pool_create
+ * @param[in]:obj, the object to release
+ *
+ * @note: the object not belongs to the pool segments is released by osal_free, so the
+ *        caller could fall back to osal_malloc for the oversize objects
+ * */
+void osal_pool_free(void *pool, void *obj);
+
+/**
+ * @brief:use this function to delete the pool, all the objects must have been released
+ *
+ * @return:0 success while -1 failed, such as the objects or the ones from the heap still in use
+ * */
+int osal_pool_delete(void *pool);
+
+/**
+ * @brief:use this function to get the pool usage
+ *
+ * @return:0 success while -1 failed
+ * */
+int osal_pool_stat(void *pool, osal_pool_stat_t *stat);
+
 
 /**
  * @brief: use this function to get the system time
@@ -44,6 +44,18 @@ typedef struct
     void  (*free)(void *addr);
     void *(*realloc)(void *ptr, int newsize);
 
+    ///< memory pool function needed by the multi region memory, could be NULL
+    void *(*mem_pool_create)(void *base, int size);
+    void *(*mem_pool_malloc)(void *pool, int size);
+    void  (*mem_pool_free)(void *pool, void *addr);
+    void *(*mem_pool_realloc)(void *pool, void *addr, int newsize);   ///< kept in the pool, NULL means could not
+
+    ///< fixed block memory function needed by the object pool, could be NULL
+    int    (*box_size)(int blksize, int blknum);    ///< the memory needed by the box
+    bool_t (*box_init)(void *box, int size, int blksize);
+    void  *(*box_alloc)(void *box);
+    void   (*box_free)(void *box, void *blk);
+    int    (*box_stat)(void *box, int *used, int *peak, int *fail);
 
     ///< system time
     unsigned long long (*get_sys_time)(void);
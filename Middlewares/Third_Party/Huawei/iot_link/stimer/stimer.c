@@ -55,6 +55,14 @@
 #define  CONFIG_STIMER_TASKPRIOR    10
 #endif
 
+#ifndef  CONFIG_STIMER_POOLSIZE
+#define  CONFIG_STIMER_POOLSIZE     8       ///< the timers in each pool segment
+#endif
+
+#ifndef  CONFIG_STIMER_NAMELEN
+#define  CONFIG_STIMER_NAMELEN      16      ///< the name longer than this will malloc from the heap
+#endif
+
 
 
 ///< we use the normal list to manage the timer, next time you could use the RB
@@ -77,6 +85,7 @@ typedef struct
     osal_mutex_t   mutex;      ///< used for protect the timer list
     stimer_item_t *lst;        ///< this is the soft timer list，
     void          *task;       ///< this is the task engine
+    void          *pool;       ///< the timer object pool
     int            daemon_exit;///< this is the task exit;
 
 }stimer_cb_t;
@@ -264,6 +273,12 @@ int32_t stimer_init()
     {
         goto EXIT_MUTEXERR;
     }
+    s_stimer_cb.pool = osal_pool_create("stimer",sizeof(stimer_item_t) + CONFIG_STIMER_NAMELEN,\
+                                        CONFIG_STIMER_POOLSIZE,1);
+    if(NULL == s_stimer_cb.pool)
+    {
+        goto EXIT_POOLERR;
+    }
 
     s_stimer_cb.task = osal_task_create("soft timer",__timer_entry,NULL,CONFIG_STIMER_STACKSIZE,NULL,CONFIG_STIMER_TASKPRIOR);
 
@@ -277,6 +292,9 @@ int32_t stimer_init()
     return ret;
 
 EXIT_TASKERR:
+    (void) osal_pool_delete(s_stimer_cb.pool);
+    s_stimer_cb.pool = NULL;
+EXIT_POOLERR:
     (void) osal_mutex_del(s_stimer_cb.mutex);
     s_stimer_cb.mutex = cn_mutex_invalid;
 EXIT_MUTEXERR:
@@ -298,7 +316,14 @@ stimer_t stimer_create(const char *name,fn_stimer_handler handler, void *arg,uin
         mem_len += strlen(name) + 1;
     }
 
-    item  = osal_malloc( mem_len);
+    if(mem_len <= (int)(sizeof(stimer_item_t) + CONFIG_STIMER_NAMELEN))
+    {
+        item = osal_pool_alloc(s_stimer_cb.pool);
+    }
+    else
+    {
+        item = osal_malloc(mem_len);      ///< released by osal_pool_free too
+    }
     if(NULL == item)
     {
         return item;
@@ -332,7 +357,7 @@ stimer_t stimer_create(const char *name,fn_stimer_handler handler, void *arg,uin
     }
     else
     {
-        osal_free(item);
+        osal_pool_free(s_stimer_cb.pool,item);
         item = NULL;
     }
 
@@ -347,7 +372,7 @@ int32_t stimer_delete(stimer_t timer)
     {
         timer_remove(timer);
         (void) osal_mutex_unlock(s_stimer_cb.mutex);
-        osal_free(timer);
+        osal_pool_free(s_stimer_cb.pool,timer);
         (void) osal_semp_post(s_stimer_cb.semp);
         ret = 0;
     }
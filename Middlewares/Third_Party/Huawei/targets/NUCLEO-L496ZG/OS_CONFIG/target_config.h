@@ -310,6 +310,12 @@ extern "C" {
  */
 #define LOSCFG_KERNEL_MEM_SLAB                              YES
 
+/**
+ * @ingroup los_config
+ * Configuration item for the lock-free membox
+ */
+#define LOSCFG_MEMBOX_LOCKFREE                              YES
+
 
 /*=============================================================================
                                        fw Interface configuration
@@ -69,6 +69,12 @@ static oc_mqtt_profile_kv_t       property_z;
 
 static volatile bool stop_report = false;
 
+static int   s_asex_x, s_asex_y, s_asex_z;
+static char  s_temp [8];
+static char  s_hum [8];
+static char  s_press [8];
+static void *s_report_template = NULL;   ///< the property report compiled once, only the values change
+
 //use this function to push all the message to the buffer
 static int app_msg_deal(oc_mqtt_profile_msgrcv_t *msg)
 {
@@ -131,9 +137,9 @@ static int app_msg_deal(oc_mqtt_profile_msgrcv_t *msg)
 #define CN_EVENT_TYPE_VERSIONQUERY   "version_query"
 #define CN_EVENT_TYPE_FIRMUPDATE     "firmware_upgrade"
 
-#include <cJSON.h>
+#include <link_json.h>
 
-static int oc_cmd_event_versionquery(cJSON *event)
+static int oc_cmd_event_versionquery(const json_value_t *event)
 {
     int ret;
     char *topic = "$oc/devices/"CN_EP_DEVICEID"/sys/events/up";
@@ -207,60 +213,79 @@ static int oc_report_upgrade_process(int ret, int total, int cur)
     return oc_mqtt_report_upgradeprogress(CN_EP_DEVICEID,NULL,ret,NULL,cur*100/total);
 }
 
-static int oc_cmd_event_firmupdate(cJSON *event)
+///< copy the string value without the escapes, return the next free position while NULL failed
+static char *oc_cmd_event_string(const json_value_t *value, char *buf, const char **str)
+{
+    int len;
+
+    len = json_value_string(value, buf, value->len + 1);
+    if(len < 0)
+    {
+        return NULL;
+    }
+    *str = buf;
+
+    return buf + len + 1;
+}
+
+static int oc_cmd_event_firmupdate(const json_value_t *event)
 {
     int ret = -1;
-    cJSON *obj_paras;
-    cJSON *obj_version;
-    cJSON *obj_url;
-    cJSON *obj_filesize;
-    cJSON *obj_accesstoken;
-    cJSON *obj_sign;
+    json_value_t obj_paras;
+    json_value_t obj_version;
+    json_value_t obj_url;
+    json_value_t obj_filesize;
+    json_value_t obj_accesstoken;
+    json_value_t obj_sign;
+    long  file_size;
+    char *buf;
 
     ota_https_para_t *otapara;
 
     stop_report = true;
 
-    otapara = osal_malloc(sizeof(ota_https_para_t));
-    memset(otapara, 0, sizeof(ota_https_para_t));
+    if((0 != json_get(event->data, event->len, "paras", &obj_paras)) || \
+       (0 != json_get(obj_paras.data, obj_paras.len, "version", &obj_version)) || \
+       (0 != json_get(obj_paras.data, obj_paras.len, "url", &obj_url)) || \
+       (0 != json_get(obj_paras.data, obj_paras.len, "file_size", &obj_filesize)) || \
+       (0 != json_get(obj_paras.data, obj_paras.len, "access_token", &obj_accesstoken)) || \
+       (0 != json_get(obj_paras.data, obj_paras.len, "sign", &obj_sign)) || \
+       (0 != json_value_int(&obj_filesize, &file_size)))
+    {
+        return ret;
+    }
+
+    ///< the para and the strings in one block, the string is never longer than its text
+    otapara = osal_zalloc(sizeof(ota_https_para_t) + obj_version.len + obj_url.len + \
+                          obj_accesstoken.len + obj_sign.len + 4);
     if(NULL == otapara)
     {
         return ret;
     }
 
-    obj_paras = cJSON_GetObjectItem(event, "paras");
-    if(NULL != obj_paras)
+    buf = (char *)(otapara + 1);
+    buf = oc_cmd_event_string(&obj_version, buf, &otapara->version);
+    buf = (NULL == buf) ? NULL : oc_cmd_event_string(&obj_url, buf, &otapara->url);
+    buf = (NULL == buf) ? NULL : oc_cmd_event_string(&obj_accesstoken, buf, &otapara->authorize);
+    buf = (NULL == buf) ? NULL : oc_cmd_event_string(&obj_sign, buf, &otapara->signature);
+    if(NULL != buf)
     {
-        obj_version = cJSON_GetObjectItem(obj_paras, "version");
-        obj_url = cJSON_GetObjectItem(obj_paras, "url");
-        obj_filesize = cJSON_GetObjectItem(obj_paras, "file_size");
-        obj_accesstoken = cJSON_GetObjectItem(obj_paras, "access_token");
-        obj_sign = cJSON_GetObjectItem(obj_paras, "sign");
-
-        if((NULL != obj_version) && (NULL != obj_url) && (NULL != obj_filesize) && \
-                (NULL != obj_accesstoken) && (NULL != obj_sign))
+        otapara->file_size = (int)file_size;
+        otapara->report_progress = oc_report_upgrade_process;
+        ///< here we do the firmware download
+        if(0 != ota_https_download(otapara))
+        {
+            oc_report_upgraderet(6,otapara->version);
+            LINK_LOG_ERROR("DOWNLOADING ERR");
+        }
+        else
         {
-            otapara->authorize = cJSON_GetStringValue(obj_accesstoken);
-            otapara->url = cJSON_GetStringValue(obj_url);
-            otapara->signature = cJSON_GetStringValue(obj_sign);
-            otapara->file_size = obj_filesize->valueint;
-            otapara->version = cJSON_GetStringValue(obj_version);
-            otapara->report_progress = oc_report_upgrade_process;
-            ///< here we do the firmware download
-            if(0 != ota_https_download(otapara))
-            {
-                oc_report_upgraderet(6,otapara->version);
-                LINK_LOG_ERROR("DOWNLOADING ERR");
-            }
-            else
-            {
-//                oc_report_upgraderet(0,otapara->version);
-                LINK_LOG_DEBUG("DOWNLOADING SUCCESS");
-                osal_task_sleep(500);
-                osal_reboot();
-            }
-            ret = 0;
+//            oc_report_upgraderet(0,otapara->version);
+            LINK_LOG_DEBUG("DOWNLOADING SUCCESS");
+            osal_task_sleep(500);
+            osal_reboot();
         }
+        ret = 0;
     }
 
     osal_free(otapara);
@@ -271,53 +296,43 @@ static int oc_cmd_event_firmupdate(cJSON *event)
 
 static int oc_cmd_event(oc_mqtt_profile_msgrcv_t *msg)
 {
-    int ret = -1;
-    cJSON *obj_root;
-    cJSON *obj_servicearry;
-    cJSON *obj_service;
-    cJSON *obj_eventtype;
-
-    obj_root = cJSON_Parse(msg->msg);
-    if(NULL == obj_root)
-    {
-        goto EXIT_JSONFMT;
-    }
-
-    obj_servicearry = cJSON_GetObjectItem(obj_root,CN_EVENT_SERVICES_ID);
-    if((NULL == obj_servicearry) || (!cJSON_IsArray(obj_servicearry)))
+    json_value_t obj_servicearry;
+    json_value_t obj_service;
+    json_value_t obj_eventtype;
+    json_iter_t  iter;
+
+    ///< walk the services in the message directly, no json tree is built
+    if((0 != json_get(msg->msg, msg->msg_len, CN_EVENT_SERVICES_ID, &obj_servicearry)) || \
+       (0 != json_iter_init(&iter, &obj_servicearry)))
     {
-        goto EXIT_JSONSERVICEARRY;
+        return -1;
     }
 
-    cJSON_ArrayForEach(obj_service,obj_servicearry)
+    while(0 == json_iter_next(&iter, NULL, &obj_service))
     {
-        obj_eventtype = cJSON_GetObjectItem(obj_service,CN_EVENT_TYPE_INDEX);
-        if(NULL == obj_eventtype)
+        if(0 != json_get(obj_service.data, obj_service.len, CN_EVENT_TYPE_INDEX, &obj_eventtype))
         {
             continue;
         }
-        if(0 == strcmp(cJSON_GetStringValue(obj_eventtype),CN_EVENT_TYPE_VERSIONQUERY))
+        if(json_value_equal(&obj_eventtype, CN_EVENT_TYPE_VERSIONQUERY, sizeof(CN_EVENT_TYPE_VERSIONQUERY) - 1))
         {
-            oc_cmd_event_versionquery(obj_service);
+            oc_cmd_event_versionquery(&obj_service);
         }
-        else if(0 == strcmp(cJSON_GetStringValue(obj_eventtype),CN_EVENT_TYPE_FIRMUPDATE))
+        else if(json_value_equal(&obj_eventtype, CN_EVENT_TYPE_FIRMUPDATE, sizeof(CN_EVENT_TYPE_FIRMUPDATE) - 1))
         {
-            oc_cmd_event_firmupdate(obj_service);
+            oc_cmd_event_firmupdate(&obj_service);
         }
     }
-    cJSON_Delete(obj_root);
-    return 0;
 
-EXIT_JSONSERVICEARRY:
-    cJSON_Delete(obj_root);
-EXIT_JSONFMT:
-    return ret;
+    return 0;
 }
 
 ///< now we deal the message here
 static int  oc_cmd_normal(oc_mqtt_profile_msgrcv_t *demo_msg)
 {
     static int value = 0;
+    oc_mqtt_profile_kv_t       property_radio;
+    oc_mqtt_profile_service_t  radio_service;
     oc_mqtt_profile_cmdresp_t  cmdresp;
     oc_mqtt_profile_propertysetresp_t propertysetresp;
     oc_mqtt_profile_propertygetresp_t propertygetresp;
@@ -353,12 +368,15 @@ static int  oc_cmd_normal(oc_mqtt_profile_msgrcv_t *demo_msg)
 
             ///< do the response
             value  = (value+1)%100;
-            s_device_service.service_property->key = "radioValue";
-            s_device_service.service_property->value = &value;
-            s_device_service.service_property->type = EN_OC_MQTT_PROFILE_VALUE_INT;
+            property_radio.nxt = NULL;
+            property_radio.key = "radioValue";
+            property_radio.value = &value;
+            property_radio.type = EN_OC_MQTT_PROFILE_VALUE_INT;
+            radio_service = s_device_service;
+            radio_service.service_property = &property_radio;
 
             propertygetresp.request_id = demo_msg->request_id;
-            propertygetresp.services = &s_device_service;
+            propertygetresp.services = &radio_service;
             (void)oc_mqtt_profile_propertygetresp(NULL,&propertygetresp);
             break;
         case EN_OC_MQTT_PROFILE_MSG_TYPE_DOWN_EVENT:
@@ -392,10 +410,6 @@ static int  oc_report_normal(void)
 {
     int ret = en_oc_mqtt_err_ok;
     float temp, hum, press;
-    static int s_asex_x, s_asex_y, s_asex_z;
-    static char s_temp [8];
-    static char s_hum [8];
-    static char s_press [8];
 
     MX_MEMS_Getinfo(&temp, &hum, &press, &s_asex_x, &s_asex_y, &s_asex_z);
 
@@ -407,31 +421,19 @@ static int  oc_report_normal(void)
     s_hum   [5] = '\0';
     s_press [7] = '\0';
 
-    property_temp.key = "temperature";
-    property_temp.value = s_temp;
-    property_temp.type = EN_OC_MQTT_PROFILE_VALUE_STRING;
-
-    property_hum.key = "humidity";
-    property_hum.value = s_hum;
-    property_hum.type = EN_OC_MQTT_PROFILE_VALUE_STRING;
-
-    property_press.key = "pressure";
-    property_press.value = s_press;
-    property_press.type = EN_OC_MQTT_PROFILE_VALUE_STRING;
-
-    property_x.key = "accelerometer_x";
-    property_x.value = &s_asex_x;
-    property_x.type = EN_OC_MQTT_PROFILE_VALUE_INT;
-
-    property_y.key = "accelerometer_y";
-    property_y.value = &s_asex_y;
-    property_y.type = EN_OC_MQTT_PROFILE_VALUE_INT;
-
-    property_z.key = "accelerometer_z";
-    property_z.value = &s_asex_z;
-    property_z.type = EN_OC_MQTT_PROFILE_VALUE_INT;
-
-    ret = oc_mqtt_profile_propertyreport(NULL,&s_device_service);
+    ///< the properties point to the values above, so the template reports the new values
+    if(NULL == s_report_template)
+    {
+        s_report_template = oc_mqtt_profile_template_create(NULL,&s_device_service);
+    }
+    if(NULL != s_report_template)
+    {
+        ret = oc_mqtt_profile_template_report(s_report_template);
+    }
+    else
+    {
+        ret = oc_mqtt_profile_propertyreport(NULL,&s_device_service);
+    }
 
     printf("reported temperature = %s, humidity = %s, pressure = %s, accelerometer = (%d, %d, %d) %s\n\r",
            s_temp, s_hum, s_press, s_asex_x, s_asex_y, s_asex_z, ret == 0 ? "successful :-)" : "fail :-(");
@@ -476,7 +478,7 @@ static int task_reportmsg_entry(void *args)
     ota_flag_save(EN_OTA_TYPE_FOTA,&otaflag);
 #endif
 
-    oc_cmd_event_versionquery((cJSON *)NULL);
+    oc_cmd_event_versionquery(NULL);
 
     char *topic;
     topic = "user/demo_topic";
@@ -503,6 +505,30 @@ int standard_app_demo_main(void)
 {
     s_queue_rcvmsg = queue_create("queue_rcvmsg",2,1);
 
+    property_temp.key = "temperature";
+    property_temp.value = s_temp;
+    property_temp.type = EN_OC_MQTT_PROFILE_VALUE_STRING;
+
+    property_hum.key = "humidity";
+    property_hum.value = s_hum;
+    property_hum.type = EN_OC_MQTT_PROFILE_VALUE_STRING;
+
+    property_press.key = "pressure";
+    property_press.value = s_press;
+    property_press.type = EN_OC_MQTT_PROFILE_VALUE_STRING;
+
+    property_x.key = "accelerometer_x";
+    property_x.value = &s_asex_x;
+    property_x.type = EN_OC_MQTT_PROFILE_VALUE_INT;
+
+    property_y.key = "accelerometer_y";
+    property_y.value = &s_asex_y;
+    property_y.type = EN_OC_MQTT_PROFILE_VALUE_INT;
+
+    property_z.key = "accelerometer_z";
+    property_z.value = &s_asex_z;
+    property_z.type = EN_OC_MQTT_PROFILE_VALUE_INT;
+
     property_temp.nxt  = &property_hum;
     property_hum.nxt   = &property_press;
     property_press.nxt = &property_x;